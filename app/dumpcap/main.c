@@ -49,6 +49,7 @@
 #define MBUF_POOL_CACHE_SIZE 32
 #define BURST_SIZE 32
 #define SLEEP_THRESHOLD 1000
+#define ZC_BLOCKS_MAX 1024
 
 /* command line flags */
 static const char *progname;
@@ -64,6 +65,7 @@ static const char *file_prefix;
 static bool dump_bpf;
 static bool show_interfaces;
 static bool print_stats;
+static bool zero_copy;
 
 /* capture limit options */
 static struct {
@@ -102,6 +104,16 @@ struct interface {
 TAILQ_HEAD(interface_list, interface);
 static struct interface_list interfaces = TAILQ_HEAD_INITIALIZER(interfaces);
 
+/* Zero-copy mode uses one ring per queue and direction */
+struct capture_ring {
+	struct rte_ring *r;
+	uint32_t esize;
+	unsigned int pending;	/* blocks dequeued, not yet released */
+};
+
+static struct capture_ring *zc_rings;
+static unsigned int nb_zc_rings;
+
 /* Can do either pcap or pcapng format output */
 typedef union {
 	rte_pcapng_t  *pcapng;
@@ -126,6 +138,7 @@ static void usage(void)
 	       "  -D, --list-interfaces    print list of interfaces and exit\n"
 	       "  -d                       print generated BPF code for capture filter\n"
 	       "  -S                       print statistics for each interface once per second\n"
+	       "  --zero-copy              capture into per queue rings without mbuf copies\n"
 	       "\n"
 	       "Stop conditions:\n"
 	       "  -c <packet count>        stop after n packets (def: infinite)\n"
@@ -351,6 +364,7 @@ static void parse_opts(int argc, char **argv)
 		{ "snapshot-length", required_argument, NULL, 's' },
 		{ "temp-dir",        required_argument, NULL, 0 },
 		{ "version",         no_argument,       NULL, 'v' },
+		{ "zero-copy",       no_argument,       NULL, 0 },
 		{ NULL },
 	};
 	int option_index, c;
@@ -374,6 +388,8 @@ static void parse_opts(int argc, char **argv)
 				file_prefix = optarg;
 			} else if (!strcmp(longopt, "temp-dir")) {
 				tmp_dir = optarg;
+			} else if (!strcmp(longopt, "zero-copy")) {
+				zero_copy = true;
 			} else if (!strcmp(longopt, "ifdescr")) {
 				if (last_intf == NULL)
 					rte_exit(EXIT_FAILURE,
@@ -671,6 +687,67 @@ static struct rte_ring *create_ring(void)
 	return ring;
 }
 
+/* Create the ring of one queue and direction for zero-copy capture */
+static struct rte_ring *create_zc_ring(const struct interface *intf,
+				       uint16_t queue, uint32_t dir,
+				       uint32_t esize)
+{
+	char name[RTE_RING_NAMESIZE];
+	struct capture_ring *rings;
+	struct rte_ring *ring;
+
+	snprintf(name, sizeof(name), "capture-%u-%s-%u", intf->port,
+		 dir == RTE_PDUMP_FLAG_RX ? "rx" : "tx", queue);
+
+	/* The primary may still write to a left over ring, reuse it if it
+	 * has the same size
+	 */
+	ring = rte_ring_lookup(name);
+	if (ring != NULL) {
+		ssize_t mem_size = rte_ring_get_memsize_elem(esize,
+						rte_ring_get_size(ring));
+
+		if (rte_ring_get_capacity(ring) != ring_size ||
+		    mem_size < 0 || ring->memzone == NULL ||
+		    ring->memzone->len < (size_t)mem_size)
+			rte_exit(EXIT_FAILURE,
+				 "Ring %s already exists with another size\n",
+				 name);
+	} else {
+		ring = rte_ring_create_elem(name, esize, ring_size,
+					    rte_socket_id(),
+					    RING_F_SP_ENQ | RING_F_SC_DEQ |
+					    RING_F_EXACT_SZ);
+		if (ring == NULL)
+			rte_exit(EXIT_FAILURE,
+				 "Could not create ring %s: %s\n",
+				 name, rte_strerror(rte_errno));
+	}
+
+	rings = realloc(zc_rings, (nb_zc_rings + 1) * sizeof(*rings));
+	if (rings == NULL)
+		rte_exit(EXIT_FAILURE, "No memory for rings\n");
+
+	zc_rings = rings;
+	zc_rings[nb_zc_rings].r = ring;
+	zc_rings[nb_zc_rings].esize = esize;
+	zc_rings[nb_zc_rings].pending = 0;
+	nb_zc_rings++;
+
+	return ring;
+}
+
+static void free_zc_rings(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < nb_zc_rings; i++)
+		rte_ring_free(zc_rings[i].r);
+	free(zc_rings);
+	zc_rings = NULL;
+	nb_zc_rings = 0;
+}
+
 static struct rte_mempool *create_mempool(void)
 {
 	const struct interface *intf;
@@ -796,6 +873,45 @@ static dumpcap_out_t create_output(void)
 	return ret;
 }
 
+/*
+ * Enable zero-copy capture on every queue of the interface,
+ * each queue and direction writing to its own ring.
+ */
+static int enable_pdump_zc(const struct interface *intf)
+{
+	static const uint32_t dirs[] = { RTE_PDUMP_FLAG_RX, RTE_PDUMP_FLAG_TX };
+	struct rte_eth_dev_info dev_info;
+	uint16_t q, nb_q;
+	unsigned int i;
+	uint32_t esize;
+	int ret;
+
+	ret = rte_eth_dev_info_get(intf->port, &dev_info);
+	if (ret != 0)
+		return ret;
+
+	esize = rte_pcapng_block_size(intf->opts.snap_len);
+
+	for (i = 0; i < RTE_DIM(dirs); i++) {
+		nb_q = dirs[i] == RTE_PDUMP_FLAG_RX ?
+			dev_info.nb_rx_queues : dev_info.nb_tx_queues;
+
+		for (q = 0; q < nb_q; q++) {
+			struct rte_ring *r;
+
+			r = create_zc_ring(intf, q, dirs[i], esize);
+			ret = rte_pdump_enable_bpf(intf->port, q,
+					dirs[i] | RTE_PDUMP_FLAG_ZEROCOPY,
+					intf->opts.snap_len, r, NULL,
+					intf->bpf_prm);
+			if (ret < 0)
+				return ret;
+		}
+	}
+
+	return 0;
+}
+
 static void enable_pdump(struct rte_ring *r, struct rte_mempool *mp)
 {
 	struct interface *intf;
@@ -808,9 +924,13 @@ static void enable_pdump(struct rte_ring *r, struct rte_mempool *mp)
 		flags |= RTE_PDUMP_FLAG_PCAPNG;
 
 	TAILQ_FOREACH(intf, &interfaces, next) {
-		ret = rte_pdump_enable_bpf(intf->port, RTE_PDUMP_ALL_QUEUES,
-					   flags, intf->opts.snap_len,
-					   r, mp, intf->bpf_prm);
+		if (zero_copy)
+			ret = enable_pdump_zc(intf);
+		else
+			ret = rte_pdump_enable_bpf(intf->port,
+						   RTE_PDUMP_ALL_QUEUES,
+						   flags, intf->opts.snap_len,
+						   r, mp, intf->bpf_prm);
 		if (ret < 0) {
 			const struct interface *intf2;
 
@@ -940,12 +1060,80 @@ static int process_ring(dumpcap_out_t out, struct rte_ring *r)
 	return 0;
 }
 
+/*
+ * Zero-copy variant: gather the blocks of all rings,
+ * write them with as few system calls as possible,
+ * then release the ring space.
+ */
+static int process_rings_zc(dumpcap_out_t out)
+{
+	static unsigned int empty_count, next;
+	void *blocks[ZC_BLOCKS_MAX];
+	unsigned int i, j, n, total = 0;
+	ssize_t written;
+
+	for (i = 0; i < nb_zc_rings && total + BURST_SIZE <= ZC_BLOCKS_MAX;
+	     i++) {
+		struct capture_ring *cr = &zc_rings[(next + i) % nb_zc_rings];
+		struct rte_ring_zc_data zcd;
+
+		n = rte_ring_dequeue_zc_burst_elem_start(cr->r, cr->esize,
+							 BURST_SIZE, &zcd,
+							 NULL);
+		for (j = 0; j < n; j++) {
+			if (j < zcd.n1)
+				blocks[total++] = RTE_PTR_ADD(zcd.ptr1,
+							      j * cr->esize);
+			else
+				blocks[total++] = RTE_PTR_ADD(zcd.ptr2,
+						(j - zcd.n1) * cr->esize);
+		}
+		cr->pending = n;
+	}
+
+	/* start with the next ring on the next call, for fairness */
+	if (nb_zc_rings != 0)
+		next = (next + i) % nb_zc_rings;
+
+	if (total == 0) {
+		/* don't consume endless amounts of cpu if idle */
+		if (empty_count < SLEEP_THRESHOLD)
+			++empty_count;
+		else
+			usleep(10);
+		return 0;
+	}
+
+	empty_count = 0;
+
+	written = rte_pcapng_write_blocks(out.pcapng, blocks, total);
+
+	for (i = 0; i < nb_zc_rings; i++) {
+		if (zc_rings[i].pending == 0)
+			continue;
+		rte_ring_dequeue_zc_elem_finish(zc_rings[i].r,
+						zc_rings[i].pending);
+		zc_rings[i].pending = 0;
+	}
+
+	if (written < 0)
+		return -1;
+
+	file_size += written;
+	packets_received += total;
+	if (!quiet)
+		show_count(packets_received);
+
+	return 0;
+}
+
 int main(int argc, char **argv)
 {
-	struct rte_ring *r;
-	struct rte_mempool *mp;
+	struct rte_ring *r = NULL;
+	struct rte_mempool *mp = NULL;
 	dumpcap_out_t out;
 	char *p;
+	int ret;
 
 	p = strrchr(argv[0], '/');
 	if (p == NULL)
@@ -954,6 +1142,8 @@ int main(int argc, char **argv)
 		progname = p + 1;
 
 	parse_opts(argc, argv);
+	if (zero_copy && !use_pcapng)
+		rte_exit(EXIT_FAILURE, "Zero-copy capture needs pcapng format\n");
 	dpdk_init();
 
 	if (show_interfaces)
@@ -979,8 +1169,10 @@ int main(int argc, char **argv)
 		exit(0);
 	}
 
-	r = create_ring();
-	mp = create_mempool();
+	if (!zero_copy) {
+		r = create_ring();
+		mp = create_mempool();
+	}
 	out = create_output();
 
 	start_time = create_timestamp();
@@ -992,7 +1184,11 @@ int main(int argc, char **argv)
 	}
 
 	while (!__atomic_load_n(&quit_signal, __ATOMIC_RELAXED)) {
-		if (process_ring(out, r) < 0) {
+		if (zero_copy)
+			ret = process_rings_zc(out);
+		else
+			ret = process_ring(out, r);
+		if (ret < 0) {
 			fprintf(stderr, "pcapng file write failed; %s\n",
 				strerror(errno));
 			break;
@@ -1022,6 +1218,7 @@ int main(int argc, char **argv)
 
 	cleanup_pdump_resources();
 
+	free_zc_rings();
 	rte_ring_free(r);
 	rte_mempool_free(mp);
 
@@ -62,6 +62,7 @@ struct evt_options {
 	uint8_t nb_timer_adptrs;
 	uint8_t timdev_use_burst;
 	uint8_t per_port_pool;
+	uint8_t flow_skew;
 	uint8_t sched_type_list[EVT_MAX_STAGES];
 	uint16_t mbuf_sz;
 	uint16_t wkr_deq_dep;
@@ -149,6 +150,18 @@ evt_service_setup(uint32_t service_id)
 			RTE_MAX_LCORE);
 	if (core_cnt < 0)
 		return -ENOENT;
+
+	/* MT safe services, e.g. event_sw with several scheduler groups,
+	 * run on all the service cores.
+	 */
+	if (rte_service_probe_capability(service_id,
+				RTE_SERVICE_CAP_MT_SAFE) == 1) {
+		while (core_cnt--)
+			if (rte_service_map_lcore_set(service_id,
+					core_array[core_cnt], 1))
+				return -ENOENT;
+		return 0;
+	}
 	/* Get the core which has least number of services running. */
 	while (core_cnt--) {
 		/* Reset default mapping */
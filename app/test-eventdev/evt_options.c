@@ -62,6 +62,20 @@ evt_parse_nb_flows(struct evt_options *opt, const char *arg)
 	return ret;
 }
 
+static int
+evt_parse_flow_skew(struct evt_options *opt, const char *arg)
+{
+	int ret;
+
+	ret = parser_read_uint8(&(opt->flow_skew), arg);
+	if (!ret && opt->flow_skew > 100) {
+		evt_err("flow_skew is a percentage, must be <= 100");
+		ret = -EINVAL;
+	}
+
+	return ret;
+}
+
 static int
 evt_parse_dev_id(struct evt_options *opt, const char *arg)
 {
@@ -440,6 +454,8 @@ usage(char *program)
 		"\t--wlcores          : list of lcore ids for workers\n"
 		"\t--stlist           : list of scheduled types of the stages\n"
 		"\t--nb_flows         : number of flows to produce\n"
+		"\t--flow_skew        : percentage of the produced events\n"
+		"\t                     sent on 1/8th of the flows\n"
 		"\t--nb_pkts          : number of packets to produce\n"
 		"\t--worker_deq_depth : dequeue depth of the worker\n"
 		"\t--fwd_latency      : perform fwd_latency measurement\n"
@@ -526,6 +542,7 @@ evt_parse_sched_type_list(struct evt_options *opt, const char *arg)
 
 static struct option lgopts[] = {
 	{ EVT_NB_FLOWS,            1, 0, 0 },
+	{ EVT_FLOW_SKEW,           1, 0, 0 },
 	{ EVT_DEVICE,              1, 0, 0 },
 	{ EVT_VERBOSE,             1, 0, 0 },
 	{ EVT_TEST,                1, 0, 0 },
@@ -574,6 +591,7 @@ evt_opts_parse_long(int opt_idx, struct evt_options *opt)
 
 	struct long_opt_parser parsermap[] = {
 		{ EVT_NB_FLOWS, evt_parse_nb_flows},
+		{ EVT_FLOW_SKEW, evt_parse_flow_skew},
 		{ EVT_DEVICE, evt_parse_dev_id},
 		{ EVT_VERBOSE, evt_parse_verbose},
 		{ EVT_TEST, evt_parse_test_name},
@@ -667,5 +685,6 @@ evt_options_dump(struct evt_options *opt)
 		printf("%d ", lcore_id);
 	evt_dump_end;
 	evt_dump_nb_flows(opt);
+	evt_dump_flow_skew(opt);
 	evt_dump_worker_dequeue_depth(opt);
 }
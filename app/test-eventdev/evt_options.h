@@ -24,6 +24,7 @@
 #define EVT_PROD_LCORES          ("plcores")
 #define EVT_WORK_LCORES          ("wlcores")
 #define EVT_NB_FLOWS             ("nb_flows")
+#define EVT_FLOW_SKEW            ("flow_skew")
 #define EVT_SOCKET_ID            ("socket_id")
 #define EVT_POOL_SZ              ("pool_sz")
 #define EVT_WKR_DEQ_DEP          ("worker_deq_depth")
@@ -197,6 +198,13 @@ evt_dump_nb_flows(struct evt_options *opt)
 	evt_dump("nb_flows", "%d", opt->nb_flows);
 }
 
+static inline void
+evt_dump_flow_skew(struct evt_options *opt)
+{
+	if (opt->flow_skew)
+		evt_dump("flow_skew", "%d%%", opt->flow_skew);
+}
+
 static inline void
 evt_dump_worker_dequeue_depth(struct evt_options *opt)
 {
@@ -116,6 +116,22 @@ perf_test_result(struct evt_test *test, struct evt_options *opt)
 	return t->result;
 }
 
+/* With flow_skew set, that percentage of the events is produced on the
+ * first eighth of the flows, to exercise the load balancing of the
+ * event device.
+ */
+static inline uint32_t
+perf_next_flow_id(uint32_t *flow_counter, const uint32_t nb_flows,
+		  const uint8_t flow_skew)
+{
+	const uint32_t counter = (*flow_counter)++;
+
+	if (flow_skew && counter % 100 < flow_skew)
+		return counter % RTE_MAX(nb_flows / 8, 1U);
+
+	return counter % nb_flows;
+}
+
 static inline int
 perf_producer(void *arg)
 {
@@ -128,6 +144,7 @@ perf_producer(void *arg)
 	struct rte_mempool *pool = t->pool;
 	const uint64_t nb_pkts = t->nb_pkts;
 	const uint32_t nb_flows = t->nb_flows;
+	const uint8_t flow_skew = opt->flow_skew;
 	uint32_t flow_counter = 0;
 	uint64_t count = 0;
 	struct perf_elt *m[BURST_SIZE + 1] = {NULL};
@@ -151,7 +168,8 @@ perf_producer(void *arg)
 		if (rte_mempool_get_bulk(pool, (void **)m, BURST_SIZE) < 0)
 			continue;
 		for (i = 0; i < BURST_SIZE; i++) {
-			ev.flow_id = flow_counter++ % nb_flows;
+			ev.flow_id = perf_next_flow_id(&flow_counter, nb_flows,
+							 flow_skew);
 			ev.event_ptr = m[i];
 			if (enable_fwd_latency)
 				m[i]->timestamp = rte_get_timer_cycles();
@@ -184,6 +202,7 @@ perf_producer_burst(void *arg)
 	struct rte_mempool *pool = t->pool;
 	const uint64_t nb_pkts = t->nb_pkts;
 	const uint32_t nb_flows = t->nb_flows;
+	const uint8_t flow_skew = opt->flow_skew;
 	uint32_t flow_counter = 0;
 	uint16_t enq = 0;
 	uint64_t count = 0;
@@ -212,7 +231,8 @@ perf_producer_burst(void *arg)
 			continue;
 		timestamp = rte_get_timer_cycles();
 		for (i = 0; i < burst_size; i++) {
-			ev[i].flow_id = flow_counter++ % nb_flows;
+			ev[i].flow_id = perf_next_flow_id(&flow_counter,
+							    nb_flows, flow_skew);
 			ev[i].event_ptr = m[i];
 			if (enable_fwd_latency)
 				m[i]->timestamp = timestamp;
@@ -869,6 +889,29 @@ total_latency(struct test_perf *t)
 	return total;
 }
 
+/* Ratio between the busiest worker's and the average worker's
+ * throughput since the last call, 1.0 meaning perfectly balanced.
+ */
+static float
+worker_imbalance(struct test_perf *t)
+{
+	static uint64_t last_pkts[EVT_MAX_PORTS];
+	uint64_t total = 0;
+	uint64_t max = 0;
+	uint8_t i;
+
+	for (i = 0; i < t->nb_workers; i++) {
+		const uint64_t pkts = t->worker[i].processed_pkts;
+		const uint64_t delta = pkts - last_pkts[i];
+
+		last_pkts[i] = pkts;
+		total += delta;
+		max = RTE_MAX(max, delta);
+	}
+
+	return total > 0 ? (float)max * t->nb_workers / total : 0;
+}
+
 
 int
 perf_launch_lcores(struct evt_test *test, struct evt_options *opt,
@@ -944,6 +987,12 @@ perf_launch_lcores(struct evt_test *test, struct evt_options *opt,
 				printf(CLGRN"\r%.3f mpps avg %.3f mpps"CLNRM,
 					mpps, total_mpps/samples);
 			}
+			/* Keep one line per sample, to show how fast the
+			 * device balances the skewed flows.
+			 */
+			if (opt->flow_skew)
+				printf(CLGRN" [worker imbalance %.2f]\n"CLNRM,
+					worker_imbalance(t));
 			fflush(stdout);
 
 			if (remaining <= 0) {
@@ -28,6 +28,7 @@ test_bpf(void)
 #else
 
 #include <rte_bpf.h>
+#include <rte_bpf_map.h>
 #include <rte_ether.h>
 #include <rte_ip.h>
 
@@ -3201,10 +3202,15 @@ static int
 run_test(const struct bpf_test *tst)
 {
 	int32_t ret, rv;
+	uint32_t i, n;
 	int64_t rc;
 	struct rte_bpf *bpf;
 	struct rte_bpf_jit jit;
+	struct rte_bpf_jit_burst jit_burst;
 	uint8_t tbuf[tst->arg_sz];
+	uint8_t bbuf[2][tst->arg_sz];
+	void *ctx[RTE_DIM(bbuf)];
+	uint64_t brc[RTE_DIM(bbuf)];
 
 	printf("%s(%s) start\n", __func__, tst->name);
 
@@ -3239,11 +3245,525 @@ run_test(const struct bpf_test *tst)
 		}
 	}
 
+	/* and with burst jit, when possible */
+	rte_bpf_get_jit_burst(bpf, &jit_burst);
+	if (jit_burst.func != NULL) {
+
+		for (i = 0; i != RTE_DIM(bbuf); i++) {
+			tst->prepare(bbuf[i]);
+			ctx[i] = bbuf[i];
+		}
+
+		n = jit_burst.func(ctx, brc, RTE_DIM(bbuf));
+		if (n != RTE_DIM(bbuf)) {
+			printf("%s@%d: burst jit(%s) processed %u of %zu;\n",
+				__func__, __LINE__, tst->name, n,
+				RTE_DIM(bbuf));
+			ret |= -1;
+		}
+
+		for (i = 0; i != n; i++) {
+			rv = tst->check_result(brc[i], bbuf[i]);
+			ret |= rv;
+			if (rv != 0) {
+				printf("%s@%d: check_result(%s) failed, "
+					"error: %d(%s);\n",
+					__func__, __LINE__, tst->name,
+					rv, strerror(rv));
+			}
+		}
+	}
+
 	rte_bpf_destroy(bpf);
 	return ret;
 
 }
 
+/*
+ * eBPF map tests: count inputs per key in the map,
+ * with the interpreter, jit and burst jit.
+ */
+
+#define TEST_MAP_ENTRIES	16
+#define TEST_MAP_KEYS		20
+#define TEST_MAP_NAME		"test_map"
+
+/* index of the lookup result check in test_map_array_prog */
+#define TEST_MAP_ARRAY_NULL_CHECK	7
+
+enum {
+	TEST_MAP_XSYM_MAP,
+	TEST_MAP_XSYM_LOOKUP,
+	TEST_MAP_XSYM_UPDATE,
+	TEST_MAP_XSYM_NUM,
+};
+
+/*
+ * uint32_t key = *(uint32_t *)arg;
+ * uint64_t *v = lookup(map, &key);
+ * if (v == NULL)
+ *	return 0;
+ * return __atomic_add_fetch(v, 1);
+ */
+static const struct ebpf_insn test_map_array_prog[] = {
+	{
+		.code = (BPF_LDX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_1,
+	},
+	{
+		.code = (BPF_STX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_10,
+		.src_reg = EBPF_REG_2,
+		.off = -(int16_t)sizeof(uint32_t),
+	},
+	{
+		.code = (BPF_LD | BPF_IMM | EBPF_DW),
+		.dst_reg = EBPF_REG_1,
+	},
+	{
+		.imm = 0,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_10,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.imm = -(int32_t)sizeof(uint32_t),
+	},
+	{
+		.code = (BPF_JMP | EBPF_CALL),
+		.imm = TEST_MAP_XSYM_LOOKUP,
+	},
+	{
+		.code = (BPF_JMP | BPF_JEQ | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.off = 4,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_1,
+		.imm = 1,
+	},
+	{
+		.code = (BPF_STX | EBPF_XADD | EBPF_DW),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_1,
+	},
+	{
+		.code = (BPF_LDX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_0,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 0,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+/*
+ * uint64_t key = *(uint64_t *)arg;
+ * uint64_t *v = lookup(map, &key);
+ * if (v != NULL)
+ *	return __atomic_add_fetch(v, 1);
+ * uint64_t one = 1;
+ * update(map, &key, &one, RTE_BPF_MAP_ANY);
+ * return 1;
+ */
+static const struct ebpf_insn test_map_hash_prog[] = {
+	{
+		.code = (BPF_LDX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_1,
+	},
+	{
+		.code = (BPF_STX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_10,
+		.src_reg = EBPF_REG_2,
+		.off = -(int16_t)sizeof(uint64_t),
+	},
+	{
+		.code = (BPF_LD | BPF_IMM | EBPF_DW),
+		.dst_reg = EBPF_REG_1,
+	},
+	{
+		.imm = 0,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_10,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.imm = -(int32_t)sizeof(uint64_t),
+	},
+	{
+		.code = (BPF_JMP | EBPF_CALL),
+		.imm = TEST_MAP_XSYM_LOOKUP,
+	},
+	{
+		.code = (BPF_JMP | EBPF_JNE | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.off = 11,
+	},
+	{
+		.code = (BPF_ST | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_10,
+		.off = -2 * (int16_t)sizeof(uint64_t),
+		.imm = 1,
+	},
+	{
+		.code = (BPF_LD | BPF_IMM | EBPF_DW),
+		.dst_reg = EBPF_REG_1,
+	},
+	{
+		.imm = 0,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_10,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.imm = -(int32_t)sizeof(uint64_t),
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_3,
+		.src_reg = EBPF_REG_10,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_3,
+		.imm = -2 * (int32_t)sizeof(uint64_t),
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_4,
+		.imm = RTE_BPF_MAP_ANY,
+	},
+	{
+		.code = (BPF_JMP | EBPF_CALL),
+		.imm = TEST_MAP_XSYM_UPDATE,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 1,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_1,
+		.imm = 1,
+	},
+	{
+		.code = (BPF_STX | EBPF_XADD | EBPF_DW),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_1,
+	},
+	{
+		.code = (BPF_LDX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_0,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+/* run the program over all keys with each available flavour */
+static int
+test_map_exec(const struct rte_bpf *bpf, uint32_t *nb_runs)
+{
+	uint32_t i, n;
+	uint64_t key[TEST_MAP_KEYS];
+	uint64_t rc[TEST_MAP_KEYS];
+	void *ctx[TEST_MAP_KEYS];
+	struct rte_bpf_jit jit;
+	struct rte_bpf_jit_burst jit_burst;
+
+	for (i = 0; i != RTE_DIM(key); i++) {
+		key[i] = i;
+		ctx[i] = key + i;
+	}
+
+	n = 1;
+	rte_bpf_exec_burst(bpf, ctx, rc, RTE_DIM(ctx));
+
+	rte_bpf_get_jit(bpf, &jit);
+	if (jit.func != NULL) {
+		for (i = 0; i != RTE_DIM(ctx); i++)
+			rc[i] = jit.func(ctx[i]);
+		n++;
+	}
+
+	rte_bpf_get_jit_burst(bpf, &jit_burst);
+	if (jit_burst.func != NULL) {
+		if (jit_burst.func(ctx, rc, RTE_DIM(ctx)) != RTE_DIM(ctx))
+			return -1;
+		n++;
+	}
+
+	*nb_runs = n;
+	return 0;
+}
+
+static int
+test_map_run(enum rte_bpf_map_type type, const struct ebpf_insn *prog,
+	uint32_t nb_ins, uint32_t key_size)
+{
+	int32_t ret;
+	uint32_t i, n;
+	uint64_t key, exp, *val;
+	struct rte_bpf *bpf;
+	struct rte_bpf_map *map;
+	struct ebpf_insn ins[nb_ins];
+	struct rte_bpf_xsym xsym[TEST_MAP_XSYM_NUM];
+	const struct rte_bpf_map_prm mprm = {
+		.name = TEST_MAP_NAME,
+		.type = type,
+		.key_size = key_size,
+		.value_size = sizeof(uint64_t),
+		.max_entries = TEST_MAP_ENTRIES,
+		.socket_id = SOCKET_ID_ANY,
+	};
+	const struct rte_bpf_prm prm = {
+		.ins = ins,
+		.nb_ins = nb_ins,
+		.xsym = xsym,
+		.nb_xsym = RTE_DIM(xsym),
+		.prog_arg = {
+			.type = RTE_BPF_ARG_PTR,
+			.size = sizeof(uint64_t),
+		},
+	};
+
+	map = rte_bpf_map_create(&mprm);
+	if (map == NULL) {
+		printf("%s@%d: failed to create map, error=%d(%s);\n",
+			__func__, __LINE__, rte_errno, strerror(rte_errno));
+		return -1;
+	}
+
+	memset(xsym, 0, sizeof(xsym));
+	xsym[TEST_MAP_XSYM_MAP].name = TEST_MAP_NAME;
+	xsym[TEST_MAP_XSYM_MAP].type = RTE_BPF_XTYPE_MAP;
+	xsym[TEST_MAP_XSYM_MAP].map.val = map;
+	xsym[TEST_MAP_XSYM_LOOKUP].name = RTE_STR(rte_bpf_map_lookup_elem);
+	xsym[TEST_MAP_XSYM_LOOKUP].type = RTE_BPF_XTYPE_FUNC;
+	xsym[TEST_MAP_XSYM_LOOKUP].func.val = (void *)rte_bpf_map_lookup_elem;
+	xsym[TEST_MAP_XSYM_UPDATE].name = RTE_STR(rte_bpf_map_update_elem);
+	xsym[TEST_MAP_XSYM_UPDATE].type = RTE_BPF_XTYPE_FUNC;
+	xsym[TEST_MAP_XSYM_UPDATE].func.val = (void *)rte_bpf_map_update_elem;
+
+	/* patch map handle into 64-bit immediate loads */
+	memcpy(ins, prog, sizeof(ins));
+	for (i = 0; i != nb_ins; i++) {
+		if (ins[i].code == (BPF_LD | BPF_IMM | EBPF_DW)) {
+			ins[i].imm = (uintptr_t)map;
+			ins[i + 1].imm = (uint64_t)(uintptr_t)map >> 32;
+			i++;
+		}
+	}
+
+	ret = -1;
+	bpf = rte_bpf_load(&prm);
+	if (bpf == NULL) {
+		printf("%s@%d: failed to load bpf code, error=%d(%s);\n",
+			__func__, __LINE__, rte_errno, strerror(rte_errno));
+		goto out;
+	}
+
+	if (test_map_exec(bpf, &n) != 0)
+		goto out;
+
+	/*
+	 * keys beyond max entries are out of array bounds,
+	 * while the hash may have some room left for them.
+	 */
+	ret = 0;
+	for (key = 0; key != TEST_MAP_KEYS; key++) {
+		if (key >= TEST_MAP_ENTRIES && type == RTE_BPF_MAP_TYPE_HASH)
+			break;
+		val = rte_bpf_map_lookup_elem(map, &key);
+		exp = (key < TEST_MAP_ENTRIES) ? n : 0;
+		if ((val != NULL ? *val : 0) != exp) {
+			printf("%s@%d: map type %d, key %" PRIu64
+				": expected %" PRIu64 ", got %" PRIu64 ";\n",
+				__func__, __LINE__, type, key, exp,
+				val != NULL ? *val : 0);
+			ret = -1;
+		}
+	}
+
+	/* value has to be checked against NULL before access */
+	rte_bpf_destroy(bpf);
+	bpf = NULL;
+	if (type == RTE_BPF_MAP_TYPE_ARRAY) {
+		ins[TEST_MAP_ARRAY_NULL_CHECK].imm = 1;
+		bpf = rte_bpf_load(&prm);
+		if (bpf != NULL) {
+			printf("%s@%d: unchecked map value accepted;\n",
+				__func__, __LINE__);
+			ret = -1;
+		}
+	}
+
+out:
+	rte_bpf_destroy(bpf);
+	rte_bpf_map_free(map);
+	return ret;
+}
+
+/* check hash map update flags and deleted elements reclaim with QSBR */
+static int
+test_map_hash_rcu(void)
+{
+	int32_t rc, ret;
+	uint64_t key, v, *val;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_bpf_map *map;
+	struct rte_bpf_map_prm lprm;
+	const struct rte_bpf_map_prm mprm = {
+		.name = TEST_MAP_NAME,
+		.type = RTE_BPF_MAP_TYPE_HASH,
+		.key_size = sizeof(uint64_t),
+		.value_size = sizeof(uint64_t),
+		.max_entries = TEST_MAP_ENTRIES,
+		.socket_id = SOCKET_ID_ANY,
+	};
+
+	/* a hash map name isn't truncated, it would not be unique anymore */
+	lprm = mprm;
+	lprm.name = TEST_MAP_NAME "_with_a_too_long_name";
+	map = rte_bpf_map_create(&lprm);
+	if (map != NULL || rte_errno != ENAMETOOLONG) {
+		printf("%s@%d: hash map with a too long name created;\n",
+			__func__, __LINE__);
+		rte_bpf_map_free(map);
+		return -1;
+	}
+
+	qsv = rte_zmalloc(NULL, rte_rcu_qsbr_get_memsize(1),
+		RTE_CACHE_LINE_SIZE);
+	map = rte_bpf_map_create(&mprm);
+	if (qsv == NULL || map == NULL) {
+		printf("%s@%d: failed to create map, error=%d(%s);\n",
+			__func__, __LINE__, rte_errno, strerror(rte_errno));
+		rte_bpf_map_free(map);
+		rte_free(qsv);
+		return -1;
+	}
+
+	/* reader thread 0 holds on the elements it looks up */
+	rte_rcu_qsbr_init(qsv, 1);
+	rte_rcu_qsbr_thread_register(qsv, 0);
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	ret = -1;
+	rc = rte_bpf_map_rcu_qsbr_add(map, qsv);
+	if (rc != 0 || rte_bpf_map_rcu_qsbr_add(map, qsv) != -EEXIST) {
+		printf("%s@%d: failed to add QSBR variable, error=%d;\n",
+			__func__, __LINE__, rc);
+		goto out;
+	}
+
+	for (key = 0; key != TEST_MAP_ENTRIES; key++) {
+		v = key + TEST_MAP_KEYS;
+		rc = rte_bpf_map_update_elem(map, &key, &v,
+			RTE_BPF_MAP_NOEXIST);
+		if (rc != 0) {
+			printf("%s@%d: key %" PRIu64 ": update error=%d;\n",
+				__func__, __LINE__, key, rc);
+			goto out;
+		}
+	}
+
+	/* existing element is left unchanged */
+	key = 0;
+	v = 0;
+	rc = rte_bpf_map_update_elem(map, &key, &v, RTE_BPF_MAP_NOEXIST);
+	val = rte_bpf_map_lookup_elem(map, &key);
+	if (rc != -EEXIST || val == NULL || *val != TEST_MAP_KEYS) {
+		printf("%s@%d: NOEXIST update of existing key, error=%d;\n",
+			__func__, __LINE__, rc);
+		goto out;
+	}
+	key = TEST_MAP_ENTRIES;
+	rc = rte_bpf_map_update_elem(map, &key, &v, RTE_BPF_MAP_EXIST);
+	if (rc != -ENOENT) {
+		printf("%s@%d: EXIST update of missing key, error=%d;\n",
+			__func__, __LINE__, rc);
+		goto out;
+	}
+
+	/* deleted element isn't reused until the reader is quiescent */
+	key = 0;
+	if (rte_bpf_map_delete_elem(map, &key) != 0 ||
+			rte_bpf_map_lookup_elem(map, &key) != NULL ||
+			rte_bpf_map_delete_elem(map, &key) != -ENOENT) {
+		printf("%s@%d: failed to delete key;\n", __func__, __LINE__);
+		goto out;
+	}
+	key = TEST_MAP_ENTRIES;
+	v = key + TEST_MAP_KEYS;
+	rc = rte_bpf_map_update_elem(map, &key, &v, RTE_BPF_MAP_ANY);
+	if (rc != -ENOSPC || *val != TEST_MAP_KEYS) {
+		printf("%s@%d: deleted element reused, error=%d;\n",
+			__func__, __LINE__, rc);
+		goto out;
+	}
+
+	rte_rcu_qsbr_quiescent(qsv, 0);
+	rc = rte_bpf_map_update_elem(map, &key, &v, RTE_BPF_MAP_ANY);
+	val = rte_bpf_map_lookup_elem(map, &key);
+	if (rc != 0 || val == NULL || *val != v) {
+		printf("%s@%d: deleted element not reclaimed, error=%d;\n",
+			__func__, __LINE__, rc);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	rte_bpf_map_free(map);
+	rte_free(qsv);
+	return ret;
+}
+
+static int
+test_bpf_map(void)
+{
+	int32_t rc;
+
+	rc = test_map_run(RTE_BPF_MAP_TYPE_ARRAY, test_map_array_prog,
+		RTE_DIM(test_map_array_prog), sizeof(uint32_t));
+	rc |= test_map_run(RTE_BPF_MAP_TYPE_PERCPU_ARRAY, test_map_array_prog,
+		RTE_DIM(test_map_array_prog), sizeof(uint32_t));
+	rc |= test_map_run(RTE_BPF_MAP_TYPE_HASH, test_map_hash_prog,
+		RTE_DIM(test_map_hash_prog), sizeof(uint64_t));
+	rc |= test_map_hash_rcu();
+
+	return rc;
+}
+
 static int
 test_bpf(void)
 {
@@ -3257,6 +3777,7 @@ test_bpf(void)
 			rc |= rv;
 	}
 
+	rc |= test_bpf_map();
 	return rc;
 }
 
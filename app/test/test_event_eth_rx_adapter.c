@@ -665,6 +665,18 @@ adapter_queue_add_del(void)
 						-1, &queue_config);
 	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
 
+	if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)) {
+		/* Rx interrupts are not enabled for the ethdev */
+		queue_config.rx_queue_flags |=
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_INTR_FALLBACK;
+		err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID,
+							TEST_ETHDEV_ID, -1,
+							&queue_config);
+		TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+		queue_config.rx_queue_flags &=
+			~RTE_EVENT_ETH_RX_ADAPTER_QUEUE_INTR_FALLBACK;
+	}
+
 	if (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_MULTI_EVENTQ) {
 		err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID,
 							TEST_ETHDEV_ID, 0,
@@ -883,6 +895,78 @@ adapter_intr_queue_add_del(void)
 	return TEST_SUCCESS;
 }
 
+static int
+adapter_intr_fallback_queue_add_del(void)
+{
+	int err;
+	struct rte_event ev;
+	uint32_t cap;
+	uint16_t eth_port;
+	struct rte_event_eth_rx_adapter_queue_conf queue_config = {0};
+
+	if (!default_params.rx_intr_port_inited)
+		return 0;
+
+	eth_port = default_params.rx_intr_port;
+	err = rte_event_eth_rx_adapter_caps_get(TEST_DEV_ID, eth_port, &cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	ev.queue_id = 0;
+	ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	ev.priority = 0;
+
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_INTR_FALLBACK;
+	queue_config.ev = ev;
+	queue_config.servicing_weight = 1;
+
+	/* poll mode with interrupt fallback */
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID,
+						TEST_ETHDEV_ID,
+						-1,
+						&queue_config);
+	if (err == -ENOTSUP)
+		return TEST_SKIPPED;
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* interrupt fallback -> intr mode queue */
+	queue_config.rx_queue_flags = 0;
+	queue_config.servicing_weight = 0;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID,
+						TEST_ETHDEV_ID,
+						-1,
+						&queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* intr mode -> interrupt fallback queue */
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_INTR_FALLBACK;
+	queue_config.servicing_weight = 1;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID,
+						TEST_ETHDEV_ID,
+						-1,
+						&queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	if (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_MULTI_EVENTQ) {
+		/* interrupt fallback -> plain poll mode queue 0 */
+		queue_config.rx_queue_flags = 0;
+		err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID,
+							TEST_ETHDEV_ID,
+							0,
+							&queue_config);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	}
+
+	/* del queues */
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID,
+						TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return TEST_SUCCESS;
+}
+
 static int
 adapter_start_stop(void)
 {
@@ -1348,6 +1432,8 @@ static struct unit_test_suite event_eth_rx_intr_tests = {
 	.unit_test_cases = {
 		TEST_CASE_ST(adapter_create, adapter_free,
 			     adapter_intr_queue_add_del),
+		TEST_CASE_ST(adapter_create, adapter_free,
+			     adapter_intr_fallback_queue_add_del),
 		TEST_CASE_ST(adapter_create, adapter_free,
 			     adapter_intrq_instance_get),
 		TEST_CASES_END() /**< NULL terminate unit test array */
@@ -28,6 +28,7 @@ test_event_timer_adapter_func(void)
 #include <rte_mempool.h>
 #include <rte_launch.h>
 #include <rte_lcore.h>
+#include <rte_malloc.h>
 #include <rte_per_lcore.h>
 #include <rte_random.h>
 #include <rte_bus_vdev.h>
@@ -375,6 +376,19 @@ timdev_setup_usec_multicore(void)
 		_timdev_setup(1E5, 1E3, flags);
 }
 
+static int
+timdev_setup_usec_wheel(void)
+{
+	uint64_t flags = RTE_EVENT_TIMER_ADAPTER_F_ADJUST_RES |
+			 RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL;
+
+	return using_services ?
+		/* Max timeout is 10,000us and bucket interval is 100us */
+		_timdev_setup(1E7, 1E5, flags) :
+		/* Max timeout is 100us and bucket interval is 1us */
+		_timdev_setup(1E5, 1E3, flags);
+}
+
 static int
 timdev_setup_msec(void)
 {
@@ -405,6 +419,38 @@ timdev_setup_msec_periodic(void)
 	return _timdev_setup(max_tmo_ns, NSECPERSEC / 10, flags);
 }
 
+static int
+timdev_setup_msec_wheel(void)
+{
+	uint64_t flags = RTE_EVENT_TIMER_ADAPTER_F_ADJUST_RES |
+			 RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL;
+
+	/* Max timeout is 3 mins, and bucket interval is 100 ms */
+	return _timdev_setup(180 * NSECPERSEC, NSECPERSEC / 10, flags);
+}
+
+static int
+timdev_setup_msec_periodic_wheel(void)
+{
+	uint32_t caps = 0;
+	uint64_t max_tmo_ns;
+
+	uint64_t flags = RTE_EVENT_TIMER_ADAPTER_F_ADJUST_RES |
+			 RTE_EVENT_TIMER_ADAPTER_F_PERIODIC |
+			 RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL;
+
+	TEST_ASSERT_SUCCESS(rte_event_timer_adapter_caps_get(evdev, &caps),
+				"failed to get adapter capabilities");
+
+	if (caps & RTE_EVENT_TIMER_ADAPTER_CAP_INTERNAL_PORT)
+		max_tmo_ns = 0;
+	else
+		max_tmo_ns = 180 * NSECPERSEC;
+
+	/* Periodic mode with 100 ms resolution */
+	return _timdev_setup(max_tmo_ns, NSECPERSEC / 10, flags);
+}
+
 static int
 timdev_setup_sec(void)
 {
@@ -414,6 +460,16 @@ timdev_setup_sec(void)
 	return _timdev_setup(1E11, 1E9, flags);
 }
 
+static int
+timdev_setup_sec_wheel(void)
+{
+	uint64_t flags = RTE_EVENT_TIMER_ADAPTER_F_ADJUST_RES |
+			 RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL;
+
+	/* Max timeout is 100sec and bucket interval is 1sec */
+	return _timdev_setup(1E11, 1E9, flags);
+}
+
 static int
 timdev_setup_sec_periodic(void)
 {
@@ -1087,6 +1143,92 @@ test_timer_cancel_random(void)
 	return TEST_SUCCESS;
 }
 
+/* Arm a burst of timers, retrying while the service frees timer resources */
+static inline int
+_arm_burst_retry(struct rte_event_timer **ev_tim, uint16_t nb_timers)
+{
+	uint64_t max_wait = rte_get_timer_hz();
+	uint64_t wait_start = rte_get_timer_cycles();
+	uint16_t n = 0;
+
+	while (n < nb_timers) {
+		n += rte_event_timer_arm_burst(timdev, &ev_tim[n],
+					       nb_timers - n);
+		if (n < nb_timers && (rte_errno != ENOSPC ||
+		    rte_get_timer_cycles() - wait_start > max_wait))
+			return -1;
+	}
+
+	return 0;
+}
+
+/* Check that cancelled timers don't keep the adapter from arming as many
+ * timers as it was configured for.
+ */
+static inline int
+test_timer_cancel_rearm(void)
+{
+	struct rte_event_timer_adapter_info info;
+	struct rte_event_timer **ev_tim;
+	struct rte_event_timer *tims;
+	uint32_t nb_timers, i, j, n;
+	const struct rte_event_timer tim = {
+		.ev.op = RTE_EVENT_OP_NEW,
+		.ev.queue_id = 0,
+		.ev.sched_type = RTE_SCHED_TYPE_ATOMIC,
+		.ev.priority = RTE_EVENT_DEV_PRIORITY_NORMAL,
+		.ev.event_type =  RTE_EVENT_TYPE_TIMER,
+		.state = RTE_EVENT_TIMER_NOT_ARMED,
+		.timeout_ticks = CALC_TICKS(100),
+	};
+
+	TEST_ASSERT_SUCCESS(rte_event_timer_adapter_get_info(timdev, &info),
+			"Failed to get adapter info");
+	nb_timers = info.conf.nb_timers;
+
+	tims = rte_malloc(NULL, nb_timers * sizeof(*tims), 0);
+	ev_tim = rte_malloc(NULL, nb_timers * sizeof(*ev_tim), 0);
+	TEST_ASSERT(tims != NULL && ev_tim != NULL,
+			"Failed to allocate event timers");
+
+	for (i = 0; i < nb_timers; i++) {
+		tims[i] = tim;
+		tims[i].ev.event_ptr = &tims[i];
+		ev_tim[i] = &tims[i];
+	}
+
+	for (i = 0; i < nb_timers; i += n) {
+		n = RTE_MIN(nb_timers - i, (uint32_t)BATCH_SIZE);
+		TEST_ASSERT_SUCCESS(_arm_burst_retry(&ev_tim[i], n),
+				"Failed to arm timer %d", rte_errno);
+	}
+
+	for (j = 0; j < 10; j++) {
+		for (i = 0; i < nb_timers; i += n) {
+			n = RTE_MIN(nb_timers - i, (uint32_t)BATCH_SIZE);
+			TEST_ASSERT_EQUAL(rte_event_timer_cancel_burst(timdev,
+						&ev_tim[i], n), n,
+					"Failed to cancel event timer %d",
+					rte_errno);
+			TEST_ASSERT_SUCCESS(_arm_burst_retry(&ev_tim[i], n),
+					"Failed to re-arm timer %d in round %u",
+					rte_errno, j);
+		}
+	}
+
+	for (i = 0; i < nb_timers; i += n) {
+		n = RTE_MIN(nb_timers - i, (uint32_t)BATCH_SIZE);
+		TEST_ASSERT_EQUAL(rte_event_timer_cancel_burst(timdev,
+					&ev_tim[i], n), n,
+				"Failed to cancel event timer %d", rte_errno);
+	}
+
+	rte_free(ev_tim);
+	rte_free(tims);
+
+	return TEST_SUCCESS;
+}
+
 /* Check that the adapter can be created correctly */
 static int
 adapter_create(void)
@@ -2024,6 +2166,28 @@ static struct unit_test_suite event_timer_adptr_functional_testsuite  = {
 		TEST_CASE(adapter_create_max),
 		TEST_CASE_ST(timdev_setup_msec, timdev_teardown,
 				test_timer_ticks_remaining),
+		TEST_CASE_ST(timdev_setup_usec_wheel, timdev_teardown,
+				test_timer_arm),
+		TEST_CASE_ST(timdev_setup_usec_wheel, timdev_teardown,
+				test_timer_arm_burst),
+		TEST_CASE_ST(timdev_setup_msec_periodic_wheel, timdev_teardown,
+				test_timer_arm_periodic),
+		TEST_CASE_ST(timdev_setup_msec_periodic_wheel, timdev_teardown,
+				test_timer_arm_burst_periodic),
+		TEST_CASE_ST(timdev_setup_sec_wheel, timdev_teardown,
+				test_timer_cancel),
+		TEST_CASE_ST(timdev_setup_sec_wheel, timdev_teardown,
+				test_timer_cancel_random),
+		TEST_CASE_ST(timdev_setup_msec_wheel, timdev_teardown,
+				event_timer_arm_expiry),
+		TEST_CASE_ST(timdev_setup_msec_wheel, timdev_teardown,
+				event_timer_arm_invalid_timeout),
+		TEST_CASE_ST(timdev_setup_msec_wheel, timdev_teardown,
+				event_timer_cancel_double),
+		TEST_CASE_ST(timdev_setup_msec_wheel, timdev_teardown,
+				test_timer_cancel_rearm),
+		TEST_CASE_ST(timdev_setup_msec_wheel, timdev_teardown,
+				test_timer_ticks_remaining),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -867,6 +867,7 @@ static int
 graph_cluster_stats_cb_t(bool is_first, bool is_last, void *cookie,
 			 const struct rte_graph_cluster_node_stats *st)
 {
+	uint64_t objs_samples = 0, cycles_samples = 0;
 	int i;
 
 	RTE_SET_USED(is_first);
@@ -891,6 +892,19 @@ graph_cluster_stats_cb_t(bool is_first, bool is_last, void *cookie,
 			}
 		}
 	}
+
+	for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++) {
+		objs_samples += st->objs_hist[i];
+		cycles_samples += st->cycles_hist[i];
+	}
+	if (objs_samples != st->calls / RTE_GRAPH_HIST_SAMPLE_INTERVAL ||
+	    cycles_samples != objs_samples) {
+		printf("Histogram samples miss match for node = %s expected = %"PRId64", got = %"PRId64"/%"PRId64"\n",
+		       st->name, st->calls / RTE_GRAPH_HIST_SAMPLE_INTERVAL,
+		       objs_samples, cycles_samples);
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -2,22 +2,42 @@
  * Copyright(c) 2018 Intel Corporation
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
 
+#include <rte_cycles.h>
 #include <rte_ethdev.h>
 #include <rte_latencystats.h>
+#include <rte_mbuf_dyn.h>
 #include "rte_lcore.h"
 #include "rte_metrics.h"
 
+#include "latencystats_hist.h"
 #include "sample_packet_forward.h"
 #include "test.h"
 
-#define NUM_STATS 4
+#define NUM_STATS 8
 #define LATENCY_NUM_PACKETS 10
 #define QUEUE_ID 0
 
+/*
+ * Known latencies: the first ones are below the median, the median is
+ * the second one and the 99th percentile and above are the last one.
+ */
+#define LATENCY_KNOWN_PACKETS 100
+static const struct {
+	uint64_t us;
+	unsigned int packets;
+} known_latencies[] = {
+	{ 1000, 40 },
+	{ 2000, 58 },
+	{ 10000, 2 },
+};
+/* Time taken by the test to transmit the packets */
+#define LATENCY_TX_US 100
+
 static uint16_t portid;
 static struct rte_ring *ring;
 
@@ -26,6 +46,10 @@ static struct rte_metric_name lat_stats_strings[] = {
 	{"avg_latency_ns"},
 	{"max_latency_ns"},
 	{"jitter_ns"},
+	{"p50_latency_ns"},
+	{"p99_latency_ns"},
+	{"p99_9_latency_ns"},
+	{"p99_99_latency_ns"},
 };
 
 /* Test case for latency init with metrics init */
@@ -120,6 +144,14 @@ static int test_latencystats_get(void)
 	TEST_ASSERT((ret == NUM_STATS), "Test Failed to get latency metrics"
 			" values");
 
+	/* Percentiles are ordered and bounded by the maximum */
+	for (i = 5; i < NUM_STATS; i++)
+		TEST_ASSERT(values[i - 1].value <= values[i].value,
+			    "Test Failed: %s above %s", lat_stats_strings[i - 1].name,
+			    lat_stats_strings[i].name);
+	TEST_ASSERT(values[NUM_STATS - 1].value <= values[2].value,
+		    "Test Failed: percentile above max latency");
+
 	/* Failure Test: Invalid values and valid size */
 	ret = rte_latencystats_get(NULL, size);
 	TEST_ASSERT((ret == NUM_STATS), "Test Failed to get the stats count,"
@@ -134,6 +166,147 @@ static int test_latencystats_get(void)
 	return TEST_SUCCESS;
 }
 
+/* Check that a value is a latency, up to the histogram resolution */
+static int
+latency_check(const char *name, uint64_t val, uint64_t latency,
+	      uint64_t slack)
+{
+	uint64_t high = (latency + slack) +
+		(latency + slack) / LATENCY_HIST_SUB;
+
+	if (val < latency || val > high) {
+		printf("%s is %"PRIu64", expected in [%"PRIu64", %"PRIu64"]\n",
+		       name, val, latency, high);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Test case to check the histogram buckets and percentiles */
+static int test_latency_hist(void)
+{
+	const double percentiles[] = { 0.5, 0.99, 0.999, 0.9999 };
+	const uint64_t expected[] = { 1, 2, 2, 2 };
+	uint64_t hist[LATENCY_HIST_BUCKETS] = { 0 };
+	uint64_t values[RTE_DIM(percentiles)];
+	uint64_t latency, count = 0;
+	unsigned int i, b, prev = 0;
+
+	/* Small latencies have their own bucket */
+	for (latency = 0; latency < LATENCY_HIST_SUB; latency++)
+		TEST_ASSERT(latency_hist_bucket(latency) == latency &&
+			    latency_hist_value(latency) == latency,
+			    "Test Failed: latency %"PRIu64" not exact", latency);
+
+	/* Larger ones are counted within the resolution */
+	for (latency = LATENCY_HIST_SUB; latency < (UINT64_C(1) << 40);
+	     latency += latency / 7 + 1) {
+		b = latency_hist_bucket(latency);
+		TEST_ASSERT(b >= prev && b < LATENCY_HIST_BUCKETS,
+			    "Test Failed: bucket %u of %"PRIu64" out of order",
+			    b, latency);
+		TEST_ASSERT_SUCCESS(latency_check("bucket value",
+				latency_hist_value(b), latency, 0),
+			"Test Failed: bucket of %"PRIu64" too coarse", latency);
+		prev = b;
+	}
+	TEST_ASSERT(latency_hist_bucket(UINT64_MAX) == LATENCY_HIST_BUCKETS - 1,
+		    "Test Failed: largest latency not in the last bucket");
+
+	/* No sample, no percentile */
+	latency_hist_percentiles(hist, percentiles, RTE_DIM(percentiles),
+				 values);
+	for (i = 0; i < RTE_DIM(percentiles); i++)
+		TEST_ASSERT(values[i] == 0,
+			    "Test Failed: percentile without samples");
+
+	/* The known latencies, in cycles, go in their own buckets */
+	for (i = 0; i < RTE_DIM(known_latencies); i++)
+		hist[latency_hist_bucket(known_latencies[i].us)] +=
+			known_latencies[i].packets;
+	for (b = 0; b < LATENCY_HIST_BUCKETS; b++)
+		count += hist[b];
+	TEST_ASSERT(count == LATENCY_KNOWN_PACKETS,
+		    "Test Failed: %"PRIu64" samples in the histogram", count);
+	for (i = 0; i < RTE_DIM(known_latencies); i++)
+		TEST_ASSERT(hist[latency_hist_bucket(known_latencies[i].us)] ==
+			    known_latencies[i].packets,
+			    "Test Failed: bucket of latency %"PRIu64" miscounted",
+			    known_latencies[i].us);
+
+	latency_hist_percentiles(hist, percentiles, RTE_DIM(percentiles),
+				 values);
+	for (i = 0; i < RTE_DIM(percentiles); i++)
+		TEST_ASSERT_SUCCESS(latency_check(lat_stats_strings[4 + i].name,
+				values[i], known_latencies[expected[i]].us, 0),
+			"Test Failed: wrong percentile");
+
+	return TEST_SUCCESS;
+}
+
+/* Test case to check the stats of packets sent with known latencies */
+static int test_latencystats_known(void)
+{
+	/* Indexes of the known latencies expected for the stats */
+	const unsigned int expected[NUM_STATS] = {
+		[0] = 0, [2] = 2, [4] = 1, [5] = 2, [6] = 2, [7] = 2,
+	};
+	struct rte_mbuf *pkts[LATENCY_KNOWN_PACKETS];
+	struct rte_metric_value values[NUM_STATS];
+	const uint64_t hz = rte_get_timer_hz();
+	struct rte_mempool *mp;
+	char poolname[] = "mbuf_pool_known";
+	uint64_t flag, now;
+	unsigned int i, j, n = 0;
+	int offset, ret;
+
+	ret = rte_mbuf_dyn_rx_timestamp_register(&offset, &flag);
+	TEST_ASSERT_SUCCESS(ret, "Test Failed: no timestamp field");
+	ret = test_get_mempool(&mp, poolname);
+	TEST_ASSERT_SUCCESS(ret, "Test Failed: mempool creation failed");
+	if (rte_pktmbuf_alloc_bulk(mp, pkts, LATENCY_KNOWN_PACKETS) != 0 ||
+	    test_dev_start(portid, mp) < 0) {
+		test_mp_free(mp);
+		TEST_ASSERT(0, "Test Failed: cannot start port %u", portid);
+	}
+
+	/* Packets timestamped on Rx as many microseconds ago */
+	now = rte_rdtsc();
+	for (i = 0; i < RTE_DIM(known_latencies); i++)
+		for (j = 0; j < known_latencies[i].packets; j++, n++) {
+			*RTE_MBUF_DYNFIELD(pkts[n], offset,
+					   rte_mbuf_timestamp_t *) =
+				now - known_latencies[i].us * hz / US_PER_S;
+			pkts[n]->ol_flags |= flag;
+		}
+
+	/* The ring port gives the packets sent back, in the same order */
+	n = rte_eth_tx_burst(portid, QUEUE_ID, pkts, LATENCY_KNOWN_PACKETS);
+	n = rte_eth_rx_burst(portid, QUEUE_ID, pkts, n);
+	rte_eth_dev_stop(portid);
+	rte_pktmbuf_free_bulk(pkts, LATENCY_KNOWN_PACKETS);
+	test_mp_free(mp);
+	TEST_ASSERT(n == LATENCY_KNOWN_PACKETS,
+		    "Test Failed: %u packets forwarded", n);
+
+	ret = rte_latencystats_get(values, NUM_STATS);
+	TEST_ASSERT((ret == NUM_STATS), "Test Failed to get latency metrics"
+			" values");
+	for (i = 0; i < NUM_STATS; i++) {
+		/* The average and jitter depend on the Tx time */
+		if (i == 1 || i == 3)
+			continue;
+		TEST_ASSERT_SUCCESS(latency_check(lat_stats_strings[i].name,
+				values[i].value,
+				known_latencies[expected[i]].us * 1000,
+				LATENCY_TX_US * 1000),
+			"Test Failed: wrong %s", lat_stats_strings[i].name);
+	}
+
+	return TEST_SUCCESS;
+}
+
 static int test_latency_ring_setup(void)
 {
 	test_ring_setup(&ring, &portid);
@@ -204,7 +377,13 @@ unit_test_suite latencystats_testsuite = {
 		 */
 		TEST_CASE_ST(NULL, NULL, test_latencystats_get),
 
-		/* Test Case 5: To check uninit of latency test */
+		/* Test Case 5: To check the histogram of latencies */
+		TEST_CASE_ST(NULL, NULL, test_latency_hist),
+
+		/* Test Case 6: To check the stats of known latencies */
+		TEST_CASE_ST(NULL, NULL, test_latencystats_known),
+
+		/* Test Case 7: To check uninit of latency test */
 		TEST_CASE_ST(NULL, NULL, test_latency_uninit),
 
 		TEST_CASES_END()
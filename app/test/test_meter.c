@@ -253,6 +253,274 @@ tm_test_srtcm_color_blind_check(void)
 
 }
 
+#define TM_TEST_BURST_SIZE 20
+#define TM_TEST_BURST_N_METERS 3
+
+/* Meters used several times by a burst, some hit by consecutive packets */
+static const uint32_t tm_burst_meter_id[TM_TEST_BURST_SIZE] = {
+	0, 0, 1, 0, 2, 1, 1, 0, 2, 2, 0, 1, 0, 0, 2, 1, 0, 2, 1, 1,
+};
+
+/* Empty burst, bursts shorter and longer than the prefetch offset, full burst */
+static const uint32_t tm_burst_n_pkts[] = {
+	0, 1, RTE_METER_BURST_PREFETCH_OFFSET - 1,
+	RTE_METER_BURST_PREFETCH_OFFSET + 1, TM_TEST_BURST_SIZE,
+};
+
+/**
+ * set the input of a burst test, the colors being set to an invalid value
+ * to check that only the colors of the first n_pkts packets are written
+ */
+static void
+tm_test_burst_input(uint64_t *time, uint32_t *pkt_len,
+	enum rte_color *pkt_color, enum rte_color *color, uint32_t bucket_size)
+{
+	uint64_t t = rte_get_tsc_cycles() + rte_get_tsc_hz();
+	uint32_t i;
+
+	for (i = 0; i < TM_TEST_BURST_SIZE; i++) {
+		time[i] = t + i;
+		pkt_len[i] = bucket_size / 2 + i;
+		pkt_color[i] = (enum rte_color)(i % RTE_COLORS);
+		color[i] = RTE_COLORS;
+	}
+}
+
+/**
+ * check the colors of a burst against the per packet colors of the
+ * reference meters
+ */
+#define TM_TEST_BURST_CHECK(msg, n_pkts, ref_check) do { \
+	uint32_t j; \
+	for (j = 0; j < TM_TEST_BURST_SIZE; j++) { \
+		enum rte_color ref = RTE_COLORS; \
+		if (j < (n_pkts)) \
+			ref = (ref_check); \
+		if (color[j] != ref) \
+			melog(msg" n_pkts %u packet %u", n_pkts, j); \
+	} \
+} while (0)
+
+/**
+ * functional test for rte_meter_srtcm_color_blind_check_burst and
+ * rte_meter_srtcm_color_aware_check_burst
+ */
+static inline int
+tm_test_srtcm_check_burst(void)
+{
+#define SRTCM_CHECK_BURST_MSG "srtcm_check_burst"
+	struct rte_meter_srtcm_profile sp;
+	struct rte_meter_srtcm sm[TM_TEST_BURST_N_METERS];
+	struct rte_meter_srtcm sm_ref[TM_TEST_BURST_N_METERS];
+	struct rte_meter_srtcm *m[TM_TEST_BURST_SIZE];
+	struct rte_meter_srtcm_profile *p[TM_TEST_BURST_SIZE];
+	uint64_t time[TM_TEST_BURST_SIZE];
+	uint32_t pkt_len[TM_TEST_BURST_SIZE];
+	enum rte_color pkt_color[TM_TEST_BURST_SIZE];
+	enum rte_color color[TM_TEST_BURST_SIZE];
+	uint32_t i, k, n;
+
+	if (rte_meter_srtcm_profile_config(&sp, &sparams) != 0)
+		melog(SRTCM_CHECK_BURST_MSG);
+	for (i = 0; i < TM_TEST_BURST_SIZE; i++) {
+		m[i] = &sm[tm_burst_meter_id[i]];
+		p[i] = &sp;
+	}
+
+	/* an empty burst does not access its arrays */
+	rte_meter_srtcm_color_blind_check_burst(NULL, NULL, NULL, NULL, NULL, 0);
+	rte_meter_srtcm_color_aware_check_burst(NULL, NULL, NULL, NULL, NULL,
+		NULL, 0);
+
+	for (k = 0; k < RTE_DIM(tm_burst_n_pkts); k++) {
+		n = tm_burst_n_pkts[k];
+
+		/* color blind */
+		for (i = 0; i < TM_TEST_BURST_N_METERS; i++) {
+			if (rte_meter_srtcm_config(&sm[i], &sp) != 0)
+				melog(SRTCM_CHECK_BURST_MSG);
+			sm_ref[i] = sm[i];
+		}
+		tm_test_burst_input(time, pkt_len, pkt_color, color,
+			TM_TEST_SRTCM_CBS_DF);
+		rte_meter_srtcm_color_blind_check_burst(m, p, time, pkt_len,
+			color, n);
+		TM_TEST_BURST_CHECK(SRTCM_CHECK_BURST_MSG" blind", n,
+			rte_meter_srtcm_color_blind_check(
+				&sm_ref[tm_burst_meter_id[j]], &sp, time[j],
+				pkt_len[j]));
+
+		/* the meter of the last packet runs out of tokens */
+		if (n == TM_TEST_BURST_SIZE &&
+		    color[TM_TEST_BURST_SIZE - 1] != RTE_COLOR_RED)
+			melog(SRTCM_CHECK_BURST_MSG" RED");
+
+		/* color aware */
+		for (i = 0; i < TM_TEST_BURST_N_METERS; i++) {
+			if (rte_meter_srtcm_config(&sm[i], &sp) != 0)
+				melog(SRTCM_CHECK_BURST_MSG);
+			sm_ref[i] = sm[i];
+		}
+		tm_test_burst_input(time, pkt_len, pkt_color, color,
+			TM_TEST_SRTCM_CBS_DF);
+		rte_meter_srtcm_color_aware_check_burst(m, p, time, pkt_len,
+			pkt_color, color, n);
+		TM_TEST_BURST_CHECK(SRTCM_CHECK_BURST_MSG" aware", n,
+			rte_meter_srtcm_color_aware_check(
+				&sm_ref[tm_burst_meter_id[j]], &sp, time[j],
+				pkt_len[j], pkt_color[j]));
+	}
+
+	return 0;
+}
+
+/**
+ * functional test for rte_meter_trtcm_color_blind_check_burst and
+ * rte_meter_trtcm_color_aware_check_burst
+ */
+static inline int
+tm_test_trtcm_check_burst(void)
+{
+#define TRTCM_CHECK_BURST_MSG "trtcm_check_burst"
+	struct rte_meter_trtcm_profile tp;
+	struct rte_meter_trtcm tm[TM_TEST_BURST_N_METERS];
+	struct rte_meter_trtcm tm_ref[TM_TEST_BURST_N_METERS];
+	struct rte_meter_trtcm *m[TM_TEST_BURST_SIZE];
+	struct rte_meter_trtcm_profile *p[TM_TEST_BURST_SIZE];
+	uint64_t time[TM_TEST_BURST_SIZE];
+	uint32_t pkt_len[TM_TEST_BURST_SIZE];
+	enum rte_color pkt_color[TM_TEST_BURST_SIZE];
+	enum rte_color color[TM_TEST_BURST_SIZE];
+	uint32_t i, k, n;
+
+	if (rte_meter_trtcm_profile_config(&tp, &tparams) != 0)
+		melog(TRTCM_CHECK_BURST_MSG);
+	for (i = 0; i < TM_TEST_BURST_SIZE; i++) {
+		m[i] = &tm[tm_burst_meter_id[i]];
+		p[i] = &tp;
+	}
+
+	/* an empty burst does not access its arrays */
+	rte_meter_trtcm_color_blind_check_burst(NULL, NULL, NULL, NULL, NULL, 0);
+	rte_meter_trtcm_color_aware_check_burst(NULL, NULL, NULL, NULL, NULL,
+		NULL, 0);
+
+	for (k = 0; k < RTE_DIM(tm_burst_n_pkts); k++) {
+		n = tm_burst_n_pkts[k];
+
+		/* color blind */
+		for (i = 0; i < TM_TEST_BURST_N_METERS; i++) {
+			if (rte_meter_trtcm_config(&tm[i], &tp) != 0)
+				melog(TRTCM_CHECK_BURST_MSG);
+			tm_ref[i] = tm[i];
+		}
+		tm_test_burst_input(time, pkt_len, pkt_color, color,
+			TM_TEST_TRTCM_CBS_DF);
+		rte_meter_trtcm_color_blind_check_burst(m, p, time, pkt_len,
+			color, n);
+		TM_TEST_BURST_CHECK(TRTCM_CHECK_BURST_MSG" blind", n,
+			rte_meter_trtcm_color_blind_check(
+				&tm_ref[tm_burst_meter_id[j]], &tp, time[j],
+				pkt_len[j]));
+
+		/* the meter of the last packet runs out of tokens */
+		if (n == TM_TEST_BURST_SIZE &&
+		    color[TM_TEST_BURST_SIZE - 1] != RTE_COLOR_RED)
+			melog(TRTCM_CHECK_BURST_MSG" RED");
+
+		/* color aware */
+		for (i = 0; i < TM_TEST_BURST_N_METERS; i++) {
+			if (rte_meter_trtcm_config(&tm[i], &tp) != 0)
+				melog(TRTCM_CHECK_BURST_MSG);
+			tm_ref[i] = tm[i];
+		}
+		tm_test_burst_input(time, pkt_len, pkt_color, color,
+			TM_TEST_TRTCM_CBS_DF);
+		rte_meter_trtcm_color_aware_check_burst(m, p, time, pkt_len,
+			pkt_color, color, n);
+		TM_TEST_BURST_CHECK(TRTCM_CHECK_BURST_MSG" aware", n,
+			rte_meter_trtcm_color_aware_check(
+				&tm_ref[tm_burst_meter_id[j]], &tp, time[j],
+				pkt_len[j], pkt_color[j]));
+	}
+
+	return 0;
+}
+
+/**
+ * functional test for rte_meter_trtcm_rfc4115_color_blind_check_burst and
+ * rte_meter_trtcm_rfc4115_color_aware_check_burst
+ */
+static inline int
+tm_test_trtcm_rfc4115_check_burst(void)
+{
+#define TRTCM_RFC4115_CHECK_BURST_MSG "trtcm_rfc4115_check_burst"
+	struct rte_meter_trtcm_rfc4115_profile tp;
+	struct rte_meter_trtcm_rfc4115 tm[TM_TEST_BURST_N_METERS];
+	struct rte_meter_trtcm_rfc4115 tm_ref[TM_TEST_BURST_N_METERS];
+	struct rte_meter_trtcm_rfc4115 *m[TM_TEST_BURST_SIZE];
+	struct rte_meter_trtcm_rfc4115_profile *p[TM_TEST_BURST_SIZE];
+	uint64_t time[TM_TEST_BURST_SIZE];
+	uint32_t pkt_len[TM_TEST_BURST_SIZE];
+	enum rte_color pkt_color[TM_TEST_BURST_SIZE];
+	enum rte_color color[TM_TEST_BURST_SIZE];
+	uint32_t i, k, n;
+
+	if (rte_meter_trtcm_rfc4115_profile_config(&tp, &rfc4115params) != 0)
+		melog(TRTCM_RFC4115_CHECK_BURST_MSG);
+	for (i = 0; i < TM_TEST_BURST_SIZE; i++) {
+		m[i] = &tm[tm_burst_meter_id[i]];
+		p[i] = &tp;
+	}
+
+	/* an empty burst does not access its arrays */
+	rte_meter_trtcm_rfc4115_color_blind_check_burst(NULL, NULL, NULL, NULL,
+		NULL, 0);
+	rte_meter_trtcm_rfc4115_color_aware_check_burst(NULL, NULL, NULL, NULL,
+		NULL, NULL, 0);
+
+	for (k = 0; k < RTE_DIM(tm_burst_n_pkts); k++) {
+		n = tm_burst_n_pkts[k];
+
+		/* color blind */
+		for (i = 0; i < TM_TEST_BURST_N_METERS; i++) {
+			if (rte_meter_trtcm_rfc4115_config(&tm[i], &tp) != 0)
+				melog(TRTCM_RFC4115_CHECK_BURST_MSG);
+			tm_ref[i] = tm[i];
+		}
+		tm_test_burst_input(time, pkt_len, pkt_color, color,
+			TM_TEST_TRTCM_CBS_DF);
+		rte_meter_trtcm_rfc4115_color_blind_check_burst(m, p, time,
+			pkt_len, color, n);
+		TM_TEST_BURST_CHECK(TRTCM_RFC4115_CHECK_BURST_MSG" blind", n,
+			rte_meter_trtcm_rfc4115_color_blind_check(
+				&tm_ref[tm_burst_meter_id[j]], &tp, time[j],
+				pkt_len[j]));
+
+		/* the meter of the last packet runs out of tokens */
+		if (n == TM_TEST_BURST_SIZE &&
+		    color[TM_TEST_BURST_SIZE - 1] != RTE_COLOR_RED)
+			melog(TRTCM_RFC4115_CHECK_BURST_MSG" RED");
+
+		/* color aware */
+		for (i = 0; i < TM_TEST_BURST_N_METERS; i++) {
+			if (rte_meter_trtcm_rfc4115_config(&tm[i], &tp) != 0)
+				melog(TRTCM_RFC4115_CHECK_BURST_MSG);
+			tm_ref[i] = tm[i];
+		}
+		tm_test_burst_input(time, pkt_len, pkt_color, color,
+			TM_TEST_TRTCM_CBS_DF);
+		rte_meter_trtcm_rfc4115_color_aware_check_burst(m, p, time,
+			pkt_len, pkt_color, color, n);
+		TM_TEST_BURST_CHECK(TRTCM_RFC4115_CHECK_BURST_MSG" aware", n,
+			rte_meter_trtcm_rfc4115_color_aware_check(
+				&tm_ref[tm_burst_meter_id[j]], &tp, time[j],
+				pkt_len[j], pkt_color[j]));
+	}
+
+	return 0;
+}
+
 /**
  * functional test for rte_meter_trtcm_color_blind_check
  */
@@ -709,6 +977,15 @@ test_meter(void)
 	if (tm_test_trtcm_rfc4115_color_aware_check() != 0)
 		return -1;
 
+	if (tm_test_srtcm_check_burst() != 0)
+		return -1;
+
+	if (tm_test_trtcm_check_burst() != 0)
+		return -1;
+
+	if (tm_test_trtcm_rfc4115_check_burst() != 0)
+		return -1;
+
 	return 0;
 
 }
@@ -0,0 +1,234 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_meter.h>
+#include <rte_random.h>
+
+#include "test.h"
+
+#define N_METERS (1 << 20)
+#define N_PKTS (1 << 16)
+#define BURST_SIZE 32
+#define ITERATIONS 64
+
+static struct rte_meter_srtcm_params srtcm_params = {
+	.cir = 1000000,
+	.cbs = 4096,
+	.ebs = 8192,
+};
+
+static struct rte_meter_trtcm_params trtcm_params = {
+	.cir = 1000000,
+	.pir = 2000000,
+	.cbs = 4096,
+	.pbs = 8192,
+};
+
+/* Per packet input, the meter of each packet being picked at random */
+static uint32_t pkt_meter[N_PKTS];
+static uint32_t pkt_len[N_PKTS];
+static uint64_t pkt_time[N_PKTS];
+
+static void
+pkts_init(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < N_PKTS; i++) {
+		pkt_meter[i] = rte_rand_max(N_METERS);
+		pkt_len[i] = 64 + rte_rand_max(1500 - 64);
+	}
+}
+
+/* Time stamps have to be increasing from the meters configuration time on */
+static void
+pkts_time_reset(void)
+{
+	uint64_t time = rte_rdtsc();
+	uint32_t i;
+
+	for (i = 0; i < N_PKTS; i++)
+		pkt_time[i] = time + i;
+}
+
+static void
+pkts_time_advance(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < N_PKTS; i++)
+		pkt_time[i] += N_PKTS;
+}
+
+static void
+result_print(const char *name, uint64_t cycles, uint64_t greens)
+{
+	uint64_t n = (uint64_t)N_PKTS * ITERATIONS;
+
+	printf("%-24s %12.1f %12.1f %12" PRIu64 "\n", name,
+	       (double)cycles / n,
+	       (double)n * rte_get_tsc_hz() / cycles / 1E6, greens);
+}
+
+static int
+test_srtcm_perf(void)
+{
+	struct rte_meter_srtcm *m[BURST_SIZE];
+	struct rte_meter_srtcm_profile *p[BURST_SIZE];
+	enum rte_color color[BURST_SIZE];
+	struct rte_meter_srtcm_profile profile;
+	struct rte_meter_srtcm *meters;
+	uint64_t start, cycles, greens;
+	uint32_t i, j, k;
+
+	meters = calloc(N_METERS, sizeof(*meters));
+	if (meters == NULL) {
+		printf("Error allocating srTCM meters\n");
+		return -1;
+	}
+
+	if (rte_meter_srtcm_profile_config(&profile, &srtcm_params)) {
+		free(meters);
+		return -1;
+	}
+
+	for (i = 0; i < N_METERS; i++)
+		rte_meter_srtcm_config(&meters[i], &profile);
+	pkts_time_reset();
+
+	greens = 0;
+	start = rte_rdtsc_precise();
+	for (i = 0; i < ITERATIONS; i++) {
+		for (j = 0; j < N_PKTS; j++)
+			greens += rte_meter_srtcm_color_blind_check(
+				&meters[pkt_meter[j]], &profile, pkt_time[j],
+				pkt_len[j]) == RTE_COLOR_GREEN;
+		pkts_time_advance();
+	}
+	cycles = rte_rdtsc_precise() - start;
+	result_print("srtcm", cycles, greens);
+
+	for (i = 0; i < N_METERS; i++)
+		rte_meter_srtcm_config(&meters[i], &profile);
+	pkts_time_reset();
+
+	for (k = 0; k < BURST_SIZE; k++)
+		p[k] = &profile;
+
+	greens = 0;
+	start = rte_rdtsc_precise();
+	for (i = 0; i < ITERATIONS; i++) {
+		for (j = 0; j < N_PKTS; j += BURST_SIZE) {
+			for (k = 0; k < BURST_SIZE; k++)
+				m[k] = &meters[pkt_meter[j + k]];
+
+			rte_meter_srtcm_color_blind_check_burst(m, p,
+				&pkt_time[j], &pkt_len[j], color, BURST_SIZE);
+
+			for (k = 0; k < BURST_SIZE; k++)
+				greens += color[k] == RTE_COLOR_GREEN;
+		}
+		pkts_time_advance();
+	}
+	cycles = rte_rdtsc_precise() - start;
+	result_print("srtcm burst", cycles, greens);
+
+	free(meters);
+	return 0;
+}
+
+static int
+test_trtcm_perf(void)
+{
+	struct rte_meter_trtcm *m[BURST_SIZE];
+	struct rte_meter_trtcm_profile *p[BURST_SIZE];
+	enum rte_color color[BURST_SIZE];
+	struct rte_meter_trtcm_profile profile;
+	struct rte_meter_trtcm *meters;
+	uint64_t start, cycles, greens;
+	uint32_t i, j, k;
+
+	meters = calloc(N_METERS, sizeof(*meters));
+	if (meters == NULL) {
+		printf("Error allocating trTCM meters\n");
+		return -1;
+	}
+
+	if (rte_meter_trtcm_profile_config(&profile, &trtcm_params)) {
+		free(meters);
+		return -1;
+	}
+
+	for (i = 0; i < N_METERS; i++)
+		rte_meter_trtcm_config(&meters[i], &profile);
+	pkts_time_reset();
+
+	greens = 0;
+	start = rte_rdtsc_precise();
+	for (i = 0; i < ITERATIONS; i++) {
+		for (j = 0; j < N_PKTS; j++)
+			greens += rte_meter_trtcm_color_blind_check(
+				&meters[pkt_meter[j]], &profile, pkt_time[j],
+				pkt_len[j]) == RTE_COLOR_GREEN;
+		pkts_time_advance();
+	}
+	cycles = rte_rdtsc_precise() - start;
+	result_print("trtcm", cycles, greens);
+
+	for (i = 0; i < N_METERS; i++)
+		rte_meter_trtcm_config(&meters[i], &profile);
+	pkts_time_reset();
+
+	for (k = 0; k < BURST_SIZE; k++)
+		p[k] = &profile;
+
+	greens = 0;
+	start = rte_rdtsc_precise();
+	for (i = 0; i < ITERATIONS; i++) {
+		for (j = 0; j < N_PKTS; j += BURST_SIZE) {
+			for (k = 0; k < BURST_SIZE; k++)
+				m[k] = &meters[pkt_meter[j + k]];
+
+			rte_meter_trtcm_color_blind_check_burst(m, p,
+				&pkt_time[j], &pkt_len[j], color, BURST_SIZE);
+
+			for (k = 0; k < BURST_SIZE; k++)
+				greens += color[k] == RTE_COLOR_GREEN;
+		}
+		pkts_time_advance();
+	}
+	cycles = rte_rdtsc_precise() - start;
+	result_print("trtcm burst", cycles, greens);
+
+	free(meters);
+	return 0;
+}
+
+static int
+test_meter_perf(void)
+{
+	pkts_init();
+
+	printf("%u meters, random meter and packet length per packet\n",
+	       N_METERS);
+	printf("%-24s %12s %12s %12s\n",
+	       "Meter", "Cycles/pkt", "Mpps", "Green");
+
+	if (test_srtcm_perf() != 0)
+		return -1;
+
+	if (test_trtcm_perf() != 0)
+		return -1;
+
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(meter_perf_autotest, test_meter_perf);
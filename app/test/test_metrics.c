@@ -7,6 +7,7 @@
 #include <stdint.h>
 #include <errno.h>
 
+#include <rte_launch.h>
 #include <rte_lcore.h>
 #include <rte_metrics.h>
 
@@ -185,6 +186,53 @@ test_metrics_update_values(void)
 	return TEST_SUCCESS;
 }
 
+static int
+metrics_update_worker(void *arg)
+{
+	const uint64_t *value = arg;
+
+	return rte_metrics_update_values(RTE_METRICS_GLOBAL, 2, value, 1);
+}
+
+/* Test case to validate the most recent update of an lcore is read */
+static int
+test_metrics_update_values_lcores(void)
+{
+	struct rte_metric_value getvalues[REG_METRIC_COUNT];
+	uint64_t value = 10;
+	unsigned int lcore_id;
+	int err;
+
+	err = rte_metrics_update_values(RTE_METRICS_GLOBAL, 2, &value, 1);
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		value++;
+		err = rte_eal_remote_launch(metrics_update_worker, &value,
+			lcore_id);
+		TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+		err = rte_eal_wait_lcore(lcore_id);
+		TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+
+		err = rte_metrics_get_values(RTE_METRICS_GLOBAL, getvalues,
+			REG_METRIC_COUNT);
+		TEST_ASSERT(err > 2 && err <= REG_METRIC_COUNT &&
+			getvalues[2].value == value,
+			"%s, %d", __func__, __LINE__);
+	}
+
+	/* main lcore updates again, its value is the most recent one */
+	value++;
+	err = rte_metrics_update_values(RTE_METRICS_GLOBAL, 2, &value, 1);
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_get_values(RTE_METRICS_GLOBAL, getvalues,
+		REG_METRIC_COUNT);
+	TEST_ASSERT(err > 2 && err <= REG_METRIC_COUNT &&
+		getvalues[2].value == value, "%s, %d", __func__, __LINE__);
+
+	return TEST_SUCCESS;
+}
+
 /* Test to validate get metric name-key lookup table */
 static int
 test_metrics_get_names(void)
@@ -271,6 +319,67 @@ test_metrics_get_values(void)
 	return TEST_SUCCESS;
 }
 
+/* Test case to validate values are updated and read after a re-init */
+static int
+test_metrics_reinit(void)
+{
+	struct rte_metric_value getvalues[REG_METRIC_COUNT];
+	const char * const mnames[] = {
+		"mean_bits_in", "mean_bits_out",
+		"peak_bits_in", "peak_bits_out",
+		};
+	uint64_t value = 20;
+	unsigned int lcore_id;
+	int err;
+
+	err = rte_metrics_deinit();
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+
+	/* Failure Test: the metric data and shards are gone */
+	err = rte_metrics_update_values(RTE_METRICS_GLOBAL, 2, &value, 1);
+	TEST_ASSERT(err == -EIO, "%s, %d", __func__, __LINE__);
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		err = rte_eal_remote_launch(metrics_update_worker, &value,
+			lcore_id);
+		TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+		err = rte_eal_wait_lcore(lcore_id);
+		TEST_ASSERT(err == -EIO, "%s, %d", __func__, __LINE__);
+	}
+	err = rte_metrics_get_values(RTE_METRICS_GLOBAL, NULL, 0);
+	TEST_ASSERT(err == -EIO, "%s, %d", __func__, __LINE__);
+
+	err = rte_metrics_init(rte_socket_id());
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_reg_names(&mnames[0], RTE_DIM(mnames));
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+
+	/* Successful Test: the lcores use new shards */
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		value++;
+		err = rte_eal_remote_launch(metrics_update_worker, &value,
+			lcore_id);
+		TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+		err = rte_eal_wait_lcore(lcore_id);
+		TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+
+		err = rte_metrics_get_values(RTE_METRICS_GLOBAL, getvalues,
+			REG_METRIC_COUNT);
+		TEST_ASSERT(err == (int)RTE_DIM(mnames) &&
+			getvalues[2].value == value,
+			"%s, %d", __func__, __LINE__);
+	}
+
+	value++;
+	err = rte_metrics_update_values(RTE_METRICS_GLOBAL, 2, &value, 1);
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_get_values(RTE_METRICS_GLOBAL, getvalues,
+		REG_METRIC_COUNT);
+	TEST_ASSERT(err == (int)RTE_DIM(mnames) &&
+		getvalues[2].value == value, "%s, %d", __func__, __LINE__);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite metrics_testsuite  = {
 	.suite_name = "Metrics Unit Test Suite",
 	.setup = NULL,
@@ -302,18 +411,28 @@ static struct unit_test_suite metrics_testsuite  = {
 		 */
 		TEST_CASE(test_metrics_update_values),
 
-		/* TEST CASE 6: Test to get metric names-key with valid
+		/* TEST CASE 6: Test to read the values updated from
+		 * different lcores
+		 */
+		TEST_CASE(test_metrics_update_values_lcores),
+
+		/* TEST CASE 7: Test to get metric names-key with valid
 		 * array list, count size and invalid array list, count size
 		 */
 		TEST_CASE(test_metrics_get_names),
 
-		/* TEST CASE 7: Test to get list of metric values with valid
+		/* TEST CASE 8: Test to get list of metric values with valid
 		 * port id, array list, count size and invalid port id,
 		 * arraylist, count size
 		 */
 		TEST_CASE(test_metrics_get_values),
 
-		/* TEST CASE 8: Test to unregister metrics*/
+		/* TEST CASE 9: Test to update and get metric values
+		 * after a re-init
+		 */
+		TEST_CASE(test_metrics_reinit),
+
+		/* TEST CASE 10: Test to unregister metrics*/
 		TEST_CASE(test_metrics_deinitialize),
 
 		TEST_CASES_END()
@@ -0,0 +1,500 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_node_ip4_api.h>
+#include <rte_random.h>
+#include <rte_rcu_qsbr.h>
+#include <rte_udp.h>
+
+#define TEST_NAT44_EXT_IP RTE_IPV4(192, 0, 2, 1)
+#define TEST_NAT44_PORT_MIN 1024
+#define TEST_NAT44_PORT_MAX 2047
+#define TEST_NAT44_SESSIONS 64
+#define TEST_NAT44_TIMEOUT 1
+#define TEST_NAT44_BURST 4
+#define TEST_NAT44_PKT_LEN 128
+
+/* Where the packets went, stored in the mbuf hash field by the sinks */
+enum {
+	TEST_NAT44_NONE,
+	TEST_NAT44_FWD,
+	TEST_NAT44_DROP,
+};
+
+struct test_nat44_burst {
+	struct rte_mbuf *pkts[TEST_NAT44_BURST];
+	uint16_t nb_pkts;
+};
+
+static struct test_nat44_burst bursts[RTE_MAX_LCORE];
+static struct rte_mbuf mbufs[RTE_MAX_LCORE][TEST_NAT44_BURST];
+static uint8_t pkt_data[RTE_MAX_LCORE][TEST_NAT44_BURST][TEST_NAT44_PKT_LEN];
+static rte_graph_t graph_ids[RTE_MAX_LCORE];
+static struct rte_rcu_qsbr *qsv;
+static uint32_t remote_ip;
+static uint16_t base_port;
+static uint32_t start;
+
+static uint16_t
+test_nat44_source(struct rte_graph *graph, struct rte_node *node, void **objs,
+		  uint16_t nb_objs)
+{
+	struct test_nat44_burst *b = &bursts[rte_lcore_id()];
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	nb_objs = b->nb_pkts;
+	if (nb_objs != 0)
+		rte_node_enqueue(graph, node, 0, (void **)b->pkts, nb_objs);
+	b->nb_pkts = 0;
+
+	return nb_objs;
+}
+
+static uint16_t
+test_nat44_sink(void **objs, uint16_t nb_objs, uint32_t where)
+{
+	uint16_t i;
+
+	for (i = 0; i < nb_objs; i++)
+		((struct rte_mbuf *)objs[i])->hash.usr = where;
+
+	return nb_objs;
+}
+
+static uint16_t
+test_nat44_fwd(struct rte_graph *graph, struct rte_node *node, void **objs,
+	       uint16_t nb_objs)
+{
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+
+	return test_nat44_sink(objs, nb_objs, TEST_NAT44_FWD);
+}
+
+static uint16_t
+test_nat44_drop(struct rte_graph *graph, struct rte_node *node, void **objs,
+		uint16_t nb_objs)
+{
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+
+	return test_nat44_sink(objs, nb_objs, TEST_NAT44_DROP);
+}
+
+static struct rte_node_register test_nat44_source_node = {
+	.name = "test_nat44_source",
+	.process = test_nat44_source,
+	.flags = RTE_NODE_SOURCE_F,
+	.nb_edges = 1,
+	.next_nodes = {"nat44"},
+};
+RTE_NODE_REGISTER(test_nat44_source_node);
+
+static struct rte_node_register test_nat44_fwd_node = {
+	.name = "test_nat44_fwd",
+	.process = test_nat44_fwd,
+};
+RTE_NODE_REGISTER(test_nat44_fwd_node);
+
+static struct rte_node_register test_nat44_drop_node = {
+	.name = "test_nat44_drop",
+	.process = test_nat44_drop,
+};
+RTE_NODE_REGISTER(test_nat44_drop_node);
+
+/* Build an UDP packet in the next mbuf of the lcore burst */
+static struct rte_mbuf *
+test_nat44_pkt_add(uint32_t src_ip, uint16_t src_port, uint32_t dst_ip,
+		   uint16_t dst_port)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct test_nat44_burst *b = &bursts[lcore_id];
+	struct rte_mbuf *m = &mbufs[lcore_id][b->nb_pkts];
+	struct rte_ipv4_hdr *ip;
+	struct rte_udp_hdr *udp;
+	uint8_t *data;
+
+	data = pkt_data[lcore_id][b->nb_pkts];
+	memset(data, 0, TEST_NAT44_PKT_LEN);
+	memset(m, 0, sizeof(*m));
+	m->buf_addr = data;
+	m->buf_len = TEST_NAT44_PKT_LEN;
+	m->nb_segs = 1;
+	m->data_len = TEST_NAT44_PKT_LEN;
+	m->pkt_len = TEST_NAT44_PKT_LEN;
+
+	ip = (struct rte_ipv4_hdr *)(data + sizeof(struct rte_ether_hdr));
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_UDP;
+	ip->total_length = rte_cpu_to_be_16(TEST_NAT44_PKT_LEN -
+					    sizeof(struct rte_ether_hdr));
+	ip->src_addr = rte_cpu_to_be_32(src_ip);
+	ip->dst_addr = rte_cpu_to_be_32(dst_ip);
+	ip->hdr_checksum = rte_ipv4_cksum(ip);
+
+	udp = (struct rte_udp_hdr *)(ip + 1);
+	udp->src_port = rte_cpu_to_be_16(src_port);
+	udp->dst_port = rte_cpu_to_be_16(dst_port);
+	udp->dgram_len = rte_cpu_to_be_16(TEST_NAT44_PKT_LEN -
+					  sizeof(struct rte_ether_hdr) -
+					  sizeof(struct rte_ipv4_hdr));
+	udp->dgram_cksum = rte_ipv4_udptcp_cksum(ip, udp);
+
+	b->pkts[b->nb_pkts++] = m;
+	return m;
+}
+
+static struct rte_ipv4_hdr *
+test_nat44_ip(struct rte_mbuf *m)
+{
+	return rte_pktmbuf_mtod_offset(m, struct rte_ipv4_hdr *,
+				       sizeof(struct rte_ether_hdr));
+}
+
+static uint16_t
+test_nat44_src_port(struct rte_mbuf *m)
+{
+	struct rte_udp_hdr *udp = (struct rte_udp_hdr *)(test_nat44_ip(m) + 1);
+
+	return rte_be_to_cpu_16(udp->src_port);
+}
+
+static uint16_t
+test_nat44_dst_port(struct rte_mbuf *m)
+{
+	struct rte_udp_hdr *udp = (struct rte_udp_hdr *)(test_nat44_ip(m) + 1);
+
+	return rte_be_to_cpu_16(udp->dst_port);
+}
+
+/* Check the checksums updated incrementally by the node */
+static int
+test_nat44_cksum_ok(struct rte_mbuf *m)
+{
+	struct rte_ipv4_hdr *ip = test_nat44_ip(m);
+	uint16_t cksum = ip->hdr_checksum;
+	int ok;
+
+	ip->hdr_checksum = 0;
+	ok = rte_ipv4_cksum(ip) == cksum;
+	ip->hdr_checksum = cksum;
+
+	return ok && rte_ipv4_udptcp_cksum_verify(ip, ip + 1) == 0;
+}
+
+/* Run the lcore graph once over its burst, as an RCU reader */
+static void
+test_nat44_walk(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct rte_graph *graph;
+
+	graph = rte_graph_lookup(rte_graph_id_to_name(graph_ids[lcore_id]));
+	rte_rcu_qsbr_thread_online(qsv, lcore_id);
+	rte_graph_walk(graph);
+	rte_rcu_qsbr_thread_offline(qsv, lcore_id);
+}
+
+/* Next port allocated after a given one */
+static uint16_t
+test_nat44_port_next(uint16_t port)
+{
+	return port == TEST_NAT44_PORT_MAX ? TEST_NAT44_PORT_MIN : port + 1;
+}
+
+static int
+test_nat44_graph_create(unsigned int lcore_id)
+{
+	static const char *patterns[] = {
+		"test_nat44_source", "nat44-test_nat44",
+		"test_nat44_fwd", "test_nat44_drop",
+	};
+	struct rte_graph_param prm = {
+		.socket_id = SOCKET_ID_ANY,
+		.nb_node_patterns = RTE_DIM(patterns),
+		.node_patterns = patterns,
+	};
+	char name[RTE_GRAPH_NAMESIZE];
+
+	snprintf(name, sizeof(name), "test_nat44_%u", lcore_id);
+	graph_ids[lcore_id] = rte_graph_create(name, &prm);
+	if (graph_ids[lcore_id] == RTE_GRAPH_ID_INVALID) {
+		printf("Graph creation failed, rc=%d\n", rte_errno);
+		return -1;
+	}
+
+	rte_rcu_qsbr_thread_register(qsv, lcore_id);
+	return 0;
+}
+
+static int
+test_nat44_setup(void)
+{
+	const char *sinks[] = { "test_nat44_fwd", "test_nat44_drop" };
+	const char *nat44 = "nat44-test_nat44";
+	struct rte_node_ip4_nat44_conf conf = {
+		.ext_ip = TEST_NAT44_EXT_IP,
+		.port_min = TEST_NAT44_PORT_MIN,
+		.port_max = TEST_NAT44_PORT_MAX,
+		.max_sessions = TEST_NAT44_SESSIONS,
+		.timeout = TEST_NAT44_TIMEOUT,
+	};
+	unsigned int lcore_id;
+	rte_node_t id;
+	size_t sz;
+	int ret;
+
+	/* Sessions, the NAT44 clone and its edges live as long as the process */
+	if (qsv == NULL) {
+		sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+		qsv = rte_zmalloc("test_nat44_qsv", sz, RTE_CACHE_LINE_SIZE);
+		TEST_ASSERT_NOT_NULL(qsv, "Failed to allocate QSBR variable");
+		rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	}
+	conf.qsv = qsv;
+	ret = rte_node_ip4_nat44_config(&conf);
+	TEST_ASSERT(ret == 0 || ret == -EEXIST, "NAT44 config failed, rc=%d",
+		    ret);
+
+	if (rte_node_is_invalid(rte_node_from_name(nat44))) {
+		id = rte_node_clone(rte_node_from_name("nat44"), "test_nat44");
+		TEST_ASSERT(!rte_node_is_invalid(id), "NAT44 clone failed");
+		TEST_ASSERT_EQUAL(rte_node_edge_update(id, 0, sinks, 2), 2,
+				  "NAT44 edge update failed");
+		TEST_ASSERT_EQUAL(rte_node_edge_update(
+				rte_node_from_name("test_nat44_source"), 0,
+				&nat44, 1), 1, "Source edge update failed");
+	}
+
+	RTE_LCORE_FOREACH(lcore_id)
+		if (test_nat44_graph_create(lcore_id) < 0)
+			return TEST_FAILED;
+
+	/* Flows not seen by previous runs */
+	remote_ip = RTE_IPV4(198, 18, 0, 0) | (rte_rand() & 0xffff);
+	base_port = 1 + rte_rand_max(UINT16_MAX / 2);
+
+	return TEST_SUCCESS;
+}
+
+static void
+test_nat44_teardown(void)
+{
+	unsigned int lcore_id;
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		rte_rcu_qsbr_thread_unregister(qsv, lcore_id);
+		rte_graph_destroy(graph_ids[lcore_id]);
+	}
+}
+
+/* Send the first packet of a new flow, return its external port */
+static int
+test_nat44_new_flow(uint16_t src_port, uint16_t *ext_port)
+{
+	struct rte_mbuf *m;
+
+	m = test_nat44_pkt_add(RTE_IPV4(10, 0, 0, 1), src_port, remote_ip, 53);
+	test_nat44_walk();
+
+	TEST_ASSERT_EQUAL(m->hash.usr, TEST_NAT44_FWD, "Packet not forwarded");
+	*ext_port = test_nat44_src_port(m);
+	return TEST_SUCCESS;
+}
+
+static int
+test_nat44_translate(void)
+{
+	struct rte_mbuf *out, *in, *unknown;
+	struct rte_ipv4_hdr *ip;
+	uint16_t ext_port;
+
+	out = test_nat44_pkt_add(RTE_IPV4(10, 0, 0, 1), base_port, remote_ip,
+				 53);
+	test_nat44_walk();
+
+	TEST_ASSERT_EQUAL(out->hash.usr, TEST_NAT44_FWD, "Packet not forwarded");
+	ip = test_nat44_ip(out);
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_32(ip->src_addr), TEST_NAT44_EXT_IP,
+			  "Source address not translated");
+	ext_port = test_nat44_src_port(out);
+	TEST_ASSERT(ext_port >= TEST_NAT44_PORT_MIN &&
+		    ext_port <= TEST_NAT44_PORT_MAX,
+		    "External port %u out of range", ext_port);
+	TEST_ASSERT(test_nat44_cksum_ok(out), "Wrong checksum in2out");
+
+	/* Reply goes back to the internal end, unknown port is dropped */
+	in = test_nat44_pkt_add(remote_ip, 53, TEST_NAT44_EXT_IP, ext_port);
+	unknown = test_nat44_pkt_add(remote_ip, 53, TEST_NAT44_EXT_IP,
+				     ext_port == TEST_NAT44_PORT_MIN ?
+				     TEST_NAT44_PORT_MAX : ext_port - 1);
+	test_nat44_walk();
+
+	TEST_ASSERT_EQUAL(in->hash.usr, TEST_NAT44_FWD, "Reply not forwarded");
+	ip = test_nat44_ip(in);
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_32(ip->dst_addr), RTE_IPV4(10, 0, 0, 1),
+			  "Destination address not translated");
+	TEST_ASSERT_EQUAL(test_nat44_dst_port(in), base_port,
+			  "Destination port not translated");
+	TEST_ASSERT(test_nat44_cksum_ok(in), "Wrong checksum out2in");
+	TEST_ASSERT_EQUAL(unknown->hash.usr, TEST_NAT44_DROP,
+			  "Packet without session not dropped");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_nat44_duplicate_first(void)
+{
+	struct rte_mbuf *m[TEST_NAT44_BURST - 1];
+	uint16_t ext_port, next_port;
+	unsigned int i;
+
+	/* Several first packets of a flow in one burst */
+	for (i = 0; i < RTE_DIM(m); i++)
+		m[i] = test_nat44_pkt_add(RTE_IPV4(10, 0, 0, 1), base_port + 1,
+					  remote_ip, 53);
+	test_nat44_walk();
+
+	ext_port = test_nat44_src_port(m[0]);
+	for (i = 0; i < RTE_DIM(m); i++) {
+		TEST_ASSERT_EQUAL(m[i]->hash.usr, TEST_NAT44_FWD,
+				  "Packet %u not forwarded", i);
+		TEST_ASSERT_EQUAL(test_nat44_src_port(m[i]), ext_port,
+				  "Packet %u got another session", i);
+	}
+
+	/* A single port was allocated */
+	TEST_ASSERT_SUCCESS(test_nat44_new_flow(base_port + 2, &next_port),
+			    "New flow failed");
+	TEST_ASSERT_EQUAL(next_port, test_nat44_port_next(ext_port),
+			  "Ports allocated for duplicate sessions");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_nat44_worker(void *arg)
+{
+	struct rte_mbuf *m;
+
+	m = test_nat44_pkt_add(RTE_IPV4(10, 0, 0, 1), base_port + 3, remote_ip,
+			       53);
+	rte_wait_until_equal_32(&start, 1, __ATOMIC_ACQUIRE);
+	test_nat44_walk();
+
+	*(uint16_t *)arg = m->hash.usr == TEST_NAT44_FWD ?
+			   test_nat44_src_port(m) : 0;
+	return 0;
+}
+
+static int
+test_nat44_concurrent_first(void)
+{
+	uint16_t ports[RTE_MAX_LCORE] = {0};
+	unsigned int lcore_id, n = 0;
+	uint16_t next_port;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores for nat44 concurrency test, expecting at least 2\n");
+		return TEST_SKIPPED;
+	}
+
+	/* First packet of a flow on all the workers at once */
+	__atomic_store_n(&start, 0, __ATOMIC_RELAXED);
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+		rte_eal_remote_launch(test_nat44_worker, &ports[lcore_id],
+				      lcore_id);
+	__atomic_store_n(&start, 1, __ATOMIC_RELEASE);
+	rte_eal_mp_wait_lcore();
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		TEST_ASSERT(ports[lcore_id] != 0,
+			    "Packet not forwarded on lcore %u", lcore_id);
+		TEST_ASSERT_EQUAL(ports[lcore_id],
+				  ports[rte_get_next_lcore(-1, 1, 0)],
+				  "Lcore %u got another session", lcore_id);
+		n++;
+	}
+
+	TEST_ASSERT_SUCCESS(test_nat44_new_flow(base_port + 4, &next_port),
+			    "New flow failed");
+	TEST_ASSERT_EQUAL(next_port,
+			  test_nat44_port_next(ports[rte_get_next_lcore(-1, 1, 0)]),
+			  "Ports allocated for duplicate sessions by %u lcores",
+			  n);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_nat44_expire(void)
+{
+	struct rte_mbuf *m;
+	uint16_t ext_port;
+	unsigned int i;
+
+	TEST_ASSERT_SUCCESS(test_nat44_new_flow(base_port + 5, &ext_port),
+			    "New flow failed");
+
+	/* Idle sessions are deleted a few per burst */
+	rte_delay_us_sleep((TEST_NAT44_TIMEOUT + 1) * US_PER_S);
+	for (i = 0; i < TEST_NAT44_SESSIONS; i++) {
+		test_nat44_pkt_add(remote_ip, 53, TEST_NAT44_EXT_IP, 1);
+		test_nat44_walk();
+	}
+
+	m = test_nat44_pkt_add(remote_ip, 53, TEST_NAT44_EXT_IP, ext_port);
+	test_nat44_walk();
+	TEST_ASSERT_EQUAL(m->hash.usr, TEST_NAT44_DROP,
+			  "Reply to an expired session not dropped");
+
+	/* Freed sessions are reused for new flows */
+	for (i = 0; i < TEST_NAT44_SESSIONS; i++) {
+		TEST_ASSERT_SUCCESS(test_nat44_new_flow(base_port + 6 + i,
+							&ext_port),
+				    "Session %u not created", i);
+	}
+
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite node_nat44_testsuite = {
+	.suite_name = "Node NAT44 tests",
+	.setup = test_nat44_setup,
+	.teardown = test_nat44_teardown,
+	.unit_test_cases = {
+		TEST_CASE(test_nat44_translate),
+		TEST_CASE(test_nat44_duplicate_first),
+		TEST_CASE(test_nat44_concurrent_first),
+		TEST_CASE(test_nat44_expire),
+		TEST_CASES_END(), /**< NULL terminate unit test array */
+	},
+};
+
+static int
+test_node_nat44(void)
+{
+	return unit_test_suite_runner(&node_nat44_testsuite);
+}
+
+REGISTER_TEST_COMMAND(node_nat44_autotest, test_node_nat44);
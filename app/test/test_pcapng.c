@@ -167,6 +167,52 @@ test_write_packets(void)
 	return 0;
 }
 
+static int
+test_write_blocks(void)
+{
+	void *blocks[NUM_PACKETS];
+	struct dummy_mbuf mbfs;
+	uint32_t bsize, blen;
+	unsigned int i;
+	uint8_t *buf;
+	ssize_t len;
+
+	/* make a dummy packet */
+	mbuf1_prepare(&mbfs, pkt_len);
+
+	/* format it in place, with a snapshot shorter than the packet */
+	bsize = rte_pcapng_block_size(pkt_len / 2);
+	buf = malloc(bsize * NUM_PACKETS);
+	if (buf == NULL) {
+		fprintf(stderr, "Cannot allocate blocks\n");
+		return -1;
+	}
+
+	for (i = 0; i < NUM_PACKETS; i++) {
+		blocks[i] = buf + i * bsize;
+		blen = rte_pcapng_block_fill(blocks[i], port_id, 0, &mbfs.mb[0],
+					     pkt_len / 2, rte_get_tsc_cycles(),
+					     RTE_PCAPNG_DIRECTION_IN);
+		if (blen != bsize) {
+			fprintf(stderr, "Block length %u, expected %u\n",
+				blen, bsize);
+			free(buf);
+			return -1;
+		}
+	}
+
+	/* write them to capture file */
+	len = rte_pcapng_write_blocks(pcapng, blocks, NUM_PACKETS);
+	free(buf);
+
+	if (len != (ssize_t)bsize * NUM_PACKETS) {
+		fprintf(stderr, "Write of blocks failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 test_write_stats(void)
 {
@@ -300,6 +346,7 @@ unit_test_suite test_pcapng_suite  = {
 	.suite_name = "Test Pcapng Unit Test Suite",
 	.unit_test_cases = {
 		TEST_CASE(test_write_packets),
+		TEST_CASE(test_write_blocks),
 		TEST_CASE(test_write_stats),
 		TEST_CASE(test_validate),
 		TEST_CASE(test_write_over_limit_iov_max),
@@ -2,11 +2,15 @@
  * Copyright(c) 2018 Intel Corporation
  */
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <stdint.h>
 #include <limits.h>
+#include <inttypes.h>
 
 #include <ethdev_driver.h>
+#include <rte_cycles.h>
+#include <rte_pcapng.h>
 #include <rte_pdump.h>
 #include "rte_eal.h"
 #include "rte_lcore.h"
@@ -20,6 +24,33 @@
 
 #define launch_p(ARGV) process_dup(ARGV, RTE_DIM(ARGV), __func__)
 
+#define ZC_SNAPLEN 128u
+
+/* Pcapng enhanced packet block, as written by the zero-copy capture */
+struct zc_block {
+	uint32_t block_type;
+	uint32_t block_length;
+	uint32_t interface_id;
+	uint32_t timestamp_hi;
+	uint32_t timestamp_lo;
+	uint32_t capture_length;
+	uint32_t original_length;
+};
+
+struct zc_option {
+	uint16_t code;
+	uint16_t length;
+	uint32_t data;
+};
+
+#define ZC_ENHANCED_PACKET_BLOCK 6
+#define ZC_EPB_FLAGS 2
+#define ZC_IFB_OUTBOUND 2
+
+#define SAMPLE_RATE 8
+#define SAMPLE_MIN_PKTS 256
+#define SAMPLE_WINDOW 64
+
 struct rte_ring *ring_server;
 uint16_t portid;
 uint16_t flag_for_send_pkts = 1;
@@ -43,6 +74,278 @@ test_pdump_init(void)
 	return ret;
 }
 
+/* Check a block written by the zero-copy capture of transmitted packets */
+static int
+check_zc_block(const struct zc_block *b, uint32_t esize)
+{
+	const struct zc_option *opt;
+
+	if (b->block_type != ZC_ENHANCED_PACKET_BLOCK) {
+		printf("zero-copy block type %u\n", b->block_type);
+		return -1;
+	}
+	if (b->block_length > esize || b->block_length % sizeof(uint32_t) ||
+	    *(const uint32_t *)RTE_PTR_ADD(b, b->block_length -
+					  sizeof(uint32_t)) != b->block_length) {
+		printf("zero-copy block length %u\n", b->block_length);
+		return -1;
+	}
+	if (b->interface_id != portid ||
+	    b->capture_length != RTE_MIN(b->original_length, ZC_SNAPLEN)) {
+		printf("zero-copy block port %u, length %u of %u\n",
+		       b->interface_id, b->capture_length, b->original_length);
+		return -1;
+	}
+
+	opt = RTE_PTR_ADD(b + 1, RTE_ALIGN(b->capture_length, sizeof(uint32_t)));
+	if (opt->code != ZC_EPB_FLAGS || opt->data != ZC_IFB_OUTBOUND) {
+		printf("zero-copy block flags option %u:%#x\n",
+		       opt->code, opt->data);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+run_pdump_zero_copy_tests(void)
+{
+	uint32_t flags = RTE_PDUMP_FLAG_TX | RTE_PDUMP_FLAG_ZEROCOPY;
+	uint32_t esize = rte_pcapng_block_size(ZC_SNAPLEN);
+	struct rte_ring *ring;
+	unsigned int i, n = 0, itr;
+	void *blocks;
+	int ret;
+
+	printf("\n***** zero-copy capture *****\n");
+
+	/* blocks are written in place, which a multi-producer ring forbids */
+	ring = rte_ring_create_elem("SR_ZC_MP", esize, RING_SIZE,
+				    rte_socket_id(), 0);
+	if (ring == NULL) {
+		printf("rte_ring_create_elem SR_ZC_MP failed\n");
+		return -1;
+	}
+	ret = rte_pdump_enable_bpf(portid, QUEUE_ID, flags, ZC_SNAPLEN,
+				   ring, NULL, NULL);
+	if (ret == 0) {
+		printf("zero-copy capture accepted a multi-producer ring\n");
+		rte_pdump_disable(portid, QUEUE_ID, flags);
+		rte_ring_free(ring);
+		return -1;
+	}
+	rte_ring_free(ring);
+
+	/* elements too small for the blocks of the snapshot length */
+	ring = rte_ring_create_elem("SR_ZC_SMALL",
+				    rte_pcapng_block_size(ZC_SNAPLEN / 2),
+				    RING_SIZE, rte_socket_id(),
+				    RING_F_SP_ENQ | RING_F_SC_DEQ);
+	if (ring == NULL) {
+		printf("rte_ring_create_elem SR_ZC_SMALL failed\n");
+		return -1;
+	}
+	ret = rte_pdump_enable_bpf(portid, QUEUE_ID, flags, ZC_SNAPLEN,
+				   ring, NULL, NULL);
+	if (ret == 0) {
+		printf("zero-copy capture accepted a wrong element size\n");
+		rte_pdump_disable(portid, QUEUE_ID, flags);
+		rte_ring_free(ring);
+		return -1;
+	}
+	rte_ring_free(ring);
+
+	ring = rte_ring_create_elem("SR_ZC", esize, RING_SIZE,
+				    rte_socket_id(),
+				    RING_F_SP_ENQ | RING_F_SC_DEQ);
+	blocks = malloc((size_t)esize * RING_SIZE);
+	if (ring == NULL || blocks == NULL) {
+		printf("zero-copy ring allocation failed\n");
+		rte_ring_free(ring);
+		free(blocks);
+		return -1;
+	}
+
+	ret = rte_pdump_enable_bpf(portid, QUEUE_ID, flags, ZC_SNAPLEN,
+				   ring, NULL, NULL);
+	if (ret < 0) {
+		printf("rte_pdump_enable_bpf zero-copy failed\n");
+		rte_ring_free(ring);
+		free(blocks);
+		return -1;
+	}
+	printf("pdump_enable_bpf zero-copy success\n");
+
+	/* wait for the primary process to transmit packets */
+	for (itr = 0; itr < 100 && n == 0; itr++) {
+		rte_delay_ms(10);
+		n = rte_ring_dequeue_burst_elem(ring, blocks, esize,
+						RING_SIZE, NULL);
+	}
+
+	ret = rte_pdump_disable(portid, QUEUE_ID, flags);
+	if (ret < 0)
+		printf("rte_pdump_disable zero-copy failed\n");
+	else if (n == 0) {
+		printf("no zero-copy block captured\n");
+		ret = -1;
+	}
+
+	for (i = 0; i < n && ret == 0; i++)
+		ret = check_zc_block(RTE_PTR_ADD(blocks, i * esize), esize);
+
+	rte_ring_free(ring);
+	free(blocks);
+	return ret;
+}
+
+/* Dequeue and free the captured packets, return their number */
+static unsigned int
+drain_ring(struct rte_ring *ring)
+{
+	struct rte_mbuf *pkts[32];
+	unsigned int n, total = 0;
+
+	while ((n = rte_ring_dequeue_burst(ring, (void **)pkts,
+					   RTE_DIM(pkts), NULL)) > 0) {
+		rte_pktmbuf_free_bulk(pkts, n);
+		total += n;
+	}
+
+	return total;
+}
+
+/* Check one transmitted packet in SAMPLE_RATE is captured */
+static int
+run_pdump_sample_count_test(struct rte_ring *ring, struct rte_mempool *mp)
+{
+	const uint32_t flags = RTE_PDUMP_FLAG_TX;
+	struct rte_pdump_sample sample = {
+		.mode = RTE_PDUMP_SAMPLE_COUNT,
+		.rate = SAMPLE_RATE,
+	};
+	struct rte_pdump_stats before, after;
+	uint64_t captured, seen, queued;
+	unsigned int n = 0, itr;
+
+	drain_ring(ring);
+	if (rte_pdump_stats(portid, &before) < 0) {
+		printf("rte_pdump_stats failed\n");
+		return -1;
+	}
+
+	if (rte_pdump_enable_sample(portid, QUEUE_ID, flags, UINT32_MAX,
+				    ring, mp, NULL, &sample) < 0) {
+		printf("rte_pdump_enable_sample count failed\n");
+		return -1;
+	}
+
+	for (itr = 0; itr < 100 && n < SAMPLE_MIN_PKTS; itr++) {
+		rte_delay_ms(10);
+		n += drain_ring(ring);
+	}
+
+	if (rte_pdump_disable(portid, QUEUE_ID, flags) < 0) {
+		printf("rte_pdump_disable failed\n");
+		return -1;
+	}
+	n += drain_ring(ring);
+
+	if (rte_pdump_stats(portid, &after) < 0) {
+		printf("rte_pdump_stats failed\n");
+		return -1;
+	}
+
+	captured = after.accepted + after.nombuf -
+		before.accepted - before.nombuf;
+	seen = captured + after.sampled - before.sampled;
+	queued = after.accepted - before.accepted -
+		(after.ringfull - before.ringfull);
+
+	printf("sampled capture: %"PRIu64" of %"PRIu64" packets, %u dequeued\n",
+	       captured, seen, n);
+
+	/* the count carries over bursts, so the ratio is exact */
+	if (n < SAMPLE_MIN_PKTS || captured != seen / SAMPLE_RATE) {
+		printf("sampled capture is not 1 in %u\n", SAMPLE_RATE);
+		return -1;
+	}
+	if (n != queued) {
+		printf("%u packets dequeued, %"PRIu64" queued\n", n, queued);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Check the trigger window only reaches the ring once triggered */
+static int
+run_pdump_trigger_test(struct rte_ring *ring, struct rte_mempool *mp)
+{
+	const uint32_t flags = RTE_PDUMP_FLAG_TX;
+	struct rte_pdump_sample sample = {
+		.mode = RTE_PDUMP_SAMPLE_NONE,
+		.window = SAMPLE_WINDOW,
+		.triggers = RTE_PDUMP_TRIGGER_MANUAL,
+	};
+	struct rte_pdump_stats before, stats;
+	unsigned int n, itr;
+
+	drain_ring(ring);
+	if (rte_pdump_stats(portid, &before) < 0) {
+		printf("rte_pdump_stats failed\n");
+		return -1;
+	}
+
+	if (rte_pdump_enable_sample(portid, QUEUE_ID, flags, UINT32_MAX,
+				    ring, mp, NULL, &sample) < 0) {
+		printf("rte_pdump_enable_sample trigger failed\n");
+		return -1;
+	}
+
+	/* packets are only kept in the window until the trigger */
+	rte_delay_ms(100);
+	n = rte_ring_count(ring);
+	rte_pdump_stats(portid, &stats);
+	if (n != 0 || stats.accepted != before.accepted ||
+	    stats.triggers != before.triggers) {
+		printf("%u packets captured before the trigger\n", n);
+		rte_pdump_disable(portid, QUEUE_ID, flags);
+		return -1;
+	}
+
+	if (rte_pdump_trigger(portid) < 0) {
+		printf("rte_pdump_trigger failed\n");
+		rte_pdump_disable(portid, QUEUE_ID, flags);
+		return -1;
+	}
+
+	/* the trigger count is updated once the window is dumped */
+	for (itr = 0; itr < 100 && stats.triggers == before.triggers; itr++) {
+		rte_delay_ms(10);
+		rte_pdump_stats(portid, &stats);
+	}
+
+	if (rte_pdump_disable(portid, QUEUE_ID, flags) < 0) {
+		printf("rte_pdump_disable failed\n");
+		return -1;
+	}
+	n = drain_ring(ring);
+	rte_pdump_stats(portid, &stats);
+
+	printf("triggered capture: %u packets dumped\n", n);
+
+	/* the window was full, as packets were sent long enough */
+	if (stats.triggers - before.triggers != 1 || n != SAMPLE_WINDOW ||
+	    stats.accepted - before.accepted != SAMPLE_WINDOW) {
+		printf("trigger dumped %u packets, window of %u\n",
+		       n, SAMPLE_WINDOW);
+		return -1;
+	}
+
+	return 0;
+}
+
 int
 run_pdump_client_tests(void)
 {
@@ -52,6 +355,13 @@ run_pdump_client_tests(void)
 	struct rte_mempool *mp = NULL;
 	struct rte_eth_dev *eth_dev = NULL;
 	char poolname[] = "mbuf_pool_client";
+	struct rte_pdump_sample sample = {
+		.mode = RTE_PDUMP_SAMPLE_FLOW,
+		.rate = 8,
+		.window = 64,
+		.triggers = RTE_PDUMP_TRIGGER_MANUAL | RTE_PDUMP_TRIGGER_DROPS,
+		.drop_threshold = 1,
+	};
 
 	ret = test_get_mempool(&mp, poolname);
 	if (ret < 0)
@@ -111,6 +421,44 @@ run_pdump_client_tests(void)
 			printf("\n***** flags = RTE_PDUMP_FLAG_RXTX *****\n");
 		}
 	}
+
+	printf("\n***** sampled and triggered capture *****\n");
+
+	ret = rte_pdump_enable_sample(portid, QUEUE_ID, flags, UINT32_MAX,
+				      ring_client, mp, NULL, &sample);
+	if (ret < 0) {
+		printf("rte_pdump_enable_sample failed\n");
+		return -1;
+	}
+	printf("pdump_enable_sample success\n");
+
+	ret = rte_pdump_trigger(portid);
+	if (ret < 0) {
+		printf("rte_pdump_trigger failed\n");
+		return -1;
+	}
+
+	ret = rte_pdump_disable(portid, QUEUE_ID, flags);
+	if (ret < 0) {
+		printf("rte_pdump_disable failed\n");
+		return -1;
+	}
+	printf("pdump_disable success\n");
+
+	if (run_pdump_sample_count_test(ring_client, mp) < 0 ||
+	    run_pdump_trigger_test(ring_client, mp) < 0)
+		return -1;
+
+	/* a filter trigger needs a filter */
+	sample.triggers = RTE_PDUMP_TRIGGER_FILTER;
+	ret = rte_pdump_enable_sample(portid, QUEUE_ID, flags, UINT32_MAX,
+				      ring_client, mp, NULL, &sample);
+	if (ret == 0) {
+		printf("rte_pdump_enable_sample accepted filter trigger without filter\n");
+		return -1;
+	}
+	ret = run_pdump_zero_copy_tests();
+
 	if (ring_client != NULL)
 		test_ring_free(ring_client);
 	if (mp != NULL)
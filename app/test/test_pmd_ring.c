@@ -9,6 +9,7 @@
 #include <rte_eth_ring.h>
 #include <rte_ethdev.h>
 #include <rte_bus_vdev.h>
+#include <rte_malloc.h>
 
 #define SOCKET0 0
 #define RING_SIZE 256
@@ -557,6 +558,95 @@ test_ethdev_configure_ports(void)
 	return TEST_SUCCESS;
 }
 
+#define CB_NB_PKTS 40
+
+static struct rte_mbuf cb_bufs[CB_NB_PKTS];
+static uint16_t cb_max_seen;
+
+static uint16_t
+test_cb_count(uint16_t port_id __rte_unused, uint16_t queue __rte_unused,
+	struct rte_mbuf *pkts[] __rte_unused, uint16_t nb_pkts,
+	uint16_t max_pkts __rte_unused, void *user_param __rte_unused)
+{
+	cb_max_seen = RTE_MAX(cb_max_seen, nb_pkts);
+	return nb_pkts;
+}
+
+/* Drop the packets at odd positions of the transmitted burst */
+static uint16_t
+test_cb_drop_odd(uint16_t port_id __rte_unused, uint16_t queue __rte_unused,
+	struct rte_mbuf *pkts[], uint16_t nb_pkts,
+	uint16_t max_pkts __rte_unused, void *user_param __rte_unused)
+{
+	uint16_t i, n = 0;
+
+	for (i = 0; i < nb_pkts; i++)
+		if (((pkts[i] - cb_bufs) & 1) == 0)
+			pkts[n++] = pkts[i];
+
+	return n;
+}
+
+static int
+test_rx_window_callbacks(void)
+{
+	struct rte_eth_rxtx_callback_stats stats[4];
+	const struct rte_eth_rxtx_callback *cb[3];
+	struct rte_mbuf *pbufs[RING_SIZE];
+	int i, n;
+
+	cb[0] = rte_eth_add_rx_callback(rx_portb, 0, test_cb_count, NULL);
+	if (cb[0] == NULL && rte_errno == ENOTSUP)
+		return TEST_SKIPPED;
+	cb[1] = rte_eth_add_rx_callback(rx_portb, 0, test_cb_drop_odd, NULL);
+	cb[2] = rte_eth_add_rx_callback(rx_portb, 0, test_cb_count, NULL);
+	TEST_ASSERT(cb[0] != NULL && cb[1] != NULL && cb[2] != NULL,
+			"Failed to add Rx callbacks");
+
+	TEST_ASSERT(rte_eth_rxtx_callback_flags_set(cb[0], UINT32_MAX) ==
+			-EINVAL, "Invalid callback flags accepted");
+	TEST_ASSERT_SUCCESS(rte_eth_rxtx_callback_flags_set(cb[0],
+			RTE_ETH_RXTX_CALLBACK_F_PKT_WINDOW |
+			RTE_ETH_RXTX_CALLBACK_F_STATS),
+			"Failed to set callback flags");
+	TEST_ASSERT_SUCCESS(rte_eth_rxtx_callback_flags_set(cb[1],
+			RTE_ETH_RXTX_CALLBACK_F_PKT_WINDOW),
+			"Failed to set callback flags");
+
+	for (i = 0; i < CB_NB_PKTS; i++)
+		pbufs[i] = &cb_bufs[i];
+
+	TEST_ASSERT_EQUAL(rte_eth_tx_burst(tx_porta, 0, pbufs, CB_NB_PKTS),
+			CB_NB_PKTS, "Failed to transmit packet burst");
+
+	/* Only the last callback is called on the whole burst */
+	cb_max_seen = 0;
+	n = rte_eth_rx_burst(rx_portb, 0, pbufs, RING_SIZE);
+	TEST_ASSERT_EQUAL(n, CB_NB_PKTS / 2, "Unexpected packets received");
+	TEST_ASSERT_EQUAL(cb_max_seen, CB_NB_PKTS / 2,
+			"Last callback not called on the whole burst");
+	for (i = 0; i < n; i++)
+		TEST_ASSERT(pbufs[i] == &cb_bufs[i * 2],
+				"Packet order not preserved");
+
+	n = rte_eth_rx_callback_stats_get(rx_portb, 0, stats, RTE_DIM(stats));
+	TEST_ASSERT_EQUAL(n, 3, "Unexpected callback stats number");
+	TEST_ASSERT(stats[0].cb == cb[0] && stats[1].cb == cb[1] &&
+			stats[2].cb == cb[2], "Unexpected callback stats order");
+	TEST_ASSERT(stats[0].calls > 1 && stats[0].pkts == CB_NB_PKTS,
+			"Packet window callback stats not accounted");
+	TEST_ASSERT(stats[1].calls == 0 && stats[2].calls == 0,
+			"Callback stats accounted while disabled");
+
+	for (i = 0; i < 3; i++) {
+		TEST_ASSERT_SUCCESS(rte_eth_remove_rx_callback(rx_portb, 0,
+				cb[i]), "Failed to remove Rx callback");
+		rte_free((void *)(uintptr_t)cb[i]);
+	}
+
+	return TEST_SUCCESS;
+}
+
 static int
 test_get_stats_for_port(void)
 {
@@ -579,6 +669,7 @@ unit_test_suite test_pmd_ring_suite  = {
 	.unit_test_cases = {
 		TEST_CASE(test_ethdev_configure_ports),
 		TEST_CASE(test_send_basic_packets),
+		TEST_CASE(test_rx_window_callbacks),
 		TEST_CASE(test_get_stats_for_port),
 		TEST_CASE(test_stats_reset_for_port),
 		TEST_CASE(test_pmd_ring_pair_create_attach),
@@ -104,14 +104,14 @@ test_rcu_qsbr_get_memsize(void)
 
 	sz = rte_rcu_qsbr_get_memsize(128);
 	/* For 128 threads,
-	 * for machines with cache line size of 64B - 8384
-	 * for machines with cache line size of 128 - 16768
+	 * for machines with cache line size of 64B - 8448
+	 * for machines with cache line size of 128 - 16896
 	 */
 	if (RTE_CACHE_LINE_SIZE == 64)
-		TEST_RCU_QSBR_RETURN_IF_ERROR((sz != 8384),
+		TEST_RCU_QSBR_RETURN_IF_ERROR((sz != 8448),
 			"Get Memsize for 128 threads");
 	else if (RTE_CACHE_LINE_SIZE == 128)
-		TEST_RCU_QSBR_RETURN_IF_ERROR((sz != 16768),
+		TEST_RCU_QSBR_RETURN_IF_ERROR((sz != 16896),
 			"Get Memsize for 128 threads");
 
 	return 0;
@@ -523,6 +523,58 @@ test_rcu_qsbr_thread_online(void)
 	return 0;
 }
 
+/*
+ * rte_rcu_qsbr_read_enter/exit: only the reader threads in a read-side
+ * critical section started before the grace period are waited on.
+ */
+static int
+test_rcu_qsbr_read_section(void)
+{
+	int ret;
+	uint64_t token;
+
+	printf("\nTest rte_rcu_qsbr_read_enter()/rte_rcu_qsbr_read_exit()\n");
+
+	rte_rcu_qsbr_init(t[0], RTE_MAX_LCORE);
+
+	rte_rcu_qsbr_thread_register(t[0], enabled_core_ids[0]);
+
+	/* A registered thread out of any critical section is not waited on */
+	token = rte_rcu_qsbr_start(t[0]);
+	ret = rte_rcu_qsbr_check(t[0], token, false);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret == 0), "out of critical section");
+
+	rte_rcu_qsbr_read_enter(t[0], enabled_core_ids[0]);
+	token = rte_rcu_qsbr_start(t[0]);
+	ret = rte_rcu_qsbr_check(t[0], token, false);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0), "in critical section");
+
+	/* Exiting a nested critical section does not end the outer one */
+	rte_rcu_qsbr_read_enter(t[0], enabled_core_ids[0]);
+	rte_rcu_qsbr_read_exit(t[0], enabled_core_ids[0]);
+	ret = rte_rcu_qsbr_check(t[0], token, false);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0), "nested critical section");
+
+	rte_rcu_qsbr_read_exit(t[0], enabled_core_ids[0]);
+	ret = rte_rcu_qsbr_check(t[0], token, false);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret == 0), "critical section exit");
+
+	/* A critical section started after the grace period is not waited
+	 * on.
+	 */
+	token = rte_rcu_qsbr_start(t[0]);
+	rte_rcu_qsbr_read_enter(t[0], enabled_core_ids[0]);
+	ret = rte_rcu_qsbr_check(t[0], token, false);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret == 0), "later critical section");
+
+	token = rte_rcu_qsbr_start(t[0]);
+	ret = rte_rcu_qsbr_check(t[0], token, false);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0), "in critical section");
+	rte_rcu_qsbr_read_exit(t[0], enabled_core_ids[0]);
+
+	return 0;
+}
+
 /*
  * rte_rcu_qsbr_thread_offline: Remove a registered reader thread, from
  * the list of threads reporting their quiescent state on a QS variable.
@@ -683,6 +735,16 @@ test_rcu_qsbr_dq_create(void)
 	TEST_RCU_QSBR_RETURN_IF_ERROR((dq == NULL), "dq create valid params");
 	rte_rcu_qsbr_dq_delete(dq);
 
+	params.flags = RTE_RCU_QSBR_DQ_PER_LCORE;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq == NULL), "dq create valid params");
+	rte_rcu_qsbr_dq_delete(dq);
+
+	/* Per lcore defer queues are multi-thread safe */
+	params.flags = RTE_RCU_QSBR_DQ_PER_LCORE | RTE_RCU_QSBR_DQ_MT_UNSAFE;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq != NULL), "dq create invalid params");
+
 	return 0;
 }
 
@@ -815,6 +877,7 @@ test_rcu_qsbr_dq_functional(int32_t size, int32_t esize, uint32_t flags)
 	uint64_t *e;
 	uint64_t sc = 200;
 	int max_entries;
+	unsigned int freed, pending, available;
 
 	printf("\nTest rte_rcu_qsbr_dq_xxx functional tests()\n");
 	printf("Size = %d, esize = %d, flags = 0x%x\n", size, esize, flags);
@@ -846,6 +909,9 @@ test_rcu_qsbr_dq_functional(int32_t size, int32_t esize, uint32_t flags)
 	 * in capacity calculation of rte_ring).
 	 */
 	max_entries = rte_align32pow2(size + 1) - 1;
+	/* The defer queue of this lcore holds up to 1024 more entries */
+	if (flags & RTE_RCU_QSBR_DQ_PER_LCORE)
+		max_entries += rte_align32pow2(RTE_MIN(size, 1024));
 	printf("max_entries = %d\n", max_entries);
 
 	/* Enqueue few counters starting with the value 'sc' */
@@ -885,6 +951,14 @@ test_rcu_qsbr_dq_functional(int32_t size, int32_t esize, uint32_t flags)
 	ret = rte_rcu_qsbr_dq_enqueue(dq, e);
 	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (ret == 0), "defer queue is not full");
 
+	/* Nothing can be reclaimed and no space is available */
+	ret = rte_rcu_qsbr_dq_reclaim(dq, max_entries, &freed, &pending,
+					&available);
+	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (ret != 0 || freed != 0 ||
+		pending != (unsigned int)max_entries || available != 0),
+		"dq reclaim of a full queue, freed = %u, pending = %u, available = %u",
+		freed, pending, available);
+
 	/* Delete should fail as there are elements in defer queue which
 	 * cannot be reclaimed.
 	 */
@@ -908,8 +982,17 @@ test_rcu_qsbr_dq_functional(int32_t size, int32_t esize, uint32_t flags)
 	ret = rte_rcu_qsbr_dq_enqueue(dq, e);
 	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (ret == 0), "defer queue is not full");
 
-	/* Report quiescent state, delete should succeed */
+	/* Report quiescent state, everything is reclaimed */
 	rte_rcu_qsbr_quiescent(t[0], 1);
+	ret = rte_rcu_qsbr_dq_reclaim(dq, max_entries, &freed, &pending,
+					&available);
+	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (ret != 0 ||
+		freed != (unsigned int)max_entries || pending != 0 ||
+		available != (unsigned int)max_entries),
+		"dq reclaim of all resources, freed = %u, pending = %u, available = %u",
+		freed, pending, available);
+
+	/* Delete should succeed */
 	ret = rte_rcu_qsbr_dq_delete(dq);
 	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0), "dq delete valid params");
 
@@ -1375,6 +1458,9 @@ test_rcu_qsbr_main(void)
 	if (test_rcu_qsbr_thread_offline() < 0)
 		goto test_fail;
 
+	if (test_rcu_qsbr_read_section() < 0)
+		goto test_fail;
+
 	if (test_rcu_qsbr_dq_create() < 0)
 		goto test_fail;
 
@@ -1407,6 +1493,12 @@ test_rcu_qsbr_main(void)
 	if (test_rcu_qsbr_dq_functional(7, 128, RTE_RCU_QSBR_DQ_MT_UNSAFE) < 0)
 		goto test_fail;
 
+	if (test_rcu_qsbr_dq_functional(303, 16, RTE_RCU_QSBR_DQ_PER_LCORE) < 0)
+		goto test_fail;
+
+	if (test_rcu_qsbr_dq_functional(2000, 8, RTE_RCU_QSBR_DQ_PER_LCORE) < 0)
+		goto test_fail;
+
 	free_rcu();
 
 	printf("\n");
@@ -609,6 +609,117 @@ error:
 	return -1;
 }
 
+#define READ_SECTIONS 100000000
+
+/*
+ * Cost of the epoch based read-side critical sections, as used by reader
+ * threads which do not report their quiescent state periodically.
+ */
+static int
+test_rcu_qsbr_read_section_perf(void)
+{
+	uint64_t begin, cycles;
+	struct rte_rcu_qsbr *v;
+	unsigned int i;
+	size_t sz;
+
+	printf("\nPerf test: 1 reader, Read-side critical section enter/exit\n");
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	v = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (v == NULL) {
+		printf("Failed to allocate QS variable\n");
+		return -1;
+	}
+
+	rte_rcu_qsbr_init(v, RTE_MAX_LCORE);
+	rte_rcu_qsbr_thread_register(v, 0);
+
+	begin = rte_rdtsc_precise();
+	for (i = 0; i < READ_SECTIONS; i++) {
+		rte_rcu_qsbr_read_enter(v, 0);
+		rte_rcu_qsbr_read_exit(v, 0);
+	}
+	cycles = rte_rdtsc_precise() - begin;
+
+	printf("Cycles per %d critical sections: %"PRIi64"\n", RCU_SCALE_DOWN,
+		cycles / (READ_SECTIONS / RCU_SCALE_DOWN));
+
+	rte_free(v);
+	return 0;
+}
+
+#define SCALE_MAX_THREADS 256
+#define SCALE_ITERATIONS 100000
+#define SCALE_POLLS 16
+
+/*
+ * Single writer polling the QS variable with non-blocking checks, as done
+ * by the defer queue reclamation, while one of the reader threads lags
+ * behind the others. Thread IDs are not bound to lcores here, the readers
+ * quiescent state is reported by the writer itself.
+ */
+static int
+test_rcu_qsbr_scale(void)
+{
+	uint64_t poll_cycles, done_cycles, begin;
+	struct rte_rcu_qsbr *v;
+	unsigned int n, i, j, k;
+	uint64_t token;
+	size_t sz;
+
+	printf("\nPerf test: 1 writer, up to %d reader threads, 1 lagging thread, Non-Blocking QSBR check\n",
+		SCALE_MAX_THREADS);
+
+	sz = rte_rcu_qsbr_get_memsize(SCALE_MAX_THREADS);
+	v = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (v == NULL) {
+		printf("Failed to allocate QS variable\n");
+		return -1;
+	}
+
+	for (n = SCALE_MAX_THREADS / 4; n <= SCALE_MAX_THREADS; n *= 2) {
+		rte_rcu_qsbr_init(v, n);
+		for (i = 0; i < n; i++) {
+			rte_rcu_qsbr_thread_register(v, i);
+			rte_rcu_qsbr_thread_online(v, i);
+		}
+
+		poll_cycles = 0;
+		done_cycles = 0;
+		for (j = 0; j < SCALE_ITERATIONS; j++) {
+			token = rte_rcu_qsbr_start(v);
+			for (i = 0; i < n - 1; i++)
+				rte_rcu_qsbr_quiescent(v, i);
+
+			begin = rte_rdtsc_precise();
+			for (k = 0; k < SCALE_POLLS; k++)
+				if (rte_rcu_qsbr_check(v, token, false) != 0)
+					goto error;
+			poll_cycles += rte_rdtsc_precise() - begin;
+
+			rte_rcu_qsbr_quiescent(v, n - 1);
+
+			begin = rte_rdtsc_precise();
+			if (rte_rcu_qsbr_check(v, token, false) != 1)
+				goto error;
+			done_cycles += rte_rdtsc_precise() - begin;
+		}
+
+		printf("%u threads: cycles per pending check %.1f, per completed check %.1f\n",
+			n, (double)poll_cycles / (SCALE_ITERATIONS * SCALE_POLLS),
+			(double)done_cycles / SCALE_ITERATIONS);
+	}
+
+	rte_free(v);
+	return 0;
+
+error:
+	printf("Unexpected QSBR check result with %u threads\n", n);
+	rte_free(v);
+	return -1;
+}
+
 static int
 test_rcu_qsbr_main(void)
 {
@@ -653,6 +764,12 @@ test_rcu_qsbr_main(void)
 	if (test_rcu_qsbr_sw_sv_1qs_non_blocking() < 0)
 		goto test_fail;
 
+	if (test_rcu_qsbr_scale() < 0)
+		goto test_fail;
+
+	if (test_rcu_qsbr_read_section_perf() < 0)
+		goto test_fail;
+
 	/* Make sure the actual number of cores provided is less than
 	 * RTE_MAX_LCORE. This will allow for some threads not
 	 * to be registered on the QS variable.
@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <unistd.h>
 
 #include "test.h"
@@ -68,6 +69,18 @@ static struct rte_sched_subport_params subport_param[] = {
 	},
 };
 
+static struct rte_sched_pipe_group_params pipe_group_param = {
+	.tb_rate = 1250000000,
+	.tb_size = 1000000,
+};
+
+static struct rte_sched_port_share_params share_param = {
+	.socket = 0,
+	.rate = 0, /* computed */
+	.tb_size = 1000000,
+	.n_credits_per_grant = 16 * 1522,
+};
+
 static struct rte_sched_port_params port_param = {
 	.socket = 0, /* computed */
 	.rate = 0, /* computed */
@@ -80,7 +93,7 @@ static struct rte_sched_port_params port_param = {
 	.n_pipes_per_subport = 1024,
 };
 
-#define NB_MBUF          32
+#define NB_MBUF          512
 #define MBUF_DATA_SZ     (2048 + RTE_PKTMBUF_HEADROOM)
 #define MEMPOOL_CACHE_SZ 0
 #define SOCKET           0
@@ -131,6 +144,199 @@ prepare_pkt(struct rte_sched_port *port, struct rte_mbuf *mbuf)
 	mbuf->data_len = 60;
 }
 
+/* Port with one subport and all its pipes configured with profile #0 */
+static struct rte_sched_port *
+create_port(void)
+{
+	struct rte_sched_port *port;
+	uint32_t pipe;
+
+	port = rte_sched_port_config(&port_param);
+	if (port == NULL)
+		return NULL;
+
+	if (rte_sched_subport_config(port, SUBPORT, subport_param, 0) != 0)
+		goto error;
+
+	for (pipe = 0; pipe < subport_param[0].n_pipes_per_subport_enabled; pipe++)
+		if (rte_sched_pipe_config(port, SUBPORT, pipe, 0) != 0)
+			goto error;
+
+	return port;
+
+error:
+	rte_sched_port_free(port);
+	return NULL;
+}
+
+/* Enqueue n_pkts 64 byte packets to each of the pipes [0, n_pipes) */
+static int
+enqueue_pipes(struct rte_sched_port *port, struct rte_mempool *mp,
+	uint32_t n_pipes, uint32_t n_pkts)
+{
+	struct rte_mbuf *mbuf;
+	uint32_t pipe, i;
+	int count = 0;
+
+	for (pipe = 0; pipe < n_pipes; pipe++)
+		for (i = 0; i < n_pkts; i++) {
+			mbuf = rte_pktmbuf_alloc(mp);
+			if (mbuf == NULL)
+				return count;
+
+			mbuf->pkt_len = 60;
+			mbuf->data_len = 60;
+			rte_sched_port_pkt_write(port, mbuf, SUBPORT, pipe, TC,
+				QUEUE, RTE_COLOR_GREEN);
+			count += rte_sched_port_enqueue(port, &mbuf, 1);
+		}
+
+	return count;
+}
+
+/* Dequeue from the ports until the deadline, return the bytes sent */
+static uint64_t
+dequeue_until(struct rte_sched_port **ports, uint32_t n_ports,
+	uint64_t deadline)
+{
+	struct rte_mbuf *out_mbufs[32];
+	uint64_t bytes = 0;
+	uint32_t i;
+	int n, j;
+
+	while (rte_get_tsc_cycles() < deadline)
+		for (i = 0; i < n_ports; i++) {
+			n = rte_sched_port_dequeue(ports[i], out_mbufs,
+				RTE_DIM(out_mbufs));
+			for (j = 0; j < n; j++) {
+				bytes += out_mbufs[j]->pkt_len +
+					port_param.frame_overhead;
+				rte_pktmbuf_free(out_mbufs[j]);
+			}
+		}
+
+	return bytes;
+}
+
+#define GROUP_PIPES      4
+/* Less than the queue size, so the queues are not full when freed */
+#define GROUP_PKTS       24
+#define GROUP_RATE       100000
+#define GROUP_TB_SIZE    1000
+#define TEST_DURATION_MS 20
+
+/*
+ * The pipes of a group together can send much more than the group rate:
+ * check the group token bucket caps what is dequeued from them.
+ */
+static int
+test_sched_pipe_group_rate(struct rte_mempool *mp)
+{
+	struct rte_sched_pipe_group_params params = {
+		.tb_rate = GROUP_RATE,
+		.tb_size = GROUP_TB_SIZE,
+	};
+	struct rte_sched_port *port;
+	uint64_t hz = rte_get_tsc_hz();
+	uint64_t start, end, bytes, max_bytes;
+	int err, n;
+
+	start = rte_get_tsc_cycles();
+	port = create_port();
+	TEST_ASSERT_NOT_NULL(port, "Error config sched port\n");
+
+	err = rte_sched_subport_pipe_group_config(port, SUBPORT, GROUP_PIPES);
+	TEST_ASSERT_SUCCESS(err, "Error config sched pipe groups, err=%d\n", err);
+
+	err = rte_sched_pipe_group_config(port, SUBPORT, 0, &params);
+	TEST_ASSERT_SUCCESS(err, "Error config sched pipe group, err=%d\n", err);
+
+	n = enqueue_pipes(port, mp, GROUP_PIPES, GROUP_PKTS);
+	TEST_ASSERT_EQUAL(n, GROUP_PIPES * GROUP_PKTS, "Wrong enqueue, n=%d\n", n);
+
+	bytes = dequeue_until(&port, 1, rte_get_tsc_cycles() +
+		hz * TEST_DURATION_MS / 1000);
+	end = rte_get_tsc_cycles();
+
+	/* Full bucket, refill since the group was created and one packet */
+	max_bytes = GROUP_TB_SIZE + GROUP_RATE * (end - start) / hz + 60 +
+		port_param.frame_overhead;
+
+	rte_sched_port_free(port);
+
+	TEST_ASSERT(bytes > 0, "Nothing dequeued from the pipe group\n");
+	TEST_ASSERT(bytes <= max_bytes,
+		"Pipe group sent %" PRIu64 " bytes, above its rate (%" PRIu64 ")\n",
+		bytes, max_bytes);
+
+	return 0;
+}
+
+#define SHARE_PORTS      2
+#define SHARE_RATE       100000
+#define SHARE_TB_SIZE    2000
+#define SHARE_GRANT      500
+
+/*
+ * The subports of the ports attached to a shared budget together can send
+ * much more than the budget rate: check the budget caps what is dequeued from
+ * all the ports.
+ */
+static int
+test_sched_port_share_rate(struct rte_mempool *mp)
+{
+	struct rte_sched_port_share_params params = {
+		.socket = 0,
+		.rate = SHARE_RATE,
+		.tb_size = SHARE_TB_SIZE,
+		.n_credits_per_grant = SHARE_GRANT,
+	};
+	struct rte_sched_port *ports[SHARE_PORTS];
+	struct rte_sched_port_share *share;
+	uint64_t hz = rte_get_tsc_hz();
+	uint64_t start, end, bytes, max_bytes;
+	int err, n, i;
+
+	start = rte_get_tsc_cycles();
+	share = rte_sched_port_share_create(&params);
+	TEST_ASSERT_NOT_NULL(share, "Error creating sched port share\n");
+
+	for (i = 0; i < SHARE_PORTS; i++) {
+		ports[i] = create_port();
+		TEST_ASSERT_NOT_NULL(ports[i], "Error config sched port\n");
+
+		err = rte_sched_port_share_attach(ports[i], share);
+		TEST_ASSERT_SUCCESS(err,
+			"Error attaching sched port share, err=%d\n", err);
+
+		n = enqueue_pipes(ports[i], mp, GROUP_PIPES, GROUP_PKTS);
+		TEST_ASSERT_EQUAL(n, GROUP_PIPES * GROUP_PKTS,
+			"Wrong enqueue, n=%d\n", n);
+	}
+
+	bytes = dequeue_until(ports, SHARE_PORTS, rte_get_tsc_cycles() +
+		hz * TEST_DURATION_MS / 1000);
+	end = rte_get_tsc_cycles();
+
+	/*
+	 * Full budget, refill since the budget was created and one packet per
+	 * port, as a port sends its last packet while it still has credits.
+	 */
+	max_bytes = SHARE_TB_SIZE + SHARE_RATE * (end - start) / hz +
+		SHARE_PORTS * (60 + port_param.frame_overhead);
+
+	for (i = 0; i < SHARE_PORTS; i++)
+		rte_sched_port_free(ports[i]);
+	rte_sched_port_share_free(share);
+
+	TEST_ASSERT(bytes > 0, "Nothing dequeued from the ports\n");
+	TEST_ASSERT(bytes <= max_bytes,
+		"Ports sent %" PRIu64 " bytes, above the shared rate (%" PRIu64 ")\n",
+		bytes, max_bytes);
+
+	return 0;
+}
+
 
 /**
  * test main entrance for library sched
@@ -140,6 +346,8 @@ test_sched(void)
 {
 	struct rte_mempool *mp = NULL;
 	struct rte_sched_port *port = NULL;
+	struct rte_sched_port_share *share = NULL;
+	struct rte_ring *ring = NULL;
 	uint32_t pipe;
 	struct rte_mbuf *in_mbufs[10];
 	struct rte_mbuf *out_mbufs[10];
@@ -164,6 +372,29 @@ test_sched(void)
 		TEST_ASSERT_SUCCESS(err, "Error config sched pipe %u, err=%d\n", pipe, err);
 	}
 
+	err = rte_sched_subport_pipe_group_config(port, SUBPORT, 3);
+	TEST_ASSERT_FAIL(err, "Pipe group size not power of 2 accepted\n");
+
+	err = rte_sched_subport_pipe_group_config(port, SUBPORT, 4);
+	TEST_ASSERT_SUCCESS(err, "Error config sched pipe groups, err=%d\n", err);
+
+	err = rte_sched_pipe_group_config(port, SUBPORT, PIPE / 4, &pipe_group_param);
+	TEST_ASSERT_SUCCESS(err, "Error config sched pipe group, err=%d\n", err);
+
+	share_param.rate = port_param.rate;
+	share = rte_sched_port_share_create(&share_param);
+	TEST_ASSERT_NOT_NULL(share, "Error creating sched port share\n");
+
+	err = rte_sched_port_share_attach(port, share);
+	TEST_ASSERT_SUCCESS(err, "Error attaching sched port share, err=%d\n", err);
+
+	err = rte_sched_port_share_attach(port, share);
+	TEST_ASSERT_FAIL(err, "Port attached twice to a shared budget\n");
+
+	ring = rte_ring_create("test_sched", 16, SOCKET,
+		RING_F_SP_ENQ | RING_F_SC_DEQ);
+	TEST_ASSERT_NOT_NULL(ring, "Error creating ring\n");
+
 	for (i = 0; i < 10; i++) {
 		in_mbufs[i] = rte_pktmbuf_alloc(mp);
 		TEST_ASSERT_NOT_NULL(in_mbufs[i], "Packet allocation failed\n");
@@ -171,7 +402,10 @@ test_sched(void)
 	}
 
 
-	err = rte_sched_port_enqueue(port, in_mbufs, 10);
+	err = rte_ring_sp_enqueue_burst(ring, (void **)in_mbufs, 10, NULL);
+	TEST_ASSERT_EQUAL(err, 10, "Wrong ring enqueue, err=%d\n", err);
+
+	err = rte_sched_port_enqueue_rings(port, &ring, 1, 10);
 	TEST_ASSERT_EQUAL(err, 10, "Wrong enqueue, err=%d\n", err);
 
 	err = rte_sched_port_dequeue(port, out_mbufs, 10);
@@ -209,6 +443,14 @@ test_sched(void)
 #endif
 
 	rte_sched_port_free(port);
+	rte_sched_port_share_free(share);
+	rte_ring_free(ring);
+
+	err = test_sched_pipe_group_rate(mp);
+	TEST_ASSERT_SUCCESS(err, "Pipe group rate test failed\n");
+
+	err = test_sched_port_share_rate(mp);
+	TEST_ASSERT_SUCCESS(err, "Shared port rate test failed\n");
 
 	return 0;
 }
@@ -379,5 +379,28 @@ test_lf_stack(void)
 #endif
 }
 
+static int
+test_lf_elim_stack(void)
+{
+#if defined(RTE_STACK_LF_SUPPORTED)
+	struct rte_stack *s;
+
+	/* Elimination is only available on top of the lock-free stack */
+	s = rte_stack_create("test", STACK_SIZE, rte_socket_id(),
+			     RTE_STACK_F_LF_ELIM);
+	if (s != NULL || rte_errno != EINVAL) {
+		printf("[%s():%u] created an elimination stack without LF\n",
+		       __func__, __LINE__);
+		rte_stack_free(s);
+		return -1;
+	}
+
+	return __test_stack(RTE_STACK_F_LF | RTE_STACK_F_LF_ELIM);
+#else
+	return TEST_SKIPPED;
+#endif
+}
+
 REGISTER_TEST_COMMAND(stack_autotest, test_stack);
 REGISTER_TEST_COMMAND(stack_lf_autotest, test_lf_stack);
+REGISTER_TEST_COMMAND(stack_lf_elim_autotest, test_lf_elim_stack);
@@ -16,6 +16,7 @@
 #define STACK_NAME "STACK_PERF"
 #define MAX_BURST 32
 #define STACK_SIZE (RTE_MAX_LCORE * MAX_BURST)
+#define MAX_CURVE_LCORES 64
 
 /*
  * Push/pop bulk sizes, marked volatile so they aren't treated as compile-time
@@ -299,6 +300,7 @@ __test_stack_perf(uint32_t flags)
 {
 	struct lcore_pair cores;
 	struct rte_stack *s;
+	unsigned int n;
 
 	__atomic_store_n(&lcore_barrier, 0, __ATOMIC_RELAXED);
 
@@ -331,6 +333,12 @@ __test_stack_perf(uint32_t flags)
 		run_on_core_pair(&cores, s, bulk_push_pop);
 	}
 
+	/* Scaling curve, to show how contention on the head grows */
+	for (n = 2; n <= MAX_CURVE_LCORES && n < rte_lcore_count(); n *= 2) {
+		printf("\n### Testing on %u lcores ###\n", n);
+		run_on_n_cores(s, bulk_push_pop, n);
+	}
+
 	printf("\n### Testing on all %u lcores ###\n", rte_lcore_count());
 	run_on_n_cores(s, bulk_push_pop, rte_lcore_count());
 
@@ -354,5 +362,16 @@ test_lf_stack_perf(void)
 #endif
 }
 
+static int
+test_lf_elim_stack_perf(void)
+{
+#if defined(RTE_STACK_LF_SUPPORTED)
+	return __test_stack_perf(RTE_STACK_F_LF | RTE_STACK_F_LF_ELIM);
+#else
+	return TEST_SKIPPED;
+#endif
+}
+
 REGISTER_TEST_COMMAND(stack_perf_autotest, test_stack_perf);
 REGISTER_TEST_COMMAND(stack_lf_perf_autotest, test_lf_stack_perf);
+REGISTER_TEST_COMMAND(stack_lf_elim_perf_autotest, test_lf_elim_stack_perf);
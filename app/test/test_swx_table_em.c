@@ -0,0 +1,224 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_memory.h>
+#include <rte_swx_table_em.h>
+
+#include "test.h"
+
+#define KEY_SIZE 16
+#define ACTION_DATA_SIZE 8
+#define N_KEYS_MAX 256
+#define N_KEYS 200
+
+static const struct {
+	const char *name;
+	struct rte_swx_table_ops *ops;
+} table_types[] = {
+	{"exact_large", &rte_swx_table_exact_match_large_ops},
+	{"exact_large_unoptimized",
+	 &rte_swx_table_exact_match_large_unoptimized_ops},
+};
+
+/* All the keys in one bucket, with the same signature. */
+static uint32_t
+hash_const(const void *key __rte_unused, uint32_t length __rte_unused,
+	   uint32_t seed __rte_unused)
+{
+	return 0;
+}
+
+/* Keys spread over a few buckets, with few signatures. */
+static uint32_t
+hash_few(const void *key, uint32_t length __rte_unused,
+	 uint32_t seed __rte_unused)
+{
+	uint32_t k = ((const uint8_t *)key)[0];
+
+	return (k & 3) | (k & 4) << 16;
+}
+
+static const struct {
+	const char *name;
+	rte_swx_hash_func_t func;
+} hash_funcs[] = {
+	{"default", NULL},
+	{"const", hash_const},
+	{"few", hash_few},
+};
+
+static void
+key_get(uint8_t *key, uint32_t id)
+{
+	memset(key, 0, KEY_SIZE);
+	memcpy(key, &id, sizeof(id));
+	key[KEY_SIZE - 1] = 0x5A;
+}
+
+static int
+key_add(struct rte_swx_table_ops *ops, void *table, uint32_t id,
+	uint64_t action_id)
+{
+	uint8_t key[KEY_SIZE], action_data[ACTION_DATA_SIZE];
+	struct rte_swx_table_entry entry = {
+		.key = key,
+		.action_id = action_id,
+		.action_data = action_data,
+	};
+
+	key_get(key, id);
+	memcpy(action_data, &action_id, sizeof(action_id));
+	return ops->add(table, &entry);
+}
+
+static int
+key_del(struct rte_swx_table_ops *ops, void *table, uint32_t id)
+{
+	uint8_t key[KEY_SIZE];
+	struct rte_swx_table_entry entry = {
+		.key = key,
+	};
+
+	key_get(key, id);
+	return ops->del(table, &entry);
+}
+
+/* Return the action id of a key, or -1 on miss or wrong action data. */
+static int64_t
+key_lookup(struct rte_swx_table_ops *ops, void *table, uint32_t id)
+{
+	uint8_t mailbox[RTE_CACHE_LINE_SIZE] __rte_cache_aligned = {0};
+	uint8_t key[KEY_SIZE], *key_ptr = key;
+	uint8_t *action_data;
+	uint64_t action_id;
+	size_t entry_id;
+	int hit;
+
+	key_get(key, id);
+	while (!ops->lkp(table, mailbox, &key_ptr, &action_id, &action_data,
+			 &entry_id, &hit))
+		;
+
+	if (!hit || memcmp(action_data, &action_id, sizeof(action_id)))
+		return -1;
+
+	return action_id;
+}
+
+static int
+table_check(struct rte_swx_table_ops *ops, void *table, uint32_t n_keys,
+	    int del_even, uint64_t even_offset)
+{
+	uint32_t i;
+
+	for (i = 0; i < n_keys; i++) {
+		int64_t expected = i;
+
+		if (!(i & 1)) {
+			if (del_even)
+				expected = -1;
+			else
+				expected += even_offset;
+		}
+
+		if (key_lookup(ops, table, i) != expected) {
+			printf("Key %u: lookup %" PRId64 ", expected %" PRId64 "\n",
+			       i, key_lookup(ops, table, i), expected);
+			return -1;
+		}
+	}
+
+	/* Keys never added miss. */
+	for (i = n_keys; i < N_KEYS_MAX; i++)
+		if (key_lookup(ops, table, i) != -1) {
+			printf("Key %u not added hits\n", i);
+			return -1;
+		}
+
+	return 0;
+}
+
+static int
+test_table(struct rte_swx_table_ops *ops, rte_swx_hash_func_t hash_func)
+{
+	struct rte_swx_table_params params = {
+		.match_type = RTE_SWX_TABLE_MATCH_EXACT,
+		.key_size = KEY_SIZE,
+		.action_data_size = ACTION_DATA_SIZE,
+		.hash_func = hash_func,
+		.n_keys_max = N_KEYS_MAX,
+	};
+	void *table;
+	uint32_t i;
+	int ret = -1;
+
+	table = ops->create(&params, NULL, NULL, SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(table, "Table creation failed");
+
+	for (i = 0; i < N_KEYS; i++)
+		if (key_add(ops, table, i, i))
+			goto out;
+	if (table_check(ops, table, N_KEYS, 0, 0))
+		goto out;
+
+	/* Deleted keys miss, the others still hit. */
+	for (i = 0; i < N_KEYS; i += 2)
+		if (key_del(ops, table, i))
+			goto out;
+	if (table_check(ops, table, N_KEYS, 1, 0))
+		goto out;
+
+	/* Deleted keys are added back, then updated in place. */
+	for (i = 0; i < N_KEYS; i += 2)
+		if (key_add(ops, table, i, i + N_KEYS_MAX))
+			goto out;
+	if (table_check(ops, table, N_KEYS, 0, N_KEYS_MAX))
+		goto out;
+	for (i = 0; i < N_KEYS; i += 2)
+		if (key_add(ops, table, i, i + 2 * N_KEYS_MAX))
+			goto out;
+	if (table_check(ops, table, N_KEYS, 0, 2 * N_KEYS_MAX))
+		goto out;
+
+	/* Updates and re-adds did not use any key on top of the N_KEYS. */
+	for (i = N_KEYS; i < N_KEYS_MAX; i++)
+		if (key_add(ops, table, i, i & 1 ? i : i + 2 * N_KEYS_MAX))
+			goto out;
+	if (key_add(ops, table, N_KEYS_MAX, N_KEYS_MAX) != -ENOSPC)
+		goto out;
+	if (table_check(ops, table, N_KEYS_MAX, 0, 2 * N_KEYS_MAX))
+		goto out;
+
+	ret = 0;
+out:
+	ops->free(table);
+	return ret;
+}
+
+static int
+test_swx_table_em(void)
+{
+	uint32_t i, j;
+
+	for (i = 0; i < RTE_DIM(table_types); i++)
+		for (j = 0; j < RTE_DIM(hash_funcs); j++) {
+			printf("Table %s, hash %s\n", table_types[i].name,
+			       hash_funcs[j].name);
+			TEST_ASSERT_SUCCESS(test_table(table_types[i].ops,
+						       hash_funcs[j].func),
+					    "Table %s with %s hash failed",
+					    table_types[i].name,
+					    hash_funcs[j].name);
+		}
+
+	return TEST_SUCCESS;
+}
+
+REGISTER_TEST_COMMAND(swx_table_em_autotest, test_swx_table_em);
@@ -0,0 +1,203 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_lcore.h>
+#include <rte_random.h>
+#include <rte_swx_table_em.h>
+
+#include "test.h"
+
+#define KEY_SIZE 16
+#define ACTION_DATA_SIZE 8
+
+/* Number of lookups in flight, as done by the pipeline for a burst. */
+#define LOOKUP_BULK 16
+#define LOOKUP_KEYS (1 << 16)
+#define LOOKUP_ITERATIONS 64
+
+static const uint32_t table_sizes[] = {
+	1 << 20,
+	4 << 20,
+	16 << 20,
+	64 << 20,
+	100000000,
+};
+
+static const struct {
+	const char *name;
+	struct rte_swx_table_ops *ops;
+} table_types[] = {
+	{"exact", &rte_swx_table_exact_match_ops},
+	{"exact_large", &rte_swx_table_exact_match_large_ops},
+};
+
+static uint8_t *lookup_keys[LOOKUP_KEYS];
+
+/* Keys are derived from their index so they do not have to be stored. */
+static void
+key_get(uint8_t *key, uint64_t id)
+{
+	uint64_t k[KEY_SIZE / sizeof(uint64_t)];
+
+	k[0] = id;
+	k[1] = ~id * 0x9E3779B97F4A7C15ULL;
+	memcpy(key, k, KEY_SIZE);
+}
+
+static int
+table_fill(struct rte_swx_table_ops *ops, void *table, uint32_t n_keys)
+{
+	uint8_t key[KEY_SIZE], action_data[ACTION_DATA_SIZE] = {0};
+	struct rte_swx_table_entry entry = {
+		.key = key,
+		.action_data = action_data,
+	};
+	uint32_t i;
+
+	for (i = 0; i < n_keys; i++) {
+		key_get(key, i);
+		entry.action_id = i;
+		if (ops->add(table, &entry))
+			return -1;
+	}
+
+	return 0;
+}
+
+static int
+table_lookup_perf(struct rte_swx_table_ops *ops, void *table,
+		  uint64_t *cycles, uint64_t *n_hits)
+{
+	uint8_t mailbox[LOOKUP_BULK][RTE_CACHE_LINE_SIZE] __rte_cache_aligned;
+	uint64_t start, hits = 0;
+	uint32_t i, j, k;
+
+	if (ops->mailbox_size_get && ops->mailbox_size_get() > RTE_CACHE_LINE_SIZE)
+		return -1;
+
+	memset(mailbox, 0, sizeof(mailbox));
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < LOOKUP_ITERATIONS; i++)
+		for (j = 0; j < LOOKUP_KEYS; j += LOOKUP_BULK) {
+			uint32_t done = 0;
+			int done_mask[LOOKUP_BULK] = {0};
+
+			/* Interleave the lookup stages of the whole bulk. */
+			while (done < LOOKUP_BULK)
+				for (k = 0; k < LOOKUP_BULK; k++) {
+					uint64_t action_id;
+					uint8_t *action_data;
+					size_t entry_id;
+					int hit;
+
+					if (done_mask[k])
+						continue;
+
+					if (ops->lkp(table, mailbox[k],
+						     &lookup_keys[j + k],
+						     &action_id, &action_data,
+						     &entry_id, &hit)) {
+						done_mask[k] = 1;
+						hits += hit;
+						done++;
+					}
+				}
+		}
+	*cycles = rte_rdtsc_precise() - start;
+	*n_hits = hits;
+
+	return 0;
+}
+
+static int
+test_swx_table_em_perf(void)
+{
+	uint32_t i, j, k;
+	int status = 0;
+
+	for (k = 0; k < LOOKUP_KEYS; k++) {
+		lookup_keys[k] = malloc(KEY_SIZE);
+		if (lookup_keys[k] == NULL) {
+			printf("Error allocating lookup keys\n");
+			status = -1;
+			goto free_keys;
+		}
+	}
+
+	printf("%-12s %12s %16s %12s\n",
+	       "Table", "Keys", "Cycles/lookup", "Mlookups/s");
+
+	for (i = 0; i < RTE_DIM(table_sizes); i++)
+		for (j = 0; j < RTE_DIM(table_types); j++) {
+			struct rte_swx_table_ops *ops = table_types[j].ops;
+			struct rte_swx_table_params params = {
+				.match_type = RTE_SWX_TABLE_MATCH_EXACT,
+				.key_size = KEY_SIZE,
+				.action_data_size = ACTION_DATA_SIZE,
+				.n_keys_max = table_sizes[i],
+			};
+			uint64_t cycles, hits, n_lookups;
+			void *table;
+
+			table = ops->create(&params, NULL, NULL,
+					    rte_socket_id());
+			if (table == NULL) {
+				printf("%-12s %12u: not enough memory, skipped\n",
+				       table_types[j].name, table_sizes[i]);
+				continue;
+			}
+
+			if (table_fill(ops, table, table_sizes[i])) {
+				printf("%-12s %12u: table fill failed\n",
+				       table_types[j].name, table_sizes[i]);
+				ops->free(table);
+				status = -1;
+				goto free_keys;
+			}
+
+			for (k = 0; k < LOOKUP_KEYS; k++)
+				key_get(lookup_keys[k],
+					rte_rand_max(table_sizes[i]));
+
+			if (table_lookup_perf(ops, table, &cycles, &hits)) {
+				ops->free(table);
+				status = -1;
+				goto free_keys;
+			}
+			ops->free(table);
+
+			n_lookups = (uint64_t)LOOKUP_KEYS * LOOKUP_ITERATIONS;
+			if (hits != n_lookups) {
+				printf("%-12s %12u: %" PRIu64 " misses\n",
+				       table_types[j].name, table_sizes[i],
+				       n_lookups - hits);
+				status = -1;
+				goto free_keys;
+			}
+
+			printf("%-12s %12u %16.1f %12.1f\n",
+			       table_types[j].name, table_sizes[i],
+			       (double)cycles / n_lookups,
+			       (double)n_lookups * rte_get_tsc_hz() / cycles / 1E6);
+		}
+
+free_keys:
+	for (k = 0; k < LOOKUP_KEYS; k++) {
+		free(lookup_keys[k]);
+		lookup_keys[k] = NULL;
+	}
+
+	return status;
+}
+
+REGISTER_TEST_COMMAND(swx_table_em_perf_autotest, test_swx_table_em_perf);
@@ -0,0 +1,312 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_memory.h>
+#include <rte_swx_table_learner.h>
+
+#include "test.h"
+
+#define KEY_SIZE 8
+#define ACTION_DATA_SIZE 8
+#define N_KEYS_MAX 64
+#define N_KEYS 32
+
+/* Key timeouts, in seconds, long enough for the 2^32 cycles granularity of the key time. */
+static uint32_t key_timeouts[] = {10, 100};
+
+/* All the keys in one bucket, with different signatures. */
+static uint32_t
+hash_one_bucket(const void *key, uint32_t length __rte_unused, uint32_t seed __rte_unused)
+{
+	return (uint32_t)((const uint8_t *)key)[0] << 16;
+}
+
+struct learner_test {
+	void *table;
+	uint8_t mailbox[RTE_CACHE_LINE_SIZE] __rte_cache_aligned;
+	uint8_t key[KEY_SIZE];
+	uint64_t sec;
+	uint64_t now;
+};
+
+static void *
+table_create(rte_swx_hash_func_t hash_func)
+{
+	struct rte_swx_table_learner_params params = {
+		.key_size = KEY_SIZE,
+		.action_data_size = ACTION_DATA_SIZE,
+		.hash_func = hash_func,
+		.n_keys_max = N_KEYS_MAX,
+		.key_timeout = key_timeouts,
+		.n_key_timeouts = RTE_DIM(key_timeouts),
+	};
+
+	return rte_swx_table_learner_create(&params, SOCKET_ID_ANY);
+}
+
+/* Look a key up, leaving the result in the mailbox for the add, rearm and delete operations. */
+static int
+key_lookup(struct learner_test *lt, uint32_t id)
+{
+	uint8_t *key = lt->key, *action_data;
+	uint64_t action_id;
+	size_t entry_id;
+	int hit;
+
+	memset(lt->key, 0, sizeof(lt->key));
+	memcpy(lt->key, &id, sizeof(id));
+	while (!rte_swx_table_learner_lookup(lt->table, lt->mailbox, lt->now, &key, &action_id,
+					     &action_data, &entry_id, &hit))
+		;
+
+	if (hit && (action_id != id || memcmp(action_data, &action_id, sizeof(action_id))))
+		return -1;
+
+	return hit;
+}
+
+static int
+key_add(struct learner_test *lt, uint32_t id, uint32_t key_timeout_id)
+{
+	uint64_t action_id = id;
+
+	if (key_lookup(lt, id))
+		return -1;
+
+	return rte_swx_table_learner_add(lt->table, lt->mailbox, lt->now, action_id,
+					 (uint8_t *)&action_id, key_timeout_id);
+}
+
+static int
+keys_check(struct learner_test *lt, uint32_t first, uint32_t n, int hit)
+{
+	uint32_t i;
+
+	for (i = first; i < first + n; i++)
+		if (key_lookup(lt, i) != hit) {
+			printf("Key %u: lookup %s, expected %s\n", i, hit ? "miss" : "hit",
+			       hit ? "hit" : "miss");
+			return -1;
+		}
+
+	return 0;
+}
+
+static int
+stats_check(struct learner_test *lt, uint64_t learned, uint64_t expired, uint64_t rejected)
+{
+	struct rte_swx_table_learner_stats stats;
+
+	if (rte_swx_table_learner_stats_read(lt->table, &stats))
+		return -1;
+
+	if (stats.n_keys_learned != learned ||
+	    stats.n_keys_expired != expired ||
+	    stats.n_keys_rejected != rejected) {
+		printf("Stats learned %" PRIu64 " expired %" PRIu64 " rejected %" PRIu64
+		       ", expected %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+		       stats.n_keys_learned, stats.n_keys_expired, stats.n_keys_rejected,
+		       learned, expired, rejected);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_learner_age(void)
+{
+	struct learner_test lt = {
+		.sec = rte_get_tsc_hz(),
+	};
+	uint32_t i, n;
+	int ret = -1;
+
+	lt.now = 1000 * lt.sec;
+	lt.table = table_create(NULL);
+	TEST_ASSERT_NOT_NULL(lt.table, "Table creation failed");
+
+	/* Half of the keys use the short timeout, half the long one. */
+	for (i = 0; i < N_KEYS; i++)
+		if (key_add(&lt, i, i < N_KEYS / 2 ? 0 : 1))
+			goto out;
+	if (keys_check(&lt, 0, N_KEYS, 1) || stats_check(&lt, N_KEYS, 0, 0))
+		goto out;
+
+	/* Nothing expired yet. */
+	lt.now += lt.sec;
+	if (rte_swx_table_learner_age(lt.table, lt.now, N_KEYS_MAX) ||
+	    keys_check(&lt, 0, N_KEYS, 1))
+		goto out;
+
+	/* The short timeout keys expire, the scan resumes where the previous call stopped. */
+	lt.now += 2 * key_timeouts[0] * lt.sec;
+	for (i = 0, n = 0; i < N_KEYS_MAX; i++)
+		n += rte_swx_table_learner_age(lt.table, lt.now, 1);
+	if (n != N_KEYS / 2 ||
+	    rte_swx_table_learner_age(lt.table, lt.now, N_KEYS_MAX) ||
+	    keys_check(&lt, 0, N_KEYS / 2, 0) ||
+	    keys_check(&lt, N_KEYS / 2, N_KEYS / 2, 1) ||
+	    stats_check(&lt, N_KEYS, N_KEYS / 2, 0))
+		goto out;
+
+	/* Rearmed keys do not expire. */
+	for (i = N_KEYS / 2; i < N_KEYS; i++) {
+		if (key_lookup(&lt, i) != 1)
+			goto out;
+		rte_swx_table_learner_rearm_new(lt.table, lt.mailbox, lt.now, 0);
+	}
+	lt.now += key_timeouts[0] * lt.sec / 2;
+	for (i = N_KEYS / 2; i < N_KEYS; i++) {
+		if (key_lookup(&lt, i) != 1)
+			goto out;
+		rte_swx_table_learner_rearm(lt.table, lt.mailbox, lt.now);
+	}
+	lt.now += key_timeouts[0] * lt.sec / 2;
+	if (rte_swx_table_learner_age(lt.table, lt.now, N_KEYS_MAX) ||
+	    keys_check(&lt, N_KEYS / 2, N_KEYS / 2, 1))
+		goto out;
+
+	/* Deleted keys are not counted as expired. */
+	for (i = N_KEYS / 2; i < N_KEYS; i++) {
+		if (key_lookup(&lt, i) != 1)
+			goto out;
+		rte_swx_table_learner_delete(lt.table, lt.mailbox);
+	}
+	lt.now += 2 * key_timeouts[1] * lt.sec;
+	if (rte_swx_table_learner_age(lt.table, lt.now, N_KEYS_MAX) ||
+	    keys_check(&lt, 0, N_KEYS, 0) ||
+	    stats_check(&lt, N_KEYS, N_KEYS / 2, 0))
+		goto out;
+
+	ret = 0;
+out:
+	rte_swx_table_learner_free(lt.table);
+	return ret;
+}
+
+static int
+test_learner_bucket_full(void)
+{
+	struct learner_test lt = {
+		.sec = rte_get_tsc_hz(),
+	};
+	uint32_t i;
+	int ret = -1;
+
+	lt.now = 1000 * lt.sec;
+	lt.table = table_create(hash_one_bucket);
+	TEST_ASSERT_NOT_NULL(lt.table, "Table creation failed");
+
+	/* A bucket holds 4 keys. */
+	for (i = 0; i < 4; i++)
+		if (key_add(&lt, i, 0))
+			goto out;
+	if (key_add(&lt, 4, 0) != 1 ||
+	    keys_check(&lt, 0, 4, 1) ||
+	    keys_check(&lt, 4, 1, 0) ||
+	    stats_check(&lt, 4, 0, 1))
+		goto out;
+
+	/* Expired keys not aged yet are replaced by the add operation and counted as expired. */
+	lt.now += 2 * key_timeouts[0] * lt.sec;
+	for (i = 4; i < 8; i++)
+		if (key_add(&lt, i, 0))
+			goto out;
+	if (keys_check(&lt, 0, 4, 0) ||
+	    keys_check(&lt, 4, 4, 1) ||
+	    stats_check(&lt, 8, 4, 1))
+		goto out;
+
+	ret = 0;
+out:
+	rte_swx_table_learner_free(lt.table);
+	return ret;
+}
+
+static int
+test_learner_rearm_aged(void)
+{
+	struct learner_test lt = {
+		.sec = rte_get_tsc_hz(),
+	};
+	uint8_t mailbox[RTE_CACHE_LINE_SIZE] __rte_cache_aligned = {0};
+	int ret = -1;
+
+	lt.now = 1000 * lt.sec;
+	lt.table = table_create(hash_one_bucket);
+	TEST_ASSERT_NOT_NULL(lt.table, "Table creation failed");
+
+	if (key_add(&lt, 0, 0))
+		goto out;
+
+	/* The key is aged between its lookup hit and its rearm: the rearm restores it. */
+	lt.now += key_timeouts[0] * lt.sec / 2;
+	if (key_lookup(&lt, 0) != 1)
+		goto out;
+	if (rte_swx_table_learner_age(lt.table, lt.now + 2 * key_timeouts[0] * lt.sec, 1) != 1 ||
+	    stats_check(&lt, 1, 1, 0))
+		goto out;
+	rte_swx_table_learner_rearm(lt.table, lt.mailbox, lt.now);
+	if (keys_check(&lt, 0, 1, 1) || stats_check(&lt, 1, 0, 0))
+		goto out;
+
+	/* The key is aged and its position reused by a new key before the rearm: the rearm
+	 * leaves the new key alone.
+	 */
+	if (key_lookup(&lt, 0) != 1)
+		goto out;
+	memcpy(mailbox, lt.mailbox, sizeof(mailbox));
+	lt.now += 2 * key_timeouts[0] * lt.sec;
+	if (rte_swx_table_learner_age(lt.table, lt.now, N_KEYS_MAX) != 1 ||
+	    key_add(&lt, 1, 1))
+		goto out;
+	rte_swx_table_learner_rearm_new(lt.table, mailbox, lt.now, 0);
+	lt.now += 2 * key_timeouts[0] * lt.sec;
+	if (keys_check(&lt, 0, 1, 0) ||
+	    keys_check(&lt, 1, 1, 1) ||
+	    stats_check(&lt, 2, 1, 0))
+		goto out;
+
+	/* The key is deleted between its lookup hit and its rearm: the rearm does not restore it. */
+	if (key_lookup(&lt, 1) != 1)
+		goto out;
+	memcpy(mailbox, lt.mailbox, sizeof(mailbox));
+	if (key_lookup(&lt, 1) != 1)
+		goto out;
+	rte_swx_table_learner_delete(lt.table, lt.mailbox);
+	rte_swx_table_learner_rearm(lt.table, mailbox, lt.now);
+	if (keys_check(&lt, 1, 1, 0) || stats_check(&lt, 2, 1, 0))
+		goto out;
+
+	ret = 0;
+out:
+	rte_swx_table_learner_free(lt.table);
+	return ret;
+}
+
+static struct unit_test_suite swx_table_learner_testsuite = {
+	.suite_name = "SWX learner table unit test suite",
+	.unit_test_cases = {
+		TEST_CASE(test_learner_age),
+		TEST_CASE(test_learner_bucket_full),
+		TEST_CASE(test_learner_rearm_aged),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_swx_table_learner(void)
+{
+	return unit_test_suite_runner(&swx_table_learner_testsuite);
+}
+
+REGISTER_TEST_COMMAND(swx_table_learner_autotest, test_swx_table_learner);
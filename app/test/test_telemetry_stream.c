@@ -0,0 +1,208 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#include <string.h>
+
+#include "telemetry_stream.h"
+
+#include "test.h"
+
+static int
+check_names(const struct tel_stream_snapshot *s, const char * const *names,
+		unsigned int n)
+{
+	const char *p = s->names;
+	unsigned int i;
+
+	if (s->n_values != n)
+		return -1;
+	for (i = 0; i < n; i++) {
+		if (strcmp(p, names[i]) != 0) {
+			printf("name %u = '%s', expected = '%s'\n",
+				i, p, names[i]);
+			return -1;
+		}
+		p += strlen(p) + 1;
+	}
+	return p == s->names + s->names_len ? 0 : -1;
+}
+
+static int
+test_flatten_dict(void)
+{
+	const char * const names[] = {
+		"pkts", "neg", "q.0", "q.1", "sub.x", "sub.q.0",
+	};
+	const uint64_t values[] = { 42, (uint64_t)-3, 1, 2, 10, 11 };
+	struct tel_stream_snapshot s = {0};
+	struct rte_tel_data *d, *q, *sub, *sub_q;
+	int ret = -1;
+
+	printf("%s: ", __func__);
+	d = rte_tel_data_alloc();
+	q = rte_tel_data_alloc();
+	sub = rte_tel_data_alloc();
+	sub_q = rte_tel_data_alloc();
+	if (d == NULL || q == NULL || sub == NULL || sub_q == NULL) {
+		rte_tel_data_free(d);
+		rte_tel_data_free(q);
+		rte_tel_data_free(sub);
+		rte_tel_data_free(sub_q);
+		return -1;
+	}
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "name", "not a counter");
+	rte_tel_data_add_dict_uint(d, "pkts", 42);
+	rte_tel_data_add_dict_int(d, "neg", -3);
+	rte_tel_data_start_array(q, RTE_TEL_UINT_VAL);
+	rte_tel_data_add_array_uint(q, 1);
+	rte_tel_data_add_array_uint(q, 2);
+	rte_tel_data_add_dict_container(d, "q", q, 0);
+	rte_tel_data_start_dict(sub);
+	rte_tel_data_add_dict_uint(sub, "x", 10);
+	rte_tel_data_start_array(sub_q, RTE_TEL_INT_VAL);
+	rte_tel_data_add_array_int(sub_q, 11);
+	rte_tel_data_add_dict_container(sub, "q", sub_q, 0);
+	rte_tel_data_add_dict_container(d, "sub", sub, 0);
+
+	/* containers not kept are freed by the flattening */
+	if (rte_tel_stream_flatten(&s, d) == 0 &&
+			check_names(&s, names, RTE_DIM(names)) == 0 &&
+			memcmp(s.values, values, sizeof(values)) == 0)
+		ret = 0;
+
+	rte_tel_stream_snapshot_free(&s);
+	rte_tel_data_free(d);
+	return ret;
+}
+
+static int
+test_flatten_array(void)
+{
+	const char * const names[] = { "0.0", "0.1", "1.0" };
+	const uint64_t values[] = { 5, 6, 7 };
+	struct tel_stream_snapshot s = {0};
+	struct rte_tel_data *d, *a0, *a1;
+	int ret = -1;
+
+	printf("%s: ", __func__);
+	d = rte_tel_data_alloc();
+	a0 = rte_tel_data_alloc();
+	a1 = rte_tel_data_alloc();
+	if (d == NULL || a0 == NULL || a1 == NULL) {
+		rte_tel_data_free(d);
+		rte_tel_data_free(a0);
+		rte_tel_data_free(a1);
+		return -1;
+	}
+
+	rte_tel_data_start_array(d, RTE_TEL_CONTAINER);
+	rte_tel_data_start_array(a0, RTE_TEL_UINT_VAL);
+	rte_tel_data_add_array_uint(a0, 5);
+	rte_tel_data_add_array_uint(a0, 6);
+	rte_tel_data_add_array_container(d, a0, 0);
+	rte_tel_data_start_array(a1, RTE_TEL_UINT_VAL);
+	rte_tel_data_add_array_uint(a1, 7);
+	/* kept containers are left to the caller */
+	rte_tel_data_add_array_container(d, a1, 1);
+
+	if (rte_tel_stream_flatten(&s, d) == 0 &&
+			check_names(&s, names, RTE_DIM(names)) == 0 &&
+			memcmp(s.values, values, sizeof(values)) == 0)
+		ret = 0;
+
+	rte_tel_stream_snapshot_free(&s);
+	rte_tel_data_free(a1);
+	rte_tel_data_free(d);
+	return ret;
+}
+
+static int
+test_deltas(void)
+{
+	const uint64_t prev[] = { 0, 100, 100, UINT64_MAX, 5, 0 };
+	const uint64_t vals[] = { 0, 101, 99, 2, 5, UINT64_MAX / 3 };
+	uint8_t buf[RTE_DIM(vals) * TEL_STREAM_VARINT_MAX];
+	size_t used = 0, pos = 0;
+	unsigned int i;
+	uint64_t v;
+
+	printf("%s: ", __func__);
+	for (i = 0; i < RTE_DIM(vals); i++)
+		used += rte_tel_stream_put_delta(buf + used, prev[i], vals[i]);
+
+	/* unchanged and small deltas, including wrapped ones, take a byte */
+	if (buf[0] != 0 || buf[1] != 2 || buf[2] != 1 || buf[3] != 6 ||
+			buf[4] != 0)
+		return -1;
+
+	for (i = 0; i < RTE_DIM(vals); i++) {
+		int n;
+
+		v = prev[i];
+		n = rte_tel_stream_get_delta(buf + pos, used - pos, &v);
+
+		if (n == 0 || v != vals[i]) {
+			printf("value %u = %"PRIu64", expected = %"PRIu64"\n",
+				i, v, vals[i]);
+			return -1;
+		}
+		pos += n;
+	}
+	if (pos != used)
+		return -1;
+
+	/* truncated encoding is rejected */
+	return rte_tel_stream_get_delta(buf + used - 2, 1, &v) == 0 ? 0 : -1;
+}
+
+static int
+test_same_schema(void)
+{
+	struct tel_stream_snapshot a = {0}, b = {0};
+	int ret = -1;
+
+	printf("%s: ", __func__);
+	if (!rte_tel_stream_same_schema(&a, &b))
+		return -1;
+	if (rte_tel_stream_snapshot_add(&a, "rx", 1) < 0 ||
+			rte_tel_stream_snapshot_add(&b, "rx", 2) < 0)
+		goto out;
+	if (!rte_tel_stream_same_schema(&a, &b))
+		goto out;
+	if (rte_tel_stream_snapshot_add(&b, "tx", 3) < 0)
+		goto out;
+	if (rte_tel_stream_same_schema(&a, &b))
+		goto out;
+	ret = 0;
+out:
+	rte_tel_stream_snapshot_free(&a);
+	rte_tel_stream_snapshot_free(&b);
+	return ret;
+}
+
+typedef int (*test_fn)(void);
+
+static int
+test_telemetry_stream(void)
+{
+	unsigned int i;
+	test_fn fns[] = {
+			test_flatten_dict,
+			test_flatten_array,
+			test_deltas,
+			test_same_schema,
+	};
+	for (i = 0; i < RTE_DIM(fns); i++)
+		if (fns[i]() == 0)
+			printf("OK\n");
+		else {
+			printf("ERROR\n");
+			return -1;
+		}
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(telemetry_stream_autotest, test_telemetry_stream);
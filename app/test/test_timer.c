@@ -44,6 +44,25 @@
  *    - Again we check that the expected number of callbacks has occurred when
  *      we call timer-manage.
  *
+ * #. Timing wheel test.
+ *
+ *    This test checks the timers started on the timing wheel of another
+ *    lcore, and the burst expiry, on a timer data instance using timing
+ *    wheels.
+ *
+ *    - The main lcore starts a timer on the wheel of a worker, which calls
+ *      rte_timer_alt_manage_burst() in a loop. The timer is checked to be
+ *      pending at once, then it is stopped and restarted many times, either
+ *      still queued or already in the wheel of the worker.
+ *    - The timer is then started with a short delay, and the main lcore checks
+ *      that its callback is called once by the worker.
+ *    - Then all cores start all the timers of a set on the wheel of the main
+ *      lcore, and stop and restart them at random, as in stress test 2.
+ *    - The main lcore calls rte_timer_alt_manage_burst() once the timers
+ *      expired, and checks that each timer is running while handed to the
+ *      callback, which is called once per timer, and that the callback can
+ *      restart one of them.
+ *
  * #. Basic test.
  *
  *    This test performs basic functional checks of the timers. The test
@@ -395,6 +414,187 @@ cleanup:
 	return 0;
 }
 
+static uint32_t wheel_data_id;
+static uint32_t wheel_cb_count;
+static struct rte_timer *wheel_rearm_tim;
+static int wheel_part1_done;
+
+/* never called, the timers of the wheel test expire in bursts */
+static void
+timer_wheel_cb(struct rte_timer *tim __rte_unused, void *arg __rte_unused)
+{
+	test_failed = 1;
+}
+
+/* burst callback for the wheel test */
+static void
+timer_wheel_burst_cb(struct rte_timer **tims, unsigned int nb_tims)
+{
+	unsigned int i;
+
+	for (i = 0; i < nb_tims; i++) {
+		if (tims[i]->status.state != RTE_TIMER_RUNNING ||
+		    tims[i]->status.owner != (int16_t)rte_lcore_id())
+			test_failed = 1;
+
+		/* timers handed to the callback can be restarted from it */
+		if (tims[i] == wheel_rearm_tim) {
+			wheel_rearm_tim = NULL;
+			if (rte_timer_alt_reset(wheel_data_id, tims[i], 0,
+						SINGLE, rte_lcore_id(),
+						timer_wheel_cb, NULL) != 0 ||
+			    !rte_timer_pending(tims[i]))
+				test_failed = 1;
+		}
+	}
+
+	__atomic_fetch_add(&wheel_cb_count, nb_tims, __ATOMIC_RELAXED);
+}
+
+#define NB_WHEEL_TIMERS 8192
+
+static int
+timer_wheel_main_loop(__rte_unused void *arg)
+{
+	static struct rte_timer *timers;
+	static struct rte_timer tim;
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t delay = hz / 20;
+	unsigned int lcore_id = rte_lcore_id();
+	unsigned int main_lcore = rte_get_main_lcore();
+	unsigned int worker_lcore = rte_get_next_lcore(main_lcore, 1, 0);
+	int i;
+
+	if (lcore_id == main_lcore) {
+		timers = rte_malloc(NULL, sizeof(*timers) * NB_WHEEL_TIMERS, 0);
+		if (timers == NULL) {
+			printf("- Cannot allocate memory for timers\n");
+			test_failed = 1;
+		} else {
+			for (i = 0; i < NB_WHEEL_TIMERS; i++)
+				rte_timer_init(&timers[i]);
+		}
+		rte_timer_init(&tim);
+		wheel_cb_count = 0;
+		wheel_part1_done = 0;
+		main_start_workers();
+	} else {
+		worker_wait_to_start();
+	}
+	if (test_failed)
+		goto cleanup;
+
+	/* part 1: the main lcore starts a timer on the wheel of a worker */
+	if (lcore_id == main_lcore) {
+		if (rte_timer_alt_reset(wheel_data_id, &tim, hz, SINGLE,
+					worker_lcore, timer_wheel_cb, NULL) != 0 ||
+		    !rte_timer_pending(&tim)) {
+			printf("- Timer not pending once started\n");
+			test_failed = 1;
+		}
+
+		/* the timer is either still queued or in the wheel */
+		for (i = 0; i < 10000 && !test_failed; i++) {
+			if (rte_timer_alt_stop(wheel_data_id, &tim) != 0 ||
+			    rte_timer_pending(&tim) ||
+			    rte_timer_alt_reset(wheel_data_id, &tim, hz, SINGLE,
+						worker_lcore, timer_wheel_cb,
+						NULL) != 0 ||
+			    rte_timer_alt_reset(wheel_data_id, &tim, hz, SINGLE,
+						worker_lcore, timer_wheel_cb,
+						NULL) != 0 ||
+			    !rte_timer_pending(&tim)) {
+				printf("- Cannot update a started timer\n");
+				test_failed = 1;
+			}
+			rte_delay_us(i % 4);
+		}
+
+		/* the timer runs once on the worker */
+		if (rte_timer_alt_reset(wheel_data_id, &tim, hz / 100, SINGLE,
+					worker_lcore, timer_wheel_cb,
+					NULL) != 0) {
+			printf("- Cannot restart a started timer\n");
+			test_failed = 1;
+		}
+		rte_delay_ms(100);
+		if (__atomic_load_n(&wheel_cb_count, __ATOMIC_RELAXED) != 1 ||
+		    rte_timer_pending(&tim)) {
+			printf("- Expected 1 callback, got %u\n",
+			       __atomic_load_n(&wheel_cb_count,
+					       __ATOMIC_RELAXED));
+			test_failed = 1;
+		}
+
+		__atomic_store_n(&wheel_part1_done, 1, __ATOMIC_RELEASE);
+		if (test_failed)
+			goto cleanup;
+		main_wait_for_workers();
+		wheel_cb_count = 0;
+		main_start_workers();
+	} else {
+		while (!__atomic_load_n(&wheel_part1_done, __ATOMIC_ACQUIRE))
+			if (lcore_id == worker_lcore)
+				rte_timer_alt_manage_burst(wheel_data_id, NULL,
+							   0,
+							   timer_wheel_burst_cb);
+		if (test_failed)
+			goto cleanup;
+		worker_finish();
+		worker_wait_to_start();
+	}
+
+	/* part 2: all cores start all timers on the wheel of the main lcore,
+	 * then stop and restart them at random
+	 */
+	for (i = 0; i < NB_WHEEL_TIMERS; i++)
+		rte_timer_alt_reset(wheel_data_id, &timers[i], delay, SINGLE,
+				    main_lcore, timer_wheel_cb, NULL);
+	for (i = 0; i < 100000; i++) {
+		int r = rand() % NB_WHEEL_TIMERS;
+
+		if (i % 2)
+			rte_timer_alt_stop(wheel_data_id, &timers[r]);
+		rte_timer_alt_reset(wheel_data_id, &timers[r], delay, SINGLE,
+				    main_lcore, timer_wheel_cb, NULL);
+	}
+
+	/* wait long enough for timers to expire */
+	rte_delay_ms(100);
+
+	if (lcore_id == main_lcore) {
+		main_wait_for_workers();
+
+		/* the restarted timer runs on the next call */
+		wheel_rearm_tim = &timers[0];
+		rte_timer_alt_manage_burst(wheel_data_id, NULL, 0,
+					   timer_wheel_burst_cb);
+		rte_delay_ms(10);
+		rte_timer_alt_manage_burst(wheel_data_id, NULL, 0,
+					   timer_wheel_burst_cb);
+		if (wheel_cb_count != NB_WHEEL_TIMERS + 1) {
+			printf("- Expected %d callbacks, got %u\n",
+			       NB_WHEEL_TIMERS + 1, wheel_cb_count);
+			test_failed = 1;
+		}
+	}
+
+cleanup:
+	if (lcore_id == main_lcore) {
+		main_wait_for_workers();
+		if (test_failed)
+			printf("Test Failed\n");
+		else
+			printf("Test OK\n");
+		rte_free(timers);
+		timers = NULL;
+	} else {
+		worker_finish();
+	}
+
+	return 0;
+}
+
 /* timer callback for basic tests */
 static void
 timer_basic_cb(struct rte_timer *tim, void *arg)
@@ -574,6 +774,21 @@ test_timer(void)
 	if (test_failed)
 		return TEST_FAILED;
 
+	/* check the timing wheels of another timer data instance */
+	printf("\nStart timer wheel tests\n");
+	if (rte_timer_data_alloc(&wheel_data_id) != 0)
+		return TEST_FAILED;
+	if (rte_timer_alt_wheel_enable(wheel_data_id, hz / 1000) != 0) {
+		rte_timer_data_dealloc(wheel_data_id);
+		return TEST_FAILED;
+	}
+	main_init_workers();
+	rte_eal_mp_remote_launch(timer_wheel_main_loop, NULL, CALL_MAIN);
+	rte_eal_mp_wait_lcore();
+	rte_timer_data_dealloc(wheel_data_id);
+	if (test_failed)
+		return TEST_FAILED;
+
 	/* calculate the "end of test" time */
 	cur_time = rte_get_timer_cycles();
 	hz = rte_get_timer_hz();
@@ -33,6 +33,154 @@ timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
 #define do_delay() rte_pause()
 #endif
 
+#define ALT_WHEEL_TICK_US 10
+
+static const unsigned int alt_n_timers[] = {1000000, 10000000};
+
+static int alt_outstanding_count;
+
+static void
+alt_timer_cb(struct rte_timer *t __rte_unused)
+{
+	alt_outstanding_count--;
+}
+
+static void
+alt_timer_burst_cb(struct rte_timer **tims __rte_unused, unsigned int nb_tims)
+{
+	alt_outstanding_count -= nb_tims;
+}
+
+static void
+alt_result_print(const char *name, const char *op, unsigned int n,
+		 uint64_t cycles)
+{
+	printf("%-10s %9u timers %-8s %8"PRIu64" cycles per timer\n",
+	       name, n, op, (cycles + n / 2) / n);
+}
+
+/* Arm, cancel half, re-arm and expire n timers on the given instance, then
+ * expire them again in bursts
+ */
+static int
+timer_perf_alt_run(uint32_t data_id, const char *name,
+		   struct rte_timer *tms, unsigned int n)
+{
+	const uint64_t ticks = rte_get_timer_hz() * DELAY_SECONDS;
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t start_tsc, delay_start;
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		rte_timer_init(&tms[i]);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i++)
+		rte_timer_alt_reset(data_id, &tms[i], rte_rand_max(ticks), SINGLE,
+				    lcore_id, NULL, NULL);
+	alt_result_print(name, "arm", n, rte_rdtsc() - start_tsc);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i += 2)
+		rte_timer_alt_stop(data_id, &tms[i]);
+	alt_result_print(name, "cancel", n / 2, rte_rdtsc() - start_tsc);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i += 2)
+		rte_timer_alt_reset(data_id, &tms[i], rte_rand_max(ticks), SINGLE,
+				    lcore_id, NULL, NULL);
+	alt_result_print(name, "re-arm", n / 2, rte_rdtsc() - start_tsc);
+
+	alt_outstanding_count = n;
+	delay_start = rte_get_timer_cycles();
+	while (rte_get_timer_cycles() < delay_start + ticks)
+		do_delay();
+
+	start_tsc = rte_rdtsc();
+	while (alt_outstanding_count > 0)
+		rte_timer_alt_manage(data_id, NULL, 0, alt_timer_cb);
+	alt_result_print(name, "expire", n, rte_rdtsc() - start_tsc);
+
+	if (alt_outstanding_count != 0) {
+		printf("Error: outstanding callback count = %d\n",
+		       alt_outstanding_count);
+		return -1;
+	}
+
+	for (i = 0; i < n; i++)
+		rte_timer_alt_reset(data_id, &tms[i], rte_rand_max(ticks), SINGLE,
+				    lcore_id, NULL, NULL);
+
+	alt_outstanding_count = n;
+	delay_start = rte_get_timer_cycles();
+	while (rte_get_timer_cycles() < delay_start + ticks)
+		do_delay();
+
+	start_tsc = rte_rdtsc();
+	while (alt_outstanding_count > 0)
+		rte_timer_alt_manage_burst(data_id, NULL, 0,
+					   alt_timer_burst_cb);
+	alt_result_print(name, "burst", n, rte_rdtsc() - start_tsc);
+
+	if (alt_outstanding_count != 0) {
+		printf("Error: outstanding callback count = %d\n",
+		       alt_outstanding_count);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Compare the skiplist and timing wheel timer data instances */
+static int
+test_timer_perf_alt(void)
+{
+	uint32_t skiplist_id, wheel_id;
+	struct rte_timer *tms;
+	unsigned int i;
+	int ret = 0;
+
+	if (rte_timer_data_alloc(&skiplist_id) != 0)
+		return -1;
+
+	if (rte_timer_data_alloc(&wheel_id) != 0) {
+		rte_timer_data_dealloc(skiplist_id);
+		return -1;
+	}
+
+	if (rte_timer_alt_wheel_enable(wheel_id,
+			rte_get_timer_hz() / US_PER_S * ALT_WHEEL_TICK_US) != 0) {
+		printf("Error enabling timing wheels\n");
+		ret = -1;
+		goto dealloc;
+	}
+
+	printf("\n");
+	for (i = 0; i < RTE_DIM(alt_n_timers); i++) {
+		tms = rte_malloc(NULL, sizeof(*tms) * alt_n_timers[i], 0);
+		if (tms == NULL) {
+			printf("Not enough memory for %u timers, skipped\n",
+			       alt_n_timers[i]);
+			continue;
+		}
+
+		ret = timer_perf_alt_run(skiplist_id, "skiplist", tms,
+					 alt_n_timers[i]);
+		if (ret == 0)
+			ret = timer_perf_alt_run(wheel_id, "wheel", tms,
+						 alt_n_timers[i]);
+		rte_free(tms);
+		if (ret != 0)
+			break;
+	}
+
+dealloc:
+	rte_timer_data_dealloc(wheel_id);
+	rte_timer_data_dealloc(skiplist_id);
+
+	return ret;
+}
+
 static int
 test_timer_perf(void)
 {
@@ -128,7 +276,8 @@ test_timer_perf(void)
 			(end_tsc - start_tsc + iterations/2) / iterations);
 
 	rte_free(tms);
-	return 0;
+
+	return test_timer_perf_alt();
 }
 
 REGISTER_TEST_COMMAND(timer_perf_autotest, test_timer_perf);
@@ -91,6 +91,7 @@
 /* rte_graph defines */
 #define RTE_GRAPH_BURST_SIZE 256
 #define RTE_LIBRTE_GRAPH_STATS 1
+#define RTE_GRAPH_HIST_SAMPLE_INTERVAL 64
 
 /****** driver defines ********/
 
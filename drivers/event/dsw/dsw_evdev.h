@@ -97,8 +97,27 @@
 #define DSW_MAX_TARGET_LOAD_FOR_MIGRATION (DSW_LOAD_FROM_PERCENT(95))
 #define DSW_REBALANCE_THRESHOLD (DSW_LOAD_FROM_PERCENT(3))
 
+/* Ports with at least this many events waiting in their input ring
+ * are not considered as migration targets, since whatever load
+ * estimate they have, they don't keep up. Below this level, the
+ * backlog is accounted for as (up to 10%) extra load.
+ */
+#define DSW_MAX_TARGET_BACKLOG_FOR_MIGRATION (2*DSW_MAX_PORT_DEQUEUE_DEPTH)
+#define DSW_BACKLOG_LOAD(backlog)					\
+	((DSW_LOAD_FROM_PERCENT(10)*(int32_t)(backlog)) /		\
+	 DSW_MAX_TARGET_BACKLOG_FOR_MIGRATION)
+
 #define DSW_MAX_EVENTS_RECORDED (128)
 
+/* The per-flow event counts of the recorded events are smoothed
+ * using an exponentially weighted moving average, spanning several
+ * emigration considerations. This is to avoid that flows which
+ * happened to be bursty during the last recording period are
+ * migrated, only to be moved back later, causing oscillation.
+ */
+#define DSW_FLOW_OLD_LOAD_WEIGHT (3)
+#define DSW_FLOW_LOAD_SHIFT (4)
+
 #define DSW_MAX_FLOWS_PER_MIGRATION (8)
 
 /* Only one outstanding migration per port is allowed */
@@ -125,6 +144,12 @@ struct dsw_queue_flow {
 	uint16_t flow_hash;
 };
 
+struct dsw_queue_flow_load {
+	struct dsw_queue_flow queue_flow;
+	/* Smoothed number of recorded events, in fixed point. */
+	uint16_t load;
+};
+
 enum dsw_migration_state {
 	DSW_MIGRATION_STATE_IDLE,
 	DSW_MIGRATION_STATE_PAUSING,
@@ -171,8 +196,10 @@ struct dsw_port {
 	enum dsw_migration_state migration_state;
 
 	uint64_t emigration_start;
+	uint64_t emigration_rounds;
 	uint64_t emigrations;
 	uint64_t emigration_latency;
+	uint64_t emigration_latency_max;
 
 	uint8_t emigration_target_port_ids[DSW_MAX_FLOWS_PER_MIGRATION];
 	struct dsw_queue_flow
@@ -202,6 +229,9 @@ struct dsw_port {
 	uint16_t seen_events_idx;
 	struct dsw_queue_flow seen_events[DSW_MAX_EVENTS_RECORDED];
 
+	uint16_t flow_loads_len;
+	struct dsw_queue_flow_load flow_loads[DSW_MAX_EVENTS_RECORDED];
+
 	uint64_t enqueue_calls;
 	uint64_t new_enqueued;
 	uint64_t forward_enqueued;
@@ -389,13 +389,20 @@ dsw_retrieve_port_loads(struct dsw_evdev *dsw, int16_t *port_loads,
 	uint16_t i;
 
 	for (i = 0; i < dsw->num_ports; i++) {
+		struct dsw_port *port = &dsw->ports[i];
 		int16_t measured_load =
-			__atomic_load_n(&dsw->ports[i].load, __ATOMIC_RELAXED);
+			__atomic_load_n(&port->load, __ATOMIC_RELAXED);
 		int32_t immigration_load =
-			__atomic_load_n(&dsw->ports[i].immigration_load,
+			__atomic_load_n(&port->immigration_load,
 					__ATOMIC_RELAXED);
+		unsigned int backlog = rte_event_ring_count(port->in_ring);
 		int32_t load = measured_load + immigration_load;
 
+		if (backlog >= DSW_MAX_TARGET_BACKLOG_FOR_MIGRATION)
+			load = DSW_MAX_LOAD;
+		else
+			load += DSW_BACKLOG_LOAD(backlog);
+
 		load = RTE_MIN(load, DSW_MAX_LOAD);
 
 		if (load < load_limit)
@@ -405,6 +412,55 @@ dsw_retrieve_port_loads(struct dsw_evdev *dsw, int16_t *port_loads,
 	return below_limit;
 }
 
+static void
+dsw_port_smooth_flow_loads(struct dsw_port *port,
+			   struct dsw_queue_flow_burst *bursts,
+			   uint16_t num_bursts)
+{
+	struct dsw_queue_flow_load *old_loads = port->flow_loads;
+	uint16_t old_loads_len = port->flow_loads_len;
+	uint16_t i;
+	uint16_t j = 0;
+	struct dsw_queue_flow_load new_loads[num_bursts];
+
+	/* Both the bursts and the previous loads are sorted by queue
+	 * and flow, so they may be merged in a single pass. Flows no
+	 * longer seen are dropped.
+	 */
+	for (i = 0; i < num_bursts; i++) {
+		struct dsw_queue_flow_burst *burst = &bursts[i];
+		uint32_t load = (uint32_t)burst->count << DSW_FLOW_LOAD_SHIFT;
+		int cmp = -1;
+
+		while (j < old_loads_len &&
+		       (cmp = dsw_cmp_qf(&old_loads[j].queue_flow,
+					 &burst->queue_flow)) < 0)
+			j++;
+
+		/* Flows seen for the first time start from their
+		 * current event count.
+		 */
+		if (j < old_loads_len && cmp == 0)
+			load = (load + old_loads[j].load *
+				DSW_FLOW_OLD_LOAD_WEIGHT) /
+				(DSW_FLOW_OLD_LOAD_WEIGHT + 1);
+
+		new_loads[i].queue_flow = burst->queue_flow;
+		new_loads[i].load = load;
+
+		load = (load + (1 << (DSW_FLOW_LOAD_SHIFT - 1))) >>
+			DSW_FLOW_LOAD_SHIFT;
+
+		/* A flow that was seen must not appear to be free to
+		 * move.
+		 */
+		burst->count = RTE_MAX(load, 1U);
+	}
+
+	memcpy(old_loads, new_loads, sizeof(new_loads[0]) * num_bursts);
+	port->flow_loads_len = num_bursts;
+}
+
 static int16_t
 dsw_flow_load(uint16_t num_events, int16_t port_load)
 {
@@ -738,6 +794,8 @@ dsw_port_emigration_stats(struct dsw_port *port, uint8_t finished)
 	flow_migration_latency =
 		(rte_get_timer_cycles() - port->emigration_start);
 	port->emigration_latency += (flow_migration_latency * finished);
+	port->emigration_latency_max = RTE_MAX(port->emigration_latency_max,
+					       flow_migration_latency);
 	port->emigrations += finished;
 }
 
@@ -922,6 +980,8 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 		return;
 	}
 
+	dsw_port_smooth_flow_loads(source_port, bursts, num_bursts);
+
 	dsw_select_emigration_targets(dsw, source_port, bursts, num_bursts,
 				      port_loads);
 
@@ -930,6 +990,7 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 
 	source_port->migration_state = DSW_MIGRATION_STATE_PAUSING;
 	source_port->emigration_start = rte_get_timer_cycles();
+	source_port->emigration_rounds++;
 
 	/* No need to go through the whole pause procedure for
 	 * parallel queues, since atomic/ordered semantics need not to
@@ -84,6 +84,7 @@ dsw_xstats_port_get_queue_dequeued(struct dsw_evdev *dsw, uint8_t port_id,
 	return dsw->ports[port_id].queue_dequeued[queue_id];
 }
 
+DSW_GEN_PORT_ACCESS_FN(emigration_rounds)
 DSW_GEN_PORT_ACCESS_FN(emigrations)
 DSW_GEN_PORT_ACCESS_FN(immigrations)
 
@@ -97,6 +98,14 @@ dsw_xstats_port_get_migration_latency(struct dsw_evdev *dsw, uint8_t port_id,
 	return num_emigrations > 0 ? total_latency / num_emigrations : 0;
 }
 
+static uint64_t
+dsw_xstats_port_get_migration_latency_max(struct dsw_evdev *dsw,
+					  uint8_t port_id,
+					  uint8_t queue_id __rte_unused)
+{
+	return dsw->ports[port_id].emigration_latency_max;
+}
+
 static uint64_t
 dsw_xstats_port_get_event_proc_latency(struct dsw_evdev *dsw, uint8_t port_id,
 				       uint8_t queue_id __rte_unused)
@@ -146,10 +155,14 @@ static struct dsw_xstats_port dsw_port_xstats[] = {
 	  false },
 	{ "port_%u_queue_%u_dequeued", dsw_xstats_port_get_queue_dequeued,
 	  true },
+	{ "port_%u_emigration_rounds", dsw_xstats_port_get_emigration_rounds,
+	  false },
 	{ "port_%u_emigrations", dsw_xstats_port_get_emigrations,
 	  false },
 	{ "port_%u_migration_latency", dsw_xstats_port_get_migration_latency,
 	  false },
+	{ "port_%u_migration_latency_max",
+	  dsw_xstats_port_get_migration_latency_max, false },
 	{ "port_%u_immigrations", dsw_xstats_port_get_immigrations,
 	  false },
 	{ "port_%u_event_proc_latency", dsw_xstats_port_get_event_proc_latency,
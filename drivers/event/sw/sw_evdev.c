@@ -24,6 +24,7 @@
 #define MIN_BURST_SIZE_ARG "min_burst"
 #define DEQ_BURST_SIZE_ARG "deq_burst"
 #define REFIL_ONCE_ARG "refill_once"
+#define SCHED_GROUPS_ARG "sched_groups"
 
 static void
 sw_info_get(struct rte_eventdev *dev, struct rte_event_dev_info *info);
@@ -52,6 +53,14 @@ sw_port_link(struct rte_eventdev *dev, void *port, const uint8_t queues[],
 			break;
 		}
 
+		/* scheduler groups are built at start, a running port
+		 * can't be linked to the QIDs of another group
+		 */
+		if (sw->started && q->sched_group != p->sched_group) {
+			rte_errno = EINVAL;
+			break;
+		}
+
 		for (j = 0; j < q->cq_num_mapped_cqs; j++) {
 			if (q->cq_map[j] == p->id)
 				break;
@@ -362,7 +371,7 @@ sw_init_qid_iqs(struct sw_evdev *sw)
 			continue;
 
 		for (j = 0; j < SW_IQS_MAX; j++)
-			iq_init(sw, &qid->iq[j]);
+			iq_init(sw_qid_sched_group(sw, qid), &qid->iq[j]);
 	}
 }
 
@@ -378,6 +387,14 @@ sw_qids_empty(struct sw_evdev *sw)
 		}
 	}
 
+	/* events on their way to another scheduler group */
+	for (i = 0; i < sw->sched_group_count; i++) {
+		struct rte_event_ring *r = sw->sched_groups[i].rx_ring;
+
+		if (r != NULL && rte_event_ring_count(r))
+			return 0;
+	}
+
 	return 1;
 }
 
@@ -422,9 +439,9 @@ sw_drain_ports(struct rte_eventdev *dev)
 }
 
 static void
-sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
+sw_drain_queue(struct rte_eventdev *dev, struct sw_sched_group *grp,
+		struct sw_iq *iq)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	eventdev_stop_flush_t flush;
 	uint8_t dev_id;
 	void *arg;
@@ -436,7 +453,7 @@ sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
 	while (iq_count(iq) > 0) {
 		struct rte_event ev;
 
-		iq_dequeue_burst(sw, iq, &ev, 1);
+		iq_dequeue_burst(grp, iq, &ev, 1);
 
 		if (flush)
 			flush(dev_id, ev, arg);
@@ -450,8 +467,11 @@ sw_drain_queues(struct rte_eventdev *dev)
 	unsigned int i, j;
 
 	for (i = 0; i < sw->qid_count; i++) {
+		struct sw_qid *qid = &sw->qids[i];
+
 		for (j = 0; j < SW_IQS_MAX; j++)
-			sw_drain_queue(dev, &sw->qids[i].iq[j]);
+			sw_drain_queue(dev, sw_qid_sched_group(sw, qid),
+					&qid->iq[j]);
 	}
 }
 
@@ -468,7 +488,8 @@ sw_clean_qid_iqs(struct rte_eventdev *dev)
 		for (j = 0; j < SW_IQS_MAX; j++) {
 			if (!qid->iq[j].head)
 				continue;
-			iq_free_chunk_list(sw, qid->iq[j].head);
+			iq_free_chunk_list(sw_qid_sched_group(sw, qid),
+					qid->iq[j].head);
 			qid->iq[j].head = NULL;
 		}
 	}
@@ -505,39 +526,74 @@ sw_port_def_conf(struct rte_eventdev *dev, uint8_t port_id,
 }
 
 static int
-sw_dev_configure(const struct rte_eventdev *dev)
+sw_sched_group_configure(struct sw_evdev *sw, struct sw_sched_group *grp,
+		int num_chunks)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
-	const struct rte_eventdev_data *data = dev->data;
-	const struct rte_event_dev_config *conf = &data->dev_conf;
-	int num_chunks, i;
-
-	sw->qid_count = conf->nb_event_queues;
-	sw->port_count = conf->nb_event_ports;
-	sw->nb_events_limit = conf->nb_events_limit;
-	rte_atomic32_set(&sw->inflights, 0);
-
-	/* Number of chunks sized for worst-case spread of events across IQs */
-	num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
-			sw->qid_count*SW_IQS_MAX*2;
+	char buf[RTE_RING_NAMESIZE];
+	int i;
 
 	/* If this is a reconfiguration, free the previous IQ allocation. All
 	 * IQ chunk references were cleaned out of the QIDs in sw_stop(), and
 	 * will be reinitialized in sw_start().
 	 */
-	rte_free(sw->chunks);
+	rte_free(grp->chunks);
 
-	sw->chunks = rte_malloc_socket(NULL,
+	grp->chunks = rte_malloc_socket(NULL,
 				       sizeof(struct sw_queue_chunk) *
 				       num_chunks,
 				       0,
 				       sw->data->socket_id);
-	if (!sw->chunks)
+	if (!grp->chunks)
 		return -ENOMEM;
 
-	sw->chunk_list_head = NULL;
+	grp->chunk_list_head = NULL;
 	for (i = 0; i < num_chunks; i++)
-		iq_free_chunk(sw, &sw->chunks[i]);
+		iq_free_chunk(grp, &grp->chunks[i]);
+
+	if (sw->sched_group_count == 1 || grp->rx_ring != NULL)
+		return 0;
+
+	/* sized for all the events of the device, so it never fills up */
+	snprintf(buf, sizeof(buf), "sw%d_g%u_rx_ring", sw->data->dev_id,
+			grp->id);
+	grp->rx_ring = rte_event_ring_create(buf, SW_INFLIGHT_EVENTS_TOTAL,
+			sw->data->socket_id,
+			RING_F_SC_DEQ | RING_F_EXACT_SZ);
+	if (grp->rx_ring == NULL) {
+		SW_LOG_ERR("Error creating RX ring for scheduler group %u\n",
+				grp->id);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static int
+sw_dev_configure(const struct rte_eventdev *dev)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	const struct rte_eventdev_data *data = dev->data;
+	const struct rte_event_dev_config *conf = &data->dev_conf;
+	uint32_t i;
+	int num_chunks, ret;
+
+	sw->qid_count = conf->nb_event_queues;
+	sw->port_count = conf->nb_event_ports;
+	sw->nb_events_limit = conf->nb_events_limit;
+	rte_atomic32_set(&sw->inflights, 0);
+
+	/* Number of chunks sized for worst-case spread of events across IQs,
+	 * for each scheduler group as all events may end up in one of them.
+	 */
+	num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
+			sw->qid_count*SW_IQS_MAX*2;
+
+	for (i = 0; i < sw->sched_group_count; i++) {
+		ret = sw_sched_group_configure(sw, &sw->sched_groups[i],
+				num_chunks);
+		if (ret < 0)
+			return ret;
+	}
 
 	if (conf->event_dev_cfg & RTE_EVENT_DEV_CFG_PER_DEQUEUE_TIMEOUT)
 		return -ENOTSUP;
@@ -626,12 +682,23 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 	fprintf(f, "EventDev %s: ports %d, qids %d\n",
 		dev->data->name, sw->port_count, sw->qid_count);
 
-	fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64"\n\ttx   %"PRIu64"\n",
-		sw->stats.rx_pkts, sw->stats.rx_dropped, sw->stats.tx_pkts);
-	fprintf(f, "\tsched calls: %"PRIu64"\n", sw->sched_called);
-	fprintf(f, "\tsched cq/qid call: %"PRIu64"\n", sw->sched_cq_qid_called);
-	fprintf(f, "\tsched no IQ enq: %"PRIu64"\n", sw->sched_no_iq_enqueues);
-	fprintf(f, "\tsched no CQ enq: %"PRIu64"\n", sw->sched_no_cq_enqueues);
+	for (i = 0; i < sw->sched_group_count; i++) {
+		const struct sw_sched_group *grp = &sw->sched_groups[i];
+
+		if (sw->sched_group_count > 1)
+			fprintf(f, "  Scheduler group %u: ports %u, qids %u\n",
+				i, grp->port_count, grp->qid_count);
+		fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64"\n\ttx   %"
+			PRIu64"\n", grp->stats.rx_pkts, grp->stats.rx_dropped,
+			grp->stats.tx_pkts);
+		fprintf(f, "\tsched calls: %"PRIu64"\n", grp->sched_called);
+		fprintf(f, "\tsched cq/qid call: %"PRIu64"\n",
+			grp->sched_cq_qid_called);
+		fprintf(f, "\tsched no IQ enq: %"PRIu64"\n",
+			grp->sched_no_iq_enqueues);
+		fprintf(f, "\tsched no CQ enq: %"PRIu64"\n",
+			grp->sched_no_cq_enqueues);
+	}
 	uint32_t inflights = rte_atomic32_read(&sw->inflights);
 	uint32_t credits = sw->nb_events_limit - inflights;
 	fprintf(f, "\tinflight %d, credits: %d\n", inflights, credits);
@@ -761,10 +828,116 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 	}
 }
 
+static int
+sw_port_linked(const struct sw_qid *qid, uint32_t port_id)
+{
+	uint32_t i;
+
+	for (i = 0; i < qid->cq_num_mapped_cqs; i++)
+		if (qid->cq_map[i] == port_id)
+			return 1;
+
+	return 0;
+}
+
+/* Split the QIDs into the scheduler groups: QIDs linked to a same port
+ * are kept together, and the resulting sets are spread over the groups.
+ * Ports follow the QIDs they are linked to, producer only ports are
+ * spread over the groups.
+ */
+static void
+sw_sched_groups_build(struct sw_evdev *sw)
+{
+	uint8_t set[RTE_EVENT_MAX_QUEUES_PER_DEV];
+	uint8_t set_grp[RTE_EVENT_MAX_QUEUES_PER_DEV];
+	uint32_t i, j, k, prio, nb_sets, nb_unlinked;
+	uint32_t nb_grps = sw->sched_group_count;
+
+	for (i = 0; i < sw->qid_count; i++)
+		set[i] = i;
+
+	/* merge the sets of all the QIDs linked to each port,
+	 * a set is named after its lowest QID
+	 */
+	for (i = 0; i < sw->port_count; i++) {
+		int first = -1;
+
+		for (j = 0; j < sw->qid_count; j++) {
+			uint8_t from, to;
+
+			if (!sw_port_linked(&sw->qids[j], i))
+				continue;
+			if (first < 0) {
+				first = j;
+				continue;
+			}
+			from = RTE_MAX(set[first], set[j]);
+			to = RTE_MIN(set[first], set[j]);
+			for (k = 0; k < sw->qid_count; k++)
+				if (set[k] == from)
+					set[k] = to;
+		}
+	}
+
+	nb_sets = 0;
+	for (i = 0; i < sw->qid_count; i++) {
+		if (set[i] == i)
+			set_grp[i] = nb_sets++ % nb_grps;
+		sw->qids[i].sched_group = set_grp[set[i]];
+	}
+
+	nb_unlinked = 0;
+	for (i = 0; i < sw->port_count; i++) {
+		struct sw_port *p = &sw->ports[i];
+
+		for (j = 0; j < sw->qid_count; j++)
+			if (sw_port_linked(&sw->qids[j], i))
+				break;
+
+		if (j < sw->qid_count)
+			p->sched_group = sw->qids[j].sched_group;
+		else
+			p->sched_group = nb_unlinked++ % nb_grps;
+	}
+
+	for (i = 0; i < nb_grps; i++) {
+		struct sw_sched_group *grp = &sw->sched_groups[i];
+
+		rte_spinlock_init(&grp->lock);
+		grp->port_count = 0;
+		for (j = 0; j < sw->port_count; j++)
+			if (sw->ports[j].sched_group == i)
+				grp->ports[grp->port_count++] = j;
+
+		/* build up our prioritized array of qids */
+		/* We don't use qsort here, as if all/multiple entries have
+		 * the same priority, the result is non-deterministic. From
+		 * "man 3 qsort": "If two members compare as equal, their
+		 * order in the sorted array is undefined."
+		 */
+		grp->qid_count = 0;
+		for (prio = 0; prio <= RTE_EVENT_DEV_PRIORITY_LOWEST; prio++) {
+			for (j = 0; j < sw->qid_count; j++) {
+				struct sw_qid *qid = &sw->qids[j];
+
+				if (qid->priority == prio &&
+						qid->sched_group == i)
+					grp->qids_prioritized[
+						grp->qid_count++] = qid;
+			}
+		}
+	}
+
+	if (nb_grps > 1 && nb_sets < nb_grps)
+		SW_LOG_INFO("%u scheduler groups used out of %u, more QIDs "
+			"have to be linked to disjoint sets of ports\n",
+			nb_sets, nb_grps);
+}
+
 static int
 sw_start(struct rte_eventdev *dev)
 {
-	unsigned int i, j;
+	unsigned int i;
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 
 	rte_service_component_runstate_set(sw->service_id, 1);
@@ -791,22 +964,7 @@ sw_start(struct rte_eventdev *dev)
 			return -ENOLINK;
 		}
 
-	/* build up our prioritized array of qids */
-	/* We don't use qsort here, as if all/multiple entries have the same
-	 * priority, the result is non-deterministic. From "man 3 qsort":
-	 * "If two members compare as equal, their order in the sorted
-	 * array is undefined."
-	 */
-	uint32_t qidx = 0;
-	for (j = 0; j <= RTE_EVENT_DEV_PRIORITY_LOWEST; j++) {
-		for (i = 0; i < sw->qid_count; i++) {
-			if (sw->qids[i].priority == j) {
-				sw->qids_prioritized[qidx] = &sw->qids[i];
-				qidx++;
-			}
-		}
-	}
-
+	sw_sched_groups_build(sw);
 	sw_init_qid_iqs(sw);
 
 	if (sw_xstats_init(sw) < 0)
@@ -862,11 +1020,18 @@ sw_close(struct rte_eventdev *dev)
 		sw_port_release(&sw->ports[i]);
 	sw->port_count = 0;
 
-	memset(&sw->stats, 0, sizeof(sw->stats));
-	sw->sched_called = 0;
-	sw->sched_no_iq_enqueues = 0;
-	sw->sched_no_cq_enqueues = 0;
-	sw->sched_cq_qid_called = 0;
+	for (i = 0; i < sw->sched_group_count; i++) {
+		struct sw_sched_group *grp = &sw->sched_groups[i];
+
+		memset(&grp->stats, 0, sizeof(grp->stats));
+		grp->sched_called = 0;
+		grp->sched_no_iq_enqueues = 0;
+		grp->sched_no_cq_enqueues = 0;
+		grp->sched_cq_qid_called = 0;
+
+		rte_event_ring_free(grp->rx_ring);
+		grp->rx_ring = NULL;
+	}
 
 	return 0;
 }
@@ -931,6 +1096,16 @@ set_refill_once(const char *key __rte_unused, const char *value, void *opaque)
 	return 0;
 }
 
+static int
+set_sched_groups(const char *key __rte_unused, const char *value, void *opaque)
+{
+	int *sched_groups = opaque;
+	*sched_groups = atoi(value);
+	if (*sched_groups < 1 || *sched_groups > SW_SCHED_GROUPS_MAX)
+		return -1;
+	return 0;
+}
+
 static int32_t sw_sched_service_func(void *args)
 {
 	struct rte_eventdev *dev = args;
@@ -979,18 +1154,21 @@ sw_probe(struct rte_vdev_device *vdev)
 		MIN_BURST_SIZE_ARG,
 		DEQ_BURST_SIZE_ARG,
 		REFIL_ONCE_ARG,
+		SCHED_GROUPS_ARG,
 		NULL
 	};
 	const char *name;
 	const char *params;
 	struct rte_eventdev *dev;
 	struct sw_evdev *sw;
+	uint32_t i;
 	int socket_id = rte_socket_id();
 	int sched_quanta  = SW_DEFAULT_SCHED_QUANTA;
 	int credit_quanta = SW_DEFAULT_CREDIT_QUANTA;
 	int min_burst_size = 1;
 	int deq_burst_size = SCHED_DEQUEUE_DEFAULT_BURST_SIZE;
 	int refill_once = 0;
+	int sched_groups = 1;
 
 	name = rte_vdev_device_name(vdev);
 	params = rte_vdev_device_args(vdev);
@@ -1062,6 +1240,16 @@ sw_probe(struct rte_vdev_device *vdev)
 				return ret;
 			}
 
+			ret = rte_kvargs_process(kvlist, SCHED_GROUPS_ARG,
+					set_sched_groups, &sched_groups);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing scheduler groups parameter",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
 			rte_kvargs_free(kvlist);
 		}
 	}
@@ -1069,9 +1257,11 @@ sw_probe(struct rte_vdev_device *vdev)
 	SW_LOG_INFO(
 			"Creating eventdev sw device %s, numa_node=%d, "
 			"sched_quanta=%d, credit_quanta=%d "
-			"min_burst=%d, deq_burst=%d, refill_once=%d\n",
+			"min_burst=%d, deq_burst=%d, refill_once=%d, "
+			"sched_groups=%d\n",
 			name, socket_id, sched_quanta, credit_quanta,
-			min_burst_size, deq_burst_size, refill_once);
+			min_burst_size, deq_burst_size, refill_once,
+			sched_groups);
 
 	dev = rte_event_pmd_vdev_init(name,
 			sizeof(struct sw_evdev), socket_id);
@@ -1099,6 +1289,9 @@ sw_probe(struct rte_vdev_device *vdev)
 	sw->sched_min_burst_size = min_burst_size;
 	sw->sched_deq_burst_size = deq_burst_size;
 	sw->refill_once_per_iter = refill_once;
+	sw->sched_group_count = sched_groups;
+	for (i = 0; i < SW_SCHED_GROUPS_MAX; i++)
+		sw->sched_groups[i].id = i;
 
 	/* register service with EAL */
 	struct rte_service_spec service;
@@ -1109,6 +1302,9 @@ sw_probe(struct rte_vdev_device *vdev)
 	service.socket_id = socket_id;
 	service.callback = sw_sched_service_func;
 	service.callback_userdata = (void *)dev;
+	/* groups are scheduled by as many service cores as mapped */
+	if (sched_groups > 1)
+		service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
 
 	int32_t ret = rte_service_component_register(&service, &sw->service_id);
 	if (ret) {
@@ -1147,5 +1343,5 @@ RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_SW_PMD, evdev_sw_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(event_sw, NUMA_NODE_ARG "=<int> "
 		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>"
 		MIN_BURST_SIZE_ARG "=<int>" DEQ_BURST_SIZE_ARG "=<int>"
-		REFIL_ONCE_ARG "=<int>");
+		REFIL_ONCE_ARG "=<int>" SCHED_GROUPS_ARG "=<int>");
 RTE_LOG_REGISTER_DEFAULT(eventdev_sw_log_level, NOTICE);
@@ -9,6 +9,7 @@
 #include <rte_eventdev.h>
 #include <eventdev_pmd_vdev.h>
 #include <rte_atomic.h>
+#include <rte_spinlock.h>
 
 #define SW_DEFAULT_CREDIT_QUANTA 32
 #define SW_DEFAULT_SCHED_QUANTA 128
@@ -21,6 +22,7 @@
 /* allow for lots of over-provisioning */
 #define MAX_SW_PROD_Q_DEPTH 4096
 #define SW_FRAGMENTS_MAX 16
+#define SW_SCHED_GROUPS_MAX 8
 
 /* Should be power-of-two minus one, to leave room for the next pointer */
 #define SW_EVS_PER_Q_CHUNK 255
@@ -133,6 +135,8 @@ struct sw_qid {
 	uint32_t window_size;          /* Used to wrap reorder_buffer_index */
 
 	uint8_t priority;
+	/* scheduler group this QID belongs to */
+	uint8_t sched_group;
 };
 
 struct sw_hist_list_entry {
@@ -153,6 +157,8 @@ struct sw_port {
 	uint8_t initialized;
 	/* A numeric ID for the port */
 	uint8_t id;
+	/* scheduler group pulling events from this port */
+	uint8_t sched_group;
 
 	/* An atomic counter for when the port has been unlinked, and the
 	 * scheduler has not yet acked this unlink - hence there may still be
@@ -209,6 +215,45 @@ struct sw_port {
 	uint8_t num_qids_mapped;
 };
 
+/*
+ * A scheduler group is a partition of the QIDs, along with the ports linked
+ * to them, which is scheduled independently of the other groups. Groups are
+ * built at start from the port to queue links, so that no port is linked to
+ * QIDs of two groups. Events enqueued from a port to a QID of another group
+ * are passed to that group through its rx_ring.
+ */
+struct sw_sched_group {
+	/* taken by the service core currently scheduling the group */
+	rte_spinlock_t lock;
+	uint8_t id;
+
+	/* Ports and QIDs of the group, QIDs sorted by priority level */
+	uint32_t port_count;
+	uint32_t qid_count;
+	uint8_t ports[SW_PORTS_MAX];
+	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+
+	/* Events from other groups, only used with several groups */
+	struct rte_event_ring *rx_ring;
+
+	/* IQ memory of the group QIDs */
+	struct sw_queue_chunk *chunk_list_head;
+	struct sw_queue_chunk *chunks;
+
+	/* Current values */
+	uint32_t sched_flush_count;
+	uint32_t sched_min_burst;
+
+	/* Stats */
+	struct sw_point_stats stats;
+	uint64_t sched_called;
+	uint64_t sched_no_iq_enqueues;
+	uint64_t sched_no_cq_enqueues;
+	uint64_t sched_cq_qid_called;
+	uint64_t sched_last_iter_bitmask;
+	uint8_t sched_progress_last_iter;
+} __rte_cache_aligned;
+
 struct sw_evdev {
 	struct rte_eventdev_data *data;
 
@@ -226,9 +271,8 @@ struct sw_evdev {
 	uint32_t sched_deq_burst_size;
 	/* Refill pp buffers only once per scheduler call*/
 	uint32_t refill_once_per_iter;
-	/* Current values */
-	uint32_t sched_flush_count;
-	uint32_t sched_min_burst;
+	/* Number of scheduler groups */
+	uint32_t sched_group_count;
 
 	/* Contains all ports - load balanced and directed */
 	struct sw_port ports[SW_PORTS_MAX] __rte_cache_aligned;
@@ -243,25 +287,13 @@ struct sw_evdev {
 
 	/* Internal queues - one per logical queue */
 	struct sw_qid qids[RTE_EVENT_MAX_QUEUES_PER_DEV] __rte_cache_aligned;
-	struct sw_queue_chunk *chunk_list_head;
-	struct sw_queue_chunk *chunks;
 
 	/* Cache how many packets are in each cq */
 	uint16_t cq_ring_space[SW_PORTS_MAX] __rte_cache_aligned;
 
-	/* Array of pointers to load-balanced QIDs sorted by priority level */
-	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+	struct sw_sched_group sched_groups[SW_SCHED_GROUPS_MAX];
 
-	/* Stats */
-	struct sw_point_stats stats __rte_cache_aligned;
-	uint64_t sched_called;
 	int32_t sched_quanta;
-	uint64_t sched_no_iq_enqueues;
-	uint64_t sched_no_cq_enqueues;
-	uint64_t sched_cq_qid_called;
-	uint64_t sched_last_iter_bitmask;
-	uint8_t sched_progress_last_iter;
-
 	uint8_t started;
 	uint32_t credit_update_quanta;
 
@@ -288,6 +320,12 @@ sw_pmd_priv_const(const struct rte_eventdev *eventdev)
 	return eventdev->data->dev_private;
 }
 
+static inline struct sw_sched_group *
+sw_qid_sched_group(struct sw_evdev *sw, const struct sw_qid *qid)
+{
+	return &sw->sched_groups[qid->sched_group];
+}
+
 uint16_t sw_event_enqueue(void *port, const struct rte_event *ev);
 uint16_t sw_event_enqueue_burst(void *port, const struct rte_event ev[],
 		uint16_t num);
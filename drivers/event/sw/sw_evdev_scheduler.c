@@ -29,13 +29,13 @@
 
 
 static inline uint32_t
-sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
-		uint32_t iq_num, unsigned int count)
+sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_sched_group *grp,
+		struct sw_qid * const qid, uint32_t iq_num, unsigned int count)
 {
 	struct rte_event qes[MAX_PER_IQ_DEQUEUE]; /* count <= MAX */
 	struct rte_event blocked_qes[MAX_PER_IQ_DEQUEUE];
 	uint32_t nb_blocked = 0;
-	uint32_t i;
+	uint32_t i, j, n;
 
 	if (count > MAX_PER_IQ_DEQUEUE)
 		count = MAX_PER_IQ_DEQUEUE;
@@ -45,13 +45,20 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 	 */
 	uint32_t qid_id = qid->id;
 
-	iq_dequeue_burst(sw, &qid->iq[iq_num], qes, count);
-	for (i = 0; i < count; i++) {
-		const struct rte_event *qe = &qes[i];
+	iq_dequeue_burst(grp, &qid->iq[iq_num], qes, count);
+	for (i = 0; i < count; i += n) {
 		const uint16_t flow_id = SW_HASH_FLOWID(qes[i].flow_id);
 		struct sw_fid_t *fid = &qid->fids[flow_id];
 		int cq = fid->cq;
 
+		/* Events of a flow often come in a row, e.g. event vectors
+		 * of an Rx queue or a burst forwarded by a worker: pin and
+		 * account them in one go.
+		 */
+		for (n = 1; i + n < count; n++)
+			if (SW_HASH_FLOWID(qes[i + n].flow_id) != flow_id)
+				break;
+
 		if (cq < 0) {
 			uint32_t cq_idx;
 			if (qid->cq_next_tx >= qid->cq_num_mapped_cqs)
@@ -75,45 +82,55 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			fid->cq = cq; /* this pins early */
 		}
 
-		if (sw->cq_ring_space[cq] == 0 ||
-				sw->ports[cq].inflights == SW_PORT_HIST_LIST) {
-			blocked_qes[nb_blocked++] = *qe;
-			continue;
-		}
-
 		struct sw_port *p = &sw->ports[cq];
 
-		/* at this point we can queue up the packet on the cq_buf */
-		fid->pcount++;
-		p->cq_buf[p->cq_buf_count++] = *qe;
-		p->inflights++;
-		sw->cq_ring_space[cq]--;
+		for (j = i; j != i + n; j++) {
+			if (sw->cq_ring_space[cq] == 0 ||
+					p->inflights == SW_PORT_HIST_LIST)
+				break;
 
-		int head = (p->hist_head++ & (SW_PORT_HIST_LIST-1));
-		p->hist_list[head].fid = flow_id;
-		p->hist_list[head].qid = qid_id;
+			/* at this point we can queue up the packet on the
+			 * cq_buf
+			 */
+			p->cq_buf[p->cq_buf_count++] = qes[j];
+			p->inflights++;
+			sw->cq_ring_space[cq]--;
 
-		p->stats.tx_pkts++;
-		qid->stats.tx_pkts++;
-		qid->to_port[cq]++;
-
-		/* if we just filled in the last slot, flush the buffer */
-		if (sw->cq_ring_space[cq] == 0) {
-			struct rte_event_ring *worker = p->cq_worker_ring;
-			rte_event_ring_enqueue_burst(worker, p->cq_buf,
-					p->cq_buf_count,
-					&sw->cq_ring_space[cq]);
-			p->cq_buf_count = 0;
+			int head = (p->hist_head++ & (SW_PORT_HIST_LIST-1));
+			p->hist_list[head].fid = flow_id;
+			p->hist_list[head].qid = qid_id;
+
+			/* if we just filled in the last slot, flush the
+			 * buffer
+			 */
+			if (sw->cq_ring_space[cq] == 0) {
+				struct rte_event_ring *worker =
+					p->cq_worker_ring;
+				rte_event_ring_enqueue_burst(worker, p->cq_buf,
+						p->cq_buf_count,
+						&sw->cq_ring_space[cq]);
+				p->cq_buf_count = 0;
+			}
 		}
+
+		fid->pcount += j - i;
+		p->stats.tx_pkts += j - i;
+		qid->stats.tx_pkts += j - i;
+		qid->to_port[cq] += j - i;
+
+		/* keep the flow order for the events which didn't fit */
+		for (; j != i + n; j++)
+			blocked_qes[nb_blocked++] = qes[j];
 	}
-	iq_put_back(sw, &qid->iq[iq_num], blocked_qes, nb_blocked);
+	iq_put_back(grp, &qid->iq[iq_num], blocked_qes, nb_blocked);
 
 	return count - nb_blocked;
 }
 
 static inline uint32_t
-sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
-		uint32_t iq_num, unsigned int count, int keep_order)
+sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_sched_group *grp,
+		struct sw_qid * const qid, uint32_t iq_num, unsigned int count,
+		int keep_order)
 {
 	uint32_t i;
 	uint32_t cq_idx = qid->cq_next_tx;
@@ -170,7 +187,7 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 					(void *)&p->hist_list[head].rob_entry);
 
 		sw->ports[cq].cq_buf[sw->ports[cq].cq_buf_count++] = *qe;
-		iq_pop(sw, &qid->iq[iq_num]);
+		iq_pop(grp, &qid->iq[iq_num]);
 
 		rte_compiler_barrier();
 		p->inflights++;
@@ -183,8 +200,9 @@ exit:
 }
 
 static uint32_t
-sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
-		uint32_t iq_num, unsigned int count __rte_unused)
+sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_sched_group *grp,
+		struct sw_qid * const qid, uint32_t iq_num,
+		unsigned int count __rte_unused)
 {
 	uint32_t cq_id = qid->cq_map[0];
 	struct sw_port *port = &sw->ports[cq_id];
@@ -196,7 +214,7 @@ sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 
 	/* burst dequeue from the QID IQ ring */
 	struct sw_iq *iq = &qid->iq[iq_num];
-	uint32_t ret = iq_dequeue_burst(sw, iq,
+	uint32_t ret = iq_dequeue_burst(grp, iq,
 			&port->cq_buf[port->cq_buf_count], count_free);
 	port->cq_buf_count += ret;
 
@@ -211,15 +229,15 @@ sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 }
 
 static uint32_t
-sw_schedule_qid_to_cq(struct sw_evdev *sw)
+sw_schedule_qid_to_cq(struct sw_evdev *sw, struct sw_sched_group *grp)
 {
 	uint32_t pkts = 0;
 	uint32_t qid_idx;
 
-	sw->sched_cq_qid_called++;
+	grp->sched_cq_qid_called++;
 
-	for (qid_idx = 0; qid_idx < sw->qid_count; qid_idx++) {
-		struct sw_qid *qid = sw->qids_prioritized[qid_idx];
+	for (qid_idx = 0; qid_idx < grp->qid_count; qid_idx++) {
+		struct sw_qid *qid = grp->qids_prioritized[qid_idx];
 
 		int type = qid->type;
 		int iq_num = PKT_MASK_TO_IQ(qid->iq_pkt_mask);
@@ -231,16 +249,16 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
 		uint32_t pkts_done = 0;
 		uint32_t count = iq_count(&qid->iq[iq_num]);
 
-		if (count >= sw->sched_min_burst) {
+		if (count >= grp->sched_min_burst) {
 			if (type == SW_SCHED_TYPE_DIRECT)
-				pkts_done += sw_schedule_dir_to_cq(sw, qid,
-						iq_num, count);
+				pkts_done += sw_schedule_dir_to_cq(sw, grp,
+						qid, iq_num, count);
 			else if (type == RTE_SCHED_TYPE_ATOMIC)
-				pkts_done += sw_schedule_atomic_to_cq(sw, qid,
-						iq_num, count);
+				pkts_done += sw_schedule_atomic_to_cq(sw, grp,
+						qid, iq_num, count);
 			else
-				pkts_done += sw_schedule_parallel_to_cq(sw, qid,
-						iq_num, count,
+				pkts_done += sw_schedule_parallel_to_cq(sw,
+						grp, qid, iq_num, count,
 						type == RTE_SCHED_TYPE_ORDERED);
 		}
 
@@ -256,19 +274,65 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
 	return pkts;
 }
 
+/* Push the QE into its QID at the right priority, or hand it over to the
+ * scheduler group of the QID if it isn't one of ours.
+ */
+static __rte_always_inline void
+sw_qid_enqueue(struct sw_evdev *sw, struct sw_sched_group *grp,
+		const struct rte_event *qe)
+{
+	uint32_t iq_num = PRIO_TO_IQ(qe->priority);
+	struct sw_qid *qid = &sw->qids[qe->queue_id];
+
+	if (unlikely(qid->sched_group != grp->id)) {
+		struct sw_sched_group *dst = sw_qid_sched_group(sw, qid);
+
+		/* rx_ring can hold all the events of the device, so
+		 * this can't fail unless credits are misused; the dropped
+		 * event is never released, so return its credit here
+		 */
+		if (rte_event_ring_enqueue_burst(dst->rx_ring, qe, 1,
+				NULL) != 1) {
+			grp->stats.rx_dropped++;
+			rte_atomic32_sub(&sw->inflights, 1);
+		}
+		return;
+	}
+
+	qid->iq_pkt_mask |= (1 << (iq_num));
+	iq_enqueue(grp, &qid->iq[iq_num], qe);
+	qid->iq_pkt_count[iq_num]++;
+	qid->stats.rx_pkts++;
+}
+
+/* Pull the QEs other scheduler groups sent to our QIDs */
+static uint32_t
+sw_schedule_pull_group(struct sw_evdev *sw, struct sw_sched_group *grp)
+{
+	struct rte_event qes[SCHED_DEQUEUE_MAX_BURST_SIZE];
+	uint32_t i, n;
+
+	n = rte_event_ring_dequeue_burst(grp->rx_ring, qes, RTE_DIM(qes),
+			NULL);
+	for (i = 0; i < n; i++)
+		sw_qid_enqueue(sw, grp, &qes[i]);
+
+	return n;
+}
+
 /* This function will perform re-ordering of packets, and injecting into
- * the appropriate QID IQ. As LB and DIR QIDs are in the same array, but *NOT*
- * contiguous in that array, this function accepts a "range" of QIDs to scan.
+ * the appropriate QID IQ, for the ordered QIDs of the scheduler group.
  */
 static uint16_t
-sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
+sw_schedule_reorder(struct sw_evdev *sw, struct sw_sched_group *grp)
 {
 	/* Perform egress reordering */
 	struct rte_event *qe;
 	uint32_t pkts_iter = 0;
+	uint32_t qid_idx;
 
-	for (; qid_start < qid_end; qid_start++) {
-		struct sw_qid *qid = &sw->qids[qid_start];
+	for (qid_idx = 0; qid_idx < grp->qid_count; qid_idx++) {
+		struct sw_qid *qid = grp->qids_prioritized[qid_idx];
 		unsigned int i, num_entries_in_use;
 
 		if (qid->type != RTE_SCHED_TYPE_ORDERED)
@@ -277,7 +341,7 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 		num_entries_in_use = rob_ring_free_count(
 					qid->reorder_buffer_freelist);
 
-		if (num_entries_in_use < sw->sched_min_burst)
+		if (num_entries_in_use < grp->sched_min_burst)
 			num_entries_in_use = 0;
 
 		for (i = 0; i < num_entries_in_use; i++) {
@@ -290,32 +354,20 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 				break;
 
 			for (j = 0; j < entry->num_fragments; j++) {
-				uint16_t dest_qid;
-				uint16_t dest_iq;
-
 				int idx = entry->fragment_index + j;
 				qe = &entry->fragments[idx];
 
-				dest_qid = qe->queue_id;
-				dest_iq  = PRIO_TO_IQ(qe->priority);
-
-				if (dest_qid >= sw->qid_count) {
-					sw->stats.rx_dropped++;
+				if (qe->queue_id >= sw->qid_count) {
+					grp->stats.rx_dropped++;
 					continue;
 				}
 
 				pkts_iter++;
 
-				struct sw_qid *q = &sw->qids[dest_qid];
-				struct sw_iq *iq = &q->iq[dest_iq];
-
 				/* we checked for space above, so enqueue must
 				 * succeed
 				 */
-				iq_enqueue(sw, iq, qe);
-				q->iq_pkt_mask |= (1 << (dest_iq));
-				q->iq_pkt_count[dest_iq]++;
-				q->stats.rx_pkts++;
+				sw_qid_enqueue(sw, grp, qe);
 			}
 
 			entry->ready = (j != entry->num_fragments);
@@ -348,7 +400,8 @@ sw_refill_pp_buf(struct sw_evdev *sw, struct sw_port *port)
 }
 
 static __rte_always_inline uint32_t
-__pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
+__pull_port_lb(struct sw_evdev *sw, struct sw_sched_group *grp,
+		uint32_t port_id, int allow_reorder)
 {
 	static struct reorder_buffer_entry dummy_rob;
 	uint32_t pkts_iter = 0;
@@ -368,15 +421,6 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 		if (!allow_reorder && !eop)
 			flags = QE_FLAG_VALID;
 
-		/*
-		 * if we don't have space for this packet in an IQ,
-		 * then move on to next queue. Technically, for a
-		 * packet that needs reordering, we don't need to check
-		 * here, but it simplifies things not to special-case
-		 */
-		uint32_t iq_num = PRIO_TO_IQ(qe->priority);
-		struct sw_qid *qid = &sw->qids[qe->queue_id];
-
 		/* now process based on flags. Note that for directed
 		 * queues, the enqueue_flush masks off all but the
 		 * valid flag. This makes FWD and PARTIAL enqueues just
@@ -427,7 +471,7 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 				 */
 				int num_frag = rob_entry->num_fragments;
 				if (num_frag == SW_FRAGMENTS_MAX)
-					sw->stats.rx_dropped++;
+					grp->stats.rx_dropped++;
 				else {
 					int idx = rob_entry->num_fragments++;
 					rob_entry->fragments[idx] = *qe;
@@ -435,14 +479,7 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 				goto end_qe;
 			}
 
-			/* Use the iq_num from above to push the QE
-			 * into the qid at the right priority
-			 */
-
-			qid->iq_pkt_mask |= (1 << (iq_num));
-			iq_enqueue(sw, &qid->iq[iq_num], qe);
-			qid->iq_pkt_count[iq_num]++;
-			qid->stats.rx_pkts++;
+			sw_qid_enqueue(sw, grp, qe);
 			pkts_iter++;
 		}
 
@@ -455,19 +492,22 @@ end_qe:
 }
 
 static uint32_t
-sw_schedule_pull_port_lb(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_lb(struct sw_evdev *sw, struct sw_sched_group *grp,
+		uint32_t port_id)
 {
-	return __pull_port_lb(sw, port_id, 1);
+	return __pull_port_lb(sw, grp, port_id, 1);
 }
 
 static uint32_t
-sw_schedule_pull_port_no_reorder(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_no_reorder(struct sw_evdev *sw,
+		struct sw_sched_group *grp, uint32_t port_id)
 {
-	return __pull_port_lb(sw, port_id, 0);
+	return __pull_port_lb(sw, grp, port_id, 0);
 }
 
 static uint32_t
-sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_dir(struct sw_evdev *sw, struct sw_sched_group *grp,
+		uint32_t port_id)
 {
 	uint32_t pkts_iter = 0;
 	struct sw_port *port = &sw->ports[port_id];
@@ -483,19 +523,9 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 		if ((flags & QE_FLAG_VALID) == 0)
 			goto end_qe;
 
-		uint32_t iq_num = PRIO_TO_IQ(qe->priority);
-		struct sw_qid *qid = &sw->qids[qe->queue_id];
-		struct sw_iq *iq = &qid->iq[iq_num];
-
 		port->stats.rx_pkts++;
 
-		/* Use the iq_num from above to push the QE
-		 * into the qid at the right priority
-		 */
-		qid->iq_pkt_mask |= (1 << (iq_num));
-		iq_enqueue(sw, iq, qe);
-		qid->iq_pkt_count[iq_num]++;
-		qid->stats.rx_pkts++;
+		sw_qid_enqueue(sw, grp, qe);
 		pkts_iter++;
 
 end_qe:
@@ -506,46 +536,54 @@ end_qe:
 	return pkts_iter;
 }
 
-int32_t
-sw_event_schedule(struct rte_eventdev *dev)
+static int32_t
+sw_schedule_group(struct sw_evdev *sw, struct sw_sched_group *grp)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	uint32_t in_pkts, out_pkts;
-	uint32_t out_pkts_total = 0, in_pkts_total = 0;
+	uint32_t out_pkts_total = 0, in_pkts_total = 0, grp_pkts_total = 0;
 	int32_t sched_quanta = sw->sched_quanta;
 	uint32_t i;
 
-	sw->sched_called++;
+	grp->sched_called++;
 	if (unlikely(!sw->started))
 		return -EAGAIN;
 
 	do {
 		uint32_t in_pkts_this_iteration = 0;
 
+		/* Pull QEs sent to our QIDs by other groups ports */
+		if (grp->rx_ring != NULL)
+			grp_pkts_total += sw_schedule_pull_group(sw, grp);
+
 		/* Pull from rx_ring for ports */
 		do {
 			in_pkts = 0;
-			for (i = 0; i < sw->port_count; i++) {
-				/* ack the unlinks in progress as done */
-				if (sw->ports[i].unlinks_in_progress)
-					sw->ports[i].unlinks_in_progress = 0;
+			for (i = 0; i < grp->port_count; i++) {
+				uint32_t port_id = grp->ports[i];
+				struct sw_port *port = &sw->ports[port_id];
 
-				if (sw->ports[i].is_directed)
-					in_pkts += sw_schedule_pull_port_dir(sw, i);
-				else if (sw->ports[i].num_ordered_qids > 0)
-					in_pkts += sw_schedule_pull_port_lb(sw, i);
+				/* ack the unlinks in progress as done */
+				if (port->unlinks_in_progress)
+					port->unlinks_in_progress = 0;
+
+				if (port->is_directed)
+					in_pkts += sw_schedule_pull_port_dir(sw,
+							grp, port_id);
+				else if (port->num_ordered_qids > 0)
+					in_pkts += sw_schedule_pull_port_lb(sw,
+							grp, port_id);
 				else
-					in_pkts += sw_schedule_pull_port_no_reorder(sw, i);
+					in_pkts += sw_schedule_pull_port_no_reorder(
+							sw, grp, port_id);
 			}
 
 			/* QID scan for re-ordered */
-			in_pkts += sw_schedule_reorder(sw, 0,
-					sw->qid_count);
+			in_pkts += sw_schedule_reorder(sw, grp);
 			in_pkts_this_iteration += in_pkts;
 		} while (in_pkts > 4 &&
 				(int)in_pkts_this_iteration < sched_quanta);
 
-		out_pkts = sw_schedule_qid_to_cq(sw);
+		out_pkts = sw_schedule_qid_to_cq(sw, grp);
 		out_pkts_total += out_pkts;
 		in_pkts_total += in_pkts_this_iteration;
 
@@ -553,14 +591,15 @@ sw_event_schedule(struct rte_eventdev *dev)
 			break;
 	} while ((int)out_pkts_total < sched_quanta);
 
-	sw->stats.tx_pkts += out_pkts_total;
-	sw->stats.rx_pkts += in_pkts_total;
+	grp->stats.tx_pkts += out_pkts_total;
+	grp->stats.rx_pkts += in_pkts_total;
 
-	sw->sched_no_iq_enqueues += (in_pkts_total == 0);
-	sw->sched_no_cq_enqueues += (out_pkts_total == 0);
+	grp->sched_no_iq_enqueues += (in_pkts_total == 0);
+	grp->sched_no_cq_enqueues += (out_pkts_total == 0);
 
-	uint64_t work_done = (in_pkts_total + out_pkts_total) != 0;
-	sw->sched_progress_last_iter = work_done;
+	uint64_t work_done =
+		(in_pkts_total + out_pkts_total + grp_pkts_total) != 0;
+	grp->sched_progress_last_iter = work_done;
 
 	uint64_t cqs_scheds_last_iter = 0;
 
@@ -568,48 +607,78 @@ sw_event_schedule(struct rte_eventdev *dev)
 	 * worker cores: aka, do the ring transfers batched.
 	 */
 	int no_enq = 1;
-	for (i = 0; i < sw->port_count; i++) {
-		struct sw_port *port = &sw->ports[i];
+	for (i = 0; i < grp->port_count; i++) {
+		uint32_t port_id = grp->ports[i];
+		struct sw_port *port = &sw->ports[port_id];
 		struct rte_event_ring *worker = port->cq_worker_ring;
 
 		/* If shadow ring has 0 pkts, pull from worker ring */
 		if (sw->refill_once_per_iter && port->pp_buf_count == 0)
 			sw_refill_pp_buf(sw, port);
 
-		if (port->cq_buf_count >= sw->sched_min_burst) {
+		if (port->cq_buf_count >= grp->sched_min_burst) {
 			rte_event_ring_enqueue_burst(worker,
 					port->cq_buf,
 					port->cq_buf_count,
-					&sw->cq_ring_space[i]);
+					&sw->cq_ring_space[port_id]);
 			port->cq_buf_count = 0;
 			no_enq = 0;
-			cqs_scheds_last_iter |= (1ULL << i);
+			cqs_scheds_last_iter |= (1ULL << port_id);
 		} else {
-			sw->cq_ring_space[i] =
+			sw->cq_ring_space[port_id] =
 					rte_event_ring_free_count(worker) -
 					port->cq_buf_count;
 		}
 	}
 
 	if (no_enq) {
-		if (unlikely(sw->sched_flush_count > SCHED_NO_ENQ_CYCLE_FLUSH))
-			sw->sched_min_burst = 1;
+		if (unlikely(grp->sched_flush_count > SCHED_NO_ENQ_CYCLE_FLUSH))
+			grp->sched_min_burst = 1;
 		else
-			sw->sched_flush_count++;
+			grp->sched_flush_count++;
 	} else {
-		if (sw->sched_flush_count)
-			sw->sched_flush_count--;
+		if (grp->sched_flush_count)
+			grp->sched_flush_count--;
 		else
-			sw->sched_min_burst = sw->sched_min_burst_size;
+			grp->sched_min_burst = sw->sched_min_burst_size;
 	}
 
 	/* Provide stats on what eventdev ports were scheduled to this
 	 * iteration. If more than 64 ports are active, always report that
 	 * all Eventdev ports have been scheduled events.
 	 */
-	sw->sched_last_iter_bitmask = cqs_scheds_last_iter;
+	grp->sched_last_iter_bitmask = cqs_scheds_last_iter;
 	if (unlikely(sw->port_count >= 64))
-		sw->sched_last_iter_bitmask = UINT64_MAX;
+		grp->sched_last_iter_bitmask = UINT64_MAX;
 
 	return work_done ? 0 : -EAGAIN;
 }
+
+int32_t
+sw_event_schedule(struct rte_eventdev *dev)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	uint32_t i, n, start;
+	int32_t ret = -EAGAIN;
+
+	n = sw->sched_group_count;
+	if (n == 1)
+		return sw_schedule_group(sw, &sw->sched_groups[0]);
+
+	/* The service is MT safe with several groups: each service core
+	 * schedules the groups no other core is busy with, starting from
+	 * a different one to limit contention.
+	 */
+	start = rte_lcore_id() % n;
+	for (i = 0; i < n; i++) {
+		struct sw_sched_group *grp = &sw->sched_groups[(start + i) % n];
+
+		if (!rte_spinlock_trylock(&grp->lock))
+			continue;
+		if (sw_schedule_group(sw, grp) == 0)
+			ret = 0;
+		rte_spinlock_unlock(&grp->lock);
+	}
+
+	return ret;
+}
@@ -2959,6 +2959,124 @@ err:
 	return -1;
 }
 
+static int
+sched_groups(struct test *t)
+{
+	static const char *eventdev_name = "event_sw_sched_groups";
+	struct rte_event ev[8];
+	const int evdev_save = evdev;
+	const uint32_t service_save = t->service_id;
+	uint32_t i, n;
+	int ret = -1;
+
+	if (rte_vdev_init(eventdev_name, "sched_groups=2") < 0) {
+		printf("%d: Error creating eventdev\n", __LINE__);
+		return -1;
+	}
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0 ||
+			rte_event_dev_service_id_get(evdev,
+				&t->service_id) < 0) {
+		printf("%d: Error getting eventdev\n", __LINE__);
+		goto out;
+	}
+	rte_service_runstate_set(t->service_id, 1);
+	rte_service_set_runstate_mapped_check(t->service_id, 0);
+
+	/* producer port 0, port 1 on qid 0 and port 2 on qid 1:
+	 * each qid goes to a group of its own
+	 */
+	if (init(t, 2, 3) < 0 ||
+			create_ports(t, 3) < 0 ||
+			create_atomic_qids(t, 2) < 0) {
+		printf("%d: Error initializing device\n", __LINE__);
+		goto out;
+	}
+
+	if (rte_event_port_link(evdev, t->port[1], &t->qid[0], NULL, 1) != 1 ||
+			rte_event_port_link(evdev, t->port[2], &t->qid[1],
+				NULL, 1) != 1) {
+		printf("%d: Error linking queues\n", __LINE__);
+		goto err;
+	}
+
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		goto err;
+	}
+
+	/* a port can't be linked to the qids of two groups */
+	if (rte_event_port_link(evdev, t->port[1], &t->qid[1], NULL, 1) != 0) {
+		printf("%d: Port linked across scheduler groups\n", __LINE__);
+		goto err;
+	}
+
+	/* new events from port 0 to qid 1, then forwarded to qid 0 */
+	for (i = 0; i < RTE_DIM(ev); i++) {
+		ev[i] = (struct rte_event){0};
+		ev[i].op = RTE_EVENT_OP_NEW;
+		ev[i].queue_id = t->qid[1];
+		ev[i].flow_id = i & 1;
+		ev[i].u64 = i;
+	}
+	if (rte_event_enqueue_burst(evdev, t->port[0], ev, RTE_DIM(ev)) !=
+			RTE_DIM(ev)) {
+		printf("%d: Error enqueuing events\n", __LINE__);
+		goto err;
+	}
+
+	/* one call may be needed to hand the events over to the other
+	 * group, and another one to schedule them there
+	 */
+	rte_service_run_iter_on_app_lcore(t->service_id, 1);
+	rte_service_run_iter_on_app_lcore(t->service_id, 1);
+
+	n = rte_event_dequeue_burst(evdev, t->port[2], ev, RTE_DIM(ev), 0);
+	if (n != RTE_DIM(ev)) {
+		printf("%d: Got %u events on port 2, expected %u\n", __LINE__,
+				n, (uint32_t)RTE_DIM(ev));
+		goto err;
+	}
+
+	for (i = 0; i < n; i++) {
+		ev[i].op = RTE_EVENT_OP_FORWARD;
+		ev[i].queue_id = t->qid[0];
+	}
+	if (rte_event_enqueue_burst(evdev, t->port[2], ev, n) != n) {
+		printf("%d: Error forwarding events\n", __LINE__);
+		goto err;
+	}
+
+	rte_service_run_iter_on_app_lcore(t->service_id, 1);
+	rte_service_run_iter_on_app_lcore(t->service_id, 1);
+
+	n = rte_event_dequeue_burst(evdev, t->port[1], ev, RTE_DIM(ev), 0);
+	if (n != RTE_DIM(ev)) {
+		printf("%d: Got %u events on port 1, expected %u\n", __LINE__,
+				n, (uint32_t)RTE_DIM(ev));
+		goto err;
+	}
+
+	/* atomic flows keep their order across groups */
+	for (i = 0; i < n; i++) {
+		if (ev[i].u64 != i) {
+			printf("%d: Event %u out of order\n", __LINE__, i);
+			goto err;
+		}
+	}
+
+	ret = 0;
+err:
+	if (ret != 0)
+		rte_event_dev_dump(evdev, stdout);
+	cleanup(t);
+out:
+	rte_vdev_uninit(eventdev_name);
+	evdev = evdev_save;
+	t->service_id = service_save;
+	return ret;
+}
+
 static int
 worker_loopback_worker_fn(void *arg)
 {
@@ -3388,6 +3506,12 @@ test_sw_eventdev(void)
 		printf("ERROR - Stop Flush test FAILED.\n");
 		goto test_fail;
 	}
+	printf("*** Running Scheduler Groups test...\n");
+	ret = sched_groups(t);
+	if (ret != 0) {
+		printf("ERROR - Scheduler Groups test FAILED.\n");
+		goto test_fail;
+	}
 	if (rte_lcore_count() >= 3) {
 		printf("*** Running Worker loopback test...\n");
 		ret = worker_loopback(t, 0);
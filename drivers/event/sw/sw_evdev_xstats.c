@@ -49,23 +49,43 @@ struct sw_xstats_entry {
 };
 
 static uint64_t
-get_dev_stat(const struct sw_evdev *sw, uint16_t obj_idx __rte_unused,
-		enum xstats_type type, int extra_arg __rte_unused)
+get_sched_group_stat(const struct sw_sched_group *grp, enum xstats_type type)
 {
 	switch (type) {
-	case rx: return sw->stats.rx_pkts;
-	case tx: return sw->stats.tx_pkts;
-	case dropped: return sw->stats.rx_dropped;
-	case calls: return sw->sched_called;
-	case no_iq_enq: return sw->sched_no_iq_enqueues;
-	case no_cq_enq: return sw->sched_no_cq_enqueues;
-	case sched_last_iter_bitmask: return sw->sched_last_iter_bitmask;
-	case sched_progress_last_iter: return sw->sched_progress_last_iter;
+	case rx: return grp->stats.rx_pkts;
+	case tx: return grp->stats.tx_pkts;
+	case dropped: return grp->stats.rx_dropped;
+	case calls: return grp->sched_called;
+	case no_iq_enq: return grp->sched_no_iq_enqueues;
+	case no_cq_enq: return grp->sched_no_cq_enqueues;
+	case sched_last_iter_bitmask: return grp->sched_last_iter_bitmask;
+	case sched_progress_last_iter: return grp->sched_progress_last_iter;
 
 	default: return -1;
 	}
 }
 
+static uint64_t
+get_dev_stat(const struct sw_evdev *sw, uint16_t obj_idx __rte_unused,
+		enum xstats_type type, int extra_arg __rte_unused)
+{
+	uint64_t val = 0;
+	uint32_t i;
+
+	/* counters add up over the scheduler groups, flags are or-ed */
+	for (i = 0; i < sw->sched_group_count; i++) {
+		uint64_t v = get_sched_group_stat(&sw->sched_groups[i], type);
+
+		if (type == sched_last_iter_bitmask ||
+				type == sched_progress_last_iter)
+			val |= v;
+		else
+			val += v;
+	}
+
+	return val;
+}
+
 static uint64_t
 get_port_stat(const struct sw_evdev *sw, uint16_t obj_idx,
 		enum xstats_type type, int extra_arg __rte_unused)
@@ -2085,14 +2085,20 @@ cmd_softnic_pipeline_stats(struct pmd_internals *softnic,
 			"\t\tLearn OK (packets): %" PRIu64 "\n"
 			"\t\tLearn error (packets): %" PRIu64 "\n"
 			"\t\tRearm (packets): %" PRIu64 "\n"
-			"\t\tForget (packets): %" PRIu64 "\n",
+			"\t\tForget (packets): %" PRIu64 "\n"
+			"\t\tLearned (keys): %" PRIu64 "\n"
+			"\t\tExpired (keys): %" PRIu64 "\n"
+			"\t\tRejected (keys): %" PRIu64 "\n",
 			learner_info.name,
 			stats.n_pkts_hit,
 			stats.n_pkts_miss,
 			stats.n_pkts_learn_ok,
 			stats.n_pkts_learn_err,
 			stats.n_pkts_rearm,
-			stats.n_pkts_forget);
+			stats.n_pkts_forget,
+			stats.n_keys_learned,
+			stats.n_keys_expired,
+			stats.n_keys_rejected);
 		out_size -= strlen(out);
 		out += strlen(out);
 
@@ -110,6 +110,13 @@ TAILQ_HEAD(pipeline_list, pipeline);
 #define PIPELINE_INSTR_QUANTA                              1000
 #endif
 
+/* Number of buckets checked for expired keys in each learner table of a
+ * pipeline every time the pipeline is run.
+ */
+#ifndef PIPELINE_AGE_BUCKETS
+#define PIPELINE_AGE_BUCKETS                               16
+#endif
+
 /**
  * Main thread: data plane thread context
  */
@@ -534,8 +534,10 @@ rte_pmd_softnic_run_internal(void *arg)
 	t->iter++;
 
 	/* Data Plane */
-	for (j = 0; j < t->n_pipelines; j++)
+	for (j = 0; j < t->n_pipelines; j++) {
 		rte_swx_pipeline_run(t->p[j], PIPELINE_INSTR_QUANTA);
+		rte_swx_pipeline_age(t->p[j], PIPELINE_AGE_BUCKETS);
+	}
 
 	/* Control Plane */
 	if ((t->iter & 0xFLLU) == 0) {
@@ -60,6 +60,10 @@
 
 /* Graph module */
 #define WORKER_MODEL_RTC "rtc"
+#define LOOKUP_METHOD_LPM "lpm"
+#define LOOKUP_METHOD_FIB "fib"
+#define FIB_MAX_ROUTES (1 << 20)
+#define FIB_NUM_TBL8 (1 << 15)
 #define WORKER_MODEL_MCORE_DISPATCH "dispatch"
 /* Static global variables used within this file. */
 static uint16_t nb_rxd = RX_DESC_DEFAULT;
@@ -87,6 +91,9 @@ static char pcap_filename[RTE_GRAPH_PCAP_FILE_SZ];
 static uint64_t packet_to_capture;
 static int pcap_trace_enable;
 
+/* Route lookup with FIB instead of LPM */
+static int lookup_fib;
+
 
 struct lcore_rx_queue {
 	uint16_t port_id;
@@ -317,7 +324,8 @@ print_usage(const char *prgname)
 		" [--max-pkt-len PKTLEN]"
 		" [--no-numa]"
 		" [--per-port-pool]"
-		" [--num-pkt-cap]\n\n"
+		" [--num-pkt-cap]"
+		" [--lookup NAME]\n\n"
 
 		"  -p PORTMASK: Hexadecimal bitmask of ports to configure\n"
 		"  -P : Enable promiscuous mode\n"
@@ -325,6 +333,7 @@ print_usage(const char *prgname)
 		"  --eth-dest=X,MM:MM:MM:MM:MM:MM: Ethernet destination for "
 		"port X\n"
 		"  --max-pkt-len PKTLEN: maximum packet length in decimal (64-9600)\n"
+		"  --lookup NAME: route lookup method, lpm(by default) or fib\n"
 		"  --model NAME: walking model name, dispatch or rtc(by default)\n"
 		"  --no-numa: Disable numa awareness\n"
 		"  --per-port-pool: Use separate buffer pool per port\n"
@@ -385,6 +394,17 @@ parse_worker_model(const char *model)
 #endif
 }
 
+static void
+parse_lookup(const char *lookup)
+{
+	if (strcmp(lookup, LOOKUP_METHOD_FIB) == 0)
+		lookup_fib = 1;
+	else if (strcmp(lookup, LOOKUP_METHOD_LPM) == 0)
+		lookup_fib = 0;
+	else
+		rte_exit(EXIT_FAILURE, "Invalid lookup method: %s", lookup);
+}
+
 static int
 parse_portmask(const char *portmask)
 {
@@ -502,6 +522,7 @@ static const char short_options[] = "p:" /* portmask */
 #define CMD_LINE_OPT_NUM_PKT_CAP   "pcap-num-cap"
 #define CMD_LINE_OPT_PCAP_FILENAME "pcap-file-name"
 #define CMD_LINE_OPT_WORKER_MODEL  "model"
+#define CMD_LINE_OPT_LOOKUP        "lookup"
 
 enum {
 	/* Long options mapped to a short option */
@@ -519,6 +540,7 @@ enum {
 	CMD_LINE_OPT_PARSE_NUM_PKT_CAP,
 	CMD_LINE_OPT_PCAP_FILENAME_CAP,
 	CMD_LINE_OPT_WORKER_MODEL_TYPE,
+	CMD_LINE_OPT_LOOKUP_NUM,
 };
 
 static const struct option lgopts[] = {
@@ -531,6 +553,7 @@ static const struct option lgopts[] = {
 	{CMD_LINE_OPT_NUM_PKT_CAP, 1, 0, CMD_LINE_OPT_PARSE_NUM_PKT_CAP},
 	{CMD_LINE_OPT_PCAP_FILENAME, 1, 0, CMD_LINE_OPT_PCAP_FILENAME_CAP},
 	{CMD_LINE_OPT_WORKER_MODEL, 1, 0, CMD_LINE_OPT_WORKER_MODEL_TYPE},
+	{CMD_LINE_OPT_LOOKUP, 1, 0, CMD_LINE_OPT_LOOKUP_NUM},
 	{NULL, 0, 0, 0},
 };
 
@@ -627,6 +650,10 @@ parse_args(int argc, char **argv)
 			parse_worker_model(optarg);
 			break;
 
+		case CMD_LINE_OPT_LOOKUP_NUM:
+			parse_lookup(optarg);
+			break;
+
 		default:
 			print_usage(prgname);
 			return -1;
@@ -1256,6 +1283,27 @@ main(int argc, char **argv)
 	if (ret)
 		rte_exit(EXIT_FAILURE, "rte_node_eth_config: err=%d\n", ret);
 
+	/* Switch lookup nodes to FIB before they get initialized */
+	if (lookup_fib) {
+		struct rte_node_ip4_lookup_fib_conf fib4_conf = {
+			.max_routes = FIB_MAX_ROUTES,
+			.num_tbl8 = FIB_NUM_TBL8,
+		};
+		struct rte_node_ip6_lookup_fib_conf fib6_conf = {
+			.max_routes = FIB_MAX_ROUTES,
+			.num_tbl8 = FIB_NUM_TBL8,
+		};
+
+		ret = rte_node_ip4_lookup_fib_config(&fib4_conf);
+		if (ret)
+			rte_exit(EXIT_FAILURE,
+				 "rte_node_ip4_lookup_fib_config: err=%d\n", ret);
+		ret = rte_node_ip6_lookup_fib_config(&fib6_conf);
+		if (ret)
+			rte_exit(EXIT_FAILURE,
+				 "rte_node_ip6_lookup_fib_config: err=%d\n", ret);
+	}
+
 	/* Start ports */
 	RTE_ETH_FOREACH_DEV(portid)
 	{
@@ -29,6 +29,13 @@
 #define PIPELINE_INSTR_QUANTA                              1000
 #endif
 
+/* Number of buckets checked for expired keys in each learner table of a pipeline every time the
+ * pipeline is run. The full scan of a table with N buckets takes N / PIPELINE_AGE_BUCKETS runs.
+ */
+#ifndef PIPELINE_AGE_BUCKETS
+#define PIPELINE_AGE_BUCKETS                               16
+#endif
+
 /**
  * In this design, there is a single control plane (CP) thread and one or multiple data plane (DP)
  * threads. Each DP thread can run up to THREAD_PIPELINES_MAX pipelines and up to THREAD_BLOCKS_MAX
@@ -363,8 +370,10 @@ thread_main(void *arg __rte_unused)
 		uint32_t i;
 
 		/* Pipelines. */
-		for (i = 0; i < t->n_pipelines; i++)
+		for (i = 0; i < t->n_pipelines; i++) {
 			rte_swx_pipeline_run(t->pipelines[i], PIPELINE_INSTR_QUANTA);
+			rte_swx_pipeline_age(t->pipelines[i], PIPELINE_AGE_BUCKETS);
+		}
 
 		/* Blocks. */
 		for (i = 0; i < t->n_blocks; i++) {
@@ -6,6 +6,8 @@
 #define BPF_IMPL_H
 
 #include <rte_bpf.h>
+#include <rte_bpf_map.h>
+#include <rte_spinlock.h>
 #include <sys/mman.h>
 
 #define MAX_BPF_STACK_SIZE	0x200
@@ -13,10 +15,58 @@
 struct rte_bpf {
 	struct rte_bpf_prm prm;
 	struct rte_bpf_jit jit;
+	struct rte_bpf_jit_burst jit_burst;
 	size_t sz;
 	uint32_t stack_sz;
 };
 
+struct rte_hash;
+struct rte_rcu_qsbr;
+struct rte_rcu_qsbr_dq;
+
+struct rte_bpf_map {
+	enum rte_bpf_map_type type;
+	uint32_t key_size;
+	uint32_t value_size;
+	uint32_t max_entries;
+	uint64_t value_stride; /* value size, rounded up to 8B */
+	uint64_t lcore_stride; /* size of per lcore copy of the values */
+	uint8_t *values;
+	struct rte_hash *hash;
+	rte_spinlock_t lock;   /* serializes hash map updates and deletes */
+	uint32_t *free_values; /* indexes of the unused hash map values */
+	uint32_t nb_free_values;
+	struct rte_rcu_qsbr_dq *dq; /* deleted hash map elements */
+	struct rte_rcu_qsbr *v;     /* readers of the hash map */
+	char name[RTE_BPF_MAP_NAMESIZE];
+};
+
+/* map helpers, known to the verifier and JIT */
+enum bpf_map_func {
+	BPF_MAP_FUNC_NONE,
+	BPF_MAP_FUNC_LOOKUP,
+	BPF_MAP_FUNC_UPDATE,
+	BPF_MAP_FUNC_DELETE,
+};
+
+static inline enum bpf_map_func
+bpf_map_func(const struct rte_bpf_xsym *xsym)
+{
+	uintptr_t fn;
+
+	if (xsym->type != RTE_BPF_XTYPE_FUNC)
+		return BPF_MAP_FUNC_NONE;
+
+	fn = (uintptr_t)xsym->func.val;
+	if (fn == (uintptr_t)rte_bpf_map_lookup_elem)
+		return BPF_MAP_FUNC_LOOKUP;
+	else if (fn == (uintptr_t)rte_bpf_map_update_elem)
+		return BPF_MAP_FUNC_UPDATE;
+	else if (fn == (uintptr_t)rte_bpf_map_delete_elem)
+		return BPF_MAP_FUNC_DELETE;
+	return BPF_MAP_FUNC_NONE;
+}
+
 /*
  * Use '__rte' prefix for non-static internal functions
  * to avoid potential name conflict with other libraries.
@@ -90,6 +90,15 @@ enum {
 	LDMB_OFS_NUM
 };
 
+/* map lookup offsets */
+enum {
+	MAPL_ARR_OFS, /* array map */
+	MAPL_NUL_OFS, /* element not found */
+	MAPL_CALL_OFS, /* other map types */
+	MAPL_FIN_OFS, /* final part */
+	MAPL_OFS_NUM
+};
+
 /*
  * callee saved registers list.
  * keep RBP as the last one.
@@ -106,6 +115,13 @@ struct bpf_jit_state {
 	struct {
 		uint32_t stack_ofs;
 	} ldmb;
+	struct {
+		uint32_t on;
+		uint32_t arg_type;
+		int32_t loop_off;
+		int32_t body_off;
+		int32_t done_off;
+	} burst;
 	uint32_t reguse;
 	int32_t *off;
 	uint8_t *ins;
@@ -1190,6 +1206,102 @@ emit_ld_mbuf(struct bpf_jit_state *st, uint32_t op, uint32_t sreg, uint32_t imm)
 	emit_ldmb_fin(st, rg[EBPF_REG_0], opsz, sz);
 }
 
+/*
+ * helper function, used by emit_map_lookup().
+ * generates the code for array map element lookup,
+ * R1 holds the map, R2 the pointer to the key.
+ */
+static void
+emit_mapl_array(struct bpf_jit_state *st, const int32_t ofs[MAPL_OFS_NUM])
+{
+	const uint32_t r0 = ebpf2x86[EBPF_REG_0];
+	const uint32_t r1 = ebpf2x86[EBPF_REG_1];
+	const uint32_t r2 = ebpf2x86[EBPF_REG_2];
+	const uint32_t r3 = ebpf2x86[EBPF_REG_3];
+
+	/* JNE map->type, RTE_BPF_MAP_TYPE_ARRAY, <call> */
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | BPF_W, r1, r3,
+		offsetof(struct rte_bpf_map, type));
+	emit_cmp_imm(st, EBPF_ALU64, r3, RTE_BPF_MAP_TYPE_ARRAY);
+	emit_abs_jcc(st, BPF_JMP | EBPF_JNE | BPF_K, ofs[MAPL_CALL_OFS]);
+
+	/* JGE *(uint32_t *)key, map->max_entries, <null> */
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | BPF_W, r2, r0, 0);
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | BPF_W, r1, r3,
+		offsetof(struct rte_bpf_map, max_entries));
+	emit_cmp_reg(st, EBPF_ALU64, r3, r0);
+	emit_abs_jcc(st, BPF_JMP | BPF_JGE | BPF_K, ofs[MAPL_NUL_OFS]);
+
+	/* R0 = map->values + R0 * map->value_stride */
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, r1, r3,
+		offsetof(struct rte_bpf_map, value_stride));
+	emit_mul(st, EBPF_ALU64 | BPF_MUL | BPF_X, r3, r0, 0);
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, r1, r3,
+		offsetof(struct rte_bpf_map, values));
+	emit_alu_reg(st, EBPF_ALU64 | BPF_ADD | BPF_X, r3, r0);
+	emit_abs_jmp(st, ofs[MAPL_FIN_OFS]);
+}
+
+/*
+ * helper function, used by emit_map_lookup().
+ * generates the code for array index out of bounds.
+ */
+static void
+emit_mapl_null(struct bpf_jit_state *st, const int32_t ofs[MAPL_OFS_NUM])
+{
+	emit_mov_imm(st, EBPF_ALU64 | EBPF_MOV | BPF_K, ebpf2x86[EBPF_REG_0],
+		0);
+	emit_abs_jmp(st, ofs[MAPL_FIN_OFS]);
+}
+
+/*
+ * emit code for rte_bpf_map_lookup_elem() call.
+ * Lookups in array maps are inlined, other map types need lcore id
+ * or hash table access and go through the actual function call:
+ *   if (map->type != RTE_BPF_MAP_TYPE_ARRAY)
+ *      goto call;
+ *   idx = *(uint32_t *)key;
+ *   if (idx >= map->max_entries)
+ *      goto null;
+ *   R0 = map->values + idx * map->value_stride;
+ *   goto fin_part;
+ * null:
+ *   R0 = NULL;
+ *   goto fin_part;
+ * call:
+ *   R0 = rte_bpf_map_lookup_elem(map, key);
+ * fin_part:
+ */
+static void
+emit_map_lookup(struct bpf_jit_state *st, uintptr_t trg)
+{
+	uint32_t i;
+	int32_t ofs[MAPL_OFS_NUM];
+
+	/* fill with fake offsets */
+	for (i = 0; i != RTE_DIM(ofs); i++)
+		ofs[i] = st->sz + INT8_MAX;
+
+	/* dry run first to calculate jump offsets */
+
+	ofs[MAPL_ARR_OFS] = st->sz;
+	emit_mapl_array(st, ofs);
+	ofs[MAPL_NUL_OFS] = st->sz;
+	emit_mapl_null(st, ofs);
+	ofs[MAPL_CALL_OFS] = st->sz;
+	emit_call(st, trg);
+	ofs[MAPL_FIN_OFS] = st->sz;
+
+	RTE_VERIFY(ofs[MAPL_FIN_OFS] - ofs[MAPL_ARR_OFS] <= INT8_MAX);
+
+	/* reset dry-run code and do a proper run */
+
+	st->sz = ofs[MAPL_ARR_OFS];
+	emit_mapl_array(st, ofs);
+	emit_mapl_null(st, ofs);
+	emit_call(st, trg);
+}
+
 static void
 emit_prolog(struct bpf_jit_state *st, int32_t stack_size)
 {
@@ -1275,6 +1387,171 @@ emit_epilog(struct bpf_jit_state *st)
 	emit_ret(st);
 }
 
+/*
+ * burst function frame layout, on top of the eBPF stack:
+ * input parameters saved at the bottom of the frame.
+ */
+enum {
+	BURST_CTX_OFS = 0,
+	BURST_RC_OFS = sizeof(uint64_t),
+	BURST_NUM_OFS = 2 * sizeof(uint64_t),
+	BURST_SLOT_SZ = 3 * sizeof(uint64_t),
+};
+
+/*
+ * emit prefetcht0 (%<reg>)
+ */
+static void
+emit_prefetch0(struct bpf_jit_state *st, uint32_t reg)
+{
+	const uint8_t ops[] = {0x0F, 0x18};
+
+	emit_rex(st, BPF_LDX | BPF_MEM | BPF_W, 0, reg);
+	emit_bytes(st, ops, sizeof(ops));
+	/* ModRM.reg == 1 selects T0 hint */
+	emit_modregrm(st, MOD_IDISP8, 1, reg);
+	if (reg == RSP || reg == R12)
+		emit_sib(st, SIB_SCALE_1, reg, reg);
+	emit_imm(st, 0, sizeof(uint8_t));
+}
+
+/*
+ * prolog for the burst version of the code:
+ * uint32_t func(void *ctx[], uint64_t rc[], uint32_t num)
+ * Saves all callee saved registers unconditionally, as R12 is used
+ * as a loop counter and ctx/rc/num are kept in the stack frame.
+ * Then loads R1 with the next ctx[] element and prefetches the packet
+ * data for the one after it, while the current one is being processed.
+ */
+static void
+emit_burst_prolog(struct bpf_jit_state *st, int32_t stack_size)
+{
+	uint32_t i;
+	int32_t frame, ofs;
+
+	emit_alu_imm(st, EBPF_ALU64 | BPF_SUB | BPF_K, RSP,
+		RTE_DIM(save_regs) * sizeof(uint64_t));
+
+	ofs = 0;
+	for (i = 0; i != RTE_DIM(save_regs); i++) {
+		emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW,
+			save_regs[i], RSP, ofs);
+		ofs += sizeof(uint64_t);
+	}
+
+	/* keep RSP 16B aligned for the external calls */
+	frame = RTE_ALIGN_CEIL(stack_size + BURST_SLOT_SZ, 16) +
+		sizeof(uint64_t);
+
+	emit_mov_reg(st, EBPF_ALU64 | EBPF_MOV | BPF_X, RSP, RBP);
+	emit_alu_imm(st, EBPF_ALU64 | BPF_SUB | BPF_K, RSP, frame);
+
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RDI, RSP, BURST_CTX_OFS);
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RSI, RSP, BURST_RC_OFS);
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RDX, RSP, BURST_NUM_OFS);
+
+	/* R12 = num (zero extended); if (R12 == 0) goto done */
+	emit_mov_reg(st, BPF_ALU | EBPF_MOV | BPF_X, RDX, R12);
+	emit_tst_reg(st, EBPF_ALU64, R12, R12);
+	emit_abs_jcc(st, BPF_JMP | BPF_JEQ | BPF_K, st->burst.done_off);
+
+	st->burst.loop_off = st->sz;
+
+	/* R1 = ctx[0] */
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RSP, REG_TMP0,
+		BURST_CTX_OFS);
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, REG_TMP0,
+		ebpf2x86[EBPF_REG_1], 0);
+
+	if (st->burst.arg_type == RTE_BPF_ARG_PTR ||
+			st->burst.arg_type == RTE_BPF_ARG_PTR_MBUF) {
+
+		/* if (R12 == 1) goto body, there is no next packet */
+		emit_cmp_imm(st, EBPF_ALU64, R12, 1);
+		emit_abs_jcc(st, BPF_JMP | BPF_JEQ | BPF_K,
+			st->burst.body_off);
+
+		/* TMP0 = ctx[1] */
+		emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, REG_TMP0,
+			REG_TMP0, sizeof(uint64_t));
+
+		/* TMP0 = TMP0->buf_addr + TMP0->data_off */
+		if (st->burst.arg_type == RTE_BPF_ARG_PTR_MBUF) {
+			emit_ld_reg(st, BPF_LDX | BPF_MEM | BPF_H, REG_TMP0,
+				REG_TMP1, offsetof(struct rte_mbuf, data_off));
+			emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, REG_TMP0,
+				REG_TMP0, offsetof(struct rte_mbuf, buf_addr));
+			emit_alu_reg(st, EBPF_ALU64 | BPF_ADD | BPF_X,
+				REG_TMP1, REG_TMP0);
+		}
+
+		emit_prefetch0(st, REG_TMP0);
+	}
+
+	st->burst.body_off = st->sz;
+}
+
+/*
+ * epilog for the burst version of the code.
+ * Instead of returning, stores R0 into rc[], advances ctx[] and rc[]
+ * and jumps back to the beginning of the loop.
+ * Slow path of BPF_ABS/BPF_IND failure lands here with R0 == 0.
+ */
+static void
+emit_burst_epilog(struct bpf_jit_state *st)
+{
+	uint32_t i;
+	int32_t ofs;
+
+	/* if we already have an epilog generate a jump to it */
+	if (st->exit.num++ != 0) {
+		emit_abs_jmp(st, st->exit.off);
+		return;
+	}
+
+	/* store offset of epilog block */
+	st->exit.off = st->sz;
+
+	/* *rc++ = R0 */
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RSP, REG_TMP0,
+		BURST_RC_OFS);
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RAX, REG_TMP0, 0);
+	emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, REG_TMP0,
+		sizeof(uint64_t));
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, REG_TMP0, RSP,
+		BURST_RC_OFS);
+
+	/* ctx++ */
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RSP, REG_TMP0,
+		BURST_CTX_OFS);
+	emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, REG_TMP0,
+		sizeof(uint64_t));
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, REG_TMP0, RSP,
+		BURST_CTX_OFS);
+
+	/* if (--R12 != 0) goto loop */
+	emit_alu_imm(st, EBPF_ALU64 | BPF_SUB | BPF_K, R12, 1);
+	emit_abs_jcc(st, BPF_JMP | EBPF_JNE | BPF_K, st->burst.loop_off);
+
+	st->burst.done_off = st->sz;
+
+	/* return num */
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | BPF_W, RSP, RAX, BURST_NUM_OFS);
+	emit_mov_reg(st, EBPF_ALU64 | EBPF_MOV | BPF_X, RBP, RSP);
+
+	ofs = 0;
+	for (i = 0; i != RTE_DIM(save_regs); i++) {
+		emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW,
+			RSP, save_regs[i], ofs);
+		ofs += sizeof(uint64_t);
+	}
+
+	emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, RSP,
+		RTE_DIM(save_regs) * sizeof(uint64_t));
+
+	emit_ret(st);
+}
+
 /*
  * walk through bpf code and translate them x86_64 one.
  */
@@ -1289,7 +1566,10 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 	st->exit.num = 0;
 	st->ldmb.stack_ofs = bpf->stack_sz;
 
-	emit_prolog(st, bpf->stack_sz);
+	if (st->burst.on != 0)
+		emit_burst_prolog(st, bpf->stack_sz);
+	else
+		emit_prolog(st, bpf->stack_sz);
 
 	for (i = 0; i != bpf->prm.nb_ins; i++) {
 
@@ -1468,12 +1748,20 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 			break;
 		/* call instructions */
 		case (BPF_JMP | EBPF_CALL):
-			emit_call(st,
-				(uintptr_t)bpf->prm.xsym[ins->imm].func.val);
+			if (bpf_map_func(bpf->prm.xsym + ins->imm) ==
+					BPF_MAP_FUNC_LOOKUP)
+				emit_map_lookup(st,
+					(uintptr_t)bpf->prm.xsym[ins->imm].func.val);
+			else
+				emit_call(st,
+					(uintptr_t)bpf->prm.xsym[ins->imm].func.val);
 			break;
 		/* return instruction */
 		case (BPF_JMP | EBPF_EXIT):
-			emit_epilog(st);
+			if (st->burst.on != 0)
+				emit_burst_epilog(st);
+			else
+				emit_epilog(st);
 			break;
 		default:
 			RTE_BPF_LOG(ERR,
@@ -1487,56 +1775,95 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 }
 
 /*
- * produce a native ISA version of the given BPF code.
+ * generate native code for the given BPF program,
+ * either single input or burst flavour.
  */
-int
-__rte_bpf_jit_x86(struct rte_bpf *bpf)
+static int
+jit_gen(struct bpf_jit_state *st, const struct rte_bpf *bpf, uint32_t burst,
+	void **func, size_t *fsz)
 {
 	int32_t rc;
 	uint32_t i;
 	size_t sz;
-	struct bpf_jit_state st;
 
 	/* init state */
-	memset(&st, 0, sizeof(st));
-	st.off = malloc(bpf->prm.nb_ins * sizeof(st.off[0]));
-	if (st.off == NULL)
-		return -ENOMEM;
+	st->sz = 0;
+	st->reguse = 0;
+	st->ins = NULL;
+	st->burst.on = burst;
+	st->burst.arg_type = bpf->prm.prog_arg.type;
 
 	/* fill with fake offsets */
-	st.exit.off = INT32_MAX;
+	st->exit.off = INT32_MAX;
+	st->burst.loop_off = INT32_MAX;
+	st->burst.body_off = INT32_MAX;
+	st->burst.done_off = INT32_MAX;
 	for (i = 0; i != bpf->prm.nb_ins; i++)
-		st.off[i] = INT32_MAX;
+		st->off[i] = INT32_MAX;
 
 	/*
 	 * dry runs, used to calculate total code size and valid jump offsets.
 	 * stop when we get minimal possible size
 	 */
 	do {
-		sz = st.sz;
-		rc = emit(&st, bpf);
-	} while (rc == 0 && sz != st.sz);
+		sz = st->sz;
+		rc = emit(st, bpf);
+	} while (rc == 0 && sz != st->sz);
 
 	if (rc == 0) {
 
 		/* allocate memory needed */
-		st.ins = mmap(NULL, st.sz, PROT_READ | PROT_WRITE,
+		st->ins = mmap(NULL, st->sz, PROT_READ | PROT_WRITE,
 			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-		if (st.ins == MAP_FAILED)
+		if (st->ins == MAP_FAILED)
 			rc = -ENOMEM;
 		else
 			/* generate code */
-			rc = emit(&st, bpf);
+			rc = emit(st, bpf);
 	}
 
-	if (rc == 0 && mprotect(st.ins, st.sz, PROT_READ | PROT_EXEC) != 0)
+	if (rc == 0 && mprotect(st->ins, st->sz, PROT_READ | PROT_EXEC) != 0)
 		rc = -ENOMEM;
 
-	if (rc != 0)
-		munmap(st.ins, st.sz);
-	else {
-		bpf->jit.func = (void *)st.ins;
-		bpf->jit.sz = st.sz;
+	if (rc != 0) {
+		if (st->ins != NULL && st->ins != MAP_FAILED)
+			munmap(st->ins, st->sz);
+	} else {
+		*func = st->ins;
+		*fsz = st->sz;
+	}
+
+	return rc;
+}
+
+/*
+ * produce a native ISA version of the given BPF code.
+ * Along with the single input function, generate a burst one
+ * that processes the whole ctx[] array within one call.
+ */
+int
+__rte_bpf_jit_x86(struct rte_bpf *bpf)
+{
+	int32_t rc;
+	void *func;
+	size_t sz;
+	struct bpf_jit_state st;
+
+	memset(&st, 0, sizeof(st));
+	st.off = malloc(bpf->prm.nb_ins * sizeof(st.off[0]));
+	if (st.off == NULL)
+		return -ENOMEM;
+
+	rc = jit_gen(&st, bpf, 0, &func, &sz);
+	if (rc == 0) {
+		bpf->jit.func = func;
+		bpf->jit.sz = sz;
+
+		/* burst flavour is optional, failure here is not fatal */
+		if (jit_gen(&st, bpf, 1, &func, &sz) == 0) {
+			bpf->jit_burst.func = func;
+			bpf->jit_burst.sz = sz;
+		}
 	}
 
 	free(st.off);
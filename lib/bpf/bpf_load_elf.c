@@ -73,6 +73,13 @@ resolve_xsym(const char *sn, size_t ofs, struct ebpf_insn *ins, size_t ins_sz,
 		return -EINVAL;
 
 	fidx = bpf_find_xsym(sn, type, prm->xsym, prm->nb_xsym);
+
+	/* 64-bit immediate load can refer to an eBPF map as well */
+	if (fidx == UINT32_MAX && type == RTE_BPF_XTYPE_VAR) {
+		type = RTE_BPF_XTYPE_MAP;
+		fidx = bpf_find_xsym(sn, type, prm->xsym, prm->nb_xsym);
+	}
+
 	if (fidx == UINT32_MAX)
 		return -ENOENT;
 
@@ -90,6 +97,11 @@ resolve_xsym(const char *sn, size_t ofs, struct ebpf_insn *ins, size_t ins_sz,
 			ins[idx].src_reg = EBPF_REG_0;
 		}
 		ins[idx].imm = fidx;
+	/* for map we need to store its handle */
+	} else if (type == RTE_BPF_XTYPE_MAP) {
+		ins[idx].imm = (uintptr_t)prm->xsym[fidx].map.val;
+		ins[idx + 1].imm =
+			(uint64_t)(uintptr_t)prm->xsym[fidx].map.val >> 32;
 	/* for variable we need to store its absolute address */
 	} else {
 		ins[idx].imm = (uintptr_t)prm->xsym[fidx].var.val;
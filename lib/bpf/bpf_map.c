@@ -0,0 +1,395 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_hash.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
+#include <rte_string_fns.h>
+
+#include "bpf_impl.h"
+
+/*
+ * Per lcore arrays have one extra copy of the values,
+ * shared by all non-EAL threads.
+ */
+#define BPF_MAP_LCORE_NUM	(RTE_MAX_LCORE + 1)
+
+/* Deleted hash map elements reclaimed at once */
+#define BPF_MAP_RCU_DQ_RECLAIM_MAX	16
+
+/* Hash map element waiting for the end of a grace period to be freed */
+struct map_hash_dq_entry {
+	int32_t pos;	/* key position */
+	uint32_t idx;	/* value index */
+};
+
+static inline uint32_t
+map_lcore_slot(void)
+{
+	uint32_t lcore_id;
+
+	lcore_id = rte_lcore_id();
+	return (lcore_id < RTE_MAX_LCORE) ? lcore_id : RTE_MAX_LCORE;
+}
+
+static inline uint8_t *
+map_array_value(const struct rte_bpf_map *map, const void *key,
+	uint32_t slot)
+{
+	uint32_t idx;
+
+	memcpy(&idx, key, sizeof(idx));
+	if (idx >= map->max_entries)
+		return NULL;
+
+	return map->values + slot * map->lcore_stride +
+		idx * map->value_stride;
+}
+
+static int
+map_hash_create(struct rte_bpf_map *map, const struct rte_bpf_map_prm *prm)
+{
+	char name[RTE_HASH_NAMESIZE];
+	struct rte_hash_parameters hprm;
+	uint32_t i;
+
+	/* a truncated name could clash with the one of another map */
+	if (snprintf(name, sizeof(name), "bpf_map_%s", prm->name) >=
+			(int)sizeof(name))
+		return -ENAMETOOLONG;
+
+	memset(&hprm, 0, sizeof(hprm));
+	hprm.name = name;
+	hprm.entries = prm->max_entries;
+	hprm.key_len = prm->key_size;
+	hprm.socket_id = prm->socket_id;
+	/* lookups can run while the map lock holder updates the hash */
+	hprm.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+
+	map->hash = rte_hash_create(&hprm);
+	if (map->hash == NULL)
+		return -rte_errno;
+
+	/*
+	 * Values are stored apart from the hash, as the key data,
+	 * so that they are written before their key is added.
+	 */
+	map->free_values = rte_malloc_socket(prm->name,
+		prm->max_entries * sizeof(map->free_values[0]), 0,
+		prm->socket_id);
+	if (map->free_values == NULL)
+		return -ENOMEM;
+
+	for (i = 0; i != prm->max_entries; i++)
+		map->free_values[i] = prm->max_entries - 1 - i;
+	map->nb_free_values = prm->max_entries;
+	rte_spinlock_init(&map->lock);
+	return 0;
+}
+
+struct rte_bpf_map *
+rte_bpf_map_create(const struct rte_bpf_map_prm *prm)
+{
+	int32_t rc;
+	size_t sz;
+	struct rte_bpf_map *map;
+
+	if (prm == NULL || prm->name == NULL || prm->value_size == 0 ||
+			prm->max_entries == 0 || prm->key_size == 0 ||
+			(prm->type != RTE_BPF_MAP_TYPE_HASH &&
+			prm->key_size != sizeof(uint32_t)) ||
+			prm->type > RTE_BPF_MAP_TYPE_HASH) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	map = rte_zmalloc_socket(prm->name, sizeof(*map), RTE_CACHE_LINE_SIZE,
+		prm->socket_id);
+	if (map == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	map->type = prm->type;
+	map->key_size = prm->key_size;
+	map->value_size = prm->value_size;
+	map->max_entries = prm->max_entries;
+	map->value_stride = RTE_ALIGN_CEIL(prm->value_size, sizeof(uint64_t));
+	map->lcore_stride = (uint64_t)prm->max_entries * map->value_stride;
+	strlcpy(map->name, prm->name, sizeof(map->name));
+
+	rc = 0;
+	sz = map->lcore_stride;
+	if (map->type == RTE_BPF_MAP_TYPE_PERCPU_ARRAY) {
+		/* avoid false sharing between lcores */
+		map->lcore_stride = RTE_ALIGN_CEIL(map->lcore_stride,
+			RTE_CACHE_LINE_SIZE);
+		sz = map->lcore_stride * BPF_MAP_LCORE_NUM;
+	} else if (map->type == RTE_BPF_MAP_TYPE_HASH) {
+		rc = map_hash_create(map, prm);
+		sz = map->lcore_stride;
+	}
+
+	if (rc == 0) {
+		map->values = rte_zmalloc_socket(prm->name, sz,
+			RTE_CACHE_LINE_SIZE, prm->socket_id);
+		if (map->values == NULL)
+			rc = -ENOMEM;
+	}
+
+	if (rc != 0) {
+		RTE_BPF_LOG(ERR, "%s(%s) failed, error code: %d;\n",
+			__func__, prm->name, rc);
+		rte_bpf_map_free(map);
+		rte_errno = -rc;
+		return NULL;
+	}
+
+	return map;
+}
+
+void
+rte_bpf_map_free(struct rte_bpf_map *map)
+{
+	if (map == NULL)
+		return;
+
+	/* map isn't used anymore, no need to wait for the readers */
+	if (map->dq != NULL && rte_rcu_qsbr_dq_delete(map->dq) != 0)
+		RTE_BPF_LOG(ERR, "%s(%s): cannot free defer queue;\n",
+			__func__, map->name);
+	rte_hash_free(map->hash);
+	rte_free(map->free_values);
+	rte_free(map->values);
+	rte_free(map);
+}
+
+void *
+rte_bpf_map_lookup_elem(struct rte_bpf_map *map, const void *key)
+{
+	void *val;
+
+	switch (map->type) {
+	case RTE_BPF_MAP_TYPE_ARRAY:
+		return map_array_value(map, key, 0);
+	case RTE_BPF_MAP_TYPE_PERCPU_ARRAY:
+		return map_array_value(map, key, map_lcore_slot());
+	case RTE_BPF_MAP_TYPE_HASH:
+		if (rte_hash_lookup_data(map->hash, key, &val) < 0)
+			return NULL;
+		return val;
+	}
+
+	return NULL;
+}
+
+void *
+rte_bpf_map_lookup_percpu_elem(struct rte_bpf_map *map, const void *key,
+	uint32_t lcore_id)
+{
+	if (map == NULL || key == NULL ||
+			map->type != RTE_BPF_MAP_TYPE_PERCPU_ARRAY ||
+			lcore_id >= BPF_MAP_LCORE_NUM)
+		return NULL;
+
+	return map_array_value(map, key, lcore_id);
+}
+
+/* Free a deleted element, called with the map lock held */
+static void
+map_hash_free(void *p, void *e, unsigned int n)
+{
+	struct rte_bpf_map *map = p;
+	const struct map_hash_dq_entry *ent = e;
+	unsigned int i;
+
+	for (i = 0; i != n; i++) {
+		rte_hash_free_key_with_position(map->hash, ent[i].pos);
+		map->free_values[map->nb_free_values++] = ent[i].idx;
+	}
+}
+
+/*
+ * Free a deleted element once the readers went through a quiescent state,
+ * called with the map lock held.
+ * The defer queue has room for all the map elements, the enqueue is not
+ * expected to fail: if it does, the element is not leaked but freed after
+ * waiting for the readers, which must then not include the caller.
+ */
+static void
+map_hash_defer_free(struct rte_bpf_map *map, struct map_hash_dq_entry *ent)
+{
+	if (rte_rcu_qsbr_dq_enqueue(map->dq, ent) == 0)
+		return;
+
+	/* defer queue is full: free the elements the readers are done with */
+	rte_rcu_qsbr_dq_reclaim(map->dq, map->max_entries, NULL, NULL, NULL);
+	if (rte_rcu_qsbr_dq_enqueue(map->dq, ent) == 0)
+		return;
+
+	/* still full, wait for the readers rather than leak the element */
+	rte_rcu_qsbr_synchronize(map->v, RTE_QSBR_THRID_INVALID);
+	map_hash_free(map, ent, 1);
+}
+
+static uint8_t *
+map_hash_value_alloc(struct rte_bpf_map *map)
+{
+	/* deleted elements may be waiting for the readers */
+	if (map->nb_free_values == 0 && map->dq != NULL)
+		rte_rcu_qsbr_dq_reclaim(map->dq, map->max_entries,
+			NULL, NULL, NULL);
+	if (map->nb_free_values == 0)
+		return NULL;
+
+	return map->values +
+		map->free_values[--map->nb_free_values] * map->value_stride;
+}
+
+static inline uint32_t
+map_hash_value_idx(const struct rte_bpf_map *map, const void *val)
+{
+	return ((const uint8_t *)val - map->values) / map->value_stride;
+}
+
+static int
+map_hash_update(struct rte_bpf_map *map, const void *key, const void *value,
+	uint64_t flags)
+{
+	int32_t rc;
+	void *val;
+
+	/* writers are serialized, the element can't appear meanwhile */
+	rte_spinlock_lock(&map->lock);
+
+	if (rte_hash_lookup_data(map->hash, key, &val) >= 0) {
+		if (flags == RTE_BPF_MAP_NOEXIST)
+			rc = -EEXIST;
+		else {
+			memcpy(val, value, map->value_size);
+			rc = 0;
+		}
+	} else if (flags == RTE_BPF_MAP_EXIST) {
+		rc = -ENOENT;
+	} else {
+		val = map_hash_value_alloc(map);
+		if (val == NULL) {
+			rc = -ENOSPC;
+		} else {
+			/* value has to be there before the key is visible */
+			memcpy(val, value, map->value_size);
+			rc = rte_hash_add_key_data(map->hash, key, val);
+			if (rc < 0)
+				map->free_values[map->nb_free_values++] =
+					map_hash_value_idx(map, val);
+		}
+	}
+
+	rte_spinlock_unlock(&map->lock);
+	return rc;
+}
+
+int
+rte_bpf_map_update_elem(struct rte_bpf_map *map, const void *key,
+	const void *value, uint64_t flags)
+{
+	uint8_t *v;
+
+	if (map == NULL || key == NULL || value == NULL ||
+			flags > RTE_BPF_MAP_EXIST)
+		return -EINVAL;
+
+	if (map->type == RTE_BPF_MAP_TYPE_HASH)
+		return map_hash_update(map, key, value, flags);
+
+	/* all array elements always exist */
+	if (flags == RTE_BPF_MAP_NOEXIST)
+		return -EEXIST;
+
+	v = rte_bpf_map_lookup_elem(map, key);
+	if (v == NULL)
+		return -E2BIG;
+
+	memcpy(v, value, map->value_size);
+	return 0;
+}
+
+int
+rte_bpf_map_delete_elem(struct rte_bpf_map *map, const void *key)
+{
+	struct map_hash_dq_entry ent;
+	void *val;
+
+	if (map == NULL || key == NULL || map->type != RTE_BPF_MAP_TYPE_HASH)
+		return -EINVAL;
+
+	rte_spinlock_lock(&map->lock);
+
+	if (rte_hash_lookup_data(map->hash, key, &val) < 0) {
+		rte_spinlock_unlock(&map->lock);
+		return -ENOENT;
+	}
+	ent.pos = rte_hash_del_key(map->hash, key);
+	ent.idx = map_hash_value_idx(map, val);
+
+	/*
+	 * Lock-free hash doesn't release the key position on delete.
+	 * Lookups may still use the element: with a QSBR variable,
+	 * free it once the readers went through a quiescent state.
+	 */
+	if (map->dq == NULL)
+		map_hash_free(map, &ent, 1);
+	else
+		map_hash_defer_free(map, &ent);
+
+	rte_spinlock_unlock(&map->lock);
+	return 0;
+}
+
+int
+rte_bpf_map_rcu_qsbr_add(struct rte_bpf_map *map, struct rte_rcu_qsbr *v)
+{
+	char name[RTE_RCU_QSBR_DQ_NAMESIZE];
+	struct rte_rcu_qsbr_dq_parameters params;
+	int32_t rc;
+
+	if (map == NULL || v == NULL || map->type != RTE_BPF_MAP_TYPE_HASH)
+		return -EINVAL;
+
+	if (snprintf(name, sizeof(name), "bpf_map_%s", map->name) >=
+			(int)sizeof(name))
+		return -ENAMETOOLONG;
+
+	memset(&params, 0, sizeof(params));
+	params.name = name;
+	/* the defer queue is only used with the map lock held */
+	params.flags = RTE_RCU_QSBR_DQ_MT_UNSAFE;
+	params.size = map->max_entries;
+	params.esize = sizeof(struct map_hash_dq_entry);
+	params.trigger_reclaim_limit = BPF_MAP_RCU_DQ_RECLAIM_MAX;
+	params.max_reclaim_size = BPF_MAP_RCU_DQ_RECLAIM_MAX;
+	params.free_fn = map_hash_free;
+	params.p = map;
+	params.v = v;
+
+	rte_spinlock_lock(&map->lock);
+	if (map->dq != NULL) {
+		rc = -EEXIST;
+	} else {
+		map->dq = rte_rcu_qsbr_dq_create(&params);
+		map->v = v;
+		rc = (map->dq == NULL) ? -rte_errno : 0;
+	}
+	rte_spinlock_unlock(&map->lock);
+
+	return rc;
+}
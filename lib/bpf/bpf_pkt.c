@@ -29,6 +29,7 @@ struct bpf_eth_cbi {
 	const struct rte_eth_rxtx_callback *cb;  /* callback handle */
 	struct rte_bpf *bpf;
 	struct rte_bpf_jit jit;
+	struct rte_bpf_jit_burst jit_burst;
 	/* used by control path only */
 	LIST_ENTRY(bpf_eth_cbi) link;
 	uint16_t port;
@@ -120,6 +121,7 @@ bpf_eth_cbi_cleanup(struct bpf_eth_cbi *bc)
 {
 	bc->bpf = NULL;
 	memset(&bc->jit, 0, sizeof(bc->jit));
+	memset(&bc->jit_burst, 0, sizeof(bc->jit_burst));
 }
 
 static struct bpf_eth_cbi *
@@ -203,18 +205,26 @@ pkt_filter_vm(const struct rte_bpf *bpf, struct rte_mbuf *mb[], uint32_t num,
 }
 
 static inline uint32_t
-pkt_filter_jit(const struct rte_bpf_jit *jit, struct rte_mbuf *mb[],
+pkt_filter_jit(const struct bpf_eth_cbi *cbi, struct rte_mbuf *mb[],
 	uint32_t num, uint32_t drop)
 {
 	uint32_t i, n;
-	void *dp;
+	void *dp[num];
 	uint64_t rc[num];
 
 	n = 0;
-	for (i = 0; i != num; i++) {
-		dp = rte_pktmbuf_mtod(mb[i], void *);
-		rc[i] = jit->func(dp);
-		n += (rc[i] == 0);
+	if (cbi->jit_burst.func != NULL) {
+		for (i = 0; i != num; i++)
+			dp[i] = rte_pktmbuf_mtod(mb[i], void *);
+		cbi->jit_burst.func(dp, rc, num);
+		for (i = 0; i != num; i++)
+			n += (rc[i] == 0);
+	} else {
+		for (i = 0; i != num; i++) {
+			dp[i] = rte_pktmbuf_mtod(mb[i], void *);
+			rc[i] = cbi->jit.func(dp[i]);
+			n += (rc[i] == 0);
+		}
 	}
 
 	if (n != 0)
@@ -234,16 +244,22 @@ pkt_filter_mb_vm(const struct rte_bpf *bpf, struct rte_mbuf *mb[], uint32_t num,
 }
 
 static inline uint32_t
-pkt_filter_mb_jit(const struct rte_bpf_jit *jit, struct rte_mbuf *mb[],
+pkt_filter_mb_jit(const struct bpf_eth_cbi *cbi, struct rte_mbuf *mb[],
 	uint32_t num, uint32_t drop)
 {
 	uint32_t i, n;
 	uint64_t rc[num];
 
 	n = 0;
-	for (i = 0; i != num; i++) {
-		rc[i] = jit->func(mb[i]);
-		n += (rc[i] == 0);
+	if (cbi->jit_burst.func != NULL) {
+		cbi->jit_burst.func((void **)mb, rc, num);
+		for (i = 0; i != num; i++)
+			n += (rc[i] == 0);
+	} else {
+		for (i = 0; i != num; i++) {
+			rc[i] = cbi->jit.func(mb[i]);
+			n += (rc[i] == 0);
+		}
 	}
 
 	if (n != 0)
@@ -285,7 +301,7 @@ bpf_rx_callback_jit(__rte_unused uint16_t port, __rte_unused uint16_t queue,
 	cbi = user_param;
 	bpf_eth_cbi_inuse(cbi);
 	rc = (cbi->cb != NULL) ?
-		pkt_filter_jit(&cbi->jit, pkt, nb_pkts, 1) :
+		pkt_filter_jit(cbi, pkt, nb_pkts, 1) :
 		nb_pkts;
 	bpf_eth_cbi_unuse(cbi);
 	return rc;
@@ -317,7 +333,7 @@ bpf_tx_callback_jit(__rte_unused uint16_t port, __rte_unused uint16_t queue,
 	cbi = user_param;
 	bpf_eth_cbi_inuse(cbi);
 	rc = (cbi->cb != NULL) ?
-		pkt_filter_jit(&cbi->jit, pkt, nb_pkts, 0) :
+		pkt_filter_jit(cbi, pkt, nb_pkts, 0) :
 		nb_pkts;
 	bpf_eth_cbi_unuse(cbi);
 	return rc;
@@ -355,7 +371,7 @@ bpf_rx_callback_mb_jit(__rte_unused uint16_t port, __rte_unused uint16_t queue,
 	cbi = user_param;
 	bpf_eth_cbi_inuse(cbi);
 	rc = (cbi->cb != NULL) ?
-		pkt_filter_mb_jit(&cbi->jit, pkt, nb_pkts, 1) :
+		pkt_filter_mb_jit(cbi, pkt, nb_pkts, 1) :
 		nb_pkts;
 	bpf_eth_cbi_unuse(cbi);
 	return rc;
@@ -387,7 +403,7 @@ bpf_tx_callback_mb_jit(__rte_unused uint16_t port, __rte_unused uint16_t queue,
 	cbi = user_param;
 	bpf_eth_cbi_inuse(cbi);
 	rc = (cbi->cb != NULL) ?
-		pkt_filter_mb_jit(&cbi->jit, pkt, nb_pkts, 0) :
+		pkt_filter_mb_jit(cbi, pkt, nb_pkts, 0) :
 		nb_pkts;
 	bpf_eth_cbi_unuse(cbi);
 	return rc;
@@ -498,6 +514,7 @@ bpf_eth_elf_load(struct bpf_eth_cbh *cbh, uint16_t port, uint16_t queue,
 	rte_rx_callback_fn frx;
 	rte_tx_callback_fn ftx;
 	struct rte_bpf_jit jit;
+	struct rte_bpf_jit_burst jit_burst;
 
 	frx = NULL;
 	ftx = NULL;
@@ -522,6 +539,7 @@ bpf_eth_elf_load(struct bpf_eth_cbh *cbh, uint16_t port, uint16_t queue,
 		return -rte_errno;
 
 	rte_bpf_get_jit(bpf, &jit);
+	rte_bpf_get_jit_burst(bpf, &jit_burst);
 
 	if ((flags & RTE_BPF_ETH_F_JIT) != 0 && jit.func == NULL) {
 		RTE_BPF_LOG(ERR, "%s(%u, %u): no JIT generated;\n",
@@ -541,6 +559,7 @@ bpf_eth_elf_load(struct bpf_eth_cbh *cbh, uint16_t port, uint16_t queue,
 
 	bc->bpf = bpf;
 	bc->jit = jit;
+	bc->jit_burst = jit_burst;
 
 	if (cbh->type == BPF_ETH_RX)
 		bc->cb = rte_eth_add_rx_callback(port, queue, frx, bc);
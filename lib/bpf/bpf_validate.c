@@ -14,9 +14,14 @@
 #include "bpf_impl.h"
 
 #define BPF_ARG_PTR_STACK RTE_BPF_ARG_RESERVED
+/* eBPF map handle, can only be passed to the map helpers */
+#define BPF_ARG_PTR_MAP (RTE_BPF_ARG_RESERVED + 1)
+/* result of map lookup, not a pointer until checked against NULL */
+#define BPF_ARG_MAP_VALUE_OR_NULL (RTE_BPF_ARG_RAW + 1)
 
 struct bpf_reg_val {
 	struct rte_bpf_arg v;
+	const struct rte_bpf_map *map;
 	uint64_t mask;
 	struct {
 		int64_t min;
@@ -198,6 +203,16 @@ eval_ld_imm64(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 			eval_fill_imm64(rd, UINT64_MAX, 0);
 			break;
 		}
+
+		/* load of eBPF map handle */
+		if (bvf->prm->xsym[i].type == RTE_BPF_XTYPE_MAP &&
+				(uintptr_t)bvf->prm->xsym[i].map.val == val) {
+			rd->v.type = BPF_ARG_PTR_MAP;
+			rd->v.size = 0;
+			rd->map = bvf->prm->xsym[i].map.val;
+			eval_fill_imm64(rd, UINT64_MAX, 0);
+			break;
+		}
 	}
 
 	return NULL;
@@ -671,6 +686,9 @@ eval_alu(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 	if (err != NULL)
 		return err;
 
+	if (op != EBPF_MOV && rd->v.type == BPF_ARG_MAP_VALUE_OR_NULL)
+		return "arithmetic on map value before NULL check";
+
 	if (op == BPF_ADD)
 		eval_add(rd, &rs, msk);
 	else if (op == BPF_SUB)
@@ -969,12 +987,63 @@ eval_func_arg(struct bpf_verifier *bvf, const struct rte_bpf_arg *arg,
 	return err;
 }
 
+/*
+ * evaluate call of the map helper:
+ * R1 must be the map handle, R2 (and R3 for update) point to the key
+ * (and value) of the map size.
+ */
+static const char *
+eval_map_call(struct bpf_verifier *bvf, enum bpf_map_func fn)
+{
+	uint32_t i;
+	const char *err;
+	struct rte_bpf_arg arg;
+	struct bpf_reg_val *rv;
+	const struct rte_bpf_map *map;
+
+	rv = bvf->evst->rv;
+
+	if (rv[EBPF_REG_1].v.type != BPF_ARG_PTR_MAP ||
+			rv[EBPF_REG_1].u.max != 0 ||
+			rv[EBPF_REG_1].u.min != 0)
+		return "invalid map handle";
+
+	map = rv[EBPF_REG_1].map;
+
+	arg.type = RTE_BPF_ARG_PTR;
+	arg.size = map->key_size;
+	err = eval_func_arg(bvf, &arg, rv + EBPF_REG_2);
+
+	if (err == NULL && fn == BPF_MAP_FUNC_UPDATE) {
+		arg.size = map->value_size;
+		err = eval_func_arg(bvf, &arg, rv + EBPF_REG_3);
+		if (err == NULL)
+			err = eval_defined(NULL, rv + EBPF_REG_4);
+	}
+
+	/* R1-R5 argument/scratch registers */
+	for (i = EBPF_REG_1; i != EBPF_REG_6; i++)
+		rv[i].v.type = RTE_BPF_ARG_UNDEF;
+
+	/* update return value */
+	if (fn == BPF_MAP_FUNC_LOOKUP) {
+		rv[EBPF_REG_0].v.type = BPF_ARG_MAP_VALUE_OR_NULL;
+		rv[EBPF_REG_0].v.size = map->value_size;
+		eval_fill_imm64(rv + EBPF_REG_0, UINTPTR_MAX, 0);
+	} else
+		eval_fill_max_bound(rv + EBPF_REG_0,
+			RTE_LEN2MASK(sizeof(int) * CHAR_BIT, uint64_t));
+
+	return err;
+}
+
 static const char *
 eval_call(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 {
 	uint32_t i, idx;
 	struct bpf_reg_val *rv;
 	const struct rte_bpf_xsym *xsym;
+	enum bpf_map_func fn;
 	const char *err;
 
 	idx = ins->imm;
@@ -989,6 +1058,10 @@ eval_call(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 
 	xsym = bvf->prm->xsym + idx;
 
+	fn = bpf_map_func(xsym);
+	if (fn != BPF_MAP_FUNC_NONE)
+		return eval_map_call(bvf, fn);
+
 	/* evaluate function arguments */
 	err = NULL;
 	for (i = 0; i != xsym->func.nb_args && err == NULL; i++) {
@@ -1073,6 +1146,14 @@ eval_jslt_jsge(struct bpf_reg_val *trd, struct bpf_reg_val *trs,
 	trd->s.max = RTE_MIN(trd->s.max, trs->s.max - 1);
 }
 
+static void
+eval_map_value_null(struct bpf_reg_val *nrd, struct bpf_reg_val *vrd)
+{
+	eval_fill_imm(nrd, UINT64_MAX, 0);
+	vrd->v.type = RTE_BPF_ARG_PTR;
+	eval_fill_imm64(vrd, UINTPTR_MAX, 0);
+}
+
 static const char *
 eval_jcc(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 {
@@ -1125,6 +1206,15 @@ eval_jcc(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 	else if (op == EBPF_JSGE)
 		eval_jslt_jsge(frd, frs, trd, trs);
 
+	/* map lookup result checked against NULL */
+	if (trd->v.type == BPF_ARG_MAP_VALUE_OR_NULL &&
+			BPF_SRC(ins->code) == BPF_K && ins->imm == 0) {
+		if (op == BPF_JEQ)
+			eval_map_value_null(trd, frd);
+		else if (op == EBPF_JNE)
+			eval_map_value_null(frd, trd);
+	}
+
 	return NULL;
 }
 
@@ -60,9 +60,12 @@ struct rte_bpf_arg {
  */
 enum rte_bpf_xtype {
 	RTE_BPF_XTYPE_FUNC, /**< function */
-	RTE_BPF_XTYPE_VAR   /**< variable */
+	RTE_BPF_XTYPE_VAR,  /**< variable */
+	RTE_BPF_XTYPE_MAP,  /**< eBPF map, see rte_bpf_map.h */
 };
 
+struct rte_bpf_map;
+
 /**
  * Definition for external symbols available in the BPF program.
  */
@@ -82,6 +85,9 @@ struct rte_bpf_xsym {
 			void *val; /**< actual memory location */
 			struct rte_bpf_arg desc; /**< type, size, etc. */
 		} var; /**< external variable */
+		struct {
+			struct rte_bpf_map *val; /**< map handle */
+		} map; /**< eBPF map */
 	};
 };
 
@@ -105,6 +111,17 @@ struct rte_bpf_jit {
 	size_t sz;                /**< size of JIT-ed code */
 };
 
+/**
+ * Information about compiled into native ISA eBPF code,
+ * that processes a burst of inputs within one call.
+ * Semantics of func() are the same as for rte_bpf_exec_burst().
+ */
+struct rte_bpf_jit_burst {
+	uint32_t (*func)(void *ctx[], uint64_t rc[], uint32_t num);
+	/**< JIT-ed native code */
+	size_t sz; /**< size of JIT-ed code */
+};
+
 struct rte_bpf;
 
 /**
@@ -199,6 +216,29 @@ rte_bpf_exec_burst(const struct rte_bpf *bpf, void *ctx[], uint64_t rc[],
 int
 rte_bpf_get_jit(const struct rte_bpf *bpf, struct rte_bpf_jit *jit);
 
+/**
+ * Provide information about natively compiled burst code for given
+ * BPF handle. The burst function runs the program over all inputs
+ * in a single loop, keeping the prolog/epilog out of the per packet path
+ * and prefetching data of the next input while the current one
+ * is processed.
+ * Not all architectures provide it, in which case func is NULL
+ * and rte_bpf_get_jit() has to be used in a loop instead.
+ *
+ * @param bpf
+ *   handle for the BPF code.
+ * @param jit
+ *   pointer to the rte_bpf_jit_burst structure to be filled
+ *   with related data.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_bpf_get_jit_burst(const struct rte_bpf *bpf,
+	struct rte_bpf_jit_burst *jit);
+
 /**
  * Dump epf instructions to a file.
  *
@@ -0,0 +1,210 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#ifndef _RTE_BPF_MAP_H_
+#define _RTE_BPF_MAP_H_
+
+/**
+ * @file rte_bpf_map.h
+ *
+ * eBPF maps: key/value storage shared between eBPF programs
+ * and the application.
+ *
+ * A map is made available to the eBPF code as an external symbol of
+ * RTE_BPF_XTYPE_MAP type, loaded with (BPF_LD | BPF_IMM | EBPF_DW).
+ * Map helpers are called as external functions of RTE_BPF_XTYPE_FUNC
+ * type, whose *val* is one of rte_bpf_map_lookup_elem(),
+ * rte_bpf_map_update_elem() or rte_bpf_map_delete_elem();
+ * their arguments and return value are checked by the verifier against
+ * the map definition, so the *nb_args*, *args* and *ret* fields
+ * of such external function are ignored.
+ * Value returned by rte_bpf_map_lookup_elem() has to be checked against
+ * NULL before being dereferenced.
+ */
+
+#include <rte_bpf.h>
+#include <rte_rcu_qsbr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Max length of the eBPF map name. */
+#define RTE_BPF_MAP_NAMESIZE	32
+
+/**
+ * Possible types of eBPF maps.
+ */
+enum rte_bpf_map_type {
+	RTE_BPF_MAP_TYPE_ARRAY,
+	/**< array of max_entries values, key is uint32_t index */
+	RTE_BPF_MAP_TYPE_PERCPU_ARRAY,
+	/**< array with a separate copy of the values for each lcore */
+	RTE_BPF_MAP_TYPE_HASH,
+	/**< hash table of up to max_entries elements */
+};
+
+/**
+ * Flags for rte_bpf_map_update_elem().
+ */
+enum {
+	RTE_BPF_MAP_ANY,     /**< create new element or update existing */
+	RTE_BPF_MAP_NOEXIST, /**< create new element only if it didn't exist */
+	RTE_BPF_MAP_EXIST,   /**< update existing element only */
+};
+
+/**
+ * eBPF map creation parameters.
+ */
+struct rte_bpf_map_prm {
+	const char *name;           /**< map name, unique for hash maps */
+	enum rte_bpf_map_type type; /**< map type */
+	uint32_t key_size;
+	/**< key size in bytes, sizeof(uint32_t) for array maps */
+	uint32_t value_size;        /**< value size in bytes */
+	uint32_t max_entries;       /**< max number of elements */
+	int socket_id;              /**< NUMA socket to allocate memory from */
+};
+
+/**
+ * Create a new eBPF map.
+ * All the elements of array maps exist and are zeroed,
+ * hash maps are empty.
+ *
+ * @param prm
+ *   Parameters of the map.
+ * @return
+ *   Map handle, or NULL on error with rte_errno set:
+ *   - EINVAL - invalid parameter passed to function
+ *   - ENOMEM - can't reserve enough memory
+ *   - EEXIST - a hash map with the same name already exists
+ *   - ENAMETOOLONG - the name of a hash map is too long
+ */
+__rte_experimental
+struct rte_bpf_map *
+rte_bpf_map_create(const struct rte_bpf_map_prm *prm);
+
+/**
+ * Free an eBPF map.
+ * It must not be used by any loaded eBPF program anymore.
+ *
+ * @param map
+ *   Map handle, can be NULL.
+ */
+__rte_experimental
+void
+rte_bpf_map_free(struct rte_bpf_map *map);
+
+/**
+ * Look up an element of the map.
+ * For per lcore arrays, the value of the calling lcore is returned,
+ * non-EAL threads share one extra copy.
+ * For hash maps, the returned pointer stays valid after a concurrent
+ * delete of the element until the calling thread reports a quiescent
+ * state on the QSBR variable of the map, see rte_bpf_map_rcu_qsbr_add().
+ *
+ * @param map
+ *   Map handle.
+ * @param key
+ *   Pointer to the key, key_size bytes long.
+ * @return
+ *   Pointer to the value, NULL if no element is found.
+ */
+__rte_experimental
+void *
+rte_bpf_map_lookup_elem(struct rte_bpf_map *map, const void *key);
+
+/**
+ * Look up the value of an element for given lcore.
+ * Intended to let the application read or reset per lcore array values.
+ *
+ * @param map
+ *   Map handle, of RTE_BPF_MAP_TYPE_PERCPU_ARRAY type.
+ * @param key
+ *   Pointer to the key.
+ * @param lcore_id
+ *   Lcore to get the value of, RTE_MAX_LCORE for the non-EAL threads one.
+ * @return
+ *   Pointer to the value, NULL if no element is found or if map
+ *   is not a per lcore one.
+ */
+__rte_experimental
+void *
+rte_bpf_map_lookup_percpu_elem(struct rte_bpf_map *map, const void *key,
+	uint32_t lcore_id);
+
+/**
+ * Create or update an element of the map.
+ * The value of an existing element is copied without any atomicity
+ * guarantee against concurrent lookups, a new hash map element is
+ * visible to lookups only once its value is written.
+ * Hash map updates and deletes are serialized by a lock.
+ *
+ * @param map
+ *   Map handle.
+ * @param key
+ *   Pointer to the key.
+ * @param value
+ *   Pointer to the value, value_size bytes long.
+ * @param flags
+ *   One of RTE_BPF_MAP_ANY, RTE_BPF_MAP_NOEXIST, RTE_BPF_MAP_EXIST.
+ * @return
+ *   - Zero if operation completed successfully.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -E2BIG if index is out of array bounds.
+ *   - -EEXIST if element exists and RTE_BPF_MAP_NOEXIST is set.
+ *   - -ENOENT if element doesn't exist and RTE_BPF_MAP_EXIST is set.
+ *   - -ENOSPC if there is no space left in the hash map.
+ */
+__rte_experimental
+int
+rte_bpf_map_update_elem(struct rte_bpf_map *map, const void *key,
+	const void *value, uint64_t flags);
+
+/**
+ * Delete an element from a hash map.
+ * Without QSBR variable associated to the map, the element is freed
+ * at once and may be reused by the next update, while lookups done
+ * in parallel still use it.
+ *
+ * @param map
+ *   Map handle.
+ * @param key
+ *   Pointer to the key.
+ * @return
+ *   - Zero if operation completed successfully.
+ *   - -EINVAL if the parameters are invalid or map is an array.
+ *   - -ENOENT if element doesn't exist.
+ */
+__rte_experimental
+int
+rte_bpf_map_delete_elem(struct rte_bpf_map *map, const void *key);
+
+/**
+ * Associate a RCU QSBR variable with a hash map.
+ * Deleted elements are then freed only after all the threads registered
+ * on the variable reported a quiescent state, so that the threads running
+ * eBPF programs, or doing lookups, can keep using the elements they found
+ * until they report it.
+ *
+ * @param map
+ *   Map handle, of RTE_BPF_MAP_TYPE_HASH type.
+ * @param v
+ *   RCU QSBR variable.
+ * @return
+ *   - Zero if operation completed successfully.
+ *   - -EINVAL if the parameters are invalid or map is not a hash one.
+ *   - -EEXIST if a QSBR variable is already associated with the map.
+ *   - -ENAMETOOLONG if the map name is too long for the defer queue.
+ *   - -ENOMEM if the defer queue can't be allocated.
+ */
+__rte_experimental
+int
+rte_bpf_map_rcu_qsbr_add(struct rte_bpf_map *map, struct rte_rcu_qsbr *v);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_BPF_MAP_H_ */
@@ -34,6 +34,11 @@ struct rte_eth_rxtx_callback {
 		rte_tx_callback_fn tx;
 	} fn;
 	void *param;
+	uint32_t flags; /**< RTE_ETH_RXTX_CALLBACK_F_* */
+	/* Accounting, updated only with RTE_ETH_RXTX_CALLBACK_F_STATS */
+	uint64_t calls;
+	uint64_t pkts;
+	uint64_t cycles;
 };
 
 /**
@@ -2,7 +2,9 @@
  * Copyright(c) 2018 Gaëtan Rivet
  */
 
+#include <rte_cycles.h>
 #include <rte_debug.h>
+#include <rte_prefetch.h>
 
 #include "rte_ethdev.h"
 #include "rte_ethdev_trace_fp.h"
@@ -285,17 +287,165 @@ eth_dev_fp_ops_setup(struct rte_eth_fp_ops *fpo,
 	fpo->txq.clbk = (void **)(uintptr_t)dev->pre_tx_burst_cbs;
 }
 
+/* Packets handed at once to the callbacks processing a burst piecewise */
+#define ETH_CB_PKT_WINDOW 8
+/* Max callbacks processing the same packet window */
+#define ETH_CB_RUN_MAX 8
+
+static inline uint16_t
+eth_call_rx_callback(const struct rte_eth_rxtx_callback *cb,
+	uint16_t port_id, uint16_t queue_id, struct rte_mbuf **rx_pkts,
+	uint16_t nb_rx, uint16_t nb_pkts)
+{
+	struct rte_eth_rxtx_callback *scb;
+	uint64_t start;
+
+	if (likely(!(cb->flags & RTE_ETH_RXTX_CALLBACK_F_STATS)))
+		return cb->fn.rx(port_id, queue_id, rx_pkts, nb_rx, nb_pkts,
+				cb->param);
+
+	/* Only the lcore polling the queue updates its callback stats */
+	scb = (struct rte_eth_rxtx_callback *)(uintptr_t)cb;
+	scb->calls++;
+	scb->pkts += nb_rx;
+	start = rte_rdtsc();
+	nb_rx = cb->fn.rx(port_id, queue_id, rx_pkts, nb_rx, nb_pkts,
+			cb->param);
+	scb->cycles += rte_rdtsc() - start;
+
+	return nb_rx;
+}
+
+static inline uint16_t
+eth_call_tx_callback(const struct rte_eth_rxtx_callback *cb,
+	uint16_t port_id, uint16_t queue_id, struct rte_mbuf **tx_pkts,
+	uint16_t nb_pkts)
+{
+	struct rte_eth_rxtx_callback *scb;
+	uint64_t start;
+
+	if (likely(!(cb->flags & RTE_ETH_RXTX_CALLBACK_F_STATS)))
+		return cb->fn.tx(port_id, queue_id, tx_pkts, nb_pkts,
+				cb->param);
+
+	/* Only the lcore polling the queue updates its callback stats */
+	scb = (struct rte_eth_rxtx_callback *)(uintptr_t)cb;
+	scb->calls++;
+	scb->pkts += nb_pkts;
+	start = rte_rdtsc();
+	nb_pkts = cb->fn.tx(port_id, queue_id, tx_pkts, nb_pkts, cb->param);
+	scb->cycles += rte_rdtsc() - start;
+
+	return nb_pkts;
+}
+
+/*
+ * Gather the callbacks following *cb* which process a burst piecewise,
+ * so that they are all called on a packet window before moving to the next.
+ * The list is walked once per burst, as it may change in the meantime.
+ */
+static inline unsigned int
+eth_cb_window_run(const struct rte_eth_rxtx_callback **cb,
+	const struct rte_eth_rxtx_callback *run[])
+{
+	const struct rte_eth_rxtx_callback *c = *cb;
+	unsigned int nb_run = 0;
+
+	do {
+		run[nb_run++] = c;
+		c = c->next;
+	} while (c != NULL && (c->flags & RTE_ETH_RXTX_CALLBACK_F_PKT_WINDOW) &&
+			nb_run < ETH_CB_RUN_MAX);
+
+	*cb = c;
+	return nb_run;
+}
+
+static inline void
+eth_cb_window_prefetch(struct rte_mbuf **pkts, uint16_t start, uint16_t end)
+{
+	uint16_t i;
+
+	end = RTE_MIN(end, start + ETH_CB_PKT_WINDOW);
+	for (i = start; i < end; i++)
+		rte_prefetch0(pkts[i]);
+}
+
+static uint16_t
+eth_call_rx_window_callbacks(const struct rte_eth_rxtx_callback *run[],
+	unsigned int nb_run, uint16_t port_id, uint16_t queue_id,
+	struct rte_mbuf **rx_pkts, uint16_t nb_rx)
+{
+	uint16_t i, j, n, nb_out = 0;
+	unsigned int k;
+
+	for (i = 0; i < nb_rx; i += ETH_CB_PKT_WINDOW) {
+		n = RTE_MIN(nb_rx - i, ETH_CB_PKT_WINDOW);
+		eth_cb_window_prefetch(rx_pkts, i + n, nb_rx);
+
+		for (k = 0; k < nb_run && n != 0; k++)
+			n = eth_call_rx_callback(run[k], port_id, queue_id,
+					&rx_pkts[i], n, n);
+
+		/* Keep the packets left by the callbacks contiguous */
+		for (j = 0; j < n; j++)
+			rx_pkts[nb_out + j] = rx_pkts[i + j];
+		nb_out += n;
+	}
+
+	return nb_out;
+}
+
+static uint16_t
+eth_call_tx_window_callbacks(const struct rte_eth_rxtx_callback *run[],
+	unsigned int nb_run, uint16_t port_id, uint16_t queue_id,
+	struct rte_mbuf **tx_pkts, uint16_t nb_pkts)
+{
+	uint16_t i, j, n, nb_out = 0;
+	unsigned int k;
+
+	for (i = 0; i < nb_pkts; i += ETH_CB_PKT_WINDOW) {
+		n = RTE_MIN(nb_pkts - i, ETH_CB_PKT_WINDOW);
+		eth_cb_window_prefetch(tx_pkts, i + n, nb_pkts);
+
+		for (k = 0; k < nb_run && n != 0; k++)
+			n = eth_call_tx_callback(run[k], port_id, queue_id,
+					&tx_pkts[i], n);
+
+		/* Keep the packets left by the callbacks contiguous */
+		for (j = 0; j < n; j++)
+			tx_pkts[nb_out + j] = tx_pkts[i + j];
+		nb_out += n;
+	}
+
+	return nb_out;
+}
+
 uint16_t
 rte_eth_call_rx_callbacks(uint16_t port_id, uint16_t queue_id,
 	struct rte_mbuf **rx_pkts, uint16_t nb_rx, uint16_t nb_pkts,
 	void *opaque)
 {
+	const struct rte_eth_rxtx_callback *run[ETH_CB_RUN_MAX];
 	const struct rte_eth_rxtx_callback *cb = opaque;
+	unsigned int nb_run;
 
 	while (cb != NULL) {
-		nb_rx = cb->fn.rx(port_id, queue_id, rx_pkts, nb_rx,
-				nb_pkts, cb->param);
-		cb = cb->next;
+		if (!(cb->flags & RTE_ETH_RXTX_CALLBACK_F_PKT_WINDOW) ||
+				cb->next == NULL) {
+			nb_rx = eth_call_rx_callback(cb, port_id, queue_id,
+					rx_pkts, nb_rx, nb_pkts);
+			cb = cb->next;
+			continue;
+		}
+
+		nb_run = eth_cb_window_run(&cb, run);
+		if (nb_run == 1)
+			nb_rx = eth_call_rx_callback(run[0], port_id, queue_id,
+					rx_pkts, nb_rx, nb_pkts);
+		else
+			nb_rx = eth_call_rx_window_callbacks(run, nb_run,
+					port_id, queue_id, rx_pkts, nb_rx);
 	}
 
 	rte_eth_trace_call_rx_callbacks(port_id, queue_id, (void **)rx_pkts,
@@ -308,12 +458,26 @@ uint16_t
 rte_eth_call_tx_callbacks(uint16_t port_id, uint16_t queue_id,
 	struct rte_mbuf **tx_pkts, uint16_t nb_pkts, void *opaque)
 {
+	const struct rte_eth_rxtx_callback *run[ETH_CB_RUN_MAX];
 	const struct rte_eth_rxtx_callback *cb = opaque;
+	unsigned int nb_run;
 
 	while (cb != NULL) {
-		nb_pkts = cb->fn.tx(port_id, queue_id, tx_pkts, nb_pkts,
-				cb->param);
-		cb = cb->next;
+		if (!(cb->flags & RTE_ETH_RXTX_CALLBACK_F_PKT_WINDOW) ||
+				cb->next == NULL) {
+			nb_pkts = eth_call_tx_callback(cb, port_id, queue_id,
+					tx_pkts, nb_pkts);
+			cb = cb->next;
+			continue;
+		}
+
+		nb_run = eth_cb_window_run(&cb, run);
+		if (nb_run == 1)
+			nb_pkts = eth_call_tx_callback(run[0], port_id,
+					queue_id, tx_pkts, nb_pkts);
+		else
+			nb_pkts = eth_call_tx_window_callbacks(run, nb_run,
+					port_id, queue_id, tx_pkts, nb_pkts);
 	}
 
 	rte_eth_trace_call_tx_callbacks(port_id, queue_id, (void **)tx_pkts,
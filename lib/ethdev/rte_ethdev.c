@@ -5780,6 +5780,88 @@ rte_eth_remove_tx_callback(uint16_t port_id, uint16_t queue_id,
 	return ret;
 }
 
+int
+rte_eth_rxtx_callback_flags_set(const struct rte_eth_rxtx_callback *user_cb,
+		uint32_t flags)
+{
+#ifndef RTE_ETHDEV_RXTX_CALLBACKS
+	return -ENOTSUP;
+#endif
+	struct rte_eth_rxtx_callback *cb;
+
+	if (user_cb == NULL || (flags & ~(RTE_ETH_RXTX_CALLBACK_F_PKT_WINDOW |
+			RTE_ETH_RXTX_CALLBACK_F_STATS)) != 0)
+		return -EINVAL;
+
+	cb = (struct rte_eth_rxtx_callback *)(uintptr_t)user_cb;
+	__atomic_store_n(&cb->flags, flags, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
+static int
+eth_dev_callback_stats_get(struct rte_eth_rxtx_callback **cbs,
+		rte_spinlock_t *lock, struct rte_eth_rxtx_callback_stats *stats,
+		unsigned int n)
+{
+	struct rte_eth_rxtx_callback *cb;
+	unsigned int count = 0;
+
+	rte_spinlock_lock(lock);
+	for (cb = *cbs; cb != NULL; cb = cb->next, count++) {
+		if (count >= n)
+			continue;
+		stats[count].cb = cb;
+		stats[count].flags = cb->flags;
+		stats[count].calls = cb->calls;
+		stats[count].pkts = cb->pkts;
+		stats[count].cycles = cb->cycles;
+	}
+	rte_spinlock_unlock(lock);
+
+	return count;
+}
+
+int
+rte_eth_rx_callback_stats_get(uint16_t port_id, uint16_t queue_id,
+		struct rte_eth_rxtx_callback_stats *stats, unsigned int n)
+{
+#ifndef RTE_ETHDEV_RXTX_CALLBACKS
+	return -ENOTSUP;
+#endif
+	struct rte_eth_dev *dev;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+	dev = &rte_eth_devices[port_id];
+
+	if (queue_id >= dev->data->nb_rx_queues ||
+			(stats == NULL && n != 0))
+		return -EINVAL;
+
+	return eth_dev_callback_stats_get(&dev->post_rx_burst_cbs[queue_id],
+			&eth_dev_rx_cb_lock, stats, n);
+}
+
+int
+rte_eth_tx_callback_stats_get(uint16_t port_id, uint16_t queue_id,
+		struct rte_eth_rxtx_callback_stats *stats, unsigned int n)
+{
+#ifndef RTE_ETHDEV_RXTX_CALLBACKS
+	return -ENOTSUP;
+#endif
+	struct rte_eth_dev *dev;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+	dev = &rte_eth_devices[port_id];
+
+	if (queue_id >= dev->data->nb_tx_queues ||
+			(stats == NULL && n != 0))
+		return -EINVAL;
+
+	return eth_dev_callback_stats_get(&dev->pre_tx_burst_cbs[queue_id],
+			&eth_dev_tx_cb_lock, stats, n);
+}
+
 int
 rte_eth_rx_queue_info_get(uint16_t port_id, uint16_t queue_id,
 	struct rte_eth_rxq_info *qinfo)
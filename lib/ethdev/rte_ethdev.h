@@ -4809,6 +4809,119 @@ int rte_eth_remove_rx_callback(uint16_t port_id, uint16_t queue_id,
 int rte_eth_remove_tx_callback(uint16_t port_id, uint16_t queue_id,
 		const struct rte_eth_rxtx_callback *user_cb);
 
+/**
+ * The Rx or Tx callback processes each packet of a burst independently of
+ * the others. It may drop packets, but must not add any.
+ * Consecutive callbacks with this flag are called on a window of a few
+ * packets of the burst in turn, the next window being prefetched, so that
+ * the packets stay in cache from one callback to the next.
+ */
+#define RTE_ETH_RXTX_CALLBACK_F_PKT_WINDOW	RTE_BIT32(0)
+/**
+ * Account the invocations, the packets and the TSC cycles spent in the Rx
+ * or Tx callback, at the cost of reading the TSC around each invocation.
+ */
+#define RTE_ETH_RXTX_CALLBACK_F_STATS		RTE_BIT32(1)
+
+/**
+ * Statistics of an Rx or Tx callback.
+ */
+struct rte_eth_rxtx_callback_stats {
+	const struct rte_eth_rxtx_callback *cb; /**< Callback handle. */
+	uint32_t flags; /**< RTE_ETH_RXTX_CALLBACK_F_* flags. */
+	uint64_t calls; /**< Number of invocations. */
+	uint64_t pkts; /**< Number of packets passed to the callback. */
+	uint64_t cycles; /**< TSC cycles spent in the callback. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the flags of an Rx or Tx packet callback.
+ *
+ * The flags can be changed while packets are received or transmitted,
+ * the change applies to the next bursts.
+ *
+ * @param user_cb
+ *   User supplied callback created via rte_eth_add_rx_callback(),
+ *   rte_eth_add_first_rx_callback() or rte_eth_add_tx_callback().
+ * @param flags
+ *   Bitmask of RTE_ETH_RXTX_CALLBACK_F_* flags.
+ *
+ * @return
+ *   - 0: Success.
+ *   - -ENOTSUP: Callback support is not available.
+ *   - -EINVAL:  The callback is NULL or the flags are invalid.
+ */
+__rte_experimental
+int rte_eth_rxtx_callback_flags_set(const struct rte_eth_rxtx_callback *user_cb,
+		uint32_t flags);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Retrieve the statistics of the callbacks of an Rx queue, in the order
+ * they are called. Only the callbacks with RTE_ETH_RXTX_CALLBACK_F_STATS
+ * flag set are accounted.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The Rx queue on the Ethernet device.
+ * @param stats
+ *   Array to be filled with the callback statistics, can be NULL if
+ *   @p n is 0.
+ * @param n
+ *   Number of elements of the @p stats array.
+ *
+ * @return
+ *   - A positive or zero value, lower or equal to @p n: success,
+ *     the number of callbacks filled in.
+ *   - A positive value greater than @p n: the number of callbacks of the
+ *     queue, @p stats array is too small and only @p n elements are filled.
+ *   - -ENODEV:  If *port_id* is invalid.
+ *   - -ENOTSUP: Callback support is not available.
+ *   - -EINVAL:  The queue_id is out of range, or @p stats is NULL
+ *               while @p n is not 0.
+ */
+__rte_experimental
+int rte_eth_rx_callback_stats_get(uint16_t port_id, uint16_t queue_id,
+		struct rte_eth_rxtx_callback_stats *stats, unsigned int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Retrieve the statistics of the callbacks of a Tx queue, in the order
+ * they are called. Only the callbacks with RTE_ETH_RXTX_CALLBACK_F_STATS
+ * flag set are accounted.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The Tx queue on the Ethernet device.
+ * @param stats
+ *   Array to be filled with the callback statistics, can be NULL if
+ *   @p n is 0.
+ * @param n
+ *   Number of elements of the @p stats array.
+ *
+ * @return
+ *   - A positive or zero value, lower or equal to @p n: success,
+ *     the number of callbacks filled in.
+ *   - A positive value greater than @p n: the number of callbacks of the
+ *     queue, @p stats array is too small and only @p n elements are filled.
+ *   - -ENODEV:  If *port_id* is invalid.
+ *   - -ENOTSUP: Callback support is not available.
+ *   - -EINVAL:  The queue_id is out of range, or @p stats is NULL
+ *               while @p n is not 0.
+ */
+__rte_experimental
+int rte_eth_tx_callback_stats_get(uint16_t port_id, uint16_t queue_id,
+		struct rte_eth_rxtx_callback_stats *stats, unsigned int n);
+
 /**
  * Retrieve information about given port's Rx queue.
  *
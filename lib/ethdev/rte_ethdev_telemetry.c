@@ -593,6 +593,85 @@ eth_dev_handle_port_rxq(const char *cmd __rte_unused,
 	return ret;
 }
 
+static int
+eth_dev_add_callback_stats(uint16_t port_id, uint16_t queue_id, bool is_rx,
+		struct rte_tel_data *d)
+{
+	struct rte_eth_rxtx_callback_stats *stats;
+	struct rte_tel_data *cb_data;
+	int i, n, ret;
+
+	n = is_rx ? rte_eth_rx_callback_stats_get(port_id, queue_id, NULL, 0) :
+		rte_eth_tx_callback_stats_get(port_id, queue_id, NULL, 0);
+	if (n < 0)
+		return n;
+
+	stats = calloc(RTE_MAX(n, 1), sizeof(*stats));
+	if (stats == NULL)
+		return -ENOMEM;
+
+	ret = is_rx ? rte_eth_rx_callback_stats_get(port_id, queue_id, stats, n) :
+		rte_eth_tx_callback_stats_get(port_id, queue_id, stats, n);
+	if (ret < 0) {
+		free(stats);
+		return ret;
+	}
+
+	rte_tel_data_start_array(d, RTE_TEL_CONTAINER);
+	for (i = 0; i < RTE_MIN(n, ret); i++) {
+		cb_data = rte_tel_data_alloc();
+		if (cb_data == NULL) {
+			free(stats);
+			return -ENOMEM;
+		}
+
+		rte_tel_data_start_dict(cb_data);
+		rte_tel_data_add_dict_string(cb_data, "pkt_window",
+			(stats[i].flags & RTE_ETH_RXTX_CALLBACK_F_PKT_WINDOW) ?
+			"on" : "off");
+		rte_tel_data_add_dict_string(cb_data, "stats",
+			(stats[i].flags & RTE_ETH_RXTX_CALLBACK_F_STATS) ?
+			"on" : "off");
+		rte_tel_data_add_dict_uint(cb_data, "calls", stats[i].calls);
+		rte_tel_data_add_dict_uint(cb_data, "pkts", stats[i].pkts);
+		rte_tel_data_add_dict_uint(cb_data, "cycles", stats[i].cycles);
+		rte_tel_data_add_array_container(d, cb_data, 0);
+	}
+
+	free(stats);
+	return 0;
+}
+
+static int
+eth_dev_handle_port_rxq_callbacks(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	uint16_t port_id, queue_id;
+	int ret;
+
+	ret = ethdev_parse_queue_params(params, true, &port_id, &queue_id);
+	if (ret != 0)
+		return ret;
+
+	return eth_dev_add_callback_stats(port_id, queue_id, true, d);
+}
+
+static int
+eth_dev_handle_port_txq_callbacks(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	uint16_t port_id, queue_id;
+	int ret;
+
+	ret = ethdev_parse_queue_params(params, false, &port_id, &queue_id);
+	if (ret != 0)
+		return ret;
+
+	return eth_dev_add_callback_stats(port_id, queue_id, false, d);
+}
+
 static int
 eth_dev_handle_port_txq(const char *cmd __rte_unused,
 		const char *params,
@@ -1048,6 +1127,12 @@ RTE_INIT(ethdev_init_telemetry)
 			"Returns Rx queue info for a port. Parameters: int port_id, int queue_id (Optional if only one queue)");
 	rte_telemetry_register_cmd("/ethdev/tx_queue", eth_dev_handle_port_txq,
 			"Returns Tx queue info for a port. Parameters: int port_id, int queue_id (Optional if only one queue)");
+	rte_telemetry_register_cmd("/ethdev/rx_queue_callbacks",
+			eth_dev_handle_port_rxq_callbacks,
+			"Returns Rx callbacks stats for a port. Parameters: int port_id, int queue_id (Optional if only one queue)");
+	rte_telemetry_register_cmd("/ethdev/tx_queue_callbacks",
+			eth_dev_handle_port_txq_callbacks,
+			"Returns Tx callbacks stats for a port. Parameters: int port_id, int queue_id (Optional if only one queue)");
 	rte_telemetry_register_cmd("/ethdev/dcb", eth_dev_handle_port_dcb,
 			"Returns DCB info for a port. Parameters: int port_id");
 	rte_telemetry_register_cmd("/ethdev/rss_info", eth_dev_handle_port_rss_info,
@@ -37,6 +37,14 @@
 
 #define RXA_NB_RX_WORK_DEFAULT 128
 
+/* Consecutive empty polls before an Rx queue falls back to interrupt mode */
+#define RXA_INTR_FALLBACK_IDLE_POLLS	1024
+
+/* Weight of a new sample in the per queue moving averages is 1/8 */
+#define RXA_AVG_WEIGHT_SHIFT	3
+/* Fractional bits of the packet and event count averages */
+#define RXA_AVG_FRAC_SHIFT	4
+
 #define ETH_RX_ADAPTER_SERVICE_NAME_LEN	32
 #define ETH_RX_ADAPTER_MEM_NAME_LEN	32
 
@@ -100,6 +108,8 @@ struct eth_event_enqueue_buffer {
 	/* last element in the buffer before rollover */
 	uint16_t last;
 	uint16_t last_mask;
+	/* Moving average of events per enqueue, RXA_AVG_FRAC_SHIFT fixed point */
+	uint32_t enq_avg;
 };
 
 struct event_eth_rx_adapter {
@@ -147,6 +157,8 @@ struct event_eth_rx_adapter {
 	int epd;
 	/* Num of interrupt driven interrupt queues */
 	uint32_t num_rx_intr;
+	/* Num of polled queues with interrupt fallback */
+	uint32_t num_intr_fallback;
 	/* Used to send <dev id, queue id> of interrupting Rx queues from
 	 * the interrupt thread to the Rx thread
 	 */
@@ -240,10 +252,27 @@ struct eth_device_info {
 };
 
 /* Per Rx queue */
+enum rxa_intr_state {
+	RXA_QUEUE_POLLED,	/* Polled by the service function */
+	RXA_QUEUE_INTR_ARMED,	/* Interrupt enabled, polled once more */
+	RXA_QUEUE_INTR_PARKED,	/* Not polled until it interrupts */
+};
+
 struct eth_rx_queue_info {
 	int queue_enabled;	/* True if added */
 	int intr_enabled;
 	uint8_t ena_vector;
+	uint8_t intr_fallback;	/* Polled queue with interrupt fallback */
+	uint8_t intr_state;	/* enum rxa_intr_state */
+	uint32_t idle_polls;	/* Consecutive empty polls */
+	uint64_t intr_parks;	/* Switches to interrupt mode */
+	uint64_t intr_wakeups;	/* Interrupts received while parked */
+	/* Moving average of packets per poll, RXA_AVG_FRAC_SHIFT fixed point */
+	uint32_t rx_avg;
+	/* Timestamp of the last poll, 0 after the queue got parked */
+	uint64_t poll_ts;
+	/* Moving average of cycles between polls */
+	uint64_t poll_intvl_avg;
 	uint16_t wt;		/* Polling weight */
 	uint32_t flow_id_mask;	/* Set to ~0 if app provides flow id else 0 */
 	uint64_t event;
@@ -799,6 +828,13 @@ rxa_enq_block_end_ts(struct event_eth_rx_adapter *rx_adapter,
 	}
 }
 
+static inline uint64_t
+rxa_avg_update(uint64_t avg, uint64_t sample)
+{
+	return avg - (avg >> RXA_AVG_WEIGHT_SHIFT) +
+		(sample >> RXA_AVG_WEIGHT_SHIFT);
+}
+
 /* Enqueue buffered events to event device */
 static inline uint16_t
 rxa_flush_event_buffer(struct event_eth_rx_adapter *rx_adapter,
@@ -842,7 +878,11 @@ rxa_flush_event_buffer(struct event_eth_rx_adapter *rx_adapter,
 		n += n1;
 	}
 
-	n ? rxa_enq_block_end_ts(rx_adapter, stats) :
+	if (n) {
+		rxa_enq_block_end_ts(rx_adapter, stats);
+		buf->enq_avg = rxa_avg_update(buf->enq_avg,
+					      n << RXA_AVG_FRAC_SHIFT);
+	} else
 		rxa_enq_block_start_ts(rx_adapter);
 
 	buf->count -= n;
@@ -1025,13 +1065,17 @@ rxa_pkt_buf_available(struct eth_event_enqueue_buffer *buf)
 	return nb_req <= buf->head;
 }
 
-/* Enqueue packets from  <port, q>  to event buffer */
+/* Enqueue packets from  <port, q>  to event buffer
+ * If flush is false, the caller is responsible for enqueuing events
+ * left in the buffer to the event device.
+ */
 static inline uint32_t
 rxa_eth_rx(struct event_eth_rx_adapter *rx_adapter, uint16_t port_id,
 	   uint16_t queue_id, uint32_t rx_count, uint32_t max_rx,
 	   int *rxq_empty, struct eth_event_enqueue_buffer *buf,
-	   struct rte_event_eth_rx_adapter_stats *stats)
+	   struct rte_event_eth_rx_adapter_stats *stats, bool flush)
 {
+	struct eth_rx_queue_info *queue_info;
 	struct rte_mbuf *mbufs[BATCH_SIZE];
 	uint16_t n;
 	uint32_t nb_rx = 0;
@@ -1061,11 +1105,15 @@ rxa_eth_rx(struct event_eth_rx_adapter *rx_adapter, uint16_t port_id,
 			break;
 	}
 
-	if (buf->count > 0)
+	if (flush && buf->count > 0)
 		nb_flushed += rxa_flush_event_buffer(rx_adapter, buf, stats);
 
+	queue_info = &rx_adapter->eth_devices[port_id].rx_queue[queue_id];
+	queue_info->rx_avg = rxa_avg_update(queue_info->rx_avg,
+					    nb_rx << RXA_AVG_FRAC_SHIFT);
+
 	stats->rx_packets += nb_rx;
-	if (nb_flushed == 0)
+	if (flush && nb_flushed == 0)
 		rte_event_maintain(rx_adapter->eventdev_id,
 				   rx_adapter->event_port_id, 0);
 
@@ -1090,6 +1138,19 @@ rxa_intr_ring_enqueue(struct event_eth_rx_adapter *rx_adapter, void *data)
 	dev_info = &rx_adapter->eth_devices[port_id];
 	queue_info = &dev_info->rx_queue[queue];
 	rte_spinlock_lock(&rx_adapter->intr_ring_lock);
+	if (queue_info->intr_fallback) {
+		/* Parked polled queue, rxa_poll() resumes polling it */
+		if (queue_info->intr_enabled) {
+			queue_info->intr_enabled = 0;
+			queue_info->intr_wakeups++;
+			rte_eth_dev_rx_intr_disable(port_id, queue);
+			__atomic_store_n(&queue_info->intr_state,
+					 RXA_QUEUE_POLLED, __ATOMIC_RELEASE);
+		}
+		rte_spinlock_unlock(&rx_adapter->intr_ring_lock);
+		return;
+	}
+
 	if (rxa_shared_intr(dev_info, queue))
 		intr_enabled = &dev_info->shared_intr_enabled;
 	else
@@ -1268,7 +1329,7 @@ rxa_intr_ring_dequeue(struct event_eth_rx_adapter *rx_adapter)
 					continue;
 				n = rxa_eth_rx(rx_adapter, port, i, nb_rx,
 					rx_adapter->max_nb_rx,
-					&rxq_empty, buf, stats);
+					&rxq_empty, buf, stats, true);
 				nb_rx += n;
 
 				enq_buffer_full = !rxq_empty && n == 0;
@@ -1289,7 +1350,7 @@ rxa_intr_ring_dequeue(struct event_eth_rx_adapter *rx_adapter)
 		} else {
 			n = rxa_eth_rx(rx_adapter, port, queue, nb_rx,
 				rx_adapter->max_nb_rx,
-				&rxq_empty, buf, stats);
+				&rxq_empty, buf, stats, true);
 			rx_adapter->qd_valid = !rxq_empty;
 			nb_rx += n;
 			if (nb_rx > rx_adapter->max_nb_rx)
@@ -1306,12 +1367,62 @@ done:
 	return work;
 }
 
+/*
+ * Switches an idle polled queue with interrupt fallback to interrupt mode.
+ * The Rx interrupt is armed first and the queue is polled once more before
+ * being parked, so packets received before the interrupt got enabled are
+ * not left on the queue. Parked queues are skipped by rxa_poll() until the
+ * interrupt thread wakes them up.
+ */
+static inline void
+rxa_intr_fallback_update(struct event_eth_rx_adapter *rx_adapter,
+			 struct eth_rx_queue_info *queue_info,
+			 uint16_t port_id, uint16_t queue_id, bool idle)
+{
+	uint8_t state;
+
+	state = __atomic_load_n(&queue_info->intr_state, __ATOMIC_RELAXED);
+	if (likely(!idle)) {
+		queue_info->idle_polls = 0;
+		if (likely(state == RXA_QUEUE_POLLED))
+			return;
+	} else if (state == RXA_QUEUE_POLLED &&
+		   ++queue_info->idle_polls < RXA_INTR_FALLBACK_IDLE_POLLS)
+		return;
+
+	rte_spinlock_lock(&rx_adapter->intr_ring_lock);
+	state = queue_info->intr_state;
+	if (!idle) {
+		/* Packets arrived while armed */
+		if (queue_info->intr_enabled) {
+			queue_info->intr_enabled = 0;
+			rte_eth_dev_rx_intr_disable(port_id, queue_id);
+		}
+		state = RXA_QUEUE_POLLED;
+	} else if (state == RXA_QUEUE_POLLED) {
+		queue_info->idle_polls = 0;
+		if (rte_eth_dev_rx_intr_enable(port_id, queue_id) == 0) {
+			queue_info->intr_enabled = 1;
+			state = RXA_QUEUE_INTR_ARMED;
+		}
+	} else if (state == RXA_QUEUE_INTR_ARMED) {
+		queue_info->intr_parks++;
+		queue_info->poll_ts = 0;
+		state = RXA_QUEUE_INTR_PARKED;
+	}
+	__atomic_store_n(&queue_info->intr_state, state, __ATOMIC_RELAXED);
+	rte_spinlock_unlock(&rx_adapter->intr_ring_lock);
+}
+
 /*
  * Polls receive queues added to the event adapter and enqueues received
  * packets to the event device.
  *
  * The receive code enqueues initially to a temporary buffer, the
- * temporary buffer is drained anytime it holds >= BATCH_SIZE packets
+ * temporary buffer is drained anytime it holds >= BATCH_SIZE packets.
+ * When the adapter level buffer is used, packets from all the queues polled
+ * in a round are combined in it and a partial burst is only enqueued at the
+ * end of the round.
  *
  * If there isn't space available in the temporary buffer, packets from the
  * Rx queue aren't dequeued from the eth device, this back pressures the
@@ -1328,16 +1439,26 @@ rxa_poll(struct event_eth_rx_adapter *rx_adapter)
 	struct rte_event_eth_rx_adapter_stats *stats = NULL;
 	uint32_t wrr_pos;
 	uint32_t max_nb_rx;
+	uint64_t now;
 	bool work = false;
 
 	wrr_pos = rx_adapter->wrr_pos;
 	max_nb_rx = rx_adapter->max_nb_rx;
+	now = rte_rdtsc();
 
 	/* Iterate through a WRR sequence */
 	for (num_queue = 0; num_queue < rx_adapter->wrr_len; num_queue++) {
 		unsigned int poll_idx = rx_adapter->wrr_sched[wrr_pos];
 		uint16_t qid = rx_adapter->eth_rx_poll[poll_idx].eth_rx_qid;
 		uint16_t d = rx_adapter->eth_rx_poll[poll_idx].eth_dev_id;
+		struct eth_rx_queue_info *queue_info;
+		uint32_t n;
+		int rxq_empty;
+
+		queue_info = &rx_adapter->eth_devices[d].rx_queue[qid];
+		if (__atomic_load_n(&queue_info->intr_state,
+				    __ATOMIC_ACQUIRE) == RXA_QUEUE_INTR_PARKED)
+			goto poll_next_entry;
 
 		buf = rxa_event_buf_get(rx_adapter, d, qid, &stats);
 
@@ -1361,8 +1482,19 @@ rxa_poll(struct event_eth_rx_adapter *rx_adapter)
 			}
 		}
 
-		nb_rx += rxa_eth_rx(rx_adapter, d, qid, nb_rx, max_nb_rx,
-				NULL, buf, stats);
+		if (queue_info->poll_ts)
+			queue_info->poll_intvl_avg =
+				rxa_avg_update(queue_info->poll_intvl_avg,
+					       now - queue_info->poll_ts);
+		queue_info->poll_ts = now;
+
+		n = rxa_eth_rx(rx_adapter, d, qid, nb_rx, max_nb_rx,
+			       &rxq_empty, buf, stats,
+			       rx_adapter->use_queue_event_buf);
+		if (queue_info->intr_fallback)
+			rxa_intr_fallback_update(rx_adapter, queue_info, d,
+						 qid, n == 0 && rxq_empty);
+		nb_rx += n;
 		if (nb_rx > max_nb_rx) {
 			rx_adapter->wrr_pos =
 				    (wrr_pos + 1) % rx_adapter->wrr_len;
@@ -1374,6 +1506,15 @@ poll_next_entry:
 			wrr_pos = 0;
 	}
 
+	if (!rx_adapter->use_queue_event_buf && rx_adapter->wrr_len) {
+		buf = &rx_adapter->event_enqueue_buffer;
+		if (buf->count == 0 ||
+		    rxa_flush_event_buffer(rx_adapter, buf,
+					   &rx_adapter->stats) == 0)
+			rte_event_maintain(rx_adapter->eventdev_id,
+					   rx_adapter->event_port_id, 0);
+	}
+
 	if (nb_rx > 0)
 		work = true;
 
@@ -1662,7 +1803,7 @@ rxa_free_intr_resources(struct event_eth_rx_adapter *rx_adapter)
 {
 	int ret;
 
-	if (rx_adapter->num_rx_intr == 0)
+	if (rx_adapter->intr_ring == NULL)
 		return 0;
 
 	ret = rxa_destroy_intr_thread(rx_adapter);
@@ -1901,6 +2042,137 @@ rxa_add_intr_queue(struct event_eth_rx_adapter *rx_adapter,
 	return err;
 }
 
+/* Register a polled queue for interrupt fallback, the interrupt is left
+ * disabled until the queue is found idle by rxa_poll()
+ */
+static int
+rxa_config_intr_fallback(struct event_eth_rx_adapter *rx_adapter,
+			 struct eth_device_info *dev_info, uint16_t rx_queue_id)
+{
+	struct eth_rx_queue_info *queue_info;
+	uint16_t eth_dev_id = dev_info->dev->data->port_id;
+	union queue_data qd;
+	int init_fd;
+	int err, err1;
+
+	queue_info = &dev_info->rx_queue[rx_queue_id];
+	if (queue_info->intr_fallback)
+		return 0;
+
+	init_fd = rx_adapter->epd;
+	err = rxa_init_epd(rx_adapter);
+	if (err)
+		return err;
+
+	qd.port = eth_dev_id;
+	qd.queue = rx_queue_id;
+
+	err = rte_eth_dev_rx_intr_ctl_q(eth_dev_id, rx_queue_id,
+					rx_adapter->epd,
+					RTE_INTR_EVENT_ADD,
+					qd.ptr);
+	if (err) {
+		RTE_EDEV_LOG_ERR("Failed to add interrupt event for"
+			" Rx Queue %u err %d", rx_queue_id, err);
+		goto err_del_fd;
+	}
+
+	err = rxa_create_intr_thread(rx_adapter);
+	if (err)
+		goto err_del_event;
+
+	queue_info->intr_enabled = 0;
+	queue_info->intr_state = RXA_QUEUE_POLLED;
+	queue_info->idle_polls = 0;
+	queue_info->intr_fallback = 1;
+	rx_adapter->num_intr_fallback++;
+	return 0;
+
+err_del_event:
+	err1 = rte_eth_dev_rx_intr_ctl_q(eth_dev_id, rx_queue_id,
+					rx_adapter->epd,
+					RTE_INTR_EVENT_DEL,
+					0);
+	if (err1) {
+		RTE_EDEV_LOG_ERR("Could not delete event for"
+				" Rx Queue %u err %d", rx_queue_id, err1);
+	}
+err_del_fd:
+	if (init_fd == INIT_FD) {
+		close(rx_adapter->epd);
+		rx_adapter->epd = INIT_FD;
+	}
+
+	return err;
+}
+
+static int
+rxa_del_intr_fallback(struct event_eth_rx_adapter *rx_adapter,
+		      struct eth_device_info *dev_info, int rx_queue_id)
+{
+	struct eth_rx_queue_info *queue_info;
+	uint16_t eth_dev_id = dev_info->dev->data->port_id;
+	int err;
+	int i;
+
+	if (rx_adapter->num_intr_fallback == 0 || dev_info->rx_queue == NULL)
+		return 0;
+
+	if (rx_queue_id == -1) {
+		for (i = 0; i < dev_info->dev->data->nb_rx_queues; i++) {
+			err = rxa_del_intr_fallback(rx_adapter, dev_info, i);
+			if (err)
+				return err;
+		}
+		return 0;
+	}
+
+	queue_info = &dev_info->rx_queue[rx_queue_id];
+	if (!queue_info->intr_fallback)
+		return 0;
+
+	rte_spinlock_lock(&rx_adapter->intr_ring_lock);
+	if (queue_info->intr_enabled) {
+		queue_info->intr_enabled = 0;
+		rte_eth_dev_rx_intr_disable(eth_dev_id, rx_queue_id);
+	}
+	queue_info->intr_fallback = 0;
+	queue_info->intr_state = RXA_QUEUE_POLLED;
+	rte_spinlock_unlock(&rx_adapter->intr_ring_lock);
+
+	err = rte_eth_dev_rx_intr_ctl_q(eth_dev_id, rx_queue_id,
+					rx_adapter->epd,
+					RTE_INTR_EVENT_DEL,
+					0);
+	if (err)
+		RTE_EDEV_LOG_ERR("Interrupt event deletion failed %d", err);
+
+	rx_adapter->num_intr_fallback--;
+	return 0;
+}
+
+static int
+rxa_add_intr_fallback(struct event_eth_rx_adapter *rx_adapter,
+		      struct eth_device_info *dev_info, int rx_queue_id)
+{
+	int err;
+	int i;
+
+	if (rx_queue_id != -1)
+		return rxa_config_intr_fallback(rx_adapter, dev_info,
+						rx_queue_id);
+
+	for (i = 0; i < dev_info->dev->data->nb_rx_queues; i++) {
+		err = rxa_config_intr_fallback(rx_adapter, dev_info, i);
+		if (err) {
+			rxa_del_intr_fallback(rx_adapter, dev_info, -1);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
 static int
 rxa_init_service(struct event_eth_rx_adapter *rx_adapter, uint8_t id)
 {
@@ -2200,6 +2472,7 @@ rxa_sw_add(struct event_eth_rx_adapter *rx_adapter, uint16_t eth_dev_id,
 	uint32_t nb_rx_intr;
 	int num_intr_vec;
 	uint16_t wt;
+	bool intr_fallback;
 
 	if (queue_conf->servicing_weight == 0) {
 		struct rte_eth_dev_data *data = dev_info->dev->data;
@@ -2225,6 +2498,25 @@ rxa_sw_add(struct event_eth_rx_adapter *rx_adapter, uint16_t eth_dev_id,
 	nb_rx_queues = dev_info->dev->data->nb_rx_queues;
 	rx_queue = dev_info->rx_queue;
 	wt = queue_conf->servicing_weight;
+	intr_fallback = wt != 0 && (queue_conf->rx_queue_flags &
+				RTE_EVENT_ETH_RX_ADAPTER_QUEUE_INTR_FALLBACK);
+
+	if (intr_fallback) {
+		if (!dev_info->dev->data->dev_conf.intr_conf.rxq) {
+			RTE_EDEV_LOG_ERR("Rx interrupts are disabled, interrupt"
+					 " fallback not supported dev_id: %d",
+					 eth_dev_id);
+			return -EINVAL;
+		}
+		if (rxa_shared_intr(dev_info, rx_queue_id == -1 ?
+				    nb_rx_queues - 1 : rx_queue_id)) {
+			RTE_EDEV_LOG_ERR("Interrupt fallback not supported for"
+					 " shared interrupts dev_id: %d"
+					 " queue_id: %d",
+					 eth_dev_id, rx_queue_id);
+			return -ENOTSUP;
+		}
+	}
 
 	if (dev_info->rx_queue == NULL) {
 		dev_info->rx_queue =
@@ -2251,6 +2543,11 @@ rxa_sw_add(struct event_eth_rx_adapter *rx_adapter, uint16_t eth_dev_id,
 	if (ret)
 		goto err_free_rxqueue;
 
+	/* Queue may be re-added with a different mode */
+	ret = rxa_del_intr_fallback(rx_adapter, dev_info, rx_queue_id);
+	if (ret)
+		goto err_free_rxqueue;
+
 	if (wt == 0) {
 		num_intr_vec = rxa_nb_intr_vect(dev_info, rx_queue_id, 1);
 
@@ -2278,7 +2575,13 @@ rxa_sw_add(struct event_eth_rx_adapter *rx_adapter, uint16_t eth_dev_id,
 		}
 	}
 
-	if (nb_rx_intr == 0) {
+	if (intr_fallback) {
+		ret = rxa_add_intr_fallback(rx_adapter, dev_info, rx_queue_id);
+		if (ret)
+			goto err_free_rxqueue;
+	}
+
+	if (nb_rx_intr == 0 && rx_adapter->num_intr_fallback == 0) {
 		ret = rxa_free_intr_resources(rx_adapter);
 		if (ret)
 			goto err_free_rxqueue;
@@ -2840,6 +3143,10 @@ rte_event_eth_rx_adapter_queue_del(uint8_t id, uint16_t eth_dev_id,
 
 		rte_spinlock_lock(&rx_adapter->rx_lock);
 
+		ret = rxa_del_intr_fallback(rx_adapter, dev_info, rx_queue_id);
+		if (ret)
+			goto unlock_ret;
+
 		num_intr_vec = 0;
 		if (rx_adapter->num_rx_intr > nb_rx_intr) {
 
@@ -2851,7 +3158,7 @@ rte_event_eth_rx_adapter_queue_del(uint8_t id, uint16_t eth_dev_id,
 				goto unlock_ret;
 		}
 
-		if (nb_rx_intr == 0) {
+		if (nb_rx_intr == 0 && rx_adapter->num_intr_fallback == 0) {
 			ret = rxa_free_intr_resources(rx_adapter);
 			if (ret)
 				goto unlock_ret;
@@ -2961,6 +3268,8 @@ rxa_queue_stats_reset(struct eth_rx_queue_info *queue_info)
 
 	q_stats = queue_info->stats;
 	memset(q_stats, 0, sizeof(*q_stats));
+	queue_info->intr_parks = 0;
+	queue_info->intr_wakeups = 0;
 }
 
 int
@@ -3753,6 +4062,121 @@ error:
 	return ret;
 }
 
+static const char *
+rxa_intr_state_str(uint8_t state)
+{
+	switch (state) {
+	case RXA_QUEUE_INTR_ARMED:
+		return "armed";
+	case RXA_QUEUE_INTR_PARKED:
+		return "parked";
+	default:
+		return "polled";
+	}
+}
+
+static int
+handle_rxa_get_queue_poll_stats(const char *cmd __rte_unused,
+				const char *params,
+				struct rte_tel_data *d)
+{
+	uint8_t rx_adapter_id;
+	uint16_t rx_queue_id;
+	int eth_dev_id, ret = -1;
+	char *token, *l_params;
+	struct event_eth_rx_adapter *rx_adapter;
+	struct eth_device_info *dev_info;
+	struct eth_rx_queue_info *queue_info;
+	struct eth_event_enqueue_buffer *buf;
+	struct rte_event_eth_rx_adapter_stats *stats;
+	uint64_t tsc_hz;
+
+	if (params == NULL || strlen(params) == 0 || !isdigit(*params))
+		return -1;
+
+	/* Get Rx adapter ID from parameter string */
+	l_params = strdup(params);
+	if (l_params == NULL)
+		return -ENOMEM;
+	token = strtok(l_params, ",");
+	RTE_EVENT_ETH_RX_ADAPTER_TOKEN_VALID_OR_GOTO_ERR_RET(token, -1);
+	rx_adapter_id = strtoul(token, NULL, 10);
+	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_GOTO_ERR_RET(rx_adapter_id, -EINVAL);
+
+	token = strtok(NULL, ",");
+	RTE_EVENT_ETH_RX_ADAPTER_TOKEN_VALID_OR_GOTO_ERR_RET(token, -1);
+
+	/* Get device ID from parameter string */
+	eth_dev_id = strtoul(token, NULL, 10);
+	RTE_ETH_VALID_PORTID_OR_GOTO_ERR_RET(eth_dev_id, -EINVAL);
+
+	token = strtok(NULL, ",");
+	RTE_EVENT_ETH_RX_ADAPTER_TOKEN_VALID_OR_GOTO_ERR_RET(token, -1);
+
+	/* Get Rx queue ID from parameter string */
+	rx_queue_id = strtoul(token, NULL, 10);
+	if (rx_queue_id >= rte_eth_devices[eth_dev_id].data->nb_rx_queues) {
+		RTE_EDEV_LOG_ERR("Invalid rx queue_id %u", rx_queue_id);
+		ret = -EINVAL;
+		goto error;
+	}
+
+	token = strtok(NULL, "\0");
+	if (token != NULL)
+		RTE_EDEV_LOG_ERR("Extra parameters passed to eventdev"
+				 " telemetry command, ignoring");
+	/* Parsing parameter finished */
+	free(l_params);
+
+	if (rxa_memzone_lookup())
+		return -ENOMEM;
+
+	rx_adapter = rxa_id_to_adapter(rx_adapter_id);
+	if (rx_adapter == NULL)
+		return -EINVAL;
+
+	dev_info = &rx_adapter->eth_devices[eth_dev_id];
+	if (dev_info->rx_queue == NULL ||
+	    !dev_info->rx_queue[rx_queue_id].queue_enabled ||
+	    dev_info->internal_event_port) {
+		RTE_EDEV_LOG_ERR("Rx queue %u not polled by the adapter"
+				 " service", rx_queue_id);
+		return -EINVAL;
+	}
+
+	queue_info = &dev_info->rx_queue[rx_queue_id];
+	buf = rxa_event_buf_get(rx_adapter, eth_dev_id, rx_queue_id, &stats);
+	tsc_hz = rte_get_tsc_hz();
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_uint(d, "rx_adapter_id", rx_adapter_id);
+	rte_tel_data_add_dict_uint(d, "eth_dev_id", eth_dev_id);
+	rte_tel_data_add_dict_uint(d, "rx_queue_id", rx_queue_id);
+	rte_tel_data_add_dict_uint(d, "intr_fallback",
+				   queue_info->intr_fallback);
+	rte_tel_data_add_dict_string(d, "intr_state",
+			rxa_intr_state_str(queue_info->intr_state));
+	rte_tel_data_add_dict_uint(d, "idle_polls", queue_info->idle_polls);
+	rte_tel_data_add_dict_uint(d, "intr_parks", queue_info->intr_parks);
+	rte_tel_data_add_dict_uint(d, "intr_wakeups",
+				   queue_info->intr_wakeups);
+	rte_tel_data_add_dict_uint(d, "rx_pkts_per_poll",
+				   queue_info->rx_avg >> RXA_AVG_FRAC_SHIFT);
+	rte_tel_data_add_dict_uint(d, "poll_interval_ns",
+				   (uint64_t)((double)queue_info->poll_intvl_avg *
+					      NS_PER_S / tsc_hz));
+	rte_tel_data_add_dict_uint(d, "event_buf_count", buf->count);
+	rte_tel_data_add_dict_uint(d, "event_buf_size", buf->events_size);
+	rte_tel_data_add_dict_uint(d, "events_per_enq",
+				   buf->enq_avg >> RXA_AVG_FRAC_SHIFT);
+
+	return 0;
+
+error:
+	free(l_params);
+	return ret;
+}
+
 static int
 handle_rxa_queue_stats_reset(const char *cmd __rte_unused,
 			     const char *params,
@@ -3894,6 +4318,11 @@ RTE_INIT(rxa_init_telemetry)
 		handle_rxa_get_queue_stats,
 		"Returns Rx queue stats. Parameter: rxa_id, dev_id, queue_id");
 
+	rte_telemetry_register_cmd("/eventdev/rxa_queue_poll_stats",
+		handle_rxa_get_queue_poll_stats,
+		"Returns Rx queue polling and interrupt fallback stats."
+		" Parameter: rxa_id, dev_id, queue_id");
+
 	rte_telemetry_register_cmd("/eventdev/rxa_queue_stats_reset",
 		handle_rxa_queue_stats_reset,
 		"Reset Rx queue stats. Parameter: rxa_id, dev_id, queue_id");
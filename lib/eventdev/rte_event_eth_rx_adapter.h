@@ -107,6 +107,15 @@ extern "C" {
 /**< This flag indicates that mbufs arriving on the queue need to be vectorized
  * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
  */
+#define RTE_EVENT_ETH_RX_ADAPTER_QUEUE_INTR_FALLBACK	0x4
+/**< This flag indicates that a polled Rx queue is switched to interrupt mode
+ * by the adapter service function after it has been found empty for a
+ * number of consecutive polls, and polled again once it interrupts.
+ * It is valid for queues with a non-zero servicing_weight, requires Rx queue
+ * interrupts to be enabled for the ethernet device and is not supported for
+ * queues that share an interrupt vector.
+ * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
+ */
 
 /**
  * Adapter configuration structure that the adapter configuration callback
@@ -14,6 +14,7 @@
 #include <rte_errno.h>
 #include <rte_malloc.h>
 #include <rte_mempool.h>
+#include <rte_ring.h>
 #include <rte_common.h>
 #include <rte_timer.h>
 #include <rte_service_component.h>
@@ -36,6 +37,7 @@ RTE_LOG_REGISTER_SUFFIX(evtim_svc_logtype, adapter.timer.svc, NOTICE);
 static struct rte_event_timer_adapter *adapters;
 
 static const struct event_timer_adapter_ops swtim_ops;
+static const struct event_timer_adapter_ops swtw_ops;
 
 #define EVTIM_LOG(level, logtype, ...) \
 	rte_log(RTE_LOG_ ## level, logtype, \
@@ -235,7 +237,9 @@ rte_event_timer_adapter_create_ext(
 	 * implementation.
 	 */
 	if (adapter->ops == NULL)
-		adapter->ops = &swtim_ops;
+		adapter->ops = (adapter->data->conf.flags &
+				RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL) ?
+				&swtw_ops : &swtim_ops;
 
 	/* Allow driver to do some setup */
 	FUNC_PTR_OR_NULL_RET_WITH_ERRNO(adapter->ops->init, ENOTSUP);
@@ -380,7 +384,9 @@ rte_event_timer_adapter_lookup(uint16_t adapter_id)
 	 * implementation.
 	 */
 	if (adapter->ops == NULL)
-		adapter->ops = &swtim_ops;
+		adapter->ops = (adapter->data->conf.flags &
+				RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL) ?
+				&swtw_ops : &swtim_ops;
 
 	/* Set fast-path function pointers */
 	adapter->arm_burst = adapter->ops->arm_burst;
@@ -1381,6 +1387,786 @@ static const struct event_timer_adapter_ops swtim_ops = {
 	.remaining_ticks_get = swtim_remaining_ticks_get,
 };
 
+/*
+ * Timer wheel software event timer adapter implementation
+ *
+ * Arming lcores hand timer nodes to the service through per-lcore rings,
+ * so arming a burst takes no lock. The service owns the wheel: it links
+ * the handed off nodes into the slot of their expiry tick and, for every
+ * adapter tick elapsed, expires the nodes of the matching slot into the
+ * event buffer. Timeouts beyond one wheel revolution stay in their slot
+ * until the wheel catches up with their expiry tick.
+ *
+ * A node word holds the event timer pointer and the node state, which
+ * the arming, cancelling and service threads change with atomic
+ * operations only. Cancelling threads hand the cancelled nodes back to
+ * the service through a ring, which the service drains on every iteration
+ * to unlink the nodes and return them to the mempool.
+ */
+#define SWTW_NODE_ARMED		1
+#define SWTW_NODE_RUNNING	2
+#define SWTW_NODE_CANCELED	3
+#define SWTW_NODE_STATE_MASK	3
+
+#define SWTW_NODE_WORD(evtim, state) ((uintptr_t)(evtim) | (state))
+
+/* Node flags, only accessed by the service */
+#define SWTW_NODE_F_LINKED	(1 << 0) /* Linked in a wheel slot */
+#define SWTW_NODE_F_HANDED_OFF	(1 << 1) /* Dequeued from its arm ring */
+#define SWTW_NODE_F_RECLAIMED	(1 << 2) /* Dequeued from the cancel ring */
+
+#define SWTW_MAX_SLOTS		(1 << 16)
+#define SWTW_RING_SZ_MAX	(1 << 14)
+#define SWTW_DRAIN_BURST	64
+#define SWTW_FREE_BUF_SZ	128
+/* Arm ring of threads without a ring of their own */
+#define SWTW_SHARED_RING	RTE_MAX_LCORE
+
+struct swtw_node {
+	/* Next node in the wheel slot */
+	struct swtw_node *next;
+	/* Pointer to this node in the wheel slot */
+	struct swtw_node **pprev;
+	/* Adapter tick at which the timer expires */
+	uint64_t expiry;
+	/* Period in adapter ticks, 0 for a single shot timer */
+	uint64_t period;
+	/* Event timer pointer and node state */
+	uint64_t word;
+	/* SWTW_NODE_F_* flags */
+	uint32_t flags;
+};
+
+struct swtw {
+	/* Identifier of service executing timer management logic. */
+	uint32_t service_id;
+	/* Timer cycles per adapter tick */
+	uint64_t cycles_per_tick;
+	/* The tick resolution used by adapter instance. */
+	uint64_t timer_tick_ns;
+	/* Maximum timeout in nanoseconds allowed by adapter instance. */
+	uint64_t max_tmo_ns;
+	/* Last adapter tick the wheel was advanced to */
+	uint64_t last_tick;
+	/* Wheel slots, each a list of nodes */
+	struct swtw_node **slots;
+	/* Number of wheel slots minus one */
+	uint64_t slot_mask;
+	/* Buffered timer expiry events to be enqueued to an event device. */
+	struct event_buffer buffer;
+	/* Statistics */
+	struct rte_event_timer_adapter_stats stats;
+	/* Mempool of timer nodes */
+	struct rte_mempool *node_pool;
+	/* Arm rings indexed by lcore, the last one shared by other threads */
+	struct rte_ring *arm_ring[RTE_MAX_LCORE + 1];
+	/* Arm rings to be drained by the service */
+	struct rte_ring *rings[RTE_MAX_LCORE + 1];
+	/* The number of arm rings */
+	unsigned int n_rings;
+	/* Ring of cancelled nodes to be reclaimed by the service */
+	struct rte_ring *cancel_ring;
+	/* Nodes which can be returned to the mempool */
+	struct swtw_node *free_nodes[SWTW_FREE_BUF_SZ];
+	/* The number of nodes which can be returned to the mempool */
+	unsigned int n_free_nodes;
+};
+
+static inline struct swtw *
+swtw_pmd_priv(const struct rte_event_timer_adapter *adapter)
+{
+	return adapter->data->adapter_priv;
+}
+
+static inline uint64_t
+swtw_now_tick(const struct swtw *sw)
+{
+	return rte_get_timer_cycles() / sw->cycles_per_tick;
+}
+
+static inline void
+swtw_free_node(struct swtw *sw, struct swtw_node *node)
+{
+	if (unlikely(sw->n_free_nodes == SWTW_FREE_BUF_SZ)) {
+		rte_mempool_put_bulk(sw->node_pool, (void **)sw->free_nodes,
+				     sw->n_free_nodes);
+		sw->n_free_nodes = 0;
+	}
+
+	sw->free_nodes[sw->n_free_nodes++] = node;
+}
+
+static inline void
+swtw_link_node(struct swtw *sw, struct swtw_node *node)
+{
+	struct swtw_node **slot;
+	uint64_t tick;
+
+	/* Nodes handed off late expire on the next tick processed */
+	tick = RTE_MAX(node->expiry, sw->last_tick + 1);
+	slot = &sw->slots[tick & sw->slot_mask];
+	node->next = *slot;
+	if (node->next != NULL)
+		node->next->pprev = &node->next;
+	node->pprev = slot;
+	*slot = node;
+	node->flags |= SWTW_NODE_F_LINKED;
+}
+
+static inline void
+swtw_unlink_node(struct swtw_node *node)
+{
+	*node->pprev = node->next;
+	if (node->next != NULL)
+		node->next->pprev = node->pprev;
+	node->flags &= ~SWTW_NODE_F_LINKED;
+}
+
+static void
+swtw_drain_rings(struct swtw *sw)
+{
+	struct swtw_node *nodes[SWTW_DRAIN_BURST];
+	unsigned int i, j, n;
+	uint64_t word;
+
+	for (i = 0; i < sw->n_rings; i++) {
+		do {
+			n = rte_ring_dequeue_burst(sw->rings[i],
+						   (void **)nodes,
+						   SWTW_DRAIN_BURST, NULL);
+			for (j = 0; j < n; j++) {
+				nodes[j]->flags |= SWTW_NODE_F_HANDED_OFF;
+				word = __atomic_load_n(&nodes[j]->word,
+						       __ATOMIC_ACQUIRE);
+				if ((word & SWTW_NODE_STATE_MASK) !=
+				    SWTW_NODE_CANCELED)
+					swtw_link_node(sw, nodes[j]);
+				/* Cancelled before the hand off, free it
+				 * once out of the cancel ring too.
+				 */
+				else if (nodes[j]->flags &
+					 SWTW_NODE_F_RECLAIMED)
+					swtw_free_node(sw, nodes[j]);
+			}
+		} while (n == SWTW_DRAIN_BURST);
+	}
+}
+
+/* Free the cancelled nodes, which are out of their arm ring. The others
+ * are freed when drained from their arm ring.
+ */
+static void
+swtw_reclaim_nodes(struct swtw *sw)
+{
+	struct swtw_node *nodes[SWTW_DRAIN_BURST];
+	unsigned int i, n;
+
+	do {
+		n = rte_ring_dequeue_burst(sw->cancel_ring, (void **)nodes,
+					   SWTW_DRAIN_BURST, NULL);
+		for (i = 0; i < n; i++) {
+			nodes[i]->flags |= SWTW_NODE_F_RECLAIMED;
+			if (!(nodes[i]->flags & SWTW_NODE_F_HANDED_OFF))
+				continue;
+
+			if (nodes[i]->flags & SWTW_NODE_F_LINKED)
+				swtw_unlink_node(nodes[i]);
+			swtw_free_node(sw, nodes[i]);
+		}
+	} while (n == SWTW_DRAIN_BURST);
+}
+
+static void
+swtw_flush(struct swtw *sw, const struct rte_event_timer_adapter *adapter)
+{
+	uint16_t nb_evs_flushed, nb_evs_invalid;
+
+	do {
+		nb_evs_flushed = 0;
+		nb_evs_invalid = 0;
+		event_buffer_flush(&sw->buffer,
+				   adapter->data->event_dev_id,
+				   adapter->data->event_port_id,
+				   &nb_evs_flushed,
+				   &nb_evs_invalid);
+
+		sw->stats.ev_enq_count += nb_evs_flushed;
+		sw->stats.ev_inv_count += nb_evs_invalid;
+	} while (nb_evs_flushed + nb_evs_invalid == EVENT_BUFFER_BATCHSZ);
+}
+
+/* Expire the nodes of the slot of the given tick. Returns -1 if the event
+ * buffer ran out of space, in which case the slot has to be processed again.
+ */
+static int
+swtw_expire_slot(struct swtw *sw,
+		 const struct rte_event_timer_adapter *adapter,
+		 uint64_t tick)
+{
+	struct rte_event_timer *evtim;
+	struct swtw_node *node, **prev;
+	uint64_t word;
+
+	prev = &sw->slots[tick & sw->slot_mask];
+	while ((node = *prev) != NULL) {
+		word = __atomic_load_n(&node->word, __ATOMIC_ACQUIRE);
+		/* Freed once out of the cancel ring */
+		if ((word & SWTW_NODE_STATE_MASK) == SWTW_NODE_CANCELED) {
+			swtw_unlink_node(node);
+			continue;
+		}
+
+		/* Expires in a later revolution of the wheel */
+		if (node->expiry > tick) {
+			prev = &node->next;
+			continue;
+		}
+
+		if (unlikely(event_buffer_full(&sw->buffer))) {
+			swtw_flush(sw, adapter);
+			if (event_buffer_full(&sw->buffer)) {
+				sw->stats.evtim_retry_count++;
+				return -1;
+			}
+		}
+
+		evtim = (struct rte_event_timer *)(uintptr_t)
+			(word & ~(uint64_t)SWTW_NODE_STATE_MASK);
+
+		/* Lost the race against a cancel, unlink it on next loop */
+		if (!__atomic_compare_exchange_n(&node->word, &word,
+				SWTW_NODE_WORD(evtim, SWTW_NODE_RUNNING), 0,
+				__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			continue;
+
+		swtw_unlink_node(node);
+		event_buffer_add(&sw->buffer, &evtim->ev);
+		sw->stats.evtim_exp_count++;
+
+		if (node->period != 0) {
+			node->expiry = RTE_MAX(node->expiry + node->period,
+					       tick + 1);
+			__atomic_store_n(&node->word,
+					 SWTW_NODE_WORD(evtim, SWTW_NODE_ARMED),
+					 __ATOMIC_RELEASE);
+			swtw_link_node(sw, node);
+		} else {
+			swtw_free_node(sw, node);
+			__atomic_store_n(&evtim->state,
+					 RTE_EVENT_TIMER_NOT_ARMED,
+					 __ATOMIC_RELEASE);
+		}
+	}
+
+	return 0;
+}
+
+static int
+swtw_service_func(void *arg)
+{
+	struct rte_event_timer_adapter *adapter = arg;
+	struct swtw *sw = swtw_pmd_priv(adapter);
+	const uint64_t prior_enq_count = sw->stats.ev_enq_count;
+	uint64_t now, tick;
+
+	swtw_drain_rings(sw);
+	swtw_reclaim_nodes(sw);
+
+	now = swtw_now_tick(sw);
+	/* Each slot has to be visited only once to catch up */
+	if (now - sw->last_tick > sw->slot_mask + 1)
+		sw->last_tick = now - (sw->slot_mask + 1);
+
+	for (tick = sw->last_tick + 1; tick <= now; tick++) {
+		if (swtw_expire_slot(sw, adapter, tick) < 0)
+			break;
+		sw->last_tick = tick;
+		sw->stats.adapter_tick_count++;
+	}
+
+	if (sw->n_free_nodes > 0) {
+		rte_mempool_put_bulk(sw->node_pool, (void **)sw->free_nodes,
+				     sw->n_free_nodes);
+		sw->n_free_nodes = 0;
+	}
+
+	swtw_flush(sw, adapter);
+
+	rte_event_maintain(adapter->data->event_dev_id,
+			   adapter->data->event_port_id, 0);
+
+	return prior_enq_count == sw->stats.ev_enq_count ? -EAGAIN : 0;
+}
+
+static int
+swtw_init(struct rte_event_timer_adapter *adapter)
+{
+	char name[RTE_RING_NAMESIZE];
+	struct rte_service_spec service;
+	uint64_t nb_timers, nb_slots, max_ticks;
+	unsigned int lcore_id;
+	uint32_t ring_sz;
+	struct swtw *sw;
+	int cache_size;
+	int ret;
+
+	if (adapter->data->conf.timer_tick_ns == 0) {
+		EVTIM_LOG_ERR("invalid timer tick resolution");
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	snprintf(name, sizeof(name), "swtw_%"PRIu8, adapter->data->id);
+	sw = rte_zmalloc_socket(name, sizeof(*sw), RTE_CACHE_LINE_SIZE,
+				adapter->data->socket_id);
+	if (sw == NULL) {
+		EVTIM_LOG_ERR("failed to allocate space for private data");
+		rte_errno = ENOMEM;
+		return -1;
+	}
+
+	adapter->data->adapter_priv = sw;
+
+	sw->timer_tick_ns = adapter->data->conf.timer_tick_ns;
+	sw->max_tmo_ns = adapter->data->conf.max_tmo_ns;
+	sw->cycles_per_tick = RTE_MAX((uint64_t)((double)sw->timer_tick_ns *
+				rte_get_timer_hz() / NSECPERSEC), UINT64_C(1));
+
+	/* Timeouts of up to max_tmo_ns expire within one revolution */
+	max_ticks = sw->max_tmo_ns / sw->timer_tick_ns;
+	nb_slots = max_ticks < SWTW_MAX_SLOTS ?
+			rte_align64pow2(max_ticks + 1) : SWTW_MAX_SLOTS;
+	sw->slot_mask = nb_slots - 1;
+	sw->slots = rte_zmalloc_socket(name, nb_slots * sizeof(*sw->slots),
+				       RTE_CACHE_LINE_SIZE,
+				       adapter->data->socket_id);
+	if (sw->slots == NULL) {
+		EVTIM_LOG_ERR("failed to allocate timer wheel");
+		rte_errno = ENOMEM;
+		goto free_alloc;
+	}
+
+	/* Optimal mempool size is a power of 2 minus one. Besides the armed
+	 * timers, the pool holds as many cancelled nodes not reclaimed by the
+	 * service yet.
+	 */
+	snprintf(name, sizeof(name), "swtw_pool_%"PRIu8, adapter->data->id);
+	nb_timers = rte_align64pow2(adapter->data->conf.nb_timers);
+	cache_size = compute_msg_mempool_cache_size(
+				adapter->data->conf.nb_timers, nb_timers);
+	sw->node_pool = rte_mempool_create(name, 2 * nb_timers - 1,
+			sizeof(struct swtw_node), cache_size, 0, NULL, NULL,
+			NULL, NULL, adapter->data->socket_id, 0);
+	if (sw->node_pool == NULL) {
+		EVTIM_LOG_ERR("failed to create timer node mempool");
+		rte_errno = ENOMEM;
+		goto free_slots;
+	}
+
+	/* A node is in the cancel ring once at most, so it never fills up */
+	snprintf(name, sizeof(name), "swtw_%"PRIu8"_cancel", adapter->data->id);
+	sw->cancel_ring = rte_ring_create(name, 2 * nb_timers,
+			adapter->data->socket_id, RING_F_SC_DEQ);
+	if (sw->cancel_ring == NULL) {
+		EVTIM_LOG_ERR("failed to create timer cancel ring");
+		rte_errno = ENOMEM;
+		goto free_pool;
+	}
+
+	/* A ring per lcore, plus one shared by the other threads */
+	ring_sz = RTE_MIN(rte_align32pow2(adapter->data->conf.nb_timers + 1),
+			  (uint32_t)SWTW_RING_SZ_MAX);
+	RTE_LCORE_FOREACH(lcore_id) {
+		snprintf(name, sizeof(name), "swtw_%"PRIu8"_%u",
+			 adapter->data->id, lcore_id);
+		sw->arm_ring[lcore_id] = rte_ring_create(name, ring_sz,
+				adapter->data->socket_id,
+				RING_F_SP_ENQ | RING_F_SC_DEQ);
+		if (sw->arm_ring[lcore_id] == NULL) {
+			EVTIM_LOG_ERR("failed to create timer arm ring");
+			rte_errno = ENOMEM;
+			goto free_rings;
+		}
+		sw->rings[sw->n_rings++] = sw->arm_ring[lcore_id];
+	}
+
+	snprintf(name, sizeof(name), "swtw_%"PRIu8"_shared",
+		 adapter->data->id);
+	sw->arm_ring[SWTW_SHARED_RING] = rte_ring_create(name, ring_sz,
+			adapter->data->socket_id, RING_F_SC_DEQ);
+	if (sw->arm_ring[SWTW_SHARED_RING] == NULL) {
+		EVTIM_LOG_ERR("failed to create timer arm ring");
+		rte_errno = ENOMEM;
+		goto free_rings;
+	}
+	sw->rings[sw->n_rings++] = sw->arm_ring[SWTW_SHARED_RING];
+
+	event_buffer_init(&sw->buffer);
+	sw->last_tick = swtw_now_tick(sw);
+
+	/* Register a service component to run adapter logic */
+	memset(&service, 0, sizeof(service));
+	snprintf(service.name, RTE_SERVICE_NAME_MAX,
+		 "swtw_svc_%"PRIu8, adapter->data->id);
+	service.socket_id = adapter->data->socket_id;
+	service.callback = swtw_service_func;
+	service.callback_userdata = adapter;
+	service.capabilities &= ~(RTE_SERVICE_CAP_MT_SAFE);
+	ret = rte_service_component_register(&service, &sw->service_id);
+	if (ret < 0) {
+		EVTIM_LOG_ERR("failed to register service %s with id %"PRIu32
+			      ": err = %d", service.name, sw->service_id,
+			      ret);
+		rte_errno = ENOSPC;
+		goto free_rings;
+	}
+
+	EVTIM_LOG_DBG("registered service %s with id %"PRIu32, service.name,
+		      sw->service_id);
+
+	adapter->data->service_id = sw->service_id;
+	adapter->data->service_inited = 1;
+
+	return 0;
+
+free_rings:
+	while (sw->n_rings > 0)
+		rte_ring_free(sw->rings[--sw->n_rings]);
+	rte_ring_free(sw->cancel_ring);
+free_pool:
+	rte_mempool_free(sw->node_pool);
+free_slots:
+	rte_free(sw->slots);
+free_alloc:
+	rte_free(sw);
+	adapter->data->adapter_priv = NULL;
+	return -1;
+}
+
+static int
+swtw_uninit(struct rte_event_timer_adapter *adapter)
+{
+	struct swtw *sw = swtw_pmd_priv(adapter);
+	int ret;
+
+	ret = rte_service_component_unregister(sw->service_id);
+	if (ret < 0) {
+		EVTIM_LOG_ERR("failed to unregister service component");
+		return ret;
+	}
+
+	/* Outstanding nodes go away with the mempool */
+	while (sw->n_rings > 0)
+		rte_ring_free(sw->rings[--sw->n_rings]);
+	rte_ring_free(sw->cancel_ring);
+	rte_mempool_free(sw->node_pool);
+	rte_free(sw->slots);
+	rte_free(sw);
+	adapter->data->adapter_priv = NULL;
+
+	return 0;
+}
+
+static int
+swtw_start(const struct rte_event_timer_adapter *adapter)
+{
+	struct swtw *sw = swtw_pmd_priv(adapter);
+	int mapped_count;
+
+	/* The wheel is owned by the service, which can't run on more than
+	 * one service core.
+	 */
+	mapped_count = get_mapped_count_for_service(sw->service_id);
+
+	if (mapped_count != 1)
+		return mapped_count < 1 ? -ENOENT : -ENOTSUP;
+
+	return rte_service_component_runstate_set(sw->service_id, 1);
+}
+
+static int
+swtw_stop(const struct rte_event_timer_adapter *adapter)
+{
+	struct swtw *sw = swtw_pmd_priv(adapter);
+	int ret;
+
+	ret = rte_service_component_runstate_set(sw->service_id, 0);
+	if (ret < 0)
+		return ret;
+
+	/* Wait for the service to complete its final iteration */
+	while (rte_service_may_be_active(sw->service_id))
+		rte_pause();
+
+	return 0;
+}
+
+static void
+swtw_get_info(const struct rte_event_timer_adapter *adapter,
+	      struct rte_event_timer_adapter_info *adapter_info)
+{
+	struct swtw *sw = swtw_pmd_priv(adapter);
+
+	adapter_info->min_resolution_ns = sw->timer_tick_ns;
+	adapter_info->max_tmo_ns = sw->max_tmo_ns;
+}
+
+static int
+swtw_stats_get(const struct rte_event_timer_adapter *adapter,
+	       struct rte_event_timer_adapter_stats *stats)
+{
+	struct swtw *sw = swtw_pmd_priv(adapter);
+
+	*stats = sw->stats; /* structure copy */
+	return 0;
+}
+
+static int
+swtw_stats_reset(const struct rte_event_timer_adapter *adapter)
+{
+	struct swtw *sw = swtw_pmd_priv(adapter);
+
+	memset(&sw->stats, 0, sizeof(sw->stats));
+	return 0;
+}
+
+static int
+swtw_remaining_ticks_get(const struct rte_event_timer_adapter *adapter,
+			 const struct rte_event_timer *evtim,
+			 uint64_t *ticks_remaining)
+{
+	struct swtw *sw = swtw_pmd_priv(adapter);
+	enum rte_event_timer_state n_state;
+	struct swtw_node *node;
+	uint64_t now;
+
+	/* Check that timer is armed */
+	n_state = __atomic_load_n(&evtim->state, __ATOMIC_ACQUIRE);
+	if (n_state != RTE_EVENT_TIMER_ARMED)
+		return -EINVAL;
+
+	node = (struct swtw_node *)(uintptr_t)evtim->impl_opaque[0];
+	now = swtw_now_tick(sw) + 1;
+	*ticks_remaining = node->expiry > now ? node->expiry - now : 0;
+
+	return 0;
+}
+
+static uint16_t
+__swtw_arm_burst(const struct rte_event_timer_adapter *adapter,
+		 struct rte_event_timer **evtims,
+		 uint16_t nb_evtims)
+{
+	struct swtw *sw = swtw_pmd_priv(adapter);
+	struct swtw_node *nodes[nb_evtims];
+	enum rte_event_timer_state n_state;
+	unsigned int lcore_id = rte_lcore_id();
+	struct rte_ring *ring;
+	uint64_t now, period;
+	uint16_t i, n, nb_nodes;
+
+#ifdef RTE_LIBRTE_EVENTDEV_DEBUG
+	/* Check that the service is running. */
+	if (rte_service_runstate_get(adapter->data->service_id) != 1) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+#endif
+
+	if (lcore_id < RTE_MAX_LCORE && sw->arm_ring[lcore_id] != NULL)
+		ring = sw->arm_ring[lcore_id];
+	else
+		ring = sw->arm_ring[SWTW_SHARED_RING];
+
+	nb_nodes = nb_evtims;
+	if (rte_mempool_get_bulk(sw->node_pool, (void **)nodes,
+				 nb_evtims) < 0) {
+		/* Arm as many timers as there are nodes left */
+		for (nb_nodes = 0; nb_nodes < nb_evtims; nb_nodes++)
+			if (rte_mempool_get(sw->node_pool,
+					    (void **)&nodes[nb_nodes]) < 0)
+				break;
+		if (nb_nodes == 0) {
+			rte_errno = ENOSPC;
+			return 0;
+		}
+	}
+
+	period = adapter->data->conf.flags &
+			RTE_EVENT_TIMER_ADAPTER_F_PERIODIC;
+	now = swtw_now_tick(sw);
+
+	for (i = 0; i < nb_nodes; i++) {
+		n_state = __atomic_load_n(&evtims[i]->state, __ATOMIC_ACQUIRE);
+		if (n_state == RTE_EVENT_TIMER_ARMED) {
+			rte_errno = EALREADY;
+			break;
+		} else if (!(n_state == RTE_EVENT_TIMER_NOT_ARMED ||
+			     n_state == RTE_EVENT_TIMER_CANCELED)) {
+			rte_errno = EINVAL;
+			break;
+		}
+
+		if (unlikely(check_destination_event_queue(evtims[i],
+							   adapter) < 0)) {
+			__atomic_store_n(&evtims[i]->state,
+					RTE_EVENT_TIMER_ERROR,
+					__ATOMIC_RELAXED);
+			rte_errno = EINVAL;
+			break;
+		}
+
+		if (unlikely(evtims[i]->timeout_ticks == 0)) {
+			__atomic_store_n(&evtims[i]->state,
+					RTE_EVENT_TIMER_ERROR_TOOEARLY,
+					__ATOMIC_RELAXED);
+			rte_errno = EINVAL;
+			break;
+		} else if (unlikely(evtims[i]->timeout_ticks >
+				    sw->max_tmo_ns / sw->timer_tick_ns)) {
+			__atomic_store_n(&evtims[i]->state,
+					RTE_EVENT_TIMER_ERROR_TOOLATE,
+					__ATOMIC_RELAXED);
+			rte_errno = EINVAL;
+			break;
+		}
+
+		/* Arming happens in the middle of the current tick, expire at
+		 * the tick boundary following the timeout so it is never early.
+		 */
+		nodes[i]->expiry = now + evtims[i]->timeout_ticks + 1;
+		nodes[i]->period = period ? evtims[i]->timeout_ticks : 0;
+		nodes[i]->word = SWTW_NODE_WORD(evtims[i], SWTW_NODE_ARMED);
+		nodes[i]->flags = 0;
+
+		evtims[i]->impl_opaque[0] = (uintptr_t)nodes[i];
+		evtims[i]->impl_opaque[1] = (uintptr_t)adapter;
+
+		/* RELEASE ordering guarantees the adapter specific value
+		 * changes observed before the update of state.
+		 */
+		__atomic_store_n(&evtims[i]->state, RTE_EVENT_TIMER_ARMED,
+				__ATOMIC_RELEASE);
+	}
+
+	/* The nodes are published to the service in a single enqueue */
+	n = rte_ring_enqueue_burst(ring, (void **)nodes, i, NULL);
+	if (unlikely(n < i)) {
+		for (; i > n; i--)
+			__atomic_store_n(&evtims[i - 1]->state,
+					RTE_EVENT_TIMER_NOT_ARMED,
+					__ATOMIC_RELEASE);
+		rte_errno = ENOSPC;
+	} else if (i < nb_evtims && i == nb_nodes) {
+		rte_errno = ENOSPC;
+	}
+
+	if (n < nb_nodes)
+		rte_mempool_put_bulk(sw->node_pool, (void **)&nodes[n],
+				     nb_nodes - n);
+
+	return n;
+}
+
+static uint16_t
+swtw_arm_burst(const struct rte_event_timer_adapter *adapter,
+	       struct rte_event_timer **evtims,
+	       uint16_t nb_evtims)
+{
+	return __swtw_arm_burst(adapter, evtims, nb_evtims);
+}
+
+static uint16_t
+swtw_arm_tmo_tick_burst(const struct rte_event_timer_adapter *adapter,
+			struct rte_event_timer **evtims,
+			uint64_t timeout_ticks,
+			uint16_t nb_evtims)
+{
+	int i;
+
+	for (i = 0; i < nb_evtims; i++)
+		evtims[i]->timeout_ticks = timeout_ticks;
+
+	return __swtw_arm_burst(adapter, evtims, nb_evtims);
+}
+
+static uint16_t
+swtw_cancel_burst(const struct rte_event_timer_adapter *adapter,
+		  struct rte_event_timer **evtims,
+		  uint16_t nb_evtims)
+{
+	struct swtw *sw = swtw_pmd_priv(adapter);
+	struct swtw_node *nodes[nb_evtims];
+	enum rte_event_timer_state n_state;
+	struct swtw_node *node;
+	uint64_t word;
+	unsigned int n;
+	int i;
+
+#ifdef RTE_LIBRTE_EVENTDEV_DEBUG
+	/* Check that the service is running. */
+	if (rte_service_runstate_get(adapter->data->service_id) != 1) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+#endif
+
+	for (i = 0; i < nb_evtims; i++) {
+		/* ACQUIRE ordering guarantees the access of implementation
+		 * specific opaque data under the correct state.
+		 */
+		n_state = __atomic_load_n(&evtims[i]->state, __ATOMIC_ACQUIRE);
+		if (n_state == RTE_EVENT_TIMER_CANCELED) {
+			rte_errno = EALREADY;
+			break;
+		} else if (n_state != RTE_EVENT_TIMER_ARMED) {
+			rte_errno = EINVAL;
+			break;
+		}
+
+		node = (struct swtw_node *)(uintptr_t)evtims[i]->impl_opaque[0];
+		RTE_ASSERT(node != NULL);
+
+		word = SWTW_NODE_WORD(evtims[i], SWTW_NODE_ARMED);
+		if (!__atomic_compare_exchange_n(&node->word, &word,
+				SWTW_NODE_WORD(evtims[i], SWTW_NODE_CANCELED),
+				0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+			/* Timer is expiring */
+			rte_errno = EAGAIN;
+			break;
+		}
+
+		/* The RELEASE ordering here pairs with atomic ordering
+		 * to make sure the state update data observed between
+		 * threads.
+		 */
+		__atomic_store_n(&evtims[i]->state, RTE_EVENT_TIMER_CANCELED,
+				__ATOMIC_RELEASE);
+		nodes[i] = node;
+	}
+
+	/* The service unlinks and frees the nodes on its next iteration */
+	n = rte_ring_enqueue_burst(sw->cancel_ring, (void **)nodes, i, NULL);
+	RTE_ASSERT(n == (unsigned int)i);
+	RTE_SET_USED(n);
+
+	return i;
+}
+
+static const struct event_timer_adapter_ops swtw_ops = {
+	.init = swtw_init,
+	.uninit = swtw_uninit,
+	.start = swtw_start,
+	.stop = swtw_stop,
+	.get_info = swtw_get_info,
+	.stats_get = swtw_stats_get,
+	.stats_reset = swtw_stats_reset,
+	.arm_burst = swtw_arm_burst,
+	.arm_tmo_tick_burst = swtw_arm_tmo_tick_burst,
+	.cancel_burst = swtw_cancel_burst,
+	.remaining_ticks_get = swtw_remaining_ticks_get,
+};
+
 static int
 handle_ta_info(const char *cmd __rte_unused, const char *params,
 		struct rte_tel_data *d)
@@ -157,6 +157,15 @@ enum rte_event_timer_adapter_clk_src {
  * @see struct rte_event_timer_adapter_conf::flags
  */
 
+#define RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL	(1ULL << 3)
+/**< Use the timer wheel based software implementation, when the event device
+ * has no timer adapter of its own. Timers are armed without taking any lock,
+ * which suits adapters holding millions of timers. Timers expire on the
+ * first adapter tick following their timeout.
+ *
+ * @see struct rte_event_timer_adapter_conf::flags
+ */
+
 /**
  * Timer adapter configuration structure
  */
@@ -9,6 +9,7 @@
 #include <rte_common.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_telemetry.h>
 
 #include "graph_private.h"
 
@@ -382,8 +383,12 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 	uint64_t sched_objs = 0, sched_fail = 0;
 	struct rte_node *node;
 	rte_node_t count;
+	unsigned int i;
 	int model;
 
+	memset(stat->objs_hist, 0, sizeof(stat->objs_hist));
+	memset(stat->cycles_hist, 0, sizeof(stat->cycles_hist));
+
 	model = rte_graph_worker_model_get(STAILQ_FIRST(graph_list_head_get())->graph);
 	for (count = 0; count < cluster->nb_nodes; count++) {
 		node = cluster->nodes[count];
@@ -397,6 +402,11 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 		objs += node->total_objs;
 		cycles += node->total_cycles;
 		realloc_count += node->realloc_count;
+
+		for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++) {
+			stat->objs_hist[i] += node->objs_hist[i];
+			stat->cycles_hist[i] += node->cycles_hist[i];
+		}
 	}
 
 	stat->calls = calls;
@@ -464,6 +474,114 @@ rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat)
 		node->prev_objs = 0;
 		node->prev_cycles = 0;
 		node->realloc_count = 0;
+		memset(node->objs_hist, 0, sizeof(node->objs_hist));
+		memset(node->cycles_hist, 0, sizeof(node->cycles_hist));
 		cluster = RTE_PTR_ADD(cluster, stat->cluster_node_size);
 	}
 }
+
+static int
+graph_stats_telemetry_list(const char *cmd __rte_unused,
+			   const char *params __rte_unused,
+			   struct rte_tel_data *d)
+{
+	struct graph *graph;
+
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, graph_list_head_get(), next)
+		rte_tel_data_add_array_string(d, graph->name);
+	graph_spinlock_unlock();
+
+	return 0;
+}
+
+static struct rte_tel_data *
+graph_stats_telemetry_hist(const uint64_t *hist)
+{
+	struct rte_tel_data *t;
+	unsigned int i;
+
+	t = rte_tel_data_alloc();
+	if (t == NULL)
+		return NULL;
+
+	rte_tel_data_start_array(t, RTE_TEL_UINT_VAL);
+	for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++)
+		rte_tel_data_add_array_uint(t, hist[i]);
+
+	return t;
+}
+
+static int
+graph_stats_telemetry_node(const char *cmd __rte_unused, const char *params,
+			   struct rte_tel_data *d)
+{
+	uint64_t objs_hist[RTE_GRAPH_HIST_BUCKETS] = {0};
+	uint64_t cycles_hist[RTE_GRAPH_HIST_BUCKETS] = {0};
+	uint64_t calls = 0, objs = 0, cycles = 0;
+	struct rte_tel_data *objs_tel, *cycles_tel;
+	struct rte_node *node;
+	struct graph *graph;
+	bool found = false;
+	rte_graph_off_t off;
+	rte_node_t count;
+	unsigned int i;
+
+	if (!rte_graph_has_stats_feature())
+		return -ENOTSUP;
+
+	if (params == NULL || strlen(params) == 0)
+		return -EINVAL;
+
+	/* Aggregate the node stats across all the graphs it belongs to */
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, graph_list_head_get(), next) {
+		rte_graph_foreach_node(count, off, graph->graph, node) {
+			if (strncmp(node->name, params, RTE_NODE_NAMESIZE))
+				continue;
+
+			calls += node->total_calls;
+			objs += node->total_objs;
+			cycles += node->total_cycles;
+			for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++) {
+				objs_hist[i] += node->objs_hist[i];
+				cycles_hist[i] += node->cycles_hist[i];
+			}
+			found = true;
+			break;
+		}
+	}
+	graph_spinlock_unlock();
+
+	if (!found)
+		return -ENOENT;
+
+	objs_tel = graph_stats_telemetry_hist(objs_hist);
+	cycles_tel = graph_stats_telemetry_hist(cycles_hist);
+	if (objs_tel == NULL || cycles_tel == NULL) {
+		rte_tel_data_free(objs_tel);
+		rte_tel_data_free(cycles_tel);
+		return -ENOMEM;
+	}
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_uint(d, "calls", calls);
+	rte_tel_data_add_dict_uint(d, "objs", objs);
+	rte_tel_data_add_dict_uint(d, "cycles", cycles);
+	rte_tel_data_add_dict_uint(d, "hist_sample_interval",
+				   RTE_GRAPH_HIST_SAMPLE_INTERVAL);
+	rte_tel_data_add_dict_container(d, "objs_hist", objs_tel, 0);
+	rte_tel_data_add_dict_container(d, "cycles_hist", cycles_tel, 0);
+
+	return 0;
+}
+
+RTE_INIT(graph_stats_telemetry)
+{
+	rte_telemetry_register_cmd("/graph/list", graph_stats_telemetry_list,
+		"Returns list of graph names. Takes no parameters");
+	rte_telemetry_register_cmd("/graph/node/stats",
+		graph_stats_telemetry_node,
+		"Returns node stats and histograms aggregated across graphs. Parameters: string node_name");
+}
@@ -69,6 +69,14 @@ typedef uint16_t rte_graph_t;      /**< Graph id type. */
 #error "Unsupported burst size"
 #endif
 
+/** Number of log2 buckets in the per node stats histograms. */
+#define RTE_GRAPH_HIST_BUCKETS 16
+
+/** Node calls between two histogram samples, must be a power of 2. */
+#ifndef RTE_GRAPH_HIST_SAMPLE_INTERVAL
+#define RTE_GRAPH_HIST_SAMPLE_INTERVAL 64
+#endif
+
 /* Forward declaration */
 struct rte_node;  /**< Node object */
 struct rte_graph; /**< Graph object */
@@ -230,6 +238,15 @@ struct rte_graph_cluster_node_stats {
 
 	uint64_t realloc_count; /**< Realloc count. */
 
+	/** Sampled objs per call histogram.
+	 * Bucket 0 counts calls with no objs, bucket N (N > 0) counts calls
+	 * with [2^(N-1), 2^N) objs, the last bucket also counts everything above.
+	 * One call out of RTE_GRAPH_HIST_SAMPLE_INTERVAL is sampled.
+	 */
+	uint64_t objs_hist[RTE_GRAPH_HIST_BUCKETS];
+	/** Sampled cycles per obj histogram, same bucket layout as objs_hist. */
+	uint64_t cycles_hist[RTE_GRAPH_HIST_BUCKETS];
+
 	rte_node_t id;	/**< Node identifier of stats. */
 	uint64_t hz;	/**< Cycles per seconds. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
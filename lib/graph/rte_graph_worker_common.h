@@ -114,6 +114,10 @@ struct rte_node {
 			uint64_t total_sched_fail; /**< Number of scheduled failure. */
 		} dispatch;
 	};
+	/** Sampled objs per call histogram, updated when stats are enabled. */
+	uint64_t objs_hist[RTE_GRAPH_HIST_BUCKETS];
+	/** Sampled cycles per obj histogram, updated when stats are enabled. */
+	uint64_t cycles_hist[RTE_GRAPH_HIST_BUCKETS];
 	/* Fast path area  */
 #define RTE_NODE_CTX_SZ 16
 	uint8_t ctx[RTE_NODE_CTX_SZ] __rte_cache_aligned; /**< Node Context. */
@@ -171,6 +175,44 @@ void __rte_node_stream_alloc_size(struct rte_graph *graph,
 
 /* Fast path helper functions */
 
+/**
+ * @internal
+ *
+ * Get the log2 histogram bucket of a value.
+ *
+ * @param val
+ *   Value to classify.
+ *
+ * @return
+ *   0 for a zero value, otherwise the position of the most significant bit
+ *   capped to the last bucket.
+ */
+static __rte_always_inline unsigned int
+__rte_graph_hist_bucket(uint64_t val)
+{
+	return RTE_MIN((unsigned int)rte_fls_u64(val),
+		       (unsigned int)RTE_GRAPH_HIST_BUCKETS - 1);
+}
+
+/**
+ * @internal
+ *
+ * Account one sampled node call into the node histograms.
+ *
+ * @param node
+ *   Pointer to the node object.
+ * @param objs
+ *   Number of objects processed by the call.
+ * @param cycles
+ *   Cycles spent in the call.
+ */
+static __rte_always_inline void
+__rte_node_hist_update(struct rte_node *node, uint16_t objs, uint64_t cycles)
+{
+	node->objs_hist[__rte_graph_hist_bucket(objs)]++;
+	node->cycles_hist[__rte_graph_hist_bucket(objs ? cycles / objs : 0)]++;
+}
+
 /**
  * @internal
  *
@@ -184,7 +226,7 @@ void __rte_node_stream_alloc_size(struct rte_graph *graph,
 static __rte_always_inline void
 __rte_node_process(struct rte_graph *graph, struct rte_node *node)
 {
-	uint64_t start;
+	uint64_t start, cycles;
 	uint16_t rc;
 	void **objs;
 
@@ -195,9 +237,13 @@ __rte_node_process(struct rte_graph *graph, struct rte_node *node)
 	if (rte_graph_has_stats_feature()) {
 		start = rte_rdtsc();
 		rc = node->process(graph, node, objs, node->idx);
-		node->total_cycles += rte_rdtsc() - start;
+		cycles = rte_rdtsc() - start;
+		node->total_cycles += cycles;
 		node->total_calls++;
 		node->total_objs += rc;
+		if (unlikely((node->total_calls &
+			      (RTE_GRAPH_HIST_SAMPLE_INTERVAL - 1)) == 0))
+			__rte_node_hist_update(node, rc, cycles);
 	} else {
 		node->process(graph, node, objs, node->idx);
 	}
@@ -659,6 +659,9 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
  * Associate RCU QSBR variable with a Hash object.
  * This API should be called to enable the integrated RCU QSBR support and
  * should be called immediately after creating the Hash object.
+ * The reader threads either report their quiescent state on the variable,
+ * or mark their lookups with rte_rcu_qsbr_read_enter/exit, when they can
+ * block for long periods.
  *
  * @param h
  *   the hash object to add RCU QSBR
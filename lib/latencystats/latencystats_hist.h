@@ -0,0 +1,91 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#ifndef _LATENCYSTATS_HIST_H_
+#define _LATENCYSTATS_HIST_H_
+
+#include <math.h>
+#include <stdint.h>
+
+#include <rte_bitops.h>
+#include <rte_common.h>
+
+/**
+ * @file
+ * Internal latency histogram functions
+ *
+ * Latencies in TSC cycles are counted in a log-linear (HDR) histogram:
+ * each power of two range is split in LATENCY_HIST_SUB buckets, so the
+ * relative error of a percentile is below 1 / LATENCY_HIST_SUB.
+ * Values below LATENCY_HIST_SUB have their own bucket, values above
+ * 2^LATENCY_HIST_MAX_BITS go in the last one.
+ */
+
+#define LATENCY_HIST_SUB_BITS	6
+#define LATENCY_HIST_SUB	(1u << LATENCY_HIST_SUB_BITS)
+#define LATENCY_HIST_MAX_BITS	40
+#define LATENCY_HIST_BUCKETS \
+	((LATENCY_HIST_MAX_BITS - LATENCY_HIST_SUB_BITS + 1) * LATENCY_HIST_SUB)
+
+/* Bucket counting a latency */
+static inline unsigned int
+latency_hist_bucket(uint64_t latency)
+{
+	unsigned int msb, shift;
+
+	if (latency < LATENCY_HIST_SUB)
+		return latency;
+
+	msb = rte_fls_u64(latency) - 1;
+	if (msb >= LATENCY_HIST_MAX_BITS)
+		return LATENCY_HIST_BUCKETS - 1;
+
+	shift = msb - LATENCY_HIST_SUB_BITS;
+	return (shift + 1) * LATENCY_HIST_SUB +
+		((latency >> shift) & (LATENCY_HIST_SUB - 1));
+}
+
+/* Highest latency counted in a bucket */
+static inline uint64_t
+latency_hist_value(unsigned int bucket)
+{
+	unsigned int group = bucket / LATENCY_HIST_SUB;
+	uint64_t sub = bucket % LATENCY_HIST_SUB;
+
+	if (group == 0)
+		return sub;
+
+	return ((LATENCY_HIST_SUB + sub + 1) << (group - 1)) - 1;
+}
+
+/*
+ * Highest latency of the buckets holding the given percentiles, in
+ * increasing order, of the samples of a histogram; 0 without samples.
+ */
+static inline void
+latency_hist_percentiles(const uint64_t *hist, const double *percentiles,
+			 unsigned int n, uint64_t *values)
+{
+	uint64_t rank[n];
+	uint64_t count = 0;
+	unsigned int i, p = 0;
+
+	for (i = 0; i < LATENCY_HIST_BUCKETS; i++)
+		count += hist[i];
+	for (i = 0; i < n; i++) {
+		rank[i] = RTE_MAX(ceil(percentiles[i] * count), 1.);
+		values[i] = 0;
+	}
+	if (count == 0)
+		return;
+
+	count = 0;
+	for (i = 0; i < LATENCY_HIST_BUCKETS && p < n; i++) {
+		count += hist[i];
+		while (p < n && count >= rank[p])
+			values[p++] = latency_hist_value(i);
+	}
+}
+
+#endif /* _LATENCYSTATS_HIST_H_ */
@@ -2,7 +2,9 @@
  * Copyright(c) 2018 Intel Corporation
  */
 
+#include <ctype.h>
 #include <math.h>
+#include <stdlib.h>
 
 #include <rte_string_fns.h>
 #include <rte_mbuf_dyn.h>
@@ -12,14 +14,16 @@
 #include <rte_metrics.h>
 #include <rte_memzone.h>
 #include <rte_lcore.h>
+#include <rte_telemetry.h>
 
 #include "rte_latencystats.h"
+#include "latencystats_hist.h"
 
 /** Nano seconds per second */
 #define NS_PER_SEC 1E9
 
 /** Clock cycles per nano second */
-static uint64_t
+static double
 latencystat_cycles_per_ns(void)
 {
 	return rte_get_timer_hz() / NS_PER_SEC;
@@ -41,15 +45,36 @@ timestamp_dynfield(struct rte_mbuf *mbuf)
 static const char *MZ_RTE_LATENCY_STATS = "rte_latencystats";
 static int latency_stats_index;
 static uint64_t samp_intvl;
-static uint64_t timer_tsc;
-static uint64_t prev_tsc;
 
-struct rte_latency_stats {
-	float min_latency; /**< Minimum latency in nano seconds */
-	float avg_latency; /**< Average latency in nano seconds */
-	float max_latency; /**< Maximum latency in nano seconds */
+/* Sampling state of a Rx queue */
+struct latency_rxq {
+	uint64_t timer_tsc;
+	uint64_t prev_tsc;
+} __rte_cache_aligned;
+
+/*
+ * Latency of a Tx queue, only written by the lcore polling the queue,
+ * so it needs no lock. Readers merge the queues they are interested in.
+ */
+struct latency_txq {
+	uint64_t samples;
+	uint64_t sum;
+	uint64_t min;
+	uint64_t max;
 	float jitter; /** Latency variation */
-	rte_spinlock_t lock; /** Latency calculation lock */
+	float prev_latency;
+	uint64_t hist[LATENCY_HIST_BUCKETS];
+} __rte_cache_aligned;
+
+/*
+ * Shared with secondary processes: the Tx queues of all ports,
+ * followed by the Rx queues sampling state.
+ */
+struct rte_latency_stats {
+	uint32_t txq_base[RTE_MAX_ETHPORTS]; /**< First Tx queue of a port */
+	uint16_t nb_txq[RTE_MAX_ETHPORTS];   /**< Number of Tx queues of a port */
+	uint32_t nb_txq_total;
+	struct latency_txq txq[];
 };
 
 static struct rte_latency_stats *glob_stats;
@@ -61,57 +86,171 @@ struct rxtx_cbs {
 static struct rxtx_cbs rx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 static struct rxtx_cbs tx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 
-struct latency_stats_nameoff {
+struct latency_stats_name {
 	char name[RTE_ETH_XSTATS_NAME_SIZE];
-	unsigned int offset;
 };
 
-static const struct latency_stats_nameoff lat_stats_strings[] = {
-	{"min_latency_ns", offsetof(struct rte_latency_stats, min_latency)},
-	{"avg_latency_ns", offsetof(struct rte_latency_stats, avg_latency)},
-	{"max_latency_ns", offsetof(struct rte_latency_stats, max_latency)},
-	{"jitter_ns", offsetof(struct rte_latency_stats, jitter)},
+enum {
+	LATENCY_MIN,
+	LATENCY_AVG,
+	LATENCY_MAX,
+	LATENCY_JITTER,
+	LATENCY_P50,
+	LATENCY_P99,
+	LATENCY_P99_9,
+	LATENCY_P99_99,
+};
+
+static const struct latency_stats_name lat_stats_strings[] = {
+	[LATENCY_MIN] = {"min_latency_ns"},
+	[LATENCY_AVG] = {"avg_latency_ns"},
+	[LATENCY_MAX] = {"max_latency_ns"},
+	[LATENCY_JITTER] = {"jitter_ns"},
+	[LATENCY_P50] = {"p50_latency_ns"},
+	[LATENCY_P99] = {"p99_latency_ns"},
+	[LATENCY_P99_9] = {"p99_9_latency_ns"},
+	[LATENCY_P99_99] = {"p99_99_latency_ns"},
 };
 
 #define NUM_LATENCY_STATS (sizeof(lat_stats_strings) / \
 				sizeof(lat_stats_strings[0]))
 
-int32_t
-rte_latencystats_update(void)
+static const double lat_percentiles[] = {
+	[LATENCY_P50 - LATENCY_P50] = 0.5,
+	[LATENCY_P99 - LATENCY_P50] = 0.99,
+	[LATENCY_P99_9 - LATENCY_P50] = 0.999,
+	[LATENCY_P99_99 - LATENCY_P50] = 0.9999,
+};
+
+/* Merge of the histograms of several Tx queues */
+struct latency_summary {
+	uint64_t samples;
+	uint64_t sum;
+	uint64_t min;
+	uint64_t max;
+	double jitter;
+	uint64_t hist[LATENCY_HIST_BUCKETS];
+};
+
+static void
+latency_summary_add(struct latency_summary *s, const struct latency_txq *q)
 {
+	uint64_t samples, val;
 	unsigned int i;
-	float *stats_ptr = NULL;
-	uint64_t values[NUM_LATENCY_STATS] = {0};
-	int ret;
 
-	for (i = 0; i < NUM_LATENCY_STATS; i++) {
-		stats_ptr = RTE_PTR_ADD(glob_stats,
-				lat_stats_strings[i].offset);
-		values[i] = (uint64_t)floor((*stats_ptr)/
-				latencystat_cycles_per_ns());
+	samples = __atomic_load_n(&q->samples, __ATOMIC_RELAXED);
+	if (samples == 0)
+		return;
+
+	s->samples += samples;
+	s->sum += __atomic_load_n(&q->sum, __ATOMIC_RELAXED);
+	s->jitter += (double)q->jitter * samples;
+
+	val = __atomic_load_n(&q->min, __ATOMIC_RELAXED);
+	if (s->min == 0 || val < s->min)
+		s->min = val;
+	val = __atomic_load_n(&q->max, __ATOMIC_RELAXED);
+	if (val > s->max)
+		s->max = val;
+
+	for (i = 0; i < LATENCY_HIST_BUCKETS; i++)
+		s->hist[i] += __atomic_load_n(&q->hist[i], __ATOMIC_RELAXED);
+}
+
+/* Merge the Tx queues of all ports, a port, or a single queue */
+static void
+latency_summary_get(struct latency_summary *s, uint16_t pid, uint16_t qid)
+{
+	uint16_t p, q;
+
+	memset(s, 0, sizeof(*s));
+	for (p = 0; p < RTE_MAX_ETHPORTS; p++) {
+		if (pid != RTE_MAX_ETHPORTS && p != pid)
+			continue;
+		for (q = 0; q < glob_stats->nb_txq[p]; q++) {
+			if (qid != UINT16_MAX && q != qid)
+				continue;
+			latency_summary_add(s,
+				&glob_stats->txq[glob_stats->txq_base[p] + q]);
+		}
 	}
+}
 
+static void
+latency_summary_values(const struct latency_summary *s, uint64_t *values)
+{
+	const double cycles_per_ns = latencystat_cycles_per_ns();
+	uint64_t pct[RTE_DIM(lat_percentiles)];
+	unsigned int i;
+
+	memset(values, 0, NUM_LATENCY_STATS * sizeof(*values));
+	if (s->samples == 0)
+		return;
+
+	values[LATENCY_MIN] = floor(s->min / cycles_per_ns);
+	values[LATENCY_AVG] = floor((double)s->sum / s->samples /
+				    cycles_per_ns);
+	values[LATENCY_MAX] = floor(s->max / cycles_per_ns);
+	values[LATENCY_JITTER] = floor(s->jitter / s->samples /
+				       cycles_per_ns);
+
+	/* The samples may not be added up yet, rank on the histogram sum */
+	latency_hist_percentiles(s->hist, lat_percentiles,
+				 RTE_DIM(lat_percentiles), pct);
+	for (i = 0; i < RTE_DIM(lat_percentiles); i++)
+		values[LATENCY_P50 + i] = floor(RTE_MIN(pct[i], s->max) /
+						cycles_per_ns);
+}
+
+int32_t
+rte_latencystats_update(void)
+{
+	struct latency_summary s;
+	uint64_t values[NUM_LATENCY_STATS];
+	uint16_t pid;
+	int ret;
+
+	latency_summary_get(&s, RTE_MAX_ETHPORTS, UINT16_MAX);
+	latency_summary_values(&s, values);
 	ret = rte_metrics_update_values(RTE_METRICS_GLOBAL,
 					latency_stats_index,
 					values, NUM_LATENCY_STATS);
-	if (ret < 0)
+	if (ret < 0) {
 		RTE_LOG(INFO, LATENCY_STATS, "Failed to push the stats\n");
+		return ret;
+	}
 
-	return ret;
+	/* Same statistics for each port */
+	for (pid = 0; pid < RTE_MAX_ETHPORTS; pid++) {
+		if (glob_stats->nb_txq[pid] == 0)
+			continue;
+
+		latency_summary_get(&s, pid, UINT16_MAX);
+		latency_summary_values(&s, values);
+		ret = rte_metrics_update_values(pid, latency_stats_index,
+						values, NUM_LATENCY_STATS);
+		if (ret < 0) {
+			RTE_LOG(INFO, LATENCY_STATS,
+				"Failed to push the stats of port %u\n", pid);
+			return ret;
+		}
+	}
+
+	return 0;
 }
 
 static void
 rte_latencystats_fill_values(struct rte_metric_value *values)
 {
+	struct latency_summary s;
+	uint64_t vals[NUM_LATENCY_STATS];
 	unsigned int i;
-	float *stats_ptr = NULL;
 
+	latency_summary_get(&s, RTE_MAX_ETHPORTS, UINT16_MAX);
+	latency_summary_values(&s, vals);
 	for (i = 0; i < NUM_LATENCY_STATS; i++) {
-		stats_ptr = RTE_PTR_ADD(glob_stats,
-				lat_stats_strings[i].offset);
 		values[i].key = i;
-		values[i].value = (uint64_t)floor((*stats_ptr)/
-						latencystat_cycles_per_ns());
+		values[i].value = vals[i];
 	}
 }
 
@@ -121,95 +260,93 @@ add_time_stamps(uint16_t pid __rte_unused,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
 		uint16_t max_pkts __rte_unused,
-		void *user_cb __rte_unused)
+		void *user_cb)
 {
+	struct latency_rxq *rxq = user_cb;
 	unsigned int i;
 	uint64_t diff_tsc, now;
 
 	/*
 	 * For every sample interval,
-	 * time stamp is marked on one received packet.
+	 * time stamp is marked on one received packet of the queue.
 	 */
 	now = rte_rdtsc();
 	for (i = 0; i < nb_pkts; i++) {
-		diff_tsc = now - prev_tsc;
-		timer_tsc += diff_tsc;
+		diff_tsc = now - rxq->prev_tsc;
+		rxq->timer_tsc += diff_tsc;
 
 		if ((pkts[i]->ol_flags & timestamp_dynflag) == 0
-				&& (timer_tsc >= samp_intvl)) {
+				&& (rxq->timer_tsc >= samp_intvl)) {
 			*timestamp_dynfield(pkts[i]) = now;
 			pkts[i]->ol_flags |= timestamp_dynflag;
-			timer_tsc = 0;
+			rxq->timer_tsc = 0;
 		}
-		prev_tsc = now;
+		rxq->prev_tsc = now;
 		now = rte_rdtsc();
 	}
 
 	return nb_pkts;
 }
 
+static inline void
+latency_txq_add(struct latency_txq *txq, uint64_t latency)
+{
+	unsigned int b = latency_hist_bucket(latency);
+
+	/*
+	 * Single writer: plain increments, stored atomically
+	 * so that readers do not see torn values.
+	 */
+	__atomic_store_n(&txq->hist[b], txq->hist[b] + 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&txq->sum, txq->sum + latency, __ATOMIC_RELAXED);
+	if (latency < txq->min)
+		__atomic_store_n(&txq->min, latency, __ATOMIC_RELAXED);
+	if (latency > txq->max)
+		__atomic_store_n(&txq->max, latency, __ATOMIC_RELAXED);
+
+	/*
+	 * The jitter is calculated as statistical mean of interpacket
+	 * delay variation. The "jitter estimate" is computed by taking
+	 * the absolute values of the ipdv sequence and applying an
+	 * exponential filter with parameter 1/16 to generate the
+	 * estimate. i.e J=J+(|D(i-1,i)|-J)/16. Where J is jitter,
+	 * D(i-1,i) is difference in latency of two consecutive packets
+	 * i-1 and i.
+	 * Reference: Calculated as per RFC 5481, sec 4.1,
+	 * RFC 3393 sec 4.5, RFC 1889 sec.
+	 */
+	txq->jitter += (fabsf(txq->prev_latency - (float)latency)
+			- txq->jitter) / 16;
+	txq->prev_latency = latency;
+
+	/* last, so that readers seeing a sample see its values */
+	__atomic_store_n(&txq->samples, txq->samples + 1, __ATOMIC_RELEASE);
+}
+
 static uint16_t
 calc_latency(uint16_t pid __rte_unused,
 		uint16_t qid __rte_unused,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
-		void *_ __rte_unused)
+		void *user_cb)
 {
-	unsigned int i, cnt = 0;
+	struct latency_txq *txq = user_cb;
+	unsigned int i;
 	uint64_t now;
-	float latency[nb_pkts];
-	static float prev_latency;
-	/*
-	 * Alpha represents degree of weighting decrease in EWMA,
-	 * a constant smoothing factor between 0 and 1. The value
-	 * is used below for measuring average latency.
-	 */
-	const float alpha = 0.2;
 
 	now = rte_rdtsc();
 	for (i = 0; i < nb_pkts; i++) {
 		if (pkts[i]->ol_flags & timestamp_dynflag)
-			latency[cnt++] = now - *timestamp_dynfield(pkts[i]);
-	}
-
-	rte_spinlock_lock(&glob_stats->lock);
-	for (i = 0; i < cnt; i++) {
-		/*
-		 * The jitter is calculated as statistical mean of interpacket
-		 * delay variation. The "jitter estimate" is computed by taking
-		 * the absolute values of the ipdv sequence and applying an
-		 * exponential filter with parameter 1/16 to generate the
-		 * estimate. i.e J=J+(|D(i-1,i)|-J)/16. Where J is jitter,
-		 * D(i-1,i) is difference in latency of two consecutive packets
-		 * i-1 and i.
-		 * Reference: Calculated as per RFC 5481, sec 4.1,
-		 * RFC 3393 sec 4.5, RFC 1889 sec.
-		 */
-		glob_stats->jitter +=  (fabsf(prev_latency - latency[i])
-					- glob_stats->jitter)/16;
-		if (glob_stats->min_latency == 0)
-			glob_stats->min_latency = latency[i];
-		else if (latency[i] < glob_stats->min_latency)
-			glob_stats->min_latency = latency[i];
-		else if (latency[i] > glob_stats->max_latency)
-			glob_stats->max_latency = latency[i];
-		/*
-		 * The average latency is measured using exponential moving
-		 * average, i.e. using EWMA
-		 * https://en.wikipedia.org/wiki/Moving_average
-		 */
-		glob_stats->avg_latency +=
-			alpha * (latency[i] - glob_stats->avg_latency);
-		prev_latency = latency[i];
+			latency_txq_add(txq,
+					now - *timestamp_dynfield(pkts[i]));
 	}
-	rte_spinlock_unlock(&glob_stats->lock);
 
 	return nb_pkts;
 }
 
 int
 rte_latencystats_init(uint64_t app_samp_intvl,
-		rte_latency_stats_flow_type_fn user_cb)
+		rte_latency_stats_flow_type_fn user_cb __rte_unused)
 {
 	unsigned int i;
 	uint16_t pid;
@@ -218,14 +355,40 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	const char *ptr_strings[NUM_LATENCY_STATS] = {0};
 	const struct rte_memzone *mz = NULL;
 	const unsigned int flags = 0;
+	uint16_t nb_rxq[RTE_MAX_ETHPORTS] = {0};
+	uint16_t nb_txq[RTE_MAX_ETHPORTS] = {0};
+	uint32_t nb_txq_total = 0, nb_rxq_total = 0;
+	struct latency_rxq *rxq;
 	int ret;
 
 	if (rte_memzone_lookup(MZ_RTE_LATENCY_STATS))
 		return -EEXIST;
 
+	/** Count the queues to allocate their stats */
+	RTE_ETH_FOREACH_DEV(pid) {
+		struct rte_eth_dev_info dev_info;
+
+		ret = rte_eth_dev_info_get(pid, &dev_info);
+		if (ret != 0) {
+			RTE_LOG(INFO, LATENCY_STATS,
+				"Error during getting device (port %u) info: %s\n",
+				pid, strerror(-ret));
+
+			continue;
+		}
+
+		nb_rxq[pid] = dev_info.nb_rx_queues;
+		nb_txq[pid] = dev_info.nb_tx_queues;
+		nb_rxq_total += dev_info.nb_rx_queues;
+		nb_txq_total += dev_info.nb_tx_queues;
+	}
+
 	/** Allocate stats in shared memory fo multi process support */
-	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, sizeof(*glob_stats),
-					rte_socket_id(), flags);
+	mz = rte_memzone_reserve_aligned(MZ_RTE_LATENCY_STATS,
+			sizeof(*glob_stats) +
+			nb_txq_total * sizeof(struct latency_txq) +
+			nb_rxq_total * sizeof(struct latency_rxq),
+			rte_socket_id(), flags, RTE_CACHE_LINE_SIZE);
 	if (mz == NULL) {
 		RTE_LOG(ERR, LATENCY_STATS, "Cannot reserve memory: %s:%d\n",
 			__func__, __LINE__);
@@ -233,7 +396,8 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	}
 
 	glob_stats = mz->addr;
-	rte_spinlock_init(&glob_stats->lock);
+	memset(glob_stats, 0, mz->len);
+	rxq = (struct latency_rxq *)&glob_stats->txq[nb_txq_total];
 	samp_intvl = app_samp_intvl * latencystat_cycles_per_ns();
 
 	/** Register latency stats with stats library */
@@ -270,23 +434,42 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 			continue;
 		}
 
+		/* queues added since counted have no stats */
+		dev_info.nb_rx_queues = RTE_MIN(dev_info.nb_rx_queues,
+						nb_rxq[pid]);
+		dev_info.nb_tx_queues = RTE_MIN(dev_info.nb_tx_queues,
+						nb_txq[pid]);
+
 		for (qid = 0; qid < dev_info.nb_rx_queues; qid++) {
 			cbs = &rx_cbs[pid][qid];
 			cbs->cb = rte_eth_add_first_rx_callback(pid, qid,
-					add_time_stamps, user_cb);
+					add_time_stamps, rxq++);
 			if (!cbs->cb)
 				RTE_LOG(INFO, LATENCY_STATS, "Failed to "
 					"register Rx callback for pid=%d, "
 					"qid=%d\n", pid, qid);
+			else
+				rte_eth_rxtx_callback_flags_set(cbs->cb,
+					RTE_ETH_RXTX_CALLBACK_F_PKT_WINDOW);
 		}
+
+		glob_stats->txq_base[pid] = glob_stats->nb_txq_total;
+		glob_stats->nb_txq[pid] = dev_info.nb_tx_queues;
 		for (qid = 0; qid < dev_info.nb_tx_queues; qid++) {
+			struct latency_txq *txq =
+				&glob_stats->txq[glob_stats->nb_txq_total++];
+
+			txq->min = UINT64_MAX;
 			cbs = &tx_cbs[pid][qid];
 			cbs->cb =  rte_eth_add_tx_callback(pid, qid,
-					calc_latency, user_cb);
+					calc_latency, txq);
 			if (!cbs->cb)
 				RTE_LOG(INFO, LATENCY_STATS, "Failed to "
 					"register Tx callback for pid=%d, "
 					"qid=%d\n", pid, qid);
+			else
+				rte_eth_rxtx_callback_flags_set(cbs->cb,
+					RTE_ETH_RXTX_CALLBACK_F_PKT_WINDOW);
 		}
 	}
 	return 0;
@@ -336,6 +519,7 @@ rte_latencystats_uninit(void)
 	mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
 	if (mz)
 		rte_memzone_free(mz);
+	glob_stats = NULL;
 
 	return 0;
 }
@@ -355,12 +539,9 @@ rte_latencystats_get_names(struct rte_metric_name *names, uint16_t size)
 	return NUM_LATENCY_STATS;
 }
 
-int
-rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
+static int
+latency_stats_lookup(void)
 {
-	if (size < NUM_LATENCY_STATS || values == NULL)
-		return NUM_LATENCY_STATS;
-
 	if (rte_eal_process_type() == RTE_PROC_SECONDARY) {
 		const struct rte_memzone *mz;
 		mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
@@ -372,8 +553,78 @@ rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
 		glob_stats =  mz->addr;
 	}
 
+	return glob_stats == NULL ? -ENOMEM : 0;
+}
+
+int
+rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
+{
+	int ret;
+
+	if (size < NUM_LATENCY_STATS || values == NULL)
+		return NUM_LATENCY_STATS;
+
+	ret = latency_stats_lookup();
+	if (ret < 0)
+		return ret;
+
 	/* Retrieve latency stats */
 	rte_latencystats_fill_values(values);
 
 	return NUM_LATENCY_STATS;
 }
+
+static int
+latency_stats_handle_stats(const char *cmd __rte_unused, const char *params,
+			   struct rte_tel_data *d)
+{
+	uint16_t pid = RTE_MAX_ETHPORTS, qid = UINT16_MAX;
+	uint64_t values[NUM_LATENCY_STATS];
+	struct latency_summary s;
+	unsigned long val;
+	unsigned int i;
+	char *end;
+
+	if (latency_stats_lookup() < 0)
+		return -EINVAL;
+
+	/* Optional port and queue ids */
+	if (params != NULL && *params != '\0') {
+		if (!isdigit(*params))
+			return -EINVAL;
+		val = strtoul(params, &end, 0);
+		if (val >= RTE_MAX_ETHPORTS || glob_stats->nb_txq[val] == 0)
+			return -EINVAL;
+		pid = val;
+
+		if (*end == ',') {
+			params = end + 1;
+			if (!isdigit(*params))
+				return -EINVAL;
+			val = strtoul(params, &end, 0);
+			if (val >= glob_stats->nb_txq[pid])
+				return -EINVAL;
+			qid = val;
+		}
+		if (*end != '\0')
+			return -EINVAL;
+	}
+
+	latency_summary_get(&s, pid, qid);
+	latency_summary_values(&s, values);
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_uint(d, "samples", s.samples);
+	for (i = 0; i < NUM_LATENCY_STATS; i++)
+		rte_tel_data_add_dict_uint(d, lat_stats_strings[i].name,
+					   values[i]);
+
+	return 0;
+}
+
+RTE_INIT(latencystats_init_telemetry)
+{
+	rte_telemetry_register_cmd("/latencystats/stats",
+		latency_stats_handle_stats,
+		"Returns the latency stats of all ports, a port or a Tx queue. Parameters: [int port_id[,int queue_id]]");
+}
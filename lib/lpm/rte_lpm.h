@@ -190,6 +190,9 @@ rte_lpm_free(struct rte_lpm *lpm);
  * @b EXPERIMENTAL: this API may change without prior notice
  *
  * Associate RCU QSBR variable with an LPM object.
+ * Reader threads which do not report their quiescent state periodically
+ * can mark their lookups as read-side critical sections on the variable
+ * instead, see rte_rcu_qsbr_read_enter().
  *
  * @param lpm
  *   the lpm object to add RCU QSBR
@@ -7,6 +7,7 @@
 #include <math.h>
 
 #include <rte_cycles.h>
+#include <rte_prefetch.h>
 
 #include "rte_meter.h"
 
@@ -158,3 +159,138 @@ rte_meter_trtcm_rfc4115_config(
 
 	return 0;
 }
+
+void
+rte_meter_srtcm_color_blind_check_burst(struct rte_meter_srtcm **m,
+	struct rte_meter_srtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < n_pkts && i < RTE_METER_BURST_PREFETCH_OFFSET; i++)
+		rte_prefetch0(m[i]);
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BURST_PREFETCH_OFFSET < n_pkts)
+			rte_prefetch0(m[i + RTE_METER_BURST_PREFETCH_OFFSET]);
+
+		color[i] = rte_meter_srtcm_color_blind_check(m[i], p[i], time[i],
+			pkt_len[i]);
+	}
+}
+
+void
+rte_meter_srtcm_color_aware_check_burst(struct rte_meter_srtcm **m,
+	struct rte_meter_srtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	const enum rte_color *pkt_color,
+	enum rte_color *color,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < n_pkts && i < RTE_METER_BURST_PREFETCH_OFFSET; i++)
+		rte_prefetch0(m[i]);
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BURST_PREFETCH_OFFSET < n_pkts)
+			rte_prefetch0(m[i + RTE_METER_BURST_PREFETCH_OFFSET]);
+
+		color[i] = rte_meter_srtcm_color_aware_check(m[i], p[i], time[i],
+			pkt_len[i], pkt_color[i]);
+	}
+}
+
+void
+rte_meter_trtcm_color_blind_check_burst(struct rte_meter_trtcm **m,
+	struct rte_meter_trtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < n_pkts && i < RTE_METER_BURST_PREFETCH_OFFSET; i++)
+		rte_prefetch0(m[i]);
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BURST_PREFETCH_OFFSET < n_pkts)
+			rte_prefetch0(m[i + RTE_METER_BURST_PREFETCH_OFFSET]);
+
+		color[i] = rte_meter_trtcm_color_blind_check(m[i], p[i], time[i],
+			pkt_len[i]);
+	}
+}
+
+void
+rte_meter_trtcm_color_aware_check_burst(struct rte_meter_trtcm **m,
+	struct rte_meter_trtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	const enum rte_color *pkt_color,
+	enum rte_color *color,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < n_pkts && i < RTE_METER_BURST_PREFETCH_OFFSET; i++)
+		rte_prefetch0(m[i]);
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BURST_PREFETCH_OFFSET < n_pkts)
+			rte_prefetch0(m[i + RTE_METER_BURST_PREFETCH_OFFSET]);
+
+		color[i] = rte_meter_trtcm_color_aware_check(m[i], p[i], time[i],
+			pkt_len[i], pkt_color[i]);
+	}
+}
+
+void
+rte_meter_trtcm_rfc4115_color_blind_check_burst(struct rte_meter_trtcm_rfc4115 **m,
+	struct rte_meter_trtcm_rfc4115_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < n_pkts && i < RTE_METER_BURST_PREFETCH_OFFSET; i++)
+		rte_prefetch0(m[i]);
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BURST_PREFETCH_OFFSET < n_pkts)
+			rte_prefetch0(m[i + RTE_METER_BURST_PREFETCH_OFFSET]);
+
+		color[i] = rte_meter_trtcm_rfc4115_color_blind_check(m[i], p[i], time[i],
+			pkt_len[i]);
+	}
+}
+
+void
+rte_meter_trtcm_rfc4115_color_aware_check_burst(struct rte_meter_trtcm_rfc4115 **m,
+	struct rte_meter_trtcm_rfc4115_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	const enum rte_color *pkt_color,
+	enum rte_color *color,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < n_pkts && i < RTE_METER_BURST_PREFETCH_OFFSET; i++)
+		rte_prefetch0(m[i]);
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BURST_PREFETCH_OFFSET < n_pkts)
+			rte_prefetch0(m[i + RTE_METER_BURST_PREFETCH_OFFSET]);
+
+		color[i] = rte_meter_trtcm_rfc4115_color_aware_check(m[i], p[i], time[i],
+			pkt_len[i], pkt_color[i]);
+	}
+}
@@ -22,6 +22,8 @@ extern "C" {
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+
 /*
  * Application Programmer's Interface (API)
  */
@@ -323,10 +325,194 @@ rte_meter_trtcm_rfc4115_color_aware_check(
 	uint32_t pkt_len,
 	enum rte_color pkt_color);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * srTCM color blind traffic metering of a burst of packets
+ *
+ * @param m
+ *    Handle to the srTCM instance of each packet
+ * @param p
+ *    Profile of each srTCM instance
+ * @param time
+ *    CPU time stamp of each packet (measured in CPU cycles)
+ * @param pkt_len
+ *    Length of each IP packet (measured in bytes)
+ * @param color
+ *    Color assigned to each IP packet
+ * @param n_pkts
+ *    Number of packets
+ */
+__rte_experimental
+void
+rte_meter_srtcm_color_blind_check_burst(struct rte_meter_srtcm **m,
+	struct rte_meter_srtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * srTCM color aware traffic metering of a burst of packets
+ *
+ * @param m
+ *    Handle to the srTCM instance of each packet
+ * @param p
+ *    Profile of each srTCM instance
+ * @param time
+ *    CPU time stamp of each packet (measured in CPU cycles)
+ * @param pkt_len
+ *    Length of each IP packet (measured in bytes)
+ * @param pkt_color
+ *    Input color of each IP packet
+ * @param color
+ *    Color assigned to each IP packet
+ * @param n_pkts
+ *    Number of packets
+ */
+__rte_experimental
+void
+rte_meter_srtcm_color_aware_check_burst(struct rte_meter_srtcm **m,
+	struct rte_meter_srtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	const enum rte_color *pkt_color,
+	enum rte_color *color,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * trTCM color blind traffic metering of a burst of packets
+ *
+ * @param m
+ *    Handle to the trTCM instance of each packet
+ * @param p
+ *    Profile of each trTCM instance
+ * @param time
+ *    CPU time stamp of each packet (measured in CPU cycles)
+ * @param pkt_len
+ *    Length of each IP packet (measured in bytes)
+ * @param color
+ *    Color assigned to each IP packet
+ * @param n_pkts
+ *    Number of packets
+ */
+__rte_experimental
+void
+rte_meter_trtcm_color_blind_check_burst(struct rte_meter_trtcm **m,
+	struct rte_meter_trtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * trTCM color aware traffic metering of a burst of packets
+ *
+ * @param m
+ *    Handle to the trTCM instance of each packet
+ * @param p
+ *    Profile of each trTCM instance
+ * @param time
+ *    CPU time stamp of each packet (measured in CPU cycles)
+ * @param pkt_len
+ *    Length of each IP packet (measured in bytes)
+ * @param pkt_color
+ *    Input color of each IP packet
+ * @param color
+ *    Color assigned to each IP packet
+ * @param n_pkts
+ *    Number of packets
+ */
+__rte_experimental
+void
+rte_meter_trtcm_color_aware_check_burst(struct rte_meter_trtcm **m,
+	struct rte_meter_trtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	const enum rte_color *pkt_color,
+	enum rte_color *color,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * trTCM RFC4115 color blind traffic metering of a burst of packets
+ *
+ * @param m
+ *    Handle to the trTCM RFC4115 instance of each packet
+ * @param p
+ *    Profile of each trTCM RFC4115 instance
+ * @param time
+ *    CPU time stamp of each packet (measured in CPU cycles)
+ * @param pkt_len
+ *    Length of each IP packet (measured in bytes)
+ * @param color
+ *    Color assigned to each IP packet
+ * @param n_pkts
+ *    Number of packets
+ */
+__rte_experimental
+void
+rte_meter_trtcm_rfc4115_color_blind_check_burst(struct rte_meter_trtcm_rfc4115 **m,
+	struct rte_meter_trtcm_rfc4115_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * trTCM RFC4115 color aware traffic metering of a burst of packets
+ *
+ * @param m
+ *    Handle to the trTCM RFC4115 instance of each packet
+ * @param p
+ *    Profile of each trTCM RFC4115 instance
+ * @param time
+ *    CPU time stamp of each packet (measured in CPU cycles)
+ * @param pkt_len
+ *    Length of each IP packet (measured in bytes)
+ * @param pkt_color
+ *    Input color of each IP packet
+ * @param color
+ *    Color assigned to each IP packet
+ * @param n_pkts
+ *    Number of packets
+ */
+__rte_experimental
+void
+rte_meter_trtcm_rfc4115_color_aware_check_burst(struct rte_meter_trtcm_rfc4115 **m,
+	struct rte_meter_trtcm_rfc4115_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	const enum rte_color *pkt_color,
+	enum rte_color *color,
+	uint32_t n_pkts);
+
 /*
  * Inline implementation of run-time methods
  */
 
+/*
+ * The burst metering functions process the packets in order, so a meter used
+ * by several packets of the burst is updated exactly as with the per packet
+ * functions, while the meters of the next packets are prefetched.
+ */
+#define RTE_METER_BURST_PREFETCH_OFFSET 8
+
 struct rte_meter_srtcm_profile {
 	uint64_t cbs;
 	/**< Upper limit for C token bucket */
@@ -661,7 +847,6 @@ rte_meter_trtcm_rfc4115_color_aware_check(
 	return RTE_COLOR_RED;
 }
 
-
 #ifdef __cplusplus
 }
 #endif
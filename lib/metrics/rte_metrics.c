@@ -7,6 +7,8 @@
 
 #include <rte_errno.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_lcore.h>
 #include <rte_string_fns.h>
 #include <rte_metrics.h>
 #include <rte_memzone.h>
@@ -15,6 +17,10 @@
 int metrics_initialized;
 
 #define RTE_METRICS_MEMZONE_NAME "RTE_METRICS"
+#define RTE_METRICS_SHARD_MEMZONE_NAME "RTE_METRICS_SHARD_%u"
+
+/* values of global metrics are stored after the ports ones in shards */
+#define METRICS_SHARD_GLOBAL RTE_MAX_ETHPORTS
 
 /**
  * Internal stats metadata and value entry.
@@ -28,6 +34,10 @@ struct rte_metrics_meta_s {
 	uint64_t value[RTE_MAX_ETHPORTS];
 	/** Used for global metrics */
 	uint64_t global_value;
+	/** Time of the last update of value */
+	uint64_t stamp[RTE_MAX_ETHPORTS];
+	/** Time of the last update of global_value */
+	uint64_t global_stamp;
 	/** Index of next root element (zero for none) */
 	uint16_t idx_next_set;
 	/** Index of next metric in set (zero for none) */
@@ -43,6 +53,8 @@ struct rte_metrics_meta_s {
  * processes is not guaranteed.
  */
 struct rte_metrics_data_s {
+	/** TSC at initialization, zero once deinitialized */
+	uint64_t generation;
 	/**   Index of last metadata entry with valid data.
 	 * This value is not valid if cnt_stats is zero.
 	 */
@@ -53,8 +65,149 @@ struct rte_metrics_data_s {
 	struct rte_metrics_meta_s metadata[RTE_METRICS_MAX_METRICS];
 	/** Metric data access lock */
 	rte_spinlock_t lock;
+	/** Set once the shard of an lcore is reserved */
+	uint8_t shard_used[RTE_MAX_LCORE];
+};
+
+/**
+ * Internal metric value entry of a shard.
+ *
+ * @internal
+ */
+struct rte_metrics_shard_value {
+	/** Current value for metric */
+	uint64_t value;
+	/** Time of the last update, zero if never updated */
+	uint64_t stamp;
+};
+
+/**
+ * Internal per lcore metric values.
+ *
+ * @internal
+ * Each lcore updates the metrics in its own shard, a memzone written
+ * without any lock, so that updates from the datapath neither contend
+ * nor share cache lines. Readers keep the most recently updated value
+ * of each metric, among the shards and the locked metric data which is
+ * updated by non-EAL threads.
+ */
+struct rte_metrics_shard_s {
+	/** Generation of the metric data the shard belongs to */
+	uint64_t generation;
+	/** Metric values of each port, followed by the global ones */
+	struct rte_metrics_shard_value
+		values[RTE_MAX_ETHPORTS + 1][RTE_METRICS_MAX_METRICS];
 };
 
+/*
+ * Memzones looked up by this process, which may have been freed or
+ * reserved again by the primary process since. Their descriptors stay
+ * mapped, so the memzone address is read from the descriptor, and the
+ * memzone is used only if it holds the expected generation.
+ */
+static const struct rte_memzone *metrics_memzone;
+static uint64_t metrics_generation;
+static const struct rte_memzone *metrics_shard_memzones[RTE_MAX_LCORE];
+
+static struct rte_metrics_data_s *
+metrics_data_get(void)
+{
+	struct rte_metrics_data_s *stats;
+	const struct rte_memzone *memzone;
+	uint64_t generation;
+
+	memzone = __atomic_load_n(&metrics_memzone, __ATOMIC_ACQUIRE);
+	if (likely(memzone != NULL)) {
+		stats = __atomic_load_n(&memzone->addr, __ATOMIC_RELAXED);
+		if (likely(stats != NULL &&
+				__atomic_load_n(&stats->generation,
+					__ATOMIC_ACQUIRE) ==
+				__atomic_load_n(&metrics_generation,
+					__ATOMIC_RELAXED)))
+			return stats;
+	}
+
+	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
+	if (memzone == NULL)
+		return NULL;
+	stats = memzone->addr;
+	generation = __atomic_load_n(&stats->generation, __ATOMIC_ACQUIRE);
+	/* being initialized or deinitialized */
+	if (generation == 0)
+		return NULL;
+	__atomic_store_n(&metrics_generation, generation, __ATOMIC_RELAXED);
+	__atomic_store_n(&metrics_memzone, memzone, __ATOMIC_RELEASE);
+	return stats;
+}
+
+static void
+metrics_shard_name(char *name, size_t len, unsigned int lcore_id)
+{
+	snprintf(name, len, RTE_METRICS_SHARD_MEMZONE_NAME, lcore_id);
+}
+
+/* get the shard of an lcore, reserved by any process */
+static struct rte_metrics_shard_s *
+metrics_shard_lookup(const struct rte_metrics_data_s *stats,
+	unsigned int lcore_id)
+{
+	char name[RTE_MEMZONE_NAMESIZE];
+	struct rte_metrics_shard_s *shard;
+	const struct rte_memzone *memzone;
+	uint64_t generation;
+
+	generation = __atomic_load_n(&stats->generation, __ATOMIC_RELAXED);
+	memzone = __atomic_load_n(&metrics_shard_memzones[lcore_id],
+		__ATOMIC_ACQUIRE);
+	if (likely(memzone != NULL)) {
+		shard = __atomic_load_n(&memzone->addr, __ATOMIC_RELAXED);
+		if (likely(shard != NULL &&
+				__atomic_load_n(&shard->generation,
+					__ATOMIC_ACQUIRE) == generation))
+			return shard;
+	}
+
+	metrics_shard_name(name, sizeof(name), lcore_id);
+	memzone = rte_memzone_lookup(name);
+	if (memzone == NULL)
+		return NULL;
+	shard = memzone->addr;
+	if (__atomic_load_n(&shard->generation, __ATOMIC_ACQUIRE) !=
+			generation)
+		return NULL;
+	__atomic_store_n(&metrics_shard_memzones[lcore_id], memzone,
+		__ATOMIC_RELEASE);
+	return shard;
+}
+
+/* get the shard of the calling lcore, reserving it on first use */
+static struct rte_metrics_shard_s *
+metrics_shard_get(struct rte_metrics_data_s *stats, unsigned int lcore_id)
+{
+	char name[RTE_MEMZONE_NAMESIZE];
+	struct rte_metrics_shard_s *shard;
+	const struct rte_memzone *memzone;
+
+	shard = metrics_shard_lookup(stats, lcore_id);
+	if (likely(shard != NULL))
+		return shard;
+
+	metrics_shard_name(name, sizeof(name), lcore_id);
+	memzone = rte_memzone_reserve(name, sizeof(*shard),
+		rte_lcore_to_socket_id(lcore_id), 0);
+	if (memzone == NULL)
+		return NULL;
+	shard = memzone->addr;
+	memset(shard, 0, sizeof(*shard));
+	__atomic_store_n(&shard->generation, stats->generation,
+		__ATOMIC_RELEASE);
+	__atomic_store_n(&metrics_shard_memzones[lcore_id], memzone,
+		__ATOMIC_RELEASE);
+	/* readers may look the shard up once it is initialized */
+	__atomic_store_n(&stats->shard_used[lcore_id], 1, __ATOMIC_RELEASE);
+	return shard;
+}
+
 int
 rte_metrics_init(int socket_id)
 {
@@ -76,6 +229,9 @@ rte_metrics_init(int socket_id)
 	stats = memzone->addr;
 	memset(stats, 0, sizeof(struct rte_metrics_data_s));
 	rte_spinlock_init(&stats->lock);
+	/* other processes may use the metric data once it has a generation */
+	__atomic_store_n(&stats->generation,
+		RTE_MAX(rte_get_tsc_cycles(), UINT64_C(1)), __ATOMIC_RELEASE);
 	metrics_initialized = 1;
 	return 0;
 }
@@ -85,6 +241,7 @@ rte_metrics_deinit(void)
 {
 	struct rte_metrics_data_s *stats;
 	const struct rte_memzone *memzone;
+	unsigned int lcore_id;
 	int ret;
 
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
@@ -94,7 +251,20 @@ rte_metrics_deinit(void)
 	if (memzone == NULL)
 		return -EIO;
 
+	/* processes which looked the memzones up will not use them anymore */
 	stats = memzone->addr;
+	__atomic_store_n(&stats->generation, 0, __ATOMIC_RELEASE);
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		char name[RTE_MEMZONE_NAMESIZE];
+		const struct rte_memzone *shard_mz;
+
+		if (!stats->shard_used[lcore_id])
+			continue;
+		metrics_shard_name(name, sizeof(name), lcore_id);
+		shard_mz = rte_memzone_lookup(name);
+		if (shard_mz != NULL)
+			rte_memzone_free(shard_mz);
+	}
 	memset(stats, 0, sizeof(struct rte_metrics_data_s));
 
 	ret = rte_memzone_free(memzone);
@@ -116,7 +286,6 @@ rte_metrics_reg_names(const char * const *names, uint16_t cnt_names)
 {
 	struct rte_metrics_meta_s *entry = NULL;
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_name;
 	uint16_t idx_base;
 
@@ -127,10 +296,9 @@ rte_metrics_reg_names(const char * const *names, uint16_t cnt_names)
 		if (names[idx_name] == NULL)
 			return -EINVAL;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_data_get();
+	if (stats == NULL)
 		return -EIO;
-	stats = memzone->addr;
 
 	if (stats->cnt_stats + cnt_names >= RTE_METRICS_MAX_METRICS)
 		return -ENOMEM;
@@ -150,7 +318,9 @@ rte_metrics_reg_names(const char * const *names, uint16_t cnt_names)
 	}
 	entry->idx_next_stat = 0;
 	entry->idx_next_set = 0;
-	stats->cnt_stats += cnt_names;
+	/* lockless updates may use the new metrics once they are visible */
+	__atomic_store_n(&stats->cnt_stats, stats->cnt_stats + cnt_names,
+		__ATOMIC_RELEASE);
 
 	rte_spinlock_unlock(&stats->lock);
 
@@ -163,18 +333,48 @@ rte_metrics_update_value(int port_id, uint16_t key, const uint64_t value)
 	return rte_metrics_update_values(port_id, key, &value, 1);
 }
 
+/* check that an update does not cross a set border */
+static int
+metrics_check_set(const struct rte_metrics_data_s *stats, uint16_t key,
+	uint32_t count)
+{
+	struct rte_metrics_meta_s const *entry;
+	uint16_t cnt_stats;
+	uint16_t idx_metric;
+	uint16_t cnt_setsize;
+
+	/* registered entries are not modified, no lock is needed */
+	cnt_stats = __atomic_load_n(&stats->cnt_stats, __ATOMIC_ACQUIRE);
+	if (key >= cnt_stats)
+		return -EINVAL;
+	idx_metric = key;
+	cnt_setsize = 1;
+	while (idx_metric < cnt_stats) {
+		entry = &stats->metadata[idx_metric];
+		if (entry->idx_next_stat == 0)
+			break;
+		cnt_setsize++;
+		idx_metric++;
+	}
+	if (count > cnt_setsize)
+		return -ERANGE;
+	return 0;
+}
+
 int
 rte_metrics_update_values(int port_id,
 	uint16_t key,
 	const uint64_t *values,
 	uint32_t count)
 {
-	struct rte_metrics_meta_s *entry;
+	struct rte_metrics_shard_value *shard_values;
+	struct rte_metrics_shard_s *shard;
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
+	unsigned int lcore_id;
 	uint16_t idx_metric;
 	uint16_t idx_value;
-	uint16_t cnt_setsize;
+	uint64_t stamp;
+	int ret;
 
 	if (port_id != RTE_METRICS_GLOBAL &&
 			(port_id < 0 || port_id >= RTE_MAX_ETHPORTS))
@@ -183,43 +383,46 @@ rte_metrics_update_values(int port_id,
 	if (values == NULL)
 		return -EINVAL;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_data_get();
+	if (stats == NULL)
 		return -EIO;
-	stats = memzone->addr;
 
-	rte_spinlock_lock(&stats->lock);
-
-	if (key >= stats->cnt_stats) {
-		rte_spinlock_unlock(&stats->lock);
-		return -EINVAL;
-	}
-	idx_metric = key;
-	cnt_setsize = 1;
-	while (idx_metric < stats->cnt_stats) {
-		entry = &stats->metadata[idx_metric];
-		if (entry->idx_next_stat == 0)
-			break;
-		cnt_setsize++;
-		idx_metric++;
-	}
-	/* Check update does not cross set border */
-	if (count > cnt_setsize) {
-		rte_spinlock_unlock(&stats->lock);
-		return -ERANGE;
+	ret = metrics_check_set(stats, key, count);
+	if (ret != 0)
+		return ret;
+
+	stamp = rte_get_tsc_cycles();
+	lcore_id = rte_lcore_id();
+	shard = lcore_id < RTE_MAX_LCORE ?
+		metrics_shard_get(stats, lcore_id) : NULL;
+	if (likely(shard != NULL)) {
+		/* only this lcore writes its shard, plain stores are enough */
+		shard_values = shard->values[port_id == RTE_METRICS_GLOBAL ?
+			METRICS_SHARD_GLOBAL : port_id];
+		for (idx_value = 0; idx_value < count; idx_value++) {
+			idx_metric = key + idx_value;
+			__atomic_store_n(&shard_values[idx_metric].value,
+				values[idx_value], __ATOMIC_RELAXED);
+			__atomic_store_n(&shard_values[idx_metric].stamp,
+				stamp, __ATOMIC_RELEASE);
+		}
+		return 0;
 	}
 
+	rte_spinlock_lock(&stats->lock);
 	if (port_id == RTE_METRICS_GLOBAL)
 		for (idx_value = 0; idx_value < count; idx_value++) {
 			idx_metric = key + idx_value;
 			stats->metadata[idx_metric].global_value =
 				values[idx_value];
+			stats->metadata[idx_metric].global_stamp = stamp;
 		}
 	else
 		for (idx_value = 0; idx_value < count; idx_value++) {
 			idx_metric = key + idx_value;
 			stats->metadata[idx_metric].value[port_id] =
 				values[idx_value];
+			stats->metadata[idx_metric].stamp[port_id] = stamp;
 		}
 	rte_spinlock_unlock(&stats->lock);
 	return 0;
@@ -230,15 +433,13 @@ rte_metrics_get_names(struct rte_metric_name *names,
 	uint16_t capacity)
 {
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_name;
 	int return_value;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_data_get();
+	if (stats == NULL)
 		return -EIO;
 
-	stats = memzone->addr;
 	rte_spinlock_lock(&stats->lock);
 	if (names != NULL) {
 		if (capacity < stats->cnt_stats) {
@@ -256,14 +457,47 @@ rte_metrics_get_names(struct rte_metric_name *names,
 	return return_value;
 }
 
+/* keep the most recent value of each metric, among the shards */
+static void
+metrics_shards_merge(struct rte_metrics_data_s *stats, int port_id,
+	struct rte_metric_value *values, uint64_t *stamps, uint16_t count)
+{
+	const struct rte_metrics_shard_value *shard_values;
+	struct rte_metrics_shard_s *shard;
+	unsigned int lcore_id;
+	uint16_t idx_name;
+	uint64_t stamp;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (!__atomic_load_n(&stats->shard_used[lcore_id],
+				__ATOMIC_ACQUIRE))
+			continue;
+		shard = metrics_shard_lookup(stats, lcore_id);
+		if (shard == NULL)
+			continue;
+		shard_values = shard->values[port_id == RTE_METRICS_GLOBAL ?
+			METRICS_SHARD_GLOBAL : port_id];
+		for (idx_name = 0; idx_name < count; idx_name++) {
+			stamp = __atomic_load_n(&shard_values[idx_name].stamp,
+				__ATOMIC_ACQUIRE);
+			if (stamp <= stamps[idx_name])
+				continue;
+			stamps[idx_name] = stamp;
+			values[idx_name].value = __atomic_load_n(
+				&shard_values[idx_name].value,
+				__ATOMIC_RELAXED);
+		}
+	}
+}
+
 int
 rte_metrics_get_values(int port_id,
 	struct rte_metric_value *values,
 	uint16_t capacity)
 {
+	uint64_t stamps[RTE_METRICS_MAX_METRICS];
 	struct rte_metrics_meta_s *entry;
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_name;
 	int return_value;
 
@@ -271,11 +505,10 @@ rte_metrics_get_values(int port_id,
 			(port_id < 0 || port_id >= RTE_MAX_ETHPORTS))
 		return -EINVAL;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_data_get();
+	if (stats == NULL)
 		return -EIO;
 
-	stats = memzone->addr;
 	rte_spinlock_lock(&stats->lock);
 
 	if (values != NULL) {
@@ -291,6 +524,7 @@ rte_metrics_get_values(int port_id,
 				entry = &stats->metadata[idx_name];
 				values[idx_name].key = idx_name;
 				values[idx_name].value = entry->global_value;
+				stamps[idx_name] = entry->global_stamp;
 			}
 		else
 			for (idx_name = 0;
@@ -299,9 +533,14 @@ rte_metrics_get_values(int port_id,
 				entry = &stats->metadata[idx_name];
 				values[idx_name].key = idx_name;
 				values[idx_name].value = entry->value[port_id];
+				stamps[idx_name] = entry->stamp[port_id];
 			}
 	}
 	return_value = stats->cnt_stats;
 	rte_spinlock_unlock(&stats->lock);
+
+	if (values != NULL && return_value <= capacity)
+		metrics_shards_merge(stats, port_id, values, stamps,
+			return_value);
 	return return_value;
 }
@@ -18,6 +18,10 @@
  * metric information by querying the central metric data, which is
  * held in shared memory. Currently only bulk querying of metrics
  * by consumers is supported.
+ *
+ * Each EAL lcore updates the metrics in its own shared memory area,
+ * without any lock, and consumers read the most recently updated value
+ * of each metric among those areas.
  */
 
 #ifndef _RTE_METRICS_H_
@@ -92,6 +96,10 @@ int rte_metrics_init(int socket_id);
  * a primary process after all the metrics usage is over, to
  *  release the shared memory.
  *
+ * Other processes must not use the metrics while it is called. Their
+ * metrics calls fail with -EIO afterwards, until rte_metrics_init()
+ * is called again.
+ *
  * @return
  *  -EINVAL - invalid parameter.
  *  -EIO: Error, unable to access metrics shared memory
@@ -215,6 +223,11 @@ int rte_metrics_update_value(
  * Updates a metric set. Note that it is an error to try to
  * update across a set boundary.
  *
+ * When called from an EAL lcore, the values are stored without any lock
+ * in memory dedicated to the lcore, reserved on its first update.
+ * Lcore ids of the processes updating metrics must not overlap.
+ * A consumer may read values of a set from consecutive updates.
+ *
  * @param port_id
  *   Port to update metrics for
  * @param key
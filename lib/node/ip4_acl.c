@@ -0,0 +1,333 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#include <rte_acl.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+
+#include "rte_node_ip4_api.h"
+
+#include "node_private.h"
+
+#define IP4_ACL_MAX_RULES 1024
+
+enum {
+	IP4_ACL_FIELD_PROTO,
+	IP4_ACL_FIELD_SRC,
+	IP4_ACL_FIELD_DST,
+	IP4_ACL_FIELD_SRCP,
+	IP4_ACL_FIELD_DSTP,
+	IP4_ACL_FIELD_MAX
+};
+
+/* Field offsets are relative to the IPv4 protocol field */
+static const struct rte_acl_field_def ip4_acl_defs[IP4_ACL_FIELD_MAX] = {
+	{
+		.type = RTE_ACL_FIELD_TYPE_BITMASK,
+		.size = sizeof(uint8_t),
+		.field_index = IP4_ACL_FIELD_PROTO,
+		.input_index = IP4_ACL_FIELD_PROTO,
+		.offset = 0,
+	},
+	{
+		.type = RTE_ACL_FIELD_TYPE_MASK,
+		.size = sizeof(uint32_t),
+		.field_index = IP4_ACL_FIELD_SRC,
+		.input_index = IP4_ACL_FIELD_SRC,
+		.offset = offsetof(struct rte_ipv4_hdr, src_addr) -
+			offsetof(struct rte_ipv4_hdr, next_proto_id),
+	},
+	{
+		.type = RTE_ACL_FIELD_TYPE_MASK,
+		.size = sizeof(uint32_t),
+		.field_index = IP4_ACL_FIELD_DST,
+		.input_index = IP4_ACL_FIELD_DST,
+		.offset = offsetof(struct rte_ipv4_hdr, dst_addr) -
+			offsetof(struct rte_ipv4_hdr, next_proto_id),
+	},
+	{
+		.type = RTE_ACL_FIELD_TYPE_RANGE,
+		.size = sizeof(uint16_t),
+		.field_index = IP4_ACL_FIELD_SRCP,
+		.input_index = IP4_ACL_FIELD_SRCP,
+		.offset = sizeof(struct rte_ipv4_hdr) -
+			offsetof(struct rte_ipv4_hdr, next_proto_id),
+	},
+	{
+		.type = RTE_ACL_FIELD_TYPE_RANGE,
+		.size = sizeof(uint16_t),
+		.field_index = IP4_ACL_FIELD_DSTP,
+		.input_index = IP4_ACL_FIELD_SRCP,
+		.offset = sizeof(struct rte_ipv4_hdr) -
+			offsetof(struct rte_ipv4_hdr, next_proto_id) +
+			sizeof(uint16_t),
+	},
+};
+
+RTE_ACL_RULE_DEF(ip4_acl_rule, IP4_ACL_FIELD_MAX);
+
+/* Classified bytes of a header without options, protocol to L4 ports */
+#define IP4_ACL_L3_LEN \
+	(sizeof(struct rte_ipv4_hdr) - offsetof(struct rte_ipv4_hdr, next_proto_id))
+#define IP4_ACL_TUPLE_LEN (IP4_ACL_L3_LEN + 2 * sizeof(uint16_t))
+
+/* IP4 ACL global data struct */
+struct ip4_acl_node_main {
+	struct rte_acl_ctx *acl_ctx[RTE_MAX_NUMA_NODES];
+	/* Set once the contexts hold a successfully built rule set */
+	bool built;
+};
+
+struct ip4_acl_node_ctx {
+	/* Socket's ACL context */
+	struct rte_acl_ctx *acl;
+};
+
+static struct ip4_acl_node_main ip4_acl_nm;
+
+#define IP4_ACL_NODE_CTX(ctx) \
+	(((struct ip4_acl_node_ctx *)ctx)->acl)
+
+static uint16_t
+ip4_acl_node_process(struct rte_graph *graph, struct rte_node *node,
+		     void **objs, uint16_t nb_objs)
+{
+	uint8_t tuples[RTE_GRAPH_BURST_SIZE][IP4_ACL_TUPLE_LEN];
+	const uint8_t *data[RTE_GRAPH_BURST_SIZE];
+	uint32_t results[RTE_GRAPH_BURST_SIZE];
+	struct rte_acl_ctx *acl = IP4_ACL_NODE_CTX(node->ctx);
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	rte_edge_t next_index;
+	uint16_t held = 0;
+	uint16_t i, j, n;
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP4_ACL_NEXT_LOOKUP;
+
+	/* No rule set yet, every packet goes to the speculated next */
+	if (unlikely(!ip4_acl_nm.built)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+
+	from = objs;
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+	for (i = 0; i < nb_objs; i += n) {
+		n = RTE_MIN(nb_objs - i, RTE_GRAPH_BURST_SIZE);
+
+		for (j = 0; j < n; j++) {
+			const struct rte_ipv4_hdr *ip;
+
+			ip = rte_pktmbuf_mtod_offset(
+				(struct rte_mbuf *)objs[i + j],
+				const struct rte_ipv4_hdr *,
+				sizeof(struct rte_ether_hdr));
+			data[j] = &ip->next_proto_id;
+			if (likely(ip->version_ihl == RTE_IPV4_VHL_DEF))
+				continue;
+
+			/* Rule offsets assume no options, move the L4 ports
+			 * right after the fixed header.
+			 */
+			memcpy(tuples[j], data[j], IP4_ACL_L3_LEN);
+			memcpy(tuples[j] + IP4_ACL_L3_LEN,
+			       (const uint8_t *)ip + rte_ipv4_hdr_len(ip),
+			       IP4_ACL_TUPLE_LEN - IP4_ACL_L3_LEN);
+			data[j] = tuples[j];
+		}
+
+		/* Classify the whole burst at once */
+		rte_acl_classify(acl, data, results, n, 1);
+
+		for (j = 0; j < n; j++) {
+			uint16_t next;
+
+			/* Userdata is next node + 1, zero means no match */
+			next = results[j] ? results[j] - 1 : next_index;
+			if (unlikely(next_index != next)) {
+				/* Copy things successfully speculated till now */
+				rte_memcpy(to_next, from,
+					   last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				rte_node_enqueue_x1(graph, node, next, from[0]);
+				from += 1;
+			} else {
+				last_spec += 1;
+			}
+		}
+	}
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+	held += last_spec;
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+static void
+ip4_acl_mask_set(struct rte_acl_field *field, uint32_t ip, uint8_t depth)
+{
+	field->value.u32 = depth ? ip & (UINT32_MAX << (32 - depth)) : 0;
+	field->mask_range.u32 = depth;
+}
+
+int
+rte_node_ip4_acl_rule_add(const struct rte_node_ip4_acl_rule *rule)
+{
+	struct ip4_acl_rule r;
+	uint8_t socket;
+	int ret;
+
+	if (rule == NULL || rule->src_depth > 32 || rule->dst_depth > 32 ||
+	    rule->src_port_min > rule->src_port_max ||
+	    rule->dst_port_min > rule->dst_port_max ||
+	    rule->next_node >= RTE_NODE_IP4_ACL_NEXT_MAX)
+		return -EINVAL;
+
+	memset(&r, 0, sizeof(r));
+	r.data.category_mask = 1;
+	r.data.priority = rule->priority;
+	/* Embed next node id into userdata, zero being reserved for no match */
+	r.data.userdata = rule->next_node + 1;
+
+	r.field[IP4_ACL_FIELD_PROTO].value.u8 = rule->proto;
+	r.field[IP4_ACL_FIELD_PROTO].mask_range.u8 = rule->proto_mask;
+	ip4_acl_mask_set(&r.field[IP4_ACL_FIELD_SRC], rule->src_ip,
+			 rule->src_depth);
+	ip4_acl_mask_set(&r.field[IP4_ACL_FIELD_DST], rule->dst_ip,
+			 rule->dst_depth);
+	r.field[IP4_ACL_FIELD_SRCP].value.u16 = rule->src_port_min;
+	r.field[IP4_ACL_FIELD_SRCP].mask_range.u16 = rule->src_port_max;
+	r.field[IP4_ACL_FIELD_DSTP].value.u16 = rule->dst_port_min;
+	r.field[IP4_ACL_FIELD_DSTP].mask_range.u16 = rule->dst_port_max;
+
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+		if (!ip4_acl_nm.acl_ctx[socket])
+			continue;
+
+		ret = rte_acl_add_rules(ip4_acl_nm.acl_ctx[socket],
+					(struct rte_acl_rule *)&r, 1);
+		if (ret < 0) {
+			node_err("acl_ip4",
+				 "Unable to add rule to ACL ctx on sock %d, rc=%d",
+				 socket, ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+int
+rte_node_ip4_acl_build(void)
+{
+	struct rte_acl_config cfg;
+	uint8_t socket;
+	int ret;
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.num_categories = 1;
+	cfg.num_fields = RTE_DIM(ip4_acl_defs);
+	memcpy(cfg.defs, ip4_acl_defs, sizeof(ip4_acl_defs));
+
+	ip4_acl_nm.built = false;
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+		if (!ip4_acl_nm.acl_ctx[socket])
+			continue;
+
+		ret = rte_acl_build(ip4_acl_nm.acl_ctx[socket], &cfg);
+		if (ret < 0) {
+			node_err("acl_ip4",
+				 "Unable to build ACL ctx on sock %d, rc=%d",
+				 socket, ret);
+			return ret;
+		}
+	}
+	ip4_acl_nm.built = true;
+
+	return 0;
+}
+
+static int
+setup_acl(struct ip4_acl_node_main *nm, int socket)
+{
+	struct rte_acl_param prm;
+	char s[RTE_ACL_NAMESIZE];
+
+	/* One ACL context per socket */
+	if (nm->acl_ctx[socket])
+		return 0;
+
+	snprintf(s, sizeof(s), "NODE_ACL_IP4_%d", socket);
+	prm.name = s;
+	prm.socket_id = socket;
+	prm.rule_size = RTE_ACL_RULE_SZ(RTE_DIM(ip4_acl_defs));
+	prm.max_rule_num = IP4_ACL_MAX_RULES;
+	nm->acl_ctx[socket] = rte_acl_create(&prm);
+	if (nm->acl_ctx[socket] == NULL)
+		return -rte_errno;
+
+	return 0;
+}
+
+static int
+ip4_acl_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	uint16_t socket, lcore_id;
+	static uint8_t init_once;
+	int rc;
+
+	RTE_BUILD_BUG_ON(sizeof(struct ip4_acl_node_ctx) > RTE_NODE_CTX_SZ);
+
+	if (!init_once) {
+		/* Setup ACL contexts for all sockets */
+		RTE_LCORE_FOREACH(lcore_id)
+		{
+			socket = rte_lcore_to_socket_id(lcore_id);
+			rc = setup_acl(&ip4_acl_nm, socket);
+			if (rc) {
+				node_err("acl_ip4",
+					 "Failed to setup ACL ctx for sock %u, rc=%d",
+					 socket, rc);
+				return rc;
+			}
+		}
+		init_once = 1;
+	}
+
+	/* Update socket's ACL context in node ctx */
+	IP4_ACL_NODE_CTX(node->ctx) = ip4_acl_nm.acl_ctx[graph->socket];
+
+	node_dbg("acl_ip4", "Initialized acl_ip4 node");
+
+	return 0;
+}
+
+static struct rte_node_register ip4_acl_node = {
+	.process = ip4_acl_node_process,
+	.name = "acl_ip4",
+
+	.init = ip4_acl_node_init,
+
+	.nb_edges = RTE_NODE_IP4_ACL_NEXT_MAX,
+	.next_nodes = {
+		[RTE_NODE_IP4_ACL_NEXT_LOOKUP] = "ip4_lookup",
+		[RTE_NODE_IP4_ACL_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(ip4_acl_node);
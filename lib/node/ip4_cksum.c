@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#include <netinet/in.h>
+
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+
+#include "rte_node_ip4_api.h"
+
+#include "node_private.h"
+
+/* Recompute the checksums not offloaded to the NIC, return the next edge */
+static __rte_always_inline uint16_t
+ip4_cksum_fixup(struct rte_mbuf *mbuf)
+{
+	const uint16_t l3_off = sizeof(struct rte_ether_hdr);
+	struct rte_ipv4_hdr *ip;
+	uint16_t l4_off, *cksum;
+	uint8_t *l4;
+
+	ip = rte_pktmbuf_mtod_offset(mbuf, struct rte_ipv4_hdr *, l3_off);
+
+	/* Packets whose TTL would reach zero when forwarded are dropped,
+	 * the decrement is done by the rewrite node.
+	 */
+	if (unlikely(ip->time_to_live <= 1))
+		return RTE_NODE_IP4_CKSUM_NEXT_PKT_DROP;
+
+	if (!(mbuf->ol_flags & RTE_MBUF_F_TX_IP_CKSUM)) {
+		ip->hdr_checksum = 0;
+		ip->hdr_checksum = rte_ipv4_cksum(ip);
+	}
+
+	if ((mbuf->ol_flags & RTE_MBUF_F_TX_L4_MASK) ||
+	    (ip->next_proto_id != IPPROTO_TCP &&
+	     ip->next_proto_id != IPPROTO_UDP) ||
+	    (ip->fragment_offset & rte_cpu_to_be_16(RTE_IPV4_HDR_MF_FLAG |
+						    RTE_IPV4_HDR_OFFSET_MASK)))
+		return RTE_NODE_IP4_CKSUM_NEXT_LOOKUP;
+
+	l4_off = l3_off + rte_ipv4_hdr_len(ip);
+	l4 = (uint8_t *)ip + rte_ipv4_hdr_len(ip);
+	if (ip->next_proto_id == IPPROTO_TCP)
+		cksum = &((struct rte_tcp_hdr *)l4)->cksum;
+	else
+		cksum = &((struct rte_udp_hdr *)l4)->dgram_cksum;
+
+	*cksum = 0;
+	if (likely(mbuf->nb_segs == 1))
+		*cksum = rte_ipv4_udptcp_cksum(ip, l4);
+	else
+		*cksum = rte_ipv4_udptcp_cksum_mbuf(mbuf, ip, l4_off);
+
+	return RTE_NODE_IP4_CKSUM_NEXT_LOOKUP;
+}
+
+static uint16_t
+ip4_cksum_node_process(struct rte_graph *graph, struct rte_node *node,
+		       void **objs, uint16_t nb_objs)
+{
+	struct rte_mbuf **pkts = (struct rte_mbuf **)objs;
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	rte_edge_t next_index;
+	uint16_t held = 0;
+	uint16_t next;
+	int i;
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP4_CKSUM_NEXT_LOOKUP;
+	from = objs;
+
+	for (i = 0; i < 4 && i < nb_objs; i++)
+		rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i], void *,
+					sizeof(struct rte_ether_hdr)));
+
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+	for (i = 0; i < nb_objs; i++) {
+		if (likely(i + 4 < nb_objs))
+			rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i + 4],
+					void *, sizeof(struct rte_ether_hdr)));
+
+		next = ip4_cksum_fixup(pkts[i]);
+		if (unlikely(next_index != next)) {
+			/* Copy things successfully speculated till now */
+			rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+			from += last_spec;
+			to_next += last_spec;
+			held += last_spec;
+			last_spec = 0;
+
+			rte_node_enqueue_x1(graph, node, next, from[0]);
+			from += 1;
+		} else {
+			last_spec += 1;
+		}
+	}
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+	held += last_spec;
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+static struct rte_node_register ip4_cksum_node = {
+	.process = ip4_cksum_node_process,
+	.name = "cksum_ip4",
+
+	.nb_edges = RTE_NODE_IP4_CKSUM_NEXT_MAX,
+	.next_nodes = {
+		[RTE_NODE_IP4_CKSUM_NEXT_LOOKUP] = "ip4_lookup",
+		[RTE_NODE_IP4_CKSUM_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(ip4_cksum_node);
@@ -7,6 +7,7 @@
 
 #include <rte_ethdev.h>
 #include <rte_ether.h>
+#include <rte_fib.h>
 #include <rte_graph.h>
 #include <rte_graph_worker.h>
 #include <rte_ip.h>
@@ -18,15 +19,29 @@
 
 #define IPV4_L3FWD_LPM_MAX_RULES 1024
 #define IPV4_L3FWD_LPM_NUMBER_TBL8S (1 << 8)
+/* Routes per FIB tbl8 group, when their number is not configured */
+#define IPV4_L3FWD_FIB_ROUTES_PER_TBL8 32
+#define IPV4_L3FWD_FIB_NAMESIZE 32
+
+/* FIB next hop layout, next node id above the 32-bit next hop id */
+#define IP4_LOOKUP_FIB_NEXT_SHIFT 32
 
 /* IP4 Lookup global data struct */
 struct ip4_lookup_node_main {
 	struct rte_lpm *lpm_tbl[RTE_MAX_NUMA_NODES];
+	struct rte_fib *fib_tbl[RTE_MAX_NUMA_NODES];
+	/* FIB mode configuration, used when fib_conf.max_routes != 0 */
+	struct rte_node_ip4_lookup_fib_conf fib_conf;
 };
 
 struct ip4_lookup_node_ctx {
-	/* Socket's LPM table */
-	struct rte_lpm *lpm;
+	RTE_STD_C11
+	union {
+		/* Socket's LPM table */
+		struct rte_lpm *lpm;
+		/* Socket's FIB table */
+		struct rte_fib *fib;
+	};
 	/* Dynamic offset to mbuf priv1 */
 	int mbuf_priv1_off;
 };
@@ -38,6 +53,9 @@ static struct ip4_lookup_node_main ip4_lookup_nm;
 #define IP4_LOOKUP_NODE_LPM(ctx) \
 	(((struct ip4_lookup_node_ctx *)ctx)->lpm)
 
+#define IP4_LOOKUP_NODE_FIB(ctx) \
+	(((struct ip4_lookup_node_ctx *)ctx)->fib)
+
 #define IP4_LOOKUP_NODE_PRIV1_OFF(ctx) \
 	(((struct ip4_lookup_node_ctx *)ctx)->mbuf_priv1_off)
 
@@ -118,6 +136,124 @@ ip4_lookup_node_process_scalar(struct rte_graph *graph, struct rte_node *node,
 	return nb_objs;
 }
 
+static uint16_t
+ip4_lookup_fib_node_process(struct rte_graph *graph, struct rte_node *node,
+			    void **objs, uint16_t nb_objs)
+{
+	struct rte_fib *fib = IP4_LOOKUP_NODE_FIB(node->ctx);
+	const int dyn = IP4_LOOKUP_NODE_PRIV1_OFF(node->ctx);
+	struct rte_mbuf **pkts = (struct rte_mbuf **)objs;
+	uint64_t next_hops[RTE_GRAPH_BURST_SIZE];
+	uint32_t ips[RTE_GRAPH_BURST_SIZE];
+	struct rte_ipv4_hdr *ipv4_hdr;
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	rte_edge_t next_index;
+	struct rte_mbuf *mbuf;
+	uint16_t held = 0;
+	uint16_t i, j, n;
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP4_LOOKUP_NEXT_REWRITE;
+	from = objs;
+
+	for (i = 0; i < 4 && i < nb_objs; i++)
+		rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i], void *,
+						sizeof(struct rte_ether_hdr)));
+
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+	for (i = 0; i < nb_objs; i += n) {
+		n = RTE_MIN(nb_objs - i, RTE_GRAPH_BURST_SIZE);
+
+		for (j = 0; j < n; j++) {
+			if (likely(i + j + 4 < nb_objs))
+				rte_prefetch0(rte_pktmbuf_mtod_offset(
+					pkts[i + j + 4], void *,
+					sizeof(struct rte_ether_hdr)));
+
+			mbuf = pkts[i + j];
+			/* Extract DIP of mbuf */
+			ipv4_hdr = rte_pktmbuf_mtod_offset(mbuf,
+					struct rte_ipv4_hdr *,
+					sizeof(struct rte_ether_hdr));
+			/* Extract cksum, ttl as ipv4 hdr is in cache */
+			node_mbuf_priv1(mbuf, dyn)->cksum =
+				ipv4_hdr->hdr_checksum;
+			node_mbuf_priv1(mbuf, dyn)->ttl =
+				ipv4_hdr->time_to_live;
+			ips[j] = rte_be_to_cpu_32(ipv4_hdr->dst_addr);
+		}
+
+		/* Bulk lookup, vectorized by FIB when the CPU allows */
+		rte_fib_lookup_bulk(fib, ips, next_hops, n);
+
+		for (j = 0; j < n; j++) {
+			uint16_t next;
+
+			mbuf = pkts[i + j];
+			node_mbuf_priv1(mbuf, dyn)->nh = (uint16_t)next_hops[j];
+			next = (uint16_t)(next_hops[j] >>
+					  IP4_LOOKUP_FIB_NEXT_SHIFT);
+
+			if (unlikely(next_index != next)) {
+				/* Copy things successfully speculated till now */
+				rte_memcpy(to_next, from,
+					   last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				rte_node_enqueue_x1(graph, node, next, from[0]);
+				from += 1;
+			} else {
+				last_spec += 1;
+			}
+		}
+	}
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+	held += last_spec;
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+static int
+ip4_fib_route_add(uint32_t ip, uint8_t depth, uint16_t next_hop,
+		  enum rte_node_ip4_lookup_next next_node, const char *abuf)
+{
+	uint8_t socket;
+	uint64_t val;
+	int ret;
+
+	val = ((uint64_t)next_node << IP4_LOOKUP_FIB_NEXT_SHIFT) | next_hop;
+	node_dbg("ip4_lookup", "FIB: Adding route %s / %d nh (0x%" PRIx64 ")",
+		 abuf, depth, val);
+
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+		if (!ip4_lookup_nm.fib_tbl[socket])
+			continue;
+
+		ret = rte_fib_add(ip4_lookup_nm.fib_tbl[socket], ip, depth,
+				  val);
+		if (ret < 0) {
+			node_err("ip4_lookup",
+				 "Unable to add entry %s / %d nh (%" PRIx64 ") to FIB table on sock %d, rc=%d\n",
+				 abuf, depth, val, socket, ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 int
 rte_node_ip4_route_add(uint32_t ip, uint8_t depth, uint16_t next_hop,
 		       enum rte_node_ip4_lookup_next next_node)
@@ -130,6 +266,9 @@ rte_node_ip4_route_add(uint32_t ip, uint8_t depth, uint16_t next_hop,
 
 	in.s_addr = htonl(ip);
 	inet_ntop(AF_INET, &in, abuf, sizeof(abuf));
+	if (ip4_lookup_nm.fib_conf.max_routes)
+		return ip4_fib_route_add(ip, depth, next_hop, next_node, abuf);
+
 	/* Embedded next node id into 24 bit next hop */
 	val = ((next_node << 16) | next_hop) & ((1ull << 24) - 1);
 	node_dbg("ip4_lookup", "LPM: Adding route %s / %d nh (0x%x)", abuf,
@@ -174,6 +313,56 @@ setup_lpm(struct ip4_lookup_node_main *nm, int socket)
 	return 0;
 }
 
+int
+rte_node_ip4_lookup_fib_config(const struct rte_node_ip4_lookup_fib_conf *conf)
+{
+	uint8_t socket;
+
+	if (conf == NULL || conf->max_routes == 0 || conf->max_routes > INT_MAX)
+		return -EINVAL;
+
+	/* Tables are created at node init, too late to switch */
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++)
+		if (ip4_lookup_nm.lpm_tbl[socket] ||
+		    ip4_lookup_nm.fib_tbl[socket])
+			return -EBUSY;
+
+	ip4_lookup_nm.fib_conf = *conf;
+
+	return 0;
+}
+
+static int
+setup_fib(struct ip4_lookup_node_main *nm, int socket)
+{
+	struct rte_fib_conf conf;
+	char s[IPV4_L3FWD_FIB_NAMESIZE];
+
+	/* One FIB table per socket */
+	if (nm->fib_tbl[socket])
+		return 0;
+
+	/* create the FIB table */
+	memset(&conf, 0, sizeof(conf));
+	conf.type = RTE_FIB_DIR24_8;
+	conf.default_nh = (uint64_t)RTE_NODE_IP4_LOOKUP_NEXT_PKT_DROP <<
+			  IP4_LOOKUP_FIB_NEXT_SHIFT;
+	conf.max_routes = nm->fib_conf.max_routes;
+	conf.dir24_8.nh_sz = RTE_FIB_DIR24_8_8B;
+	conf.dir24_8.num_tbl8 = nm->fib_conf.num_tbl8;
+	/* Routes longer than /24 take a tbl8 group, scale with the table */
+	if (conf.dir24_8.num_tbl8 == 0)
+		conf.dir24_8.num_tbl8 = RTE_MAX(
+			nm->fib_conf.max_routes / IPV4_L3FWD_FIB_ROUTES_PER_TBL8,
+			(uint32_t)IPV4_L3FWD_LPM_NUMBER_TBL8S);
+	snprintf(s, sizeof(s), "IPV4_L3FWD_FIB_%d", socket);
+	nm->fib_tbl[socket] = rte_fib_create(s, socket, &conf);
+	if (nm->fib_tbl[socket] == NULL)
+		return -rte_errno;
+
+	return 0;
+}
+
 static int
 ip4_lookup_node_init(const struct rte_graph *graph, struct rte_node *node)
 {
@@ -194,10 +383,13 @@ ip4_lookup_node_init(const struct rte_graph *graph, struct rte_node *node)
 		RTE_LCORE_FOREACH(lcore_id)
 		{
 			socket = rte_lcore_to_socket_id(lcore_id);
-			rc = setup_lpm(&ip4_lookup_nm, socket);
+			if (ip4_lookup_nm.fib_conf.max_routes)
+				rc = setup_fib(&ip4_lookup_nm, socket);
+			else
+				rc = setup_lpm(&ip4_lookup_nm, socket);
 			if (rc) {
 				node_err("ip4_lookup",
-					 "Failed to setup lpm tbl for sock %u, rc=%d",
+					 "Failed to setup lookup tbl for sock %u, rc=%d",
 					 socket, rc);
 				return rc;
 			}
@@ -205,6 +397,19 @@ ip4_lookup_node_init(const struct rte_graph *graph, struct rte_node *node)
 		init_once = 1;
 	}
 
+	if (ip4_lookup_nm.fib_conf.max_routes) {
+		/* Update socket's FIB and mbuf dyn priv1 offset in node ctx */
+		IP4_LOOKUP_NODE_FIB(node->ctx) =
+			ip4_lookup_nm.fib_tbl[graph->socket];
+		IP4_LOOKUP_NODE_PRIV1_OFF(node->ctx) =
+			node_mbuf_priv1_dynfield_offset;
+		node->process = ip4_lookup_fib_node_process;
+
+		node_dbg("ip4_lookup", "Initialized ip4_lookup node with FIB");
+
+		return 0;
+	}
+
 	/* Update socket's LPM and mbuf dyn priv1 offset in node ctx */
 	IP4_LOOKUP_NODE_LPM(node->ctx) = ip4_lookup_nm.lpm_tbl[graph->socket];
 	IP4_LOOKUP_NODE_PRIV1_OFF(node->ctx) = node_mbuf_priv1_dynfield_offset;
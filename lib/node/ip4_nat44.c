@@ -0,0 +1,568 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#include <netinet/in.h>
+
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_hash.h>
+#include <rte_hash_crc.h>
+#include <rte_ip.h>
+#include <rte_malloc.h>
+#include <rte_spinlock.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+
+#include "rte_node_ip4_api.h"
+
+#include "node_private.h"
+
+#define NAT44_BULK RTE_HASH_LOOKUP_BULK_MAX
+#define NAT44_PORT_ALLOC_TRIES 8
+#define NAT44_EXPIRE_SCAN 8
+
+enum nat44_dir {
+	NAT44_DIR_IN2OUT,
+	NAT44_DIR_OUT2IN,
+	NAT44_DIR_MAX,
+};
+
+/* Session key, all fields in network byte order */
+struct nat44_key {
+	uint32_t src_ip;
+	uint32_t dst_ip;
+	uint16_t src_port;
+	uint16_t dst_port;
+	uint8_t proto;
+	uint8_t pad[3];
+};
+
+/* Session, the data of both table entries */
+struct nat44_session {
+	/* The in2out key holds the internal address and port,
+	 * the out2in key the external port.
+	 */
+	struct nat44_key key[NAT44_DIR_MAX];
+	uint64_t last_seen;	/* Timer cycles of the last packet */
+	bool in_use;
+};
+
+/* NAT44 global data struct */
+struct nat44_node_main {
+	/* Session tables, both map to the session */
+	struct rte_hash *tbl[NAT44_DIR_MAX];
+	struct nat44_session *sessions;
+	uint32_t *free_idx;	/* Stack of free session indexes */
+	uint32_t nb_free;
+	uint32_t max_sessions;
+	uint32_t expire_next;	/* Expiry scan cursor */
+	uint64_t timeout;	/* Timer cycles, 0 for never */
+	/* Deleted sessions waiting for the readers to be done with them */
+	struct rte_rcu_qsbr_dq *dq;
+	/* Serializes session creation and deletion, lookups are lock-free */
+	rte_spinlock_t lock;
+	uint32_t ext_ip;	/* Network byte order */
+	uint16_t port_min;
+	uint16_t nb_ports;
+	uint32_t port_next;	/* Port allocation cursor */
+};
+
+static struct nat44_node_main nat44_nm;
+
+/* Incremental checksum update as per RFC 1624 */
+static __rte_always_inline uint16_t
+nat44_cksum_adjust16(uint16_t cksum, uint16_t old_val, uint16_t new_val)
+{
+	uint32_t sum;
+
+	sum = (uint16_t)~cksum + (uint16_t)~old_val + new_val;
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t)~sum;
+}
+
+static __rte_always_inline uint16_t
+nat44_cksum_adjust32(uint16_t cksum, uint32_t old_val, uint32_t new_val)
+{
+	cksum = nat44_cksum_adjust16(cksum, old_val >> 16, new_val >> 16);
+	return nat44_cksum_adjust16(cksum, old_val & 0xffff, new_val & 0xffff);
+}
+
+static __rte_always_inline int
+nat44_key_get(const struct rte_ipv4_hdr *ip, uint32_t ext_ip,
+	      struct nat44_key *key)
+{
+	const struct rte_udp_hdr *l4;
+
+	if (unlikely(ip->next_proto_id != IPPROTO_TCP &&
+		     ip->next_proto_id != IPPROTO_UDP))
+		return -1;
+
+	/* Only first fragments carry the ports */
+	if (unlikely(ip->fragment_offset &
+		     rte_cpu_to_be_16(RTE_IPV4_HDR_MF_FLAG |
+				      RTE_IPV4_HDR_OFFSET_MASK)))
+		return -1;
+
+	/* TCP and UDP ports are at the same offset */
+	l4 = (const struct rte_udp_hdr *)((const uint8_t *)ip +
+					  rte_ipv4_hdr_len(ip));
+	key->src_ip = ip->src_addr;
+	key->dst_ip = ip->dst_addr;
+	key->src_port = l4->src_port;
+	key->dst_port = l4->dst_port;
+	key->proto = ip->next_proto_id;
+	memset(key->pad, 0, sizeof(key->pad));
+
+	return ip->dst_addr == ext_ip ? NAT44_DIR_OUT2IN : NAT44_DIR_IN2OUT;
+}
+
+static __rte_always_inline void
+nat44_translate(struct rte_ipv4_hdr *ip, uint32_t *addr, uint16_t *port,
+		uint32_t new_ip, uint16_t new_port)
+{
+	uint8_t *l4 = (uint8_t *)ip + rte_ipv4_hdr_len(ip);
+	uint16_t *cksum;
+
+	ip->hdr_checksum = nat44_cksum_adjust32(ip->hdr_checksum, *addr,
+						new_ip);
+	if (ip->next_proto_id == IPPROTO_TCP)
+		cksum = &((struct rte_tcp_hdr *)l4)->cksum;
+	else
+		cksum = &((struct rte_udp_hdr *)l4)->dgram_cksum;
+
+	/* Zero UDP checksum means no checksum */
+	if (ip->next_proto_id == IPPROTO_TCP || *cksum != 0) {
+		*cksum = nat44_cksum_adjust32(*cksum, *addr, new_ip);
+		*cksum = nat44_cksum_adjust16(*cksum, *port, new_port);
+		if (ip->next_proto_id == IPPROTO_UDP && *cksum == 0)
+			*cksum = 0xffff;
+	}
+
+	*addr = new_ip;
+	*port = new_port;
+}
+
+static __rte_always_inline void
+nat44_translate_in2out(struct rte_ipv4_hdr *ip,
+		       const struct nat44_session *s)
+{
+	struct rte_udp_hdr *l4;
+
+	l4 = (struct rte_udp_hdr *)((uint8_t *)ip + rte_ipv4_hdr_len(ip));
+	nat44_translate(ip, &ip->src_addr, &l4->src_port, nat44_nm.ext_ip,
+			s->key[NAT44_DIR_OUT2IN].dst_port);
+}
+
+static __rte_always_inline void
+nat44_translate_out2in(struct rte_ipv4_hdr *ip,
+		       const struct nat44_session *s)
+{
+	struct rte_udp_hdr *l4;
+
+	l4 = (struct rte_udp_hdr *)((uint8_t *)ip + rte_ipv4_hdr_len(ip));
+	nat44_translate(ip, &ip->dst_addr, &l4->dst_port,
+			s->key[NAT44_DIR_IN2OUT].src_ip,
+			s->key[NAT44_DIR_IN2OUT].src_port);
+}
+
+/* Return a session to the free stack, called with the lock held */
+static void
+nat44_session_put(uint32_t idx)
+{
+	nat44_nm.free_idx[nat44_nm.nb_free++] = idx;
+}
+
+static void
+nat44_session_free(void *p, void *e, unsigned int n)
+{
+	RTE_SET_USED(p);
+	RTE_SET_USED(n);
+
+	nat44_session_put(*(uint32_t *)e);
+}
+
+/* Delete a session from the tables, called with the lock held */
+static void
+nat44_session_delete(struct nat44_session *s, bool in2out)
+{
+	uint32_t idx = s - nat44_nm.sessions;
+	int32_t pos;
+	int dir;
+
+	s->in_use = false;
+
+	for (dir = in2out ? NAT44_DIR_IN2OUT : NAT44_DIR_OUT2IN;
+	     dir < NAT44_DIR_MAX; dir++) {
+		pos = rte_hash_del_key(nat44_nm.tbl[dir], &s->key[dir]);
+		/* With RCU, tables free the entry after the grace period */
+		if (nat44_nm.dq == NULL && pos >= 0)
+			rte_hash_free_key_with_position(nat44_nm.tbl[dir], pos);
+	}
+
+	/* Without RCU, sessions are only deleted when their creation fails,
+	 * right after being published.
+	 */
+	if (nat44_nm.dq == NULL)
+		nat44_session_put(idx);
+	else if (rte_rcu_qsbr_dq_enqueue(nat44_nm.dq, &idx) != 0)
+		node_err("nat44", "Failed to defer session %u free", idx);
+}
+
+/* Slow path, create both directions of a new session */
+static struct nat44_session *
+nat44_session_create(const struct nat44_key *key, uint64_t now)
+{
+	struct rte_hash *in2out = nat44_nm.tbl[NAT44_DIR_IN2OUT];
+	struct rte_hash *out2in = nat44_nm.tbl[NAT44_DIR_OUT2IN];
+	struct nat44_session *s = NULL;
+	struct nat44_key *okey;
+	void *data;
+	uint16_t port;
+	int i;
+
+	rte_spinlock_lock(&nat44_nm.lock);
+
+	/* Another packet of the flow, in the same burst or on another
+	 * worker, may have created the session since the lookup.
+	 */
+	if (rte_hash_lookup_data(in2out, key, &data) >= 0) {
+		s = data;
+		goto unlock;
+	}
+	if (nat44_nm.nb_free == 0 && nat44_nm.dq != NULL)
+		rte_rcu_qsbr_dq_reclaim(nat44_nm.dq, nat44_nm.max_sessions,
+					NULL, NULL, NULL);
+	if (nat44_nm.nb_free == 0)
+		goto unlock;
+
+	s = &nat44_nm.sessions[nat44_nm.free_idx[--nat44_nm.nb_free]];
+	s->key[NAT44_DIR_IN2OUT] = *key;
+	okey = &s->key[NAT44_DIR_OUT2IN];
+	okey->src_ip = key->dst_ip;
+	okey->dst_ip = nat44_nm.ext_ip;
+	okey->src_port = key->dst_port;
+	okey->proto = key->proto;
+	memset(okey->pad, 0, sizeof(okey->pad));
+	s->last_seen = now;
+
+	for (i = 0; i < NAT44_PORT_ALLOC_TRIES; i++) {
+		port = nat44_nm.port_min +
+		       nat44_nm.port_next++ % nat44_nm.nb_ports;
+		okey->dst_port = rte_cpu_to_be_16(port);
+
+		/* Port already used towards this remote end */
+		if (rte_hash_lookup(out2in, okey) >= 0)
+			continue;
+
+		if (rte_hash_add_key_data(out2in, okey, s) < 0)
+			break;
+
+		if (rte_hash_add_key_data(in2out, key, s) < 0) {
+			nat44_session_delete(s, false);
+			s = NULL;
+			goto unlock;
+		}
+
+		s->in_use = true;
+		goto unlock;
+	}
+
+	nat44_session_put(s - nat44_nm.sessions);
+	s = NULL;
+unlock:
+	rte_spinlock_unlock(&nat44_nm.lock);
+	return s;
+}
+
+/* Delete a few sessions idle for longer than the timeout */
+static void
+nat44_sessions_expire(uint64_t now)
+{
+	struct nat44_session *s;
+	int i;
+
+	/* Another worker is already at it */
+	if (!rte_spinlock_trylock(&nat44_nm.lock))
+		return;
+
+	for (i = 0; i < NAT44_EXPIRE_SCAN; i++) {
+		s = &nat44_nm.sessions[nat44_nm.expire_next];
+		if (++nat44_nm.expire_next == nat44_nm.max_sessions)
+			nat44_nm.expire_next = 0;
+
+		if (s->in_use &&
+		    __atomic_load_n(&s->last_seen, __ATOMIC_RELAXED) +
+		    nat44_nm.timeout < now)
+			nat44_session_delete(s, true);
+	}
+
+	rte_spinlock_unlock(&nat44_nm.lock);
+}
+
+static uint16_t
+nat44_node_process(struct rte_graph *graph, struct rte_node *node,
+		   void **objs, uint16_t nb_objs)
+{
+	const void *keys_ptr[NAT44_DIR_MAX][NAT44_BULK];
+	uint16_t idx[NAT44_DIR_MAX][NAT44_BULK];
+	struct rte_ipv4_hdr *ips[NAT44_BULK];
+	struct nat44_key keys[NAT44_BULK];
+	uint16_t nexts[NAT44_BULK];
+	void *data[NAT44_BULK];
+	uint16_t cnt[NAT44_DIR_MAX];
+	const uint32_t ext_ip = nat44_nm.ext_ip;
+	struct nat44_session *s;
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	rte_edge_t next_index;
+	uint16_t held = 0;
+	uint16_t i, j, k, n;
+	uint64_t hits, now;
+	int dir;
+
+	/* Sessions are stamped with the time of the burst */
+	now = nat44_nm.timeout ? rte_get_timer_cycles() : 0;
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP4_NAT44_NEXT_LOOKUP;
+	from = objs;
+
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+	for (i = 0; i < nb_objs; i += n) {
+		n = RTE_MIN(nb_objs - i, NAT44_BULK);
+
+		/* Extract the session keys and sort them per direction */
+		cnt[NAT44_DIR_IN2OUT] = 0;
+		cnt[NAT44_DIR_OUT2IN] = 0;
+		for (j = 0; j < n; j++) {
+			ips[j] = rte_pktmbuf_mtod_offset(
+				(struct rte_mbuf *)objs[i + j],
+				struct rte_ipv4_hdr *,
+				sizeof(struct rte_ether_hdr));
+			dir = nat44_key_get(ips[j], ext_ip, &keys[j]);
+			if (unlikely(dir < 0)) {
+				nexts[j] = RTE_NODE_IP4_NAT44_NEXT_PKT_DROP;
+				continue;
+			}
+			nexts[j] = next_index;
+			keys_ptr[dir][cnt[dir]] = &keys[j];
+			idx[dir][cnt[dir]++] = j;
+		}
+
+		/* Lock-free bulk lookup of both directions */
+		for (dir = 0; dir < NAT44_DIR_MAX; dir++) {
+			if (cnt[dir] == 0)
+				continue;
+
+			hits = 0;
+			rte_hash_lookup_bulk_data(nat44_nm.tbl[dir],
+						  keys_ptr[dir], cnt[dir],
+						  &hits, data);
+			for (k = 0; k < cnt[dir]; k++) {
+				j = idx[dir][k];
+				s = likely(hits & (1ULL << k)) ? data[k] : NULL;
+				if (unlikely(s == NULL) &&
+				    dir == NAT44_DIR_IN2OUT)
+					s = nat44_session_create(&keys[j], now);
+				if (unlikely(s == NULL)) {
+					nexts[j] =
+						RTE_NODE_IP4_NAT44_NEXT_PKT_DROP;
+					continue;
+				}
+
+				__atomic_store_n(&s->last_seen, now,
+						 __ATOMIC_RELAXED);
+				if (dir == NAT44_DIR_OUT2IN)
+					nat44_translate_out2in(ips[j], s);
+				else
+					nat44_translate_in2out(ips[j], s);
+			}
+		}
+
+		for (j = 0; j < n; j++) {
+			if (unlikely(next_index != nexts[j])) {
+				/* Copy things successfully speculated till now */
+				rte_memcpy(to_next, from,
+					   last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				rte_node_enqueue_x1(graph, node, nexts[j],
+						    from[0]);
+				from += 1;
+			} else {
+				last_spec += 1;
+			}
+		}
+	}
+
+	if (nat44_nm.timeout)
+		nat44_sessions_expire(now);
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+	held += last_spec;
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+static void
+nat44_free(void)
+{
+	int dir;
+
+	for (dir = 0; dir < NAT44_DIR_MAX; dir++) {
+		rte_hash_free(nat44_nm.tbl[dir]);
+		nat44_nm.tbl[dir] = NULL;
+	}
+	rte_rcu_qsbr_dq_delete(nat44_nm.dq);
+	nat44_nm.dq = NULL;
+	rte_free(nat44_nm.sessions);
+	nat44_nm.sessions = NULL;
+	rte_free(nat44_nm.free_idx);
+	nat44_nm.free_idx = NULL;
+}
+
+int
+rte_node_ip4_nat44_config(const struct rte_node_ip4_nat44_conf *conf)
+{
+	struct rte_rcu_qsbr_dq_parameters dq_prm;
+	struct rte_hash_rcu_config rcu_cfg;
+	struct rte_hash_parameters prm;
+	char s[RTE_HASH_NAMESIZE];
+	uint32_t i;
+	int dir;
+
+	if (conf == NULL || conf->port_min > conf->port_max ||
+	    conf->port_min == 0 || conf->max_sessions == 0 ||
+	    (conf->timeout != 0 && conf->qsv == NULL))
+		return -EINVAL;
+
+	/* Session tables are shared by all the graphs */
+	if (nat44_nm.tbl[NAT44_DIR_IN2OUT] != NULL)
+		return -EEXIST;
+
+	nat44_nm.sessions = rte_zmalloc("nat44_sessions",
+			conf->max_sessions * sizeof(struct nat44_session),
+			RTE_CACHE_LINE_SIZE);
+	nat44_nm.free_idx = rte_malloc("nat44_free_idx",
+			conf->max_sessions * sizeof(uint32_t), 0);
+	if (nat44_nm.sessions == NULL || nat44_nm.free_idx == NULL) {
+		node_err("nat44", "Failed to allocate %u sessions",
+			 conf->max_sessions);
+		nat44_free();
+		return -ENOMEM;
+	}
+	/* Hand out the first sessions first */
+	for (i = 0; i < conf->max_sessions; i++)
+		nat44_nm.free_idx[i] = conf->max_sessions - 1 - i;
+	nat44_nm.nb_free = conf->max_sessions;
+	nat44_nm.max_sessions = conf->max_sessions;
+	nat44_nm.expire_next = 0;
+
+	memset(&prm, 0, sizeof(prm));
+	prm.entries = conf->max_sessions;
+	prm.key_len = sizeof(struct nat44_key);
+	prm.hash_func = rte_hash_crc;
+	prm.socket_id = SOCKET_ID_ANY;
+	/* Readers are lock-free, writers are serialized by the session lock,
+	 * extendable buckets make room for all the sessions.
+	 */
+	prm.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF |
+			 RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+
+	memset(&rcu_cfg, 0, sizeof(rcu_cfg));
+	rcu_cfg.v = conf->qsv;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_DQ;
+
+	for (dir = 0; dir < NAT44_DIR_MAX; dir++) {
+		snprintf(s, sizeof(s), "NODE_NAT44_%s",
+			 dir == NAT44_DIR_IN2OUT ? "IN2OUT" : "OUT2IN");
+		prm.name = s;
+		nat44_nm.tbl[dir] = rte_hash_create(&prm);
+		if (nat44_nm.tbl[dir] == NULL) {
+			node_err("nat44", "Failed to create %s table, rc=%d",
+				 s, rte_errno);
+			nat44_free();
+			return -rte_errno;
+		}
+
+		if (conf->qsv != NULL &&
+		    rte_hash_rcu_qsbr_add(nat44_nm.tbl[dir], &rcu_cfg)) {
+			node_err("nat44", "Failed to attach RCU to %s, rc=%d",
+				 s, rte_errno);
+			nat44_free();
+			return -rte_errno;
+		}
+	}
+
+	if (conf->qsv != NULL) {
+		memset(&dq_prm, 0, sizeof(dq_prm));
+		dq_prm.name = "NODE_NAT44";
+		dq_prm.size = conf->max_sessions;
+		dq_prm.esize = sizeof(uint32_t);
+		dq_prm.max_reclaim_size = NAT44_EXPIRE_SCAN;
+		dq_prm.free_fn = nat44_session_free;
+		dq_prm.v = conf->qsv;
+		nat44_nm.dq = rte_rcu_qsbr_dq_create(&dq_prm);
+		if (nat44_nm.dq == NULL) {
+			node_err("nat44", "Failed to create defer queue, rc=%d",
+				 rte_errno);
+			nat44_free();
+			return -rte_errno;
+		}
+	}
+
+	rte_spinlock_init(&nat44_nm.lock);
+	nat44_nm.timeout = (uint64_t)conf->timeout * rte_get_timer_hz();
+	nat44_nm.ext_ip = rte_cpu_to_be_32(conf->ext_ip);
+	nat44_nm.port_min = conf->port_min;
+	nat44_nm.nb_ports = conf->port_max - conf->port_min + 1;
+	nat44_nm.port_next = 0;
+
+	return 0;
+}
+
+static int
+nat44_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+
+	if (nat44_nm.tbl[NAT44_DIR_IN2OUT] == NULL) {
+		node_err("nat44", "NAT44 is not configured");
+		return -EINVAL;
+	}
+
+	node_dbg("nat44", "Initialized nat44 node");
+
+	return 0;
+}
+
+static struct rte_node_register nat44_node = {
+	.process = nat44_node_process,
+	.name = "nat44",
+
+	.init = nat44_node_init,
+
+	.nb_edges = RTE_NODE_IP4_NAT44_NEXT_MAX,
+	.next_nodes = {
+		[RTE_NODE_IP4_NAT44_NEXT_LOOKUP] = "ip4_lookup",
+		[RTE_NODE_IP4_NAT44_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(nat44_node);
@@ -7,6 +7,7 @@
 
 #include <rte_ethdev.h>
 #include <rte_ether.h>
+#include <rte_fib6.h>
 #include <rte_graph.h>
 #include <rte_graph_worker.h>
 #include <rte_ip.h>
@@ -18,15 +19,34 @@
 
 #define IPV6_L3FWD_LPM_MAX_RULES 1024
 #define IPV6_L3FWD_LPM_NUMBER_TBL8S (1 << 8)
+/*
+ * Prefix length the FIB tbl8 groups are sized for, when their number is
+ * not configured: /64, the usual length of IPv6 subnets.
+ */
+#define IPV6_L3FWD_FIB_DEPTH 64
+/* First 24 bits of the address are resolved by the trie tbl24 */
+#define IPV6_L3FWD_FIB_TBL24_DEPTH 24
+#define IPV6_L3FWD_FIB_NAMESIZE 32
+
+/* FIB next hop layout, next node id above the 32-bit next hop id */
+#define IP6_LOOKUP_FIB_NEXT_SHIFT 32
 
 /* IP6 Lookup global data struct */
 struct ip6_lookup_node_main {
 	struct rte_lpm6 *lpm_tbl[RTE_MAX_NUMA_NODES];
+	struct rte_fib6 *fib_tbl[RTE_MAX_NUMA_NODES];
+	/* FIB mode configuration, used when fib_conf.max_routes != 0 */
+	struct rte_node_ip6_lookup_fib_conf fib_conf;
 };
 
 struct ip6_lookup_node_ctx {
-	/* Socket's LPM table */
-	struct rte_lpm6 *lpm6;
+	RTE_STD_C11
+	union {
+		/* Socket's LPM table */
+		struct rte_lpm6 *lpm6;
+		/* Socket's FIB table */
+		struct rte_fib6 *fib6;
+	};
 	/* Dynamic offset to mbuf priv1 */
 	int mbuf_priv1_off;
 };
@@ -36,6 +56,9 @@ static struct ip6_lookup_node_main ip6_lookup_nm;
 #define IP6_LOOKUP_NODE_LPM(ctx) \
 	(((struct ip6_lookup_node_ctx *)ctx)->lpm6)
 
+#define IP6_LOOKUP_NODE_FIB(ctx) \
+	(((struct ip6_lookup_node_ctx *)ctx)->fib6)
+
 #define IP6_LOOKUP_NODE_PRIV1_OFF(ctx) \
 	(((struct ip6_lookup_node_ctx *)ctx)->mbuf_priv1_off)
 
@@ -257,6 +280,123 @@ ip6_lookup_node_process_scalar(struct rte_graph *graph, struct rte_node *node,
 	return nb_objs;
 }
 
+static uint16_t
+ip6_lookup_fib_node_process(struct rte_graph *graph, struct rte_node *node,
+			    void **objs, uint16_t nb_objs)
+{
+	struct rte_fib6 *fib6 = IP6_LOOKUP_NODE_FIB(node->ctx);
+	const int dyn = IP6_LOOKUP_NODE_PRIV1_OFF(node->ctx);
+	struct rte_mbuf **pkts = (struct rte_mbuf **)objs;
+	uint8_t ips[RTE_GRAPH_BURST_SIZE][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t next_hops[RTE_GRAPH_BURST_SIZE];
+	struct rte_ipv6_hdr *ipv6_hdr;
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	rte_edge_t next_index;
+	struct rte_mbuf *mbuf;
+	uint16_t held = 0;
+	uint16_t i, j, n;
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP6_LOOKUP_NEXT_REWRITE;
+	from = objs;
+
+	for (i = 0; i < 4 && i < nb_objs; i++)
+		rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i], void *,
+						sizeof(struct rte_ether_hdr)));
+
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+	for (i = 0; i < nb_objs; i += n) {
+		n = RTE_MIN(nb_objs - i, RTE_GRAPH_BURST_SIZE);
+
+		for (j = 0; j < n; j++) {
+			if (likely(i + j + 4 < nb_objs))
+				rte_prefetch0(rte_pktmbuf_mtod_offset(
+					pkts[i + j + 4], void *,
+					sizeof(struct rte_ether_hdr)));
+
+			mbuf = pkts[i + j];
+			/* Extract DIP of mbuf */
+			ipv6_hdr = rte_pktmbuf_mtod_offset(mbuf,
+					struct rte_ipv6_hdr *,
+					sizeof(struct rte_ether_hdr));
+			/* Extract hop_limits as ipv6 hdr is in cache */
+			node_mbuf_priv1(mbuf, dyn)->ttl = ipv6_hdr->hop_limits;
+			rte_memcpy(ips[j], ipv6_hdr->dst_addr,
+				   RTE_FIB6_IPV6_ADDR_SIZE);
+		}
+
+		/* Bulk lookup, vectorized by FIB when the CPU allows */
+		rte_fib6_lookup_bulk(fib6, ips, next_hops, n);
+
+		for (j = 0; j < n; j++) {
+			uint16_t next;
+
+			mbuf = pkts[i + j];
+			node_mbuf_priv1(mbuf, dyn)->nh = (uint16_t)next_hops[j];
+			next = (uint16_t)(next_hops[j] >>
+					  IP6_LOOKUP_FIB_NEXT_SHIFT);
+
+			if (unlikely(next_index != next)) {
+				/* Copy things successfully speculated till now */
+				rte_memcpy(to_next, from,
+					   last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				rte_node_enqueue_x1(graph, node, next, from[0]);
+				from += 1;
+			} else {
+				last_spec += 1;
+			}
+		}
+	}
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+	held += last_spec;
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+static int
+ip6_fib_route_add(const uint8_t *ip, uint8_t depth, uint16_t next_hop,
+		  enum rte_node_ip6_lookup_next next_node, const char *abuf)
+{
+	uint8_t socket;
+	uint64_t val;
+	int ret;
+
+	val = ((uint64_t)next_node << IP6_LOOKUP_FIB_NEXT_SHIFT) | next_hop;
+	node_dbg("ip6_lookup", "FIB: Adding route %s / %d nh (0x%" PRIx64 ")",
+		 abuf, depth, val);
+
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+		if (!ip6_lookup_nm.fib_tbl[socket])
+			continue;
+
+		ret = rte_fib6_add(ip6_lookup_nm.fib_tbl[socket], ip, depth,
+				   val);
+		if (ret < 0) {
+			node_err("ip6_lookup",
+				 "Unable to add entry %s / %d nh (%" PRIx64 ") to FIB "
+				 "table on sock %d, rc=%d\n",
+				 abuf, depth, val, socket, ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 int
 rte_node_ip6_route_add(const uint8_t *ip, uint8_t depth, uint16_t next_hop,
 		       enum rte_node_ip6_lookup_next next_node)
@@ -269,6 +409,9 @@ rte_node_ip6_route_add(const uint8_t *ip, uint8_t depth, uint16_t next_hop,
 
 	memcpy(in6.s6_addr, ip, RTE_LPM6_IPV6_ADDR_SIZE);
 	inet_ntop(AF_INET6, &in6, abuf, sizeof(abuf));
+	if (ip6_lookup_nm.fib_conf.max_routes)
+		return ip6_fib_route_add(ip, depth, next_hop, next_node, abuf);
+
 	/* Embedded next node id into 24 bit next hop */
 	val = ((next_node << 16) | next_hop) & ((1ull << 24) - 1);
 	node_dbg("ip6_lookup", "LPM: Adding route %s / %d nh (0x%x)", abuf,
@@ -314,6 +457,61 @@ setup_lpm6(struct ip6_lookup_node_main *nm, int socket)
 	return 0;
 }
 
+int
+rte_node_ip6_lookup_fib_config(const struct rte_node_ip6_lookup_fib_conf *conf)
+{
+	uint8_t socket;
+
+	if (conf == NULL || conf->max_routes == 0 || conf->max_routes > INT_MAX)
+		return -EINVAL;
+
+	/* Tables are created at node init, too late to switch */
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++)
+		if (ip6_lookup_nm.lpm_tbl[socket] ||
+		    ip6_lookup_nm.fib_tbl[socket])
+			return -EBUSY;
+
+	ip6_lookup_nm.fib_conf = *conf;
+
+	return 0;
+}
+
+static int
+setup_fib6(struct ip6_lookup_node_main *nm, int socket)
+{
+	struct rte_fib6_conf conf;
+	char s[IPV6_L3FWD_FIB_NAMESIZE];
+
+	/* One FIB table per socket */
+	if (nm->fib_tbl[socket])
+		return 0;
+
+	/* create the FIB table */
+	memset(&conf, 0, sizeof(conf));
+	conf.type = RTE_FIB6_TRIE;
+	conf.default_nh = (uint64_t)RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP <<
+			  IP6_LOOKUP_FIB_NEXT_SHIFT;
+	conf.max_routes = nm->fib_conf.max_routes;
+	conf.trie.nh_sz = RTE_FIB6_TRIE_8B;
+	conf.trie.num_tbl8 = nm->fib_conf.num_tbl8;
+	/*
+	 * Each byte of prefix beyond the tbl24 takes one more tbl8 group,
+	 * which routes share only with the routes of the same prefix up to
+	 * that byte: in the worst case, a /64 route takes 5 groups of its own.
+	 */
+	if (conf.trie.num_tbl8 == 0)
+		conf.trie.num_tbl8 = RTE_MAX(nm->fib_conf.max_routes *
+			((IPV6_L3FWD_FIB_DEPTH - IPV6_L3FWD_FIB_TBL24_DEPTH) /
+			 8),
+			(uint32_t)IPV6_L3FWD_LPM_NUMBER_TBL8S);
+	snprintf(s, sizeof(s), "IPV6_L3FWD_FIB_%d", socket);
+	nm->fib_tbl[socket] = rte_fib6_create(s, socket, &conf);
+	if (nm->fib_tbl[socket] == NULL)
+		return -rte_errno;
+
+	return 0;
+}
+
 static int
 ip6_lookup_node_init(const struct rte_graph *graph, struct rte_node *node)
 {
@@ -335,10 +533,13 @@ ip6_lookup_node_init(const struct rte_graph *graph, struct rte_node *node)
 		RTE_LCORE_FOREACH(lcore_id)
 		{
 			socket = rte_lcore_to_socket_id(lcore_id);
-			rc = setup_lpm6(&ip6_lookup_nm, socket);
+			if (ip6_lookup_nm.fib_conf.max_routes)
+				rc = setup_fib6(&ip6_lookup_nm, socket);
+			else
+				rc = setup_lpm6(&ip6_lookup_nm, socket);
 			if (rc) {
 				node_err("ip6_lookup",
-					 "Failed to setup lpm6 tbl for "
+					 "Failed to setup lookup tbl for "
 					 "sock %u, rc=%d", socket, rc);
 				return rc;
 			}
@@ -346,6 +547,19 @@ ip6_lookup_node_init(const struct rte_graph *graph, struct rte_node *node)
 		init_once = 1;
 	}
 
+	if (ip6_lookup_nm.fib_conf.max_routes) {
+		/* Update socket's FIB and mbuf dyn priv1 offset in node ctx */
+		IP6_LOOKUP_NODE_FIB(node->ctx) =
+			ip6_lookup_nm.fib_tbl[graph->socket];
+		IP6_LOOKUP_NODE_PRIV1_OFF(node->ctx) =
+			node_mbuf_priv1_dynfield_offset;
+		node->process = ip6_lookup_fib_node_process;
+
+		node_dbg("ip6_lookup", "Initialized ip6_lookup node with FIB");
+
+		return 0;
+	}
+
 	/* Update socket's LPM and mbuf dyn priv1 offset in node ctx */
 	IP6_LOOKUP_NODE_LPM(node->ctx) = ip6_lookup_nm.lpm_tbl[graph->socket];
 	IP6_LOOKUP_NODE_PRIV1_OFF(node->ctx) =
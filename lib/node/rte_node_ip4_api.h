@@ -13,7 +13,8 @@
  * All functions in this file may be changed or removed without prior notice.
  *
  * This API allows to do control path functions of ip4_* nodes
- * like ip4_lookup, ip4_rewrite.
+ * like ip4_lookup, ip4_rewrite, and of the IPv4 service nodes
+ * acl_ip4, nat44 and cksum_ip4.
  */
 #ifdef __cplusplus
 extern "C" {
@@ -21,6 +22,7 @@ extern "C" {
 
 #include <rte_common.h>
 #include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 /**
  * IP4 lookup next nodes.
@@ -53,6 +55,34 @@ __rte_experimental
 int rte_node_ip4_route_add(uint32_t ip, uint8_t depth, uint16_t next_hop,
 			   enum rte_node_ip4_lookup_next next_node);
 
+/**
+ * IP4 lookup node FIB configuration.
+ *
+ * @see rte_node_ip4_lookup_fib_config()
+ */
+struct rte_node_ip4_lookup_fib_conf {
+	uint32_t max_routes;	/**< Maximum number of routes. */
+	uint32_t num_tbl8;
+	/**< Number of tbl8 groups, 0 for a default derived from max_routes. */
+};
+
+/**
+ * Make the ip4_lookup node use a DIR24_8 FIB instead of LPM.
+ *
+ * Routes are stored with 8-byte next hops holding the next node and the
+ * next hop id, resolved by bulk lookups using AVX512 when available.
+ * Must be called before creating a graph containing the ip4_lookup node.
+ *
+ * @param conf
+ *   FIB configuration.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip4_lookup_fib_config(
+		const struct rte_node_ip4_lookup_fib_conf *conf);
+
 /**
  * Add a next hop's rewrite data.
  *
@@ -72,6 +102,132 @@ __rte_experimental
 int rte_node_ip4_rewrite_add(uint16_t next_hop, uint8_t *rewrite_data,
 			     uint8_t rewrite_len, uint16_t dst_port);
 
+/**
+ * IP4 ACL next nodes.
+ */
+enum rte_node_ip4_acl_next {
+	RTE_NODE_IP4_ACL_NEXT_LOOKUP,
+	/**< IP4 lookup node, also used for packets matching no rule. */
+	RTE_NODE_IP4_ACL_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+	RTE_NODE_IP4_ACL_NEXT_MAX,
+	/**< Number of next nodes of ACL node. */
+};
+
+/**
+ * IP4 ACL rule, all fields are in host byte order.
+ *
+ * @see rte_node_ip4_acl_rule_add()
+ */
+struct rte_node_ip4_acl_rule {
+	uint32_t src_ip;	/**< Source IP address. */
+	uint32_t dst_ip;	/**< Destination IP address. */
+	uint8_t src_depth;	/**< Source IP prefix length, 0 to 32. */
+	uint8_t dst_depth;	/**< Destination IP prefix length, 0 to 32. */
+	uint8_t proto;		/**< IP protocol. */
+	uint8_t proto_mask;	/**< IP protocol mask, 0 matches any. */
+	uint16_t src_port_min;	/**< First matching L4 source port. */
+	uint16_t src_port_max;	/**< Last matching L4 source port. */
+	uint16_t dst_port_min;	/**< First matching L4 destination port. */
+	uint16_t dst_port_max;	/**< Last matching L4 destination port. */
+	int32_t priority;	/**< Rule priority, the highest one wins. */
+	enum rte_node_ip4_acl_next next_node;
+	/**< Next node to redirect matching traffic to. */
+};
+
+/**
+ * Add a rule to the ACL node tables.
+ *
+ * Rules only take effect after rte_node_ip4_acl_build() is called.
+ *
+ * @param rule
+ *   Rule to be added.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip4_acl_rule_add(const struct rte_node_ip4_acl_rule *rule);
+
+/**
+ * Build the ACL node tables from the rules added so far.
+ *
+ * The tables are shared by all the graphs of a socket, so the build
+ * must not run while any graph containing the acl_ip4 node is walked.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip4_acl_build(void);
+
+/**
+ * IP4 NAT44 next nodes.
+ */
+enum rte_node_ip4_nat44_next {
+	RTE_NODE_IP4_NAT44_NEXT_LOOKUP,
+	/**< IP4 lookup node. */
+	RTE_NODE_IP4_NAT44_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+	RTE_NODE_IP4_NAT44_NEXT_MAX,
+	/**< Number of next nodes of NAT44 node. */
+};
+
+/**
+ * NAT44 configuration, all fields are in host byte order.
+ *
+ * @see rte_node_ip4_nat44_config()
+ */
+struct rte_node_ip4_nat44_conf {
+	uint32_t ext_ip;	/**< External IP address sessions are mapped to. */
+	uint16_t port_min;	/**< First external port to allocate. */
+	uint16_t port_max;	/**< Last external port to allocate. */
+	uint32_t max_sessions;	/**< Maximum number of sessions. */
+	uint32_t timeout;
+	/**< Idle time in seconds after which a session expires, 0 for never. */
+	struct rte_rcu_qsbr *qsv;
+	/**< RCU QSBR variable the workers walking the graphs report their
+	 * quiescent state on, required to expire sessions.
+	 */
+};
+
+/**
+ * Configure the NAT44 node.
+ *
+ * TCP and UDP packets not destined to the external address get their
+ * source address and port translated, a session being created on the
+ * first packet of a flow. Packets destined to the external address are
+ * translated back using the session tables, others are dropped.
+ *
+ * When a timeout is set, the nat44 node deletes the sessions idle for
+ * longer, a few of them per burst. The memory of a deleted session is
+ * reused only once all the threads registered on the RCU QSBR variable
+ * reported a quiescent state, e.g. with rte_rcu_qsbr_quiescent() after
+ * each rte_graph_walk().
+ *
+ * Must be called once before creating a graph containing the nat44 node.
+ *
+ * @param conf
+ *   NAT44 configuration.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip4_nat44_config(const struct rte_node_ip4_nat44_conf *conf);
+
+/**
+ * IP4 checksum next nodes.
+ */
+enum rte_node_ip4_cksum_next {
+	RTE_NODE_IP4_CKSUM_NEXT_LOOKUP,
+	/**< IP4 lookup node. */
+	RTE_NODE_IP4_CKSUM_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+	RTE_NODE_IP4_CKSUM_NEXT_MAX,
+	/**< Number of next nodes of checksum node. */
+};
+
 #ifdef __cplusplus
 }
 #endif
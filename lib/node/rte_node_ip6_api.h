@@ -13,7 +13,8 @@
  * All functions in this file may be changed or removed without prior notice.
  *
  * This API allows to do control path functions of ip6_* nodes
- * like ip6_lookup, ip6_rewrite.
+ * like ip6_lookup, ip6_rewrite, and of the IPv6 service nodes
+ * acl_ip6 and cksum_ip6.
  */
 #ifdef __cplusplus
 extern "C" {
@@ -53,6 +54,38 @@ __rte_experimental
 int rte_node_ip6_route_add(const uint8_t *ip, uint8_t depth, uint16_t next_hop,
 			   enum rte_node_ip6_lookup_next next_node);
 
+/**
+ * IP6 lookup node FIB configuration.
+ *
+ * @see rte_node_ip6_lookup_fib_config()
+ */
+struct rte_node_ip6_lookup_fib_conf {
+	uint32_t max_routes;	/**< Maximum number of routes. */
+	uint32_t num_tbl8;
+	/**< Number of tbl8 groups, 0 for a default derived from max_routes.
+	 * Each byte of prefix beyond the first 24 bits takes a tbl8 group,
+	 * the default is sized for routes up to /64, i.e. 5 groups per route.
+	 * Set it explicitly for longer routes, up to 13 groups per /128 route.
+	 */
+};
+
+/**
+ * Make the ip6_lookup node use a TRIE FIB instead of LPM.
+ *
+ * Routes are stored with 8-byte next hops holding the next node and the
+ * next hop id, resolved by bulk lookups using AVX512 when available.
+ * Must be called before creating a graph containing the ip6_lookup node.
+ *
+ * @param conf
+ *   FIB configuration.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_lookup_fib_config(
+		const struct rte_node_ip6_lookup_fib_conf *conf);
+
 /**
  * Add a next hop's rewrite data.
  *
@@ -72,6 +105,78 @@ __rte_experimental
 int rte_node_ip6_rewrite_add(uint16_t next_hop, uint8_t *rewrite_data,
 			     uint8_t rewrite_len, uint16_t dst_port);
 
+/**
+ * IP6 ACL next nodes.
+ */
+enum rte_node_ip6_acl_next {
+	RTE_NODE_IP6_ACL_NEXT_LOOKUP,
+	/**< IP6 lookup node, also used for packets matching no rule. */
+	RTE_NODE_IP6_ACL_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+	RTE_NODE_IP6_ACL_NEXT_MAX,
+	/**< Number of next nodes of ACL node. */
+};
+
+/**
+ * IP6 ACL rule, addresses are in network byte order,
+ * other fields in host byte order.
+ *
+ * @see rte_node_ip6_acl_rule_add()
+ */
+struct rte_node_ip6_acl_rule {
+	uint8_t src_ip[16];	/**< Source IPv6 address. */
+	uint8_t dst_ip[16];	/**< Destination IPv6 address. */
+	uint8_t src_depth;	/**< Source IP prefix length, 0 to 128. */
+	uint8_t dst_depth;	/**< Destination IP prefix length, 0 to 128. */
+	uint8_t proto;		/**< Next header protocol. */
+	uint8_t proto_mask;	/**< Next header protocol mask, 0 matches any. */
+	uint16_t src_port_min;	/**< First matching L4 source port. */
+	uint16_t src_port_max;	/**< Last matching L4 source port. */
+	uint16_t dst_port_min;	/**< First matching L4 destination port. */
+	uint16_t dst_port_max;	/**< Last matching L4 destination port. */
+	int32_t priority;	/**< Rule priority, the highest one wins. */
+	enum rte_node_ip6_acl_next next_node;
+	/**< Next node to redirect matching traffic to. */
+};
+
+/**
+ * Add a rule to the ACL node tables.
+ *
+ * Rules only take effect after rte_node_ip6_acl_build() is called.
+ *
+ * @param rule
+ *   Rule to be added.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_acl_rule_add(const struct rte_node_ip6_acl_rule *rule);
+
+/**
+ * Build the ACL node tables from the rules added so far.
+ *
+ * The tables are shared by all the graphs of a socket, so the build
+ * must not run while any graph containing the acl_ip6 node is walked.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_acl_build(void);
+
+/**
+ * IP6 checksum next nodes.
+ */
+enum rte_node_ip6_cksum_next {
+	RTE_NODE_IP6_CKSUM_NEXT_LOOKUP,
+	/**< IP6 lookup node. */
+	RTE_NODE_IP6_CKSUM_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+	RTE_NODE_IP6_CKSUM_NEXT_MAX,
+	/**< Number of next nodes of checksum node. */
+};
+
 #ifdef __cplusplus
 }
 #endif
@@ -478,6 +478,20 @@ pcapng_vlan_insert(struct rte_mbuf *m, uint16_t ether_type, uint16_t tci)
 	return 0;
 }
 
+/* Enhanced packet block flags for a packet direction */
+static uint32_t
+pcapng_direction_flags(enum rte_pcapng_direction direction)
+{
+	switch (direction) {
+	case RTE_PCAPNG_DIRECTION_IN:
+		return PCAPNG_IFB_INBOUND;
+	case RTE_PCAPNG_DIRECTION_OUT:
+		return PCAPNG_IFB_OUTBOUND;
+	default:
+		return 0;
+	}
+}
+
 /*
  *   The mbufs created use the Pcapng standard enhanced packet  block.
  *
@@ -592,16 +606,7 @@ rte_pcapng_copy(uint16_t port_id, uint32_t queue,
 	if (unlikely(opt == NULL))
 		goto fail;
 
-	switch (direction) {
-	case RTE_PCAPNG_DIRECTION_IN:
-		flags = PCAPNG_IFB_INBOUND;
-		break;
-	case RTE_PCAPNG_DIRECTION_OUT:
-		flags = PCAPNG_IFB_OUTBOUND;
-		break;
-	default:
-		flags = 0;
-	}
+	flags = pcapng_direction_flags(direction);
 
 	opt = pcapng_add_option(opt, PCAPNG_EPB_FLAGS,
 				&flags, sizeof(flags));
@@ -656,6 +661,119 @@ fail:
 	return NULL;
 }
 
+uint32_t
+rte_pcapng_block_size(uint32_t length)
+{
+	/* Same layout as rte_pcapng_copy() without the VLAN header. */
+	return sizeof(struct pcapng_enhance_packet_block)
+		+ RTE_ALIGN(length, sizeof(uint32_t))
+		+ pcapng_optlen(sizeof(uint32_t)) /* flag option */
+		+ pcapng_optlen(sizeof(uint32_t)) /* queue option */
+		+ sizeof(uint32_t);		  /*  length */
+}
+
+/* Format the first bytes of an mbuf as a pcapng block in place */
+uint32_t
+rte_pcapng_block_fill(void *buf, uint16_t port_id, uint32_t queue,
+		      const struct rte_mbuf *m, uint32_t length,
+		      uint64_t cycles, enum rte_pcapng_direction direction)
+{
+	struct pcapng_enhance_packet_block *epb = buf;
+	uint32_t orig_len, data_len, padding, flags;
+	struct pcapng_option *opt;
+	const void *src;
+	uint8_t *data;
+	uint64_t ns;
+
+	ns = pcapng_tsc_to_ns(cycles);
+
+	orig_len = rte_pktmbuf_pkt_len(m);
+	data_len = RTE_MIN(orig_len, length);
+
+	/* Segmented packets are gathered directly into the block */
+	data = (uint8_t *)(epb + 1);
+	src = rte_pktmbuf_read(m, 0, data_len, data);
+	if (src != data)
+		rte_memcpy(data, src, data_len);
+
+	/* pad the packet to 32 bit boundary */
+	padding = RTE_ALIGN(data_len, sizeof(uint32_t)) - data_len;
+	memset(data + data_len, 0, padding);
+
+	flags = pcapng_direction_flags(direction);
+
+	opt = (struct pcapng_option *)(data + data_len + padding);
+	opt = pcapng_add_option(opt, PCAPNG_EPB_FLAGS,
+				&flags, sizeof(flags));
+	opt = pcapng_add_option(opt, PCAPNG_EPB_QUEUE,
+				&queue, sizeof(queue));
+
+	epb->block_type = PCAPNG_ENHANCED_PACKET_BLOCK;
+	epb->block_length = (uint8_t *)opt + sizeof(uint32_t) - (uint8_t *)buf;
+
+	/* Port id is mapped to the interface index during write */
+	epb->interface_id = port_id;
+
+	epb->timestamp_hi = ns >> 32;
+	epb->timestamp_lo = (uint32_t)ns;
+	epb->capture_length = data_len;
+	epb->original_length = orig_len;
+
+	/* set trailer of block length */
+	*(uint32_t *)opt = epb->block_length;
+
+	return epb->block_length;
+}
+
+/* Write blocks formatted by rte_pcapng_block_fill() to file. */
+ssize_t
+rte_pcapng_write_blocks(rte_pcapng_t *self,
+			void * const blocks[], uint16_t nb_blocks)
+{
+	struct iovec iov[IOV_MAX];
+	unsigned int i, cnt = 0;
+	ssize_t ret, total = 0;
+
+	for (i = 0; i < nb_blocks; i++) {
+		struct pcapng_enhance_packet_block *epb = blocks[i];
+		uint32_t port_id = epb->interface_id;
+
+		if (unlikely(epb->block_type != PCAPNG_ENHANCED_PACKET_BLOCK ||
+			     port_id >= RTE_MAX_ETHPORTS)) {
+			rte_errno = EINVAL;
+			return -1;
+		}
+
+		/* check that this interface was added. */
+		epb->interface_id = self->port_index[port_id];
+		if (unlikely(epb->interface_id > RTE_MAX_ETHPORTS)) {
+			rte_errno = EINVAL;
+			return -1;
+		}
+
+		if (unlikely(cnt == IOV_MAX)) {
+			ret = writev(self->outfd, iov, cnt);
+			if (unlikely(ret < 0)) {
+				rte_errno = errno;
+				return -1;
+			}
+			total += ret;
+			cnt = 0;
+		}
+
+		iov[cnt].iov_base = epb;
+		iov[cnt].iov_len = epb->block_length;
+		++cnt;
+	}
+
+	ret = writev(self->outfd, iov, cnt);
+	if (unlikely(ret < 0)) {
+		rte_errno = errno;
+		return -1;
+	}
+	return total + ret;
+}
+
 /* Write pre-formatted packets to file. */
 ssize_t
 rte_pcapng_write_packets(rte_pcapng_t *self,
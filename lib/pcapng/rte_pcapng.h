@@ -179,6 +179,72 @@ ssize_t
 rte_pcapng_write_packets(rte_pcapng_t *self,
 			 struct rte_mbuf *pkts[], uint16_t nb_pkts);
 
+/**
+ * Determine the buffer size needed by rte_pcapng_block_fill().
+ *
+ * @param length
+ *   The largest packet that will be formatted.
+ * @return
+ *   The number of bytes of the largest block, always a multiple of 4.
+ */
+__rte_experimental
+uint32_t
+rte_pcapng_block_size(uint32_t length);
+
+/**
+ * Format a packet as a pcapng block into a caller provided buffer.
+ *
+ * Unlike rte_pcapng_copy(), no mbuf is allocated: the first *length* bytes
+ * of the packet are written, with the pcapng header and options, into *buf*,
+ * which may for example be an element of a ring. Offloaded VLAN tags are
+ * not reinserted into the packet data.
+ *
+ * @param buf
+ *   The destination buffer, of at least rte_pcapng_block_size(length) bytes
+ *   and aligned on 4 bytes.
+ * @param port_id
+ *   The Ethernet port on which packet was received
+ *   or is going to be transmitted.
+ * @param queue
+ *   The queue on the Ethernet port where packet was received
+ *   or is going to be transmitted.
+ * @param m
+ *   The packet to format.
+ * @param length
+ *   The upper limit on bytes to copy.
+ * @param timestamp
+ *   The timestamp in TSC cycles.
+ * @param direction
+ *   The direction of the packet: receive, transmit or unknown.
+ * @return
+ *   The length of the block written in *buf*.
+ */
+__rte_experimental
+uint32_t
+rte_pcapng_block_fill(void *buf, uint16_t port_id, uint32_t queue,
+		      const struct rte_mbuf *m, uint32_t length,
+		      uint64_t timestamp, enum rte_pcapng_direction direction);
+
+/**
+ * Write blocks formatted by rte_pcapng_block_fill() to the capture file.
+ *
+ * The blocks are written with as few system calls as possible, directly
+ * from their buffers. Their interface field is updated in place.
+ *
+ * @param self
+ *  The handle to the packet capture file
+ * @param blocks
+ *  The address of an array of *nb_blocks* pointers to formatted blocks.
+ * @param nb_blocks
+ *  The number of blocks to write to the file.
+ * @return
+ *  The number of bytes written to file, -1 on failure to write file.
+ */
+__rte_experimental
+ssize_t
+rte_pcapng_write_blocks(rte_pcapng_t *self,
+			void * const blocks[], uint16_t nb_blocks);
+
 /**
  * Write an Interface statistics block.
  * For statistics, use 0 if don't know or care to report it.
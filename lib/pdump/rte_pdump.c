@@ -2,16 +2,22 @@
  * Copyright(c) 2016-2018 Intel Corporation
  */
 
+#include <ctype.h>
 #include <stdlib.h>
 
 #include <rte_mbuf.h>
 #include <rte_ethdev.h>
+#include <rte_ip.h>
 #include <rte_lcore.h>
 #include <rte_log.h>
+#include <rte_malloc.h>
 #include <rte_memzone.h>
 #include <rte_errno.h>
+#include <rte_pause.h>
+#include <rte_spinlock.h>
 #include <rte_string_fns.h>
 #include <rte_pcapng.h>
+#include <rte_telemetry.h>
 
 #include "rte_pdump.h"
 
@@ -25,6 +31,13 @@ RTE_LOG_REGISTER_DEFAULT(pdump_logtype, NOTICE);
 /* Used for the multi-process communication */
 #define PDUMP_MP	"mp_pdump"
 
+/* Largest trigger window, in packets per queue */
+#define PDUMP_WINDOW_MAX	(1u << 16)
+/* Number of port drop counters polls per second in trigger mode */
+#define PDUMP_DROPS_POLL_HZ	100
+/* Packets written to the ring at once when dumping a window */
+#define PDUMP_DUMP_BURST	32
+
 enum pdump_operation {
 	DISABLE = 1,
 	ENABLE = 2
@@ -34,6 +47,7 @@ enum pdump_operation {
 enum pdump_version {
 	V1 = 1,		    /* no filtering or snap */
 	V2 = 2,
+	V3 = 3,		    /* pcapng blocks written in the ring */
 };
 
 struct pdump_request {
@@ -47,6 +61,8 @@ struct pdump_request {
 
 	const struct rte_bpf_prm *prm;
 	uint32_t snaplen;
+	struct rte_pdump_sample sample;
+	uint32_t esize;
 };
 
 struct pdump_response {
@@ -55,6 +71,22 @@ struct pdump_response {
 	int32_t err_value;
 };
 
+/*
+ * Trigger mode keeps references to the last packets of a queue,
+ * overwriting the oldest one, until a trigger condition fires.
+ */
+struct pdump_window {
+	uint32_t size;
+	uint32_t head;		/* next slot to be written */
+	uint32_t count;		/* number of valid slots */
+	uint64_t trigger_seen;	/* last manual trigger handled */
+	uint64_t drops;		/* port drops last seen */
+	struct {
+		struct rte_mbuf *m;
+		uint64_t ts;
+	} slots[];
+};
+
 static struct pdump_rxtx_cbs {
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
@@ -62,10 +94,26 @@ static struct pdump_rxtx_cbs {
 	const struct rte_bpf *filter;
 	enum pdump_version ver;
 	uint32_t snaplen;
+	uint32_t esize;
+	struct rte_pdump_sample sample;
+	uint32_t sample_cnt;	/* packets since the last one sampled */
+	uint32_t flow_limit;	/* flow hash below which flows are sampled */
+	struct pdump_window *win;
+	uint32_t use;		/* odd while the callback runs */
 } rx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT],
 tx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 
 
+/*
+ * Port drop counters shared by the trigger windows of all queues of a port,
+ * polled by one queue at a time.
+ */
+static struct pdump_port_drops {
+	rte_spinlock_t lock;
+	uint64_t next_poll;	/* TSC of next poll */
+	uint64_t drops;		/* port drops at last poll */
+} __rte_cache_aligned port_drops[RTE_MAX_ETHPORTS];
+
 /*
  * The packet capture statistics keep track of packets
  * accepted, filtered and dropped. These are per-queue
@@ -75,14 +123,149 @@ static const char MZ_RTE_PDUMP_STATS[] = "rte_pdump_stats";
 static struct {
 	struct rte_pdump_stats rx[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 	struct rte_pdump_stats tx[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
+	uint64_t trigger[RTE_MAX_ETHPORTS]; /* manual trigger generation */
 	const struct rte_memzone *mz;
 } *pdump_stats;
 
-/* Create a clone of mbuf to be placed into ring. */
+/* Hash the addresses and ports of packets without RSS hash */
+static uint32_t
+pdump_flow_key(const struct rte_mbuf *m)
+{
+	const struct rte_ether_hdr *eh;
+	const struct rte_ipv4_hdr *ip4;
+	const struct rte_ipv6_hdr *ip6;
+	const uint32_t *w;
+	uint32_t h = 0, off;
+	uint8_t proto;
+	unsigned int i;
+
+	off = sizeof(*eh);
+	if (rte_pktmbuf_data_len(m) < off + sizeof(*ip6) + sizeof(uint32_t))
+		return 0;
+
+	eh = rte_pktmbuf_mtod(m, const struct rte_ether_hdr *);
+	if (eh->ether_type == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4)) {
+		ip4 = rte_pktmbuf_mtod_offset(m, const struct rte_ipv4_hdr *,
+					      off);
+		h = ip4->src_addr ^ rte_bswap32(ip4->dst_addr);
+		proto = ip4->next_proto_id;
+		if (ip4->fragment_offset & rte_cpu_to_be_16(
+				RTE_IPV4_HDR_MF_FLAG | RTE_IPV4_HDR_OFFSET_MASK))
+			proto = 0;
+		off += rte_ipv4_hdr_len(ip4);
+	} else if (eh->ether_type == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6)) {
+		ip6 = rte_pktmbuf_mtod_offset(m, const struct rte_ipv6_hdr *,
+					      off);
+		w = (const uint32_t *)ip6->src_addr;
+		for (i = 0; i < 8; i++)
+			h = (h << 5 | h >> 27) ^ w[i];
+		proto = ip6->proto;
+		off += sizeof(*ip6);
+	} else {
+		w = (const uint32_t *)eh;
+		return w[0] ^ w[1] ^ w[2];
+	}
+
+	/* source and destination ports */
+	if ((proto == IPPROTO_TCP || proto == IPPROTO_UDP) &&
+	    rte_pktmbuf_data_len(m) >= off + sizeof(uint32_t))
+		h ^= *rte_pktmbuf_mtod_offset(m, const unaligned_uint32_t *,
+					      off);
+
+	return h ^ proto;
+}
+
+static inline uint32_t
+pdump_flow_hash(const struct rte_mbuf *m)
+{
+	uint32_t h;
+
+	if (m->ol_flags & RTE_MBUF_F_RX_RSS_HASH)
+		h = m->hash.rss;
+	else
+		h = pdump_flow_key(m);
+
+	/* Mix, as the low bits of the RSS hash are the same on a queue */
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+/* Select the sampled packets in out[], return their number. */
+static uint16_t
+pdump_sample(struct pdump_rxtx_cbs *cbs,
+	     struct rte_mbuf **pkts, uint16_t nb_pkts,
+	     struct rte_mbuf **out)
+{
+	uint32_t rate = cbs->sample.rate;
+	uint32_t i;
+	uint16_t n = 0;
+
+	if (cbs->sample.mode == RTE_PDUMP_SAMPLE_COUNT) {
+		/* go straight to the packets completing a count of rate */
+		for (i = rate - 1 - cbs->sample_cnt; i < nb_pkts; i += rate)
+			out[n++] = pkts[i];
+		cbs->sample_cnt = (cbs->sample_cnt + nb_pkts) % rate;
+	} else {
+		for (i = 0; i < nb_pkts; i++)
+			if (pdump_flow_hash(pkts[i]) < cbs->flow_limit)
+				out[n++] = pkts[i];
+	}
+
+	return n;
+}
+
+/* Run the filter over a burst, natively compiled if available */
+static inline void
+pdump_filter_exec(const struct rte_bpf *filter, struct rte_mbuf **pkts,
+		  uint64_t *rcs, uint16_t nb_pkts)
+{
+	struct rte_bpf_jit_burst jit;
+
+	if (rte_bpf_get_jit_burst(filter, &jit) == 0 && jit.func != NULL)
+		jit.func((void **)pkts, rcs, nb_pkts);
+	else
+		rte_bpf_exec_burst(filter, (void **)pkts, rcs, nb_pkts);
+}
+
+/*
+ * Keep the packets matching the filter in out[], which can be pkts,
+ * return their number.
+ * This uses same BPF return value convention as socket filter
+ * and pcap_offline_filter: if program returns zero
+ * then packet doesn't match the filter (will be ignored).
+ */
+static uint16_t
+pdump_filter(const struct rte_bpf *filter,
+	     struct rte_mbuf **pkts, uint16_t nb_pkts,
+	     struct rte_mbuf **out,
+	     struct rte_pdump_stats *stats)
+{
+	uint64_t rcs[nb_pkts];
+	uint16_t i, n = 0;
+
+	pdump_filter_exec(filter, pkts, rcs, nb_pkts);
+	for (i = 0; i < nb_pkts; i++)
+		if (rcs[i] != 0)
+			out[n++] = pkts[i];
+
+	if (n < nb_pkts)
+		__atomic_fetch_add(&stats->filtered, nb_pkts - n,
+				   __ATOMIC_RELAXED);
+	return n;
+}
+
+/*
+ * Create a clone of mbuf to be placed into ring.
+ * Packets are timestamped now, unless their timestamps are given in tss.
+ */
 static void
 pdump_copy(uint16_t port_id, uint16_t queue,
 	   enum rte_pcapng_direction direction,
-	   struct rte_mbuf **pkts, uint16_t nb_pkts,
+	   struct rte_mbuf **pkts, const uint64_t *tss, uint16_t nb_pkts,
 	   const struct pdump_rxtx_cbs *cbs,
 	   struct rte_pdump_stats *stats)
 {
@@ -94,27 +277,11 @@ pdump_copy(uint16_t port_id, uint16_t queue,
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
 	struct rte_mbuf *p;
-	uint64_t rcs[nb_pkts];
-
-	if (cbs->filter)
-		rte_bpf_exec_burst(cbs->filter, (void **)pkts, rcs, nb_pkts);
 
 	ts = rte_get_tsc_cycles();
 	ring = cbs->ring;
 	mp = cbs->mp;
 	for (i = 0; i < nb_pkts; i++) {
-		/*
-		 * This uses same BPF return value convention as socket filter
-		 * and pcap_offline_filter.
-		 * if program returns zero
-		 * then packet doesn't match the filter (will be ignored).
-		 */
-		if (cbs->filter && rcs[i] == 0) {
-			__atomic_fetch_add(&stats->filtered,
-					   1, __ATOMIC_RELAXED);
-			continue;
-		}
-
 		/*
 		 * If using pcapng then want to wrap packets
 		 * otherwise a simple copy.
@@ -122,7 +289,7 @@ pdump_copy(uint16_t port_id, uint16_t queue,
 		if (cbs->ver == V2)
 			p = rte_pcapng_copy(port_id, queue,
 					    pkts[i], mp, cbs->snaplen,
-					    ts, direction, NULL);
+					    tss ? tss[i] : ts, direction, NULL);
 		else
 			p = rte_pktmbuf_copy(pkts[i], mp, 0, cbs->snaplen);
 
@@ -143,16 +310,264 @@ pdump_copy(uint16_t port_id, uint16_t queue,
 	}
 }
 
+/*
+ * Format packets as pcapng blocks directly in the ring elements.
+ * Packets are timestamped now, unless their timestamps are given in tss.
+ */
+static void
+pdump_block(uint16_t port_id, uint16_t queue,
+	    enum rte_pcapng_direction direction,
+	    struct rte_mbuf **pkts, const uint64_t *tss, uint16_t nb_pkts,
+	    const struct pdump_rxtx_cbs *cbs,
+	    struct rte_pdump_stats *stats)
+{
+	struct rte_ring_zc_data zcd;
+	uint16_t i, n;
+	uint64_t ts;
+	void *buf;
+
+	__atomic_fetch_add(&stats->accepted, nb_pkts, __ATOMIC_RELAXED);
+
+	/* Only the snapshot of each packet is copied, into ring memory */
+	n = rte_ring_enqueue_zc_burst_elem_start(cbs->ring, cbs->esize,
+						 nb_pkts, &zcd, NULL);
+	ts = rte_get_tsc_cycles();
+	for (i = 0; i < n; i++) {
+		if (i < zcd.n1)
+			buf = RTE_PTR_ADD(zcd.ptr1, i * cbs->esize);
+		else
+			buf = RTE_PTR_ADD(zcd.ptr2, (i - zcd.n1) * cbs->esize);
+
+		rte_pcapng_block_fill(buf, port_id, queue, pkts[i],
+				      cbs->snaplen, tss ? tss[i] : ts,
+				      direction);
+	}
+	rte_ring_enqueue_zc_elem_finish(cbs->ring, n);
+
+	if (unlikely(n < nb_pkts))
+		__atomic_fetch_add(&stats->ringfull, nb_pkts - n,
+				   __ATOMIC_RELAXED);
+}
+
+static void
+pdump_output(uint16_t port_id, uint16_t queue,
+	     enum rte_pcapng_direction direction,
+	     struct rte_mbuf **pkts, const uint64_t *tss, uint16_t nb_pkts,
+	     const struct pdump_rxtx_cbs *cbs,
+	     struct rte_pdump_stats *stats)
+{
+	if (cbs->ver == V3)
+		pdump_block(port_id, queue, direction, pkts, tss, nb_pkts,
+			    cbs, stats);
+	else
+		pdump_copy(port_id, queue, direction, pkts, tss, nb_pkts,
+			   cbs, stats);
+}
+
+/* Write the trigger window to the ring, oldest packet first, and empty it */
+static void
+pdump_window_dump(uint16_t port_id, uint16_t queue,
+		  enum rte_pcapng_direction direction,
+		  const struct pdump_rxtx_cbs *cbs,
+		  struct pdump_window *win,
+		  struct rte_pdump_stats *stats)
+{
+	struct rte_mbuf *pkts[PDUMP_DUMP_BURST];
+	uint64_t tss[PDUMP_DUMP_BURST];
+	uint32_t idx, n;
+
+	idx = (win->head + win->size - win->count) % win->size;
+	while (win->count > 0) {
+		for (n = 0; n < PDUMP_DUMP_BURST && win->count > 0; n++) {
+			pkts[n] = win->slots[idx].m;
+			tss[n] = win->slots[idx].ts;
+			win->slots[idx].m = NULL;
+			idx = (idx + 1 == win->size) ? 0 : idx + 1;
+			win->count--;
+		}
+
+		pdump_output(port_id, queue, direction, pkts, tss, n,
+			     cbs, stats);
+		rte_pktmbuf_free_bulk(pkts, n);
+	}
+
+	__atomic_fetch_add(&stats->triggers, 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * Sum of the port counters of packets dropped, as of the last poll.
+ * Reading the port counters is slow and not safe against concurrent
+ * readers in all drivers: they are polled periodically, by the queue which
+ * takes the port lock, the other queues use the value of the last poll.
+ */
+static uint64_t
+pdump_port_drops(uint16_t port_id, uint64_t now)
+{
+	struct pdump_port_drops *pd = &port_drops[port_id];
+	struct rte_eth_stats st;
+
+	if (now >= __atomic_load_n(&pd->next_poll, __ATOMIC_RELAXED) &&
+	    rte_spinlock_trylock(&pd->lock)) {
+		if (now >= pd->next_poll) {
+			__atomic_store_n(&pd->next_poll,
+					 now + rte_get_tsc_hz() / PDUMP_DROPS_POLL_HZ,
+					 __ATOMIC_RELAXED);
+			if (rte_eth_stats_get(port_id, &st) == 0)
+				__atomic_store_n(&pd->drops, st.imissed +
+						 st.rx_nombuf + st.oerrors,
+						 __ATOMIC_RELAXED);
+		}
+		rte_spinlock_unlock(&pd->lock);
+	}
+
+	return __atomic_load_n(&pd->drops, __ATOMIC_RELAXED);
+}
+
+/*
+ * Trigger mode: keep a reference to the packets in the window,
+ * and dump the window if a trigger condition fires.
+ */
+static void
+pdump_window_update(uint16_t port_id, uint16_t queue,
+		    enum rte_pcapng_direction direction,
+		    struct rte_mbuf **pkts, uint16_t nb_pkts,
+		    const struct pdump_rxtx_cbs *cbs,
+		    struct pdump_window *win,
+		    struct rte_pdump_stats *stats)
+{
+	const uint32_t triggers = cbs->sample.triggers;
+	struct rte_mbuf *match[nb_pkts + 1];
+	uint64_t now, gen, drops;
+	struct rte_mbuf *m;
+	bool fire = false;
+	uint16_t i;
+
+	if (cbs->filter && nb_pkts > 0) {
+		if (triggers & RTE_PDUMP_TRIGGER_FILTER) {
+			/* matches fire the trigger, all packets are kept */
+			uint64_t rcs[nb_pkts];
+
+			pdump_filter_exec(cbs->filter, pkts, rcs, nb_pkts);
+			for (i = 0; i < nb_pkts; i++)
+				fire |= rcs[i] != 0;
+		} else {
+			nb_pkts = pdump_filter(cbs->filter, pkts, nb_pkts,
+					       match, stats);
+			pkts = match;
+		}
+	}
+
+	now = rte_get_tsc_cycles();
+	for (i = 0; i < nb_pkts; i++) {
+		m = rte_pktmbuf_clone(pkts[i], cbs->mp);
+		if (unlikely(m == NULL)) {
+			__atomic_fetch_add(&stats->nombuf, 1,
+					   __ATOMIC_RELAXED);
+			continue;
+		}
+
+		if (win->slots[win->head].m != NULL)
+			rte_pktmbuf_free(win->slots[win->head].m);
+		win->slots[win->head].m = m;
+		win->slots[win->head].ts = now;
+		win->head = (win->head + 1 == win->size) ? 0 : win->head + 1;
+		if (win->count < win->size)
+			win->count++;
+	}
+
+	gen = __atomic_load_n(&pdump_stats->trigger[port_id],
+			      __ATOMIC_RELAXED);
+	if (gen != win->trigger_seen) {
+		win->trigger_seen = gen;
+		if (triggers & RTE_PDUMP_TRIGGER_MANUAL)
+			fire = true;
+	}
+
+	if (triggers & RTE_PDUMP_TRIGGER_DROPS) {
+		drops = pdump_port_drops(port_id, now);
+		if (drops > win->drops &&
+		    drops - win->drops >= cbs->sample.drop_threshold)
+			fire = true;
+		win->drops = drops;
+	}
+
+	if (fire && win->count > 0)
+		pdump_window_dump(port_id, queue, direction, cbs, win, stats);
+}
+
+static void
+pdump_capture(uint16_t port_id, uint16_t queue,
+	      enum rte_pcapng_direction direction,
+	      struct rte_mbuf **pkts, uint16_t nb_pkts,
+	      struct pdump_rxtx_cbs *cbs,
+	      struct rte_pdump_stats *stats)
+{
+	struct pdump_window *win = cbs->win;
+	struct rte_mbuf *sel[nb_pkts + 1];
+	uint16_t n;
+
+	/* Sampling is done first, to bound the cost of filter and copy */
+	if (cbs->sample.mode != RTE_PDUMP_SAMPLE_NONE && nb_pkts > 0) {
+		n = pdump_sample(cbs, pkts, nb_pkts, sel);
+		if (n < nb_pkts)
+			__atomic_fetch_add(&stats->sampled, nb_pkts - n,
+					   __ATOMIC_RELAXED);
+		pkts = sel;
+		nb_pkts = n;
+	}
+
+	/* Trigger conditions are checked even without packets */
+	if (win != NULL) {
+		pdump_window_update(port_id, queue, direction, pkts, nb_pkts,
+				    cbs, win, stats);
+		return;
+	}
+
+	if (cbs->filter && nb_pkts > 0) {
+		nb_pkts = pdump_filter(cbs->filter, pkts, nb_pkts, sel, stats);
+		pkts = sel;
+	}
+	if (nb_pkts == 0)
+		return;
+
+	pdump_output(port_id, queue, direction, pkts, NULL, nb_pkts,
+		     cbs, stats);
+}
+
+/*
+ * The callbacks can still run for a while after their removal:
+ * mark them in use, to wait for their end before releasing their resources.
+ */
+static inline void
+pdump_cbs_inuse(struct pdump_rxtx_cbs *cbs)
+{
+	cbs->use++;
+	/* make sure no store/load reordering could happen */
+	rte_smp_mb();
+}
+
+static inline void
+pdump_cbs_unuse(struct pdump_rxtx_cbs *cbs)
+{
+	/* make sure all previous loads are completed */
+	rte_smp_rmb();
+	cbs->use++;
+}
+
 static uint16_t
 pdump_rx(uint16_t port, uint16_t queue,
 	struct rte_mbuf **pkts, uint16_t nb_pkts,
 	uint16_t max_pkts __rte_unused, void *user_params)
 {
-	const struct pdump_rxtx_cbs *cbs = user_params;
+	struct pdump_rxtx_cbs *cbs = user_params;
 	struct rte_pdump_stats *stats = &pdump_stats->rx[port][queue];
 
-	pdump_copy(port, queue, RTE_PCAPNG_DIRECTION_IN,
-		   pkts, nb_pkts, cbs, stats);
+	pdump_cbs_inuse(cbs);
+	/* the callback may be called once more after its removal */
+	if (cbs->cb != NULL)
+		pdump_capture(port, queue, RTE_PCAPNG_DIRECTION_IN,
+			      pkts, nb_pkts, cbs, stats);
+	pdump_cbs_unuse(cbs);
 	return nb_pkts;
 }
 
@@ -160,20 +575,98 @@ static uint16_t
 pdump_tx(uint16_t port, uint16_t queue,
 		struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
 {
-	const struct pdump_rxtx_cbs *cbs = user_params;
+	struct pdump_rxtx_cbs *cbs = user_params;
 	struct rte_pdump_stats *stats = &pdump_stats->tx[port][queue];
 
-	pdump_copy(port, queue, RTE_PCAPNG_DIRECTION_OUT,
-		   pkts, nb_pkts, cbs, stats);
+	pdump_cbs_inuse(cbs);
+	/* the callback may be called once more after its removal */
+	if (cbs->cb != NULL)
+		pdump_capture(port, queue, RTE_PCAPNG_DIRECTION_OUT,
+			      pkts, nb_pkts, cbs, stats);
+	pdump_cbs_unuse(cbs);
 	return nb_pkts;
 }
 
+static struct pdump_window *
+pdump_window_create(uint16_t port, const struct rte_pdump_sample *sample)
+{
+	struct pdump_window *win;
+
+	win = rte_zmalloc_socket("pdump_window", sizeof(*win) +
+				 sample->window * sizeof(win->slots[0]),
+				 RTE_CACHE_LINE_SIZE,
+				 rte_eth_dev_socket_id(port));
+	if (win == NULL)
+		return NULL;
+
+	win->size = sample->window;
+	win->trigger_seen = __atomic_load_n(&pdump_stats->trigger[port],
+					    __ATOMIC_RELAXED);
+	if (sample->triggers & RTE_PDUMP_TRIGGER_DROPS)
+		win->drops = pdump_port_drops(port, rte_get_tsc_cycles());
+
+	return win;
+}
+
+static void
+pdump_window_free(struct pdump_window *win)
+{
+	uint32_t i;
+
+	if (win == NULL)
+		return;
+
+	for (i = 0; i < win->size; i++)
+		rte_pktmbuf_free(win->slots[i].m);
+	rte_free(win);
+}
+
+/* Remove the callback resources, once no Rx/Tx iteration uses them */
+static void
+pdump_cbs_release(struct pdump_rxtx_cbs *cbs)
+{
+	struct pdump_window *win = cbs->win;
+	uint32_t puse;
+
+	cbs->cb = NULL;
+	cbs->win = NULL;
+
+	/* make sure all previous loads and stores are completed */
+	rte_smp_mb();
+
+	puse = cbs->use;
+
+	/* in use, busy wait till current Rx/Tx iteration is finished */
+	if ((puse & 1) != 0)
+		RTE_WAIT_UNTIL_MASKED(&cbs->use, UINT32_MAX, !=, puse,
+				      __ATOMIC_RELAXED);
+
+	pdump_window_free(win);
+}
+
+static void
+pdump_cbs_sample_init(struct pdump_rxtx_cbs *cbs,
+		      const struct rte_pdump_sample *sample)
+{
+	cbs->sample = *sample;
+	cbs->sample_cnt = 0;
+	cbs->flow_limit = 0;
+	/* sampling one in one is no sampling */
+	if (sample->rate <= 1)
+		cbs->sample.mode = RTE_PDUMP_SAMPLE_NONE;
+	else if (sample->mode == RTE_PDUMP_SAMPLE_FLOW)
+		cbs->flow_limit = (uint32_t)((UINT64_C(1) << 32) /
+					     sample->rate);
+}
+
 static int
 pdump_register_rx_callbacks(enum pdump_version ver,
 			    uint16_t end_q, uint16_t port, uint16_t queue,
 			    struct rte_ring *ring, struct rte_mempool *mp,
 			    struct rte_bpf *filter,
-			    uint16_t operation, uint32_t snaplen)
+			    uint16_t operation, uint32_t snaplen,
+			    uint32_t esize,
+			    const struct rte_pdump_sample *sample)
 {
 	uint16_t qid;
 
@@ -192,7 +685,17 @@ pdump_register_rx_callbacks(enum pdump_version ver,
 			cbs->ring = ring;
 			cbs->mp = mp;
 			cbs->snaplen = snaplen;
+			cbs->esize = esize;
 			cbs->filter = filter;
+			pdump_cbs_sample_init(cbs, sample);
+			if (sample->window > 0) {
+				cbs->win = pdump_window_create(port, sample);
+				if (cbs->win == NULL) {
+					PDUMP_LOG(ERR,
+						"cannot allocate trigger window\n");
+					return -ENOMEM;
+				}
+			}
 
 			cbs->cb = rte_eth_add_first_rx_callback(port, qid,
 								pdump_rx, cbs);
@@ -200,6 +703,8 @@ pdump_register_rx_callbacks(enum pdump_version ver,
 				PDUMP_LOG(ERR,
 					"failed to add rx callback, errno=%d\n",
 					rte_errno);
+				pdump_window_free(cbs->win);
+				cbs->win = NULL;
 				return rte_errno;
 			}
 		} else if (operation == DISABLE) {
@@ -218,7 +723,7 @@ pdump_register_rx_callbacks(enum pdump_version ver,
 					-ret);
 				return ret;
 			}
-			cbs->cb = NULL;
+			pdump_cbs_release(cbs);
 		}
 	}
 
@@ -230,7 +735,9 @@ pdump_register_tx_callbacks(enum pdump_version ver,
 			    uint16_t end_q, uint16_t port, uint16_t queue,
 			    struct rte_ring *ring, struct rte_mempool *mp,
 			    struct rte_bpf *filter,
-			    uint16_t operation, uint32_t snaplen)
+			    uint16_t operation, uint32_t snaplen,
+			    uint32_t esize,
+			    const struct rte_pdump_sample *sample)
 {
 
 	uint16_t qid;
@@ -250,7 +757,17 @@ pdump_register_tx_callbacks(enum pdump_version ver,
 			cbs->ring = ring;
 			cbs->mp = mp;
 			cbs->snaplen = snaplen;
+			cbs->esize = esize;
 			cbs->filter = filter;
+			pdump_cbs_sample_init(cbs, sample);
+			if (sample->window > 0) {
+				cbs->win = pdump_window_create(port, sample);
+				if (cbs->win == NULL) {
+					PDUMP_LOG(ERR,
+						"cannot allocate trigger window\n");
+					return -ENOMEM;
+				}
+			}
 
 			cbs->cb = rte_eth_add_tx_callback(port, qid, pdump_tx,
 								cbs);
@@ -258,6 +775,8 @@ pdump_register_tx_callbacks(enum pdump_version ver,
 				PDUMP_LOG(ERR,
 					"failed to add tx callback, errno=%d\n",
 					rte_errno);
+				pdump_window_free(cbs->win);
+				cbs->win = NULL;
 				return rte_errno;
 			}
 		} else if (operation == DISABLE) {
@@ -276,13 +795,46 @@ pdump_register_tx_callbacks(enum pdump_version ver,
 					-ret);
 				return ret;
 			}
-			cbs->cb = NULL;
+			pdump_cbs_release(cbs);
 		}
 	}
 
 	return 0;
 }
 
+/*
+ * The callbacks write blocks of the element size given by the client, which
+ * must hold a block of snaplen bytes, in place into the ring: check that the
+ * ring was created with elements of that size.
+ */
+static int
+pdump_validate_zc_esize(const struct rte_ring *ring, uint32_t esize,
+			uint32_t snaplen)
+{
+	ssize_t ring_size;
+
+	if (esize < rte_pcapng_block_size(snaplen) || esize % sizeof(uint32_t)) {
+		PDUMP_LOG(ERR,
+			  "element size %u does not fit snaplen %u\n",
+			  esize, snaplen);
+		return -EINVAL;
+	}
+
+	/* the ring memory is only known for rings created in a memzone */
+	if (ring->memzone == NULL)
+		return 0;
+
+	ring_size = rte_ring_get_memsize_elem(esize, ring->size);
+	if (ring_size < 0 || ring->memzone->len < (size_t)ring_size) {
+		PDUMP_LOG(ERR,
+			  "ring %s elements are smaller than %u bytes\n",
+			  ring->name, esize);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 static int
 set_pdump_rxtx_cbs(const struct pdump_request *p)
 {
@@ -296,7 +848,7 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	struct rte_mempool *mp;
 
 	/* Check for possible DPDK version mismatch */
-	if (!(p->ver == V1 || p->ver == V2)) {
+	if (!(p->ver == V1 || p->ver == V2 || p->ver == V3)) {
 		PDUMP_LOG(ERR,
 			  "incorrect client version %u\n", p->ver);
 		return -EINVAL;
@@ -364,12 +916,32 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 		}
 	}
 
+	if (operation == ENABLE && p->ver == V3) {
+		ret = pdump_validate_zc_esize(ring, p->esize, p->snaplen);
+		if (ret < 0)
+			return ret;
+	}
+
+	/* the window clones would be freed to the wrong pool by fast free */
+	if (operation == ENABLE && p->sample.window > 0) {
+		struct rte_eth_conf dev_conf;
+
+		ret = rte_eth_dev_conf_get(port, &dev_conf);
+		if (ret == 0 && (dev_conf.txmode.offloads &
+				 RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE)) {
+			PDUMP_LOG(ERR,
+				"trigger window not supported with mbuf fast free\n");
+			return -ENOTSUP;
+		}
+	}
+
 	/* register RX callback */
 	if (flags & RTE_PDUMP_FLAG_RX) {
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_rx_q : queue + 1;
 		ret = pdump_register_rx_callbacks(p->ver, end_q, port, queue,
 						  ring, mp, filter,
-						  operation, p->snaplen);
+						  operation, p->snaplen,
+						  p->esize, &p->sample);
 		if (ret < 0)
 			return ret;
 	}
@@ -379,7 +951,8 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_tx_q : queue + 1;
 		ret = pdump_register_tx_callbacks(p->ver, end_q, port, queue,
 						  ring, mp, filter,
-						  operation, p->snaplen);
+						  operation, p->snaplen,
+						  p->esize, &p->sample);
 		if (ret < 0)
 			return ret;
 	}
@@ -479,6 +1052,102 @@ pdump_validate_ring_mp(struct rte_ring *ring, struct rte_mempool *mp)
 	return 0;
 }
 
+/*
+ * In zero-copy mode the callbacks write in place into the ring elements,
+ * which needs a ring with a single or head/tail sync producer. A single
+ * producer ring can only be fed by one queue in one direction.
+ */
+static int
+pdump_validate_zc_ring(struct rte_ring *ring, uint16_t queue,
+		       uint32_t flags, uint32_t snaplen)
+{
+	enum rte_ring_sync_type st;
+
+	if (ring == NULL) {
+		PDUMP_LOG(ERR, "NULL ring\n");
+		rte_errno = EINVAL;
+		return -1;
+	}
+	if (snaplen == 0 || snaplen > UINT16_MAX) {
+		PDUMP_LOG(ERR,
+			  "zero-copy capture needs a snaplen of 1 to %u\n",
+			  UINT16_MAX);
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	st = rte_ring_get_prod_sync_type(ring);
+	if (st != RTE_RING_SYNC_ST && st != RTE_RING_SYNC_MT_HTS) {
+		PDUMP_LOG(ERR,
+			  "ring for zero-copy capture must have SP or MP_HTS set\n");
+		rte_errno = EINVAL;
+		return -1;
+	}
+	if (st == RTE_RING_SYNC_ST &&
+	    (queue == RTE_PDUMP_ALL_QUEUES ||
+	     (flags & RTE_PDUMP_FLAG_RXTX) == RTE_PDUMP_FLAG_RXTX)) {
+		PDUMP_LOG(ERR,
+			  "ring with SP set is only valid for one queue and direction\n");
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+pdump_validate_sample(const struct rte_pdump_sample *sample,
+		      struct rte_mempool *mp,
+		      const struct rte_bpf_prm *prm)
+{
+	if (sample->mode > RTE_PDUMP_SAMPLE_FLOW ||
+	    (sample->mode != RTE_PDUMP_SAMPLE_NONE && sample->rate == 0)) {
+		PDUMP_LOG(ERR, "invalid sampling mode or rate\n");
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	if (sample->window == 0)
+		return 0;
+
+	if (sample->window > PDUMP_WINDOW_MAX) {
+		PDUMP_LOG(ERR, "trigger window larger than %u\n",
+			  PDUMP_WINDOW_MAX);
+		rte_errno = EINVAL;
+		return -1;
+	}
+	if (sample->triggers == 0 ||
+	    (sample->triggers & ~(RTE_PDUMP_TRIGGER_MANUAL |
+				  RTE_PDUMP_TRIGGER_FILTER |
+				  RTE_PDUMP_TRIGGER_DROPS))) {
+		PDUMP_LOG(ERR, "invalid triggers: %#x\n", sample->triggers);
+		rte_errno = EINVAL;
+		return -1;
+	}
+	if ((sample->triggers & RTE_PDUMP_TRIGGER_FILTER) && prm == NULL) {
+		PDUMP_LOG(ERR, "filter trigger without BPF filter\n");
+		rte_errno = EINVAL;
+		return -1;
+	}
+	if ((sample->triggers & RTE_PDUMP_TRIGGER_DROPS) &&
+	    sample->drop_threshold == 0) {
+		PDUMP_LOG(ERR, "drops trigger without threshold\n");
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	/* the window clones come from the mempool, even in zero-copy mode */
+	if (mp == NULL ||
+	    mp->flags & (RTE_MEMPOOL_F_SP_PUT | RTE_MEMPOOL_F_SC_GET)) {
+		PDUMP_LOG(ERR,
+			  "trigger window needs a mempool with MP and MC set\n");
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 pdump_validate_flags(uint32_t flags)
 {
@@ -490,7 +1159,8 @@ pdump_validate_flags(uint32_t flags)
 	}
 
 	/* mask off the flags we know about */
-	if (flags & ~(RTE_PDUMP_FLAG_RXTX | RTE_PDUMP_FLAG_PCAPNG)) {
+	if (flags & ~(RTE_PDUMP_FLAG_RXTX | RTE_PDUMP_FLAG_PCAPNG |
+		      RTE_PDUMP_FLAG_ZEROCOPY)) {
 		PDUMP_LOG(ERR,
 			  "unknown flags: %#x\n", flags);
 		rte_errno = ENOTSUP;
@@ -528,7 +1198,8 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
 			     uint16_t operation,
 			     struct rte_ring *ring,
 			     struct rte_mempool *mp,
-			     const struct rte_bpf_prm *prm)
+			     const struct rte_bpf_prm *prm,
+			     const struct rte_pdump_sample *sample)
 {
 	int ret = -1;
 	struct rte_mp_msg mp_req, *mp_rep;
@@ -545,7 +1216,10 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
 
 	memset(req, 0, sizeof(*req));
 
-	req->ver = (flags & RTE_PDUMP_FLAG_PCAPNG) ? V2 : V1;
+	if (flags & RTE_PDUMP_FLAG_ZEROCOPY)
+		req->ver = V3;
+	else
+		req->ver = (flags & RTE_PDUMP_FLAG_PCAPNG) ? V2 : V1;
 	req->flags = flags & RTE_PDUMP_FLAG_RXTX;
 	req->op = operation;
 	req->queue = queue;
@@ -556,6 +1230,9 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
 		req->mp = mp;
 		req->prm = prm;
 		req->snaplen = snaplen;
+		req->sample = *sample;
+		if (flags & RTE_PDUMP_FLAG_ZEROCOPY)
+			req->esize = rte_pcapng_block_size(snaplen);
 	}
 
 	rte_strscpy(mp_req.name, PDUMP_MP, RTE_MP_MAX_NAME_LEN);
@@ -576,6 +1253,11 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
 	return ret;
 }
 
+/* Continuous capture of all packets */
+static const struct rte_pdump_sample no_sample = {
+	.mode = RTE_PDUMP_SAMPLE_NONE,
+};
+
 /*
  * There are two versions of this function, because although original API
  * left place holder for future filter, it never checked the value.
@@ -586,7 +1268,8 @@ static int
 pdump_enable(uint16_t port, uint16_t queue,
 	     uint32_t flags, uint32_t snaplen,
 	     struct rte_ring *ring, struct rte_mempool *mp,
-	     const struct rte_bpf_prm *prm)
+	     const struct rte_bpf_prm *prm,
+	     const struct rte_pdump_sample *sample)
 {
 	int ret;
 	char name[RTE_DEV_NAME_MAX_LEN];
@@ -594,10 +1277,16 @@ pdump_enable(uint16_t port, uint16_t queue,
 	ret = pdump_validate_port(port, name);
 	if (ret < 0)
 		return ret;
-	ret = pdump_validate_ring_mp(ring, mp);
+	ret = pdump_validate_flags(flags);
 	if (ret < 0)
 		return ret;
-	ret = pdump_validate_flags(flags);
+	if (flags & RTE_PDUMP_FLAG_ZEROCOPY)
+		ret = pdump_validate_zc_ring(ring, queue, flags, snaplen);
+	else
+		ret = pdump_validate_ring_mp(ring, mp);
+	if (ret < 0)
+		return ret;
+	ret = pdump_validate_sample(sample, mp, prm);
 	if (ret < 0)
 		return ret;
 
@@ -605,7 +1294,7 @@ pdump_enable(uint16_t port, uint16_t queue,
 		snaplen = UINT32_MAX;
 
 	return pdump_prepare_client_request(name, queue, flags, snaplen,
-					    ENABLE, ring, mp, prm);
+					    ENABLE, ring, mp, prm, sample);
 }
 
 int
@@ -615,7 +1304,7 @@ rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
 		 void *filter __rte_unused)
 {
 	return pdump_enable(port, queue, flags, 0,
-			    ring, mp, NULL);
+			    ring, mp, NULL, &no_sample);
 }
 
 int
@@ -626,7 +1315,24 @@ rte_pdump_enable_bpf(uint16_t port, uint16_t queue,
 		     const struct rte_bpf_prm *prm)
 {
 	return pdump_enable(port, queue, flags, snaplen,
-			    ring, mp, prm);
+			    ring, mp, prm, &no_sample);
+}
+
+int
+rte_pdump_enable_sample(uint16_t port, uint16_t queue,
+			uint32_t flags, uint32_t snaplen,
+			struct rte_ring *ring,
+			struct rte_mempool *mp,
+			const struct rte_bpf_prm *prm,
+			const struct rte_pdump_sample *sample)
+{
+	if (sample == NULL) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	return pdump_enable(port, queue, flags, snaplen,
+			    ring, mp, prm, sample);
 }
 
 static int
@@ -634,14 +1340,21 @@ pdump_enable_by_deviceid(const char *device_id, uint16_t queue,
 			 uint32_t flags, uint32_t snaplen,
 			 struct rte_ring *ring,
 			 struct rte_mempool *mp,
-			 const struct rte_bpf_prm *prm)
+			 const struct rte_bpf_prm *prm,
+			 const struct rte_pdump_sample *sample)
 {
 	int ret;
 
-	ret = pdump_validate_ring_mp(ring, mp);
+	ret = pdump_validate_flags(flags);
 	if (ret < 0)
 		return ret;
-	ret = pdump_validate_flags(flags);
+	if (flags & RTE_PDUMP_FLAG_ZEROCOPY)
+		ret = pdump_validate_zc_ring(ring, queue, flags, snaplen);
+	else
+		ret = pdump_validate_ring_mp(ring, mp);
+	if (ret < 0)
+		return ret;
+	ret = pdump_validate_sample(sample, mp, prm);
 	if (ret < 0)
 		return ret;
 
@@ -649,7 +1362,7 @@ pdump_enable_by_deviceid(const char *device_id, uint16_t queue,
 		snaplen = UINT32_MAX;
 
 	return pdump_prepare_client_request(device_id, queue, flags, snaplen,
-					    ENABLE, ring, mp, prm);
+					    ENABLE, ring, mp, prm, sample);
 }
 
 int
@@ -660,7 +1373,7 @@ rte_pdump_enable_by_deviceid(char *device_id, uint16_t queue,
 			     void *filter __rte_unused)
 {
 	return pdump_enable_by_deviceid(device_id, queue, flags, 0,
-					ring, mp, NULL);
+					ring, mp, NULL, &no_sample);
 }
 
 int
@@ -671,7 +1384,7 @@ rte_pdump_enable_bpf_by_deviceid(const char *device_id, uint16_t queue,
 				 const struct rte_bpf_prm *prm)
 {
 	return pdump_enable_by_deviceid(device_id, queue, flags, snaplen,
-					ring, mp, prm);
+					ring, mp, prm, &no_sample);
 }
 
 int
@@ -688,7 +1401,7 @@ rte_pdump_disable(uint16_t port, uint16_t queue, uint32_t flags)
 		return ret;
 
 	ret = pdump_prepare_client_request(name, queue, flags, 0,
-					   DISABLE, NULL, NULL, NULL);
+					   DISABLE, NULL, NULL, NULL, NULL);
 
 	return ret;
 }
@@ -704,7 +1417,7 @@ rte_pdump_disable_by_deviceid(char *device_id, uint16_t queue,
 		return ret;
 
 	ret = pdump_prepare_client_request(device_id, queue, flags, 0,
-					   DISABLE, NULL, NULL, NULL);
+					   DISABLE, NULL, NULL, NULL, NULL);
 
 	return ret;
 }
@@ -729,11 +1442,38 @@ pdump_sum_stats(uint16_t port, uint16_t nq,
 	}
 }
 
+static int
+pdump_stats_lookup(void)
+{
+	const struct rte_memzone *mz;
+
+	if (pdump_stats != NULL)
+		return 0;
+
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
+		/* rte_pdump_init was not called */
+		PDUMP_LOG(ERR, "pdump stats not initialized\n");
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	/* secondary process looks up the memzone */
+	mz = rte_memzone_lookup(MZ_RTE_PDUMP_STATS);
+	if (mz == NULL) {
+		/* rte_pdump_init was not called in primary process?? */
+		PDUMP_LOG(ERR, "can not find pdump stats\n");
+		rte_errno = EINVAL;
+		return -1;
+	}
+	pdump_stats = mz->addr;
+
+	return 0;
+}
+
 int
 rte_pdump_stats(uint16_t port, struct rte_pdump_stats *stats)
 {
 	struct rte_eth_dev_info dev_info;
-	const struct rte_memzone *mz;
 	int ret;
 
 	memset(stats, 0, sizeof(*stats));
@@ -745,26 +1485,57 @@ rte_pdump_stats(uint16_t port, struct rte_pdump_stats *stats)
 		return ret;
 	}
 
-	if (pdump_stats == NULL) {
-		if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
-			/* rte_pdump_init was not called */
-			PDUMP_LOG(ERR, "pdump stats not initialized\n");
-			rte_errno = EINVAL;
-			return -1;
-		}
-
-		/* secondary process looks up the memzone */
-		mz = rte_memzone_lookup(MZ_RTE_PDUMP_STATS);
-		if (mz == NULL) {
-			/* rte_pdump_init was not called in primary process?? */
-			PDUMP_LOG(ERR, "can not find pdump stats\n");
-			rte_errno = EINVAL;
-			return -1;
-		}
-		pdump_stats = mz->addr;
-	}
+	if (pdump_stats_lookup() < 0)
+		return -1;
 
 	pdump_sum_stats(port, dev_info.nb_rx_queues, pdump_stats->rx, stats);
 	pdump_sum_stats(port, dev_info.nb_tx_queues, pdump_stats->tx, stats);
 	return 0;
 }
+
+int
+rte_pdump_trigger(uint16_t port)
+{
+	if (!rte_eth_dev_is_valid_port(port)) {
+		PDUMP_LOG(ERR, "Invalid port id %u\n", port);
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	if (pdump_stats_lookup() < 0)
+		return -1;
+
+	/* queues in trigger mode dump their window on generation change */
+	__atomic_fetch_add(&pdump_stats->trigger[port], 1, __ATOMIC_RELAXED);
+	return 0;
+}
+
+static int
+pdump_handle_trigger(const char *cmd __rte_unused, const char *params,
+		     struct rte_tel_data *d)
+{
+	unsigned long port;
+	char *end;
+
+	if (params == NULL || !isdigit(*params))
+		return -EINVAL;
+
+	port = strtoul(params, &end, 0);
+	if (*end != '\0' || port >= RTE_MAX_ETHPORTS)
+		return -EINVAL;
+
+	if (rte_pdump_trigger(port) < 0)
+		return -rte_errno;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_uint(d, "trigger",
+				   __atomic_load_n(&pdump_stats->trigger[port],
+						   __ATOMIC_RELAXED));
+	return 0;
+}
+
+RTE_INIT(pdump_init_telemetry)
+{
+	rte_telemetry_register_cmd("/pdump/trigger", pdump_handle_trigger,
+		"Dumps the capture windows of a port in trigger mode. Parameters: int port_id");
+}
@@ -13,6 +13,7 @@
  */
 
 #include <stdint.h>
+#include <rte_bitops.h>
 #include <rte_compat.h>
 #include <rte_bpf.h>
 
@@ -29,6 +30,43 @@ enum {
 	RTE_PDUMP_FLAG_RXTX = (RTE_PDUMP_FLAG_RX|RTE_PDUMP_FLAG_TX),
 
 	RTE_PDUMP_FLAG_PCAPNG = 4, /* format for pcapng */
+	/* pcapng blocks written in place into the ring, without mbuf copy */
+	RTE_PDUMP_FLAG_ZEROCOPY = 8,
+};
+
+/**
+ * Packet sampling applied by the capture callbacks, before the filter.
+ */
+enum rte_pdump_sample_mode {
+	RTE_PDUMP_SAMPLE_NONE = 0, /**< All packets are captured. */
+	RTE_PDUMP_SAMPLE_COUNT,    /**< One packet in *rate* on each queue. */
+	RTE_PDUMP_SAMPLE_FLOW,     /**< All packets of one flow in *rate*. */
+};
+
+/** Dump the trigger window on rte_pdump_trigger() or telemetry command. */
+#define RTE_PDUMP_TRIGGER_MANUAL RTE_BIT32(0)
+/** Dump the trigger window when a packet matches the BPF filter. */
+#define RTE_PDUMP_TRIGGER_FILTER RTE_BIT32(1)
+/** Dump the trigger window when the port drop counters jump. */
+#define RTE_PDUMP_TRIGGER_DROPS  RTE_BIT32(2)
+
+/**
+ * Sampling and trigger parameters for rte_pdump_enable_sample().
+ */
+struct rte_pdump_sample {
+	enum rte_pdump_sample_mode mode; /**< Sampling mode. */
+	uint32_t rate;     /**< Sampling rate, 1 in *rate* packets or flows. */
+	/**
+	 * Number of the most recent packets kept per queue in trigger mode,
+	 * 0 for continuous capture. In trigger mode, nothing is written
+	 * to the ring until one of the *triggers* conditions fires.
+	 */
+	uint32_t window;
+	uint32_t triggers; /**< RTE_PDUMP_TRIGGER_* conditions. */
+	/** Port drops (missed, no mbuf and Tx errors) within a poll period
+	 *  firing RTE_PDUMP_TRIGGER_DROPS.
+	 */
+	uint64_t drop_threshold;
 };
 
 /**
@@ -103,9 +141,20 @@ rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
  *  The ring on which captured packets will be enqueued for user.
  * @param mp
  *  The mempool on to which original packets will be mirrored or duplicated.
+ *  Unused with RTE_PDUMP_FLAG_ZEROCOPY.
  * @param prm
  *  Use BPF program to run to filter packes (can be NULL)
  *
+ * With RTE_PDUMP_FLAG_ZEROCOPY, no mbuf is allocated nor copied: the first
+ * *snaplen* bytes of each packet are written as a pcapng block directly into
+ * an element of *ring*, to be written to file with rte_pcapng_write_blocks().
+ * The ring must then be created by rte_ring_create_elem() with an element
+ * size of rte_pcapng_block_size(snaplen), and either RING_F_SP_ENQ, to be
+ * used by a single queue in a single direction, or RING_F_MP_HTS_ENQ, to be
+ * shared by several queues. *snaplen* must be set and not exceed UINT16_MAX.
+ * The primary process rejects a ring whose memory does not fit elements of
+ * that size.
+ *
  * @return
  *    0 on success, -1 on error, rte_errno is set accordingly.
  */
@@ -117,6 +166,78 @@ rte_pdump_enable_bpf(uint16_t port_id, uint16_t queue,
 		     struct rte_mempool *mp,
 		     const struct rte_bpf_prm *prm);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enables sampled or triggered packet capturing on given port and queue.
+ *
+ * Same as rte_pdump_enable_bpf(), with the callbacks first selecting
+ * the packets according to *sample->mode*, before running the filter
+ * and copying them. This bounds the capture cost on busy queues.
+ *
+ * If *sample->window* is set, the queues keep a reference (clone allocated
+ * from *mp*) to their last *window* packets and write them to *ring*
+ * only when one of *sample->triggers* fires; the window is then emptied
+ * and armed again. With RTE_PDUMP_TRIGGER_FILTER, the filter fires the
+ * trigger instead of selecting the packets. The window holds mbufs
+ * of the port mempools, so it must be small compared to them, and it cannot
+ * be used with RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE. As the packet data is
+ * not copied, a change of the packet by the application after the
+ * callback shows in the capture.
+ *
+ * @param port_id
+ *  The Ethernet port on which packet capturing should be enabled.
+ * @param queue
+ *  The queue on the Ethernet port which packet capturing
+ *  should be enabled. Pass UINT16_MAX to enable packet capturing on all
+ *  queues of a given port.
+ * @param flags
+ *  Pdump library flags that specify direction and packet format.
+ * @param snaplen
+ *  The upper limit on bytes to copy.
+ *  Passing UINT32_MAX means capture all the possible data.
+ * @param ring
+ *  The ring on which captured packets will be enqueued for user.
+ * @param mp
+ *  The mempool on to which original packets will be mirrored or duplicated,
+ *  and from which the trigger window clones are allocated.
+ * @param prm
+ *  Use BPF program to run to filter packets (can be NULL)
+ * @param sample
+ *  Sampling and trigger parameters.
+ *
+ * @return
+ *    0 on success, -1 on error, rte_errno is set accordingly.
+ */
+__rte_experimental
+int
+rte_pdump_enable_sample(uint16_t port_id, uint16_t queue,
+			uint32_t flags, uint32_t snaplen,
+			struct rte_ring *ring,
+			struct rte_mempool *mp,
+			const struct rte_bpf_prm *prm,
+			const struct rte_pdump_sample *sample);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Fire RTE_PDUMP_TRIGGER_MANUAL on all queues of a port.
+ *
+ * Each queue in trigger mode writes its window to its ring
+ * on its next burst. The same is done by the "/pdump/trigger"
+ * telemetry command.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @return
+ *   Zero if successful. -1 on error and rte_errno is set.
+ */
+__rte_experimental
+int
+rte_pdump_trigger(uint16_t port_id);
+
 /**
  * Disables packet capturing on given port and queue.
  *
@@ -190,9 +311,12 @@ rte_pdump_enable_by_deviceid(char *device_id, uint16_t queue,
  *  The ring on which captured packets will be enqueued for user.
  * @param mp
  *  The mempool on to which original packets will be mirrored or duplicated.
+ *  Unused with RTE_PDUMP_FLAG_ZEROCOPY.
  * @param filter
  *  Use BPF program to run to filter packes (can be NULL)
  *
+ * See rte_pdump_enable_bpf() for the requirements of RTE_PDUMP_FLAG_ZEROCOPY.
+ *
  * @return
  *    0 on success, -1 on error, rte_errno is set accordingly.
  */
@@ -237,8 +361,10 @@ struct rte_pdump_stats {
 	uint64_t filtered; /**< Number of packets rejected by filter. */
 	uint64_t nombuf;   /**< Number of mbuf allocation failures. */
 	uint64_t ringfull; /**< Number of missed packets due to ring full. */
+	uint64_t sampled;  /**< Number of packets skipped by sampling. */
+	uint64_t triggers; /**< Number of trigger windows dumped. */
 
-	uint64_t reserved[4]; /**< Reserved and pad to cache line */
+	uint64_t reserved[2]; /**< Reserved and pad to cache line */
 };
 
 /**
@@ -691,6 +691,15 @@ struct rte_swx_learner_stats {
 	/** Number of packets with forget event. */
 	uint64_t n_pkts_forget;
 
+	/** Number of keys added to the table. */
+	uint64_t n_keys_learned;
+
+	/** Number of keys removed from the table on timeout. */
+	uint64_t n_keys_expired;
+
+	/** Number of keys not added to the table because their bucket is full. */
+	uint64_t n_keys_rejected;
+
 	/** Number of packets (with either lookup hit or miss) per pipeline action. Array of
 	 * pipeline *n_actions* elements indexed by the pipeline-level *action_id*, therefore this
 	 * array has the same size for all the tables within the same pipeline.
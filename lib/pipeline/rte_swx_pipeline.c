@@ -10311,6 +10311,13 @@ table_types_register(struct rte_swx_pipeline *p)
 	if (status)
 		return status;
 
+	status = rte_swx_pipeline_table_type_register(p,
+		"exact_large",
+		RTE_SWX_TABLE_MATCH_EXACT,
+		&rte_swx_table_exact_match_large_ops);
+	if (status)
+		return status;
+
 	status = rte_swx_pipeline_table_type_register(p,
 		"wildcard",
 		RTE_SWX_TABLE_MATCH_WILDCARD,
@@ -10562,6 +10569,25 @@ rte_swx_pipeline_run(struct rte_swx_pipeline *p, uint32_t n_instructions)
 		instr_exec(p);
 }
 
+void
+rte_swx_pipeline_age(struct rte_swx_pipeline *p, uint32_t n_buckets)
+{
+	uint64_t time;
+	uint32_t i;
+
+	if (!p->n_learners)
+		return;
+
+	time = rte_get_tsc_cycles();
+
+	for (i = 0; i < p->n_learners; i++) {
+		struct rte_swx_table_state *ts = &p->table_state[p->n_tables +
+			p->n_selectors + i];
+
+		rte_swx_table_learner_age(ts->obj, time, n_buckets);
+	}
+}
+
 void
 rte_swx_pipeline_flush(struct rte_swx_pipeline *p)
 {
@@ -11091,6 +11117,9 @@ rte_swx_ctl_pipeline_learner_stats_read(struct rte_swx_pipeline *p,
 {
 	struct learner *l;
 	struct learner_statistics *learner_stats;
+	struct rte_swx_table_state *ts;
+	struct rte_swx_table_learner_stats table_stats;
+	int status;
 
 	if (!p || !learner_name || !learner_name[0] || !stats || !stats->n_pkts_action)
 		return -EINVAL;
@@ -11100,6 +11129,11 @@ rte_swx_ctl_pipeline_learner_stats_read(struct rte_swx_pipeline *p,
 		return -EINVAL;
 
 	learner_stats = &p->learner_stats[l->id];
+	ts = &p->table_state[p->n_tables + p->n_selectors + l->id];
+
+	status = rte_swx_table_learner_stats_read(ts->obj, &table_stats);
+	if (status)
+		return status;
 
 	memcpy(stats->n_pkts_action,
 	       learner_stats->n_pkts_action,
@@ -11114,6 +11148,10 @@ rte_swx_ctl_pipeline_learner_stats_read(struct rte_swx_pipeline *p,
 	stats->n_pkts_rearm = learner_stats->n_pkts_rearm;
 	stats->n_pkts_forget = learner_stats->n_pkts_forget;
 
+	stats->n_keys_learned = table_stats.n_keys_learned;
+	stats->n_keys_expired = table_stats.n_keys_expired;
+	stats->n_keys_rejected = table_stats.n_keys_rejected;
+
 	return 0;
 }
 
@@ -1047,6 +1047,24 @@ void
 rte_swx_pipeline_run(struct rte_swx_pipeline *p,
 		     uint32_t n_instructions);
 
+/**
+ * Pipeline learner tables aging
+ *
+ * Remove the expired keys from a few buckets of each learner table of the pipeline. Typically
+ * invoked periodically by the data plane thread running the pipeline, in between the
+ * rte_swx_pipeline_run() calls, so that the expired keys are reclaimed incrementally with bounded
+ * work per call.
+ *
+ * @param[in] p
+ *   Pipeline handle.
+ * @param[in] n_buckets
+ *   Number of buckets to check in each learner table.
+ */
+__rte_experimental
+void
+rte_swx_pipeline_age(struct rte_swx_pipeline *p,
+		     uint32_t n_buckets);
+
 /**
  * Pipeline flush
  *
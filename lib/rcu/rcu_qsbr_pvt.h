@@ -15,6 +15,21 @@
 
 #include "rte_rcu_qsbr.h"
 
+/* Maximum number of elements in a per lcore defer queue, the resources
+ * which do not fit are stored in the shared defer queue.
+ */
+#define __RTE_RCU_QSBR_DQ_LCORE_SIZE_MAX 1024u
+
+/* Per lcore defer queue.
+ * This structure is only accessed by its lcore, except when the defer
+ * queue is deleted.
+ */
+struct __rte_rcu_qsbr_dq_lcore {
+	uint32_t head;   /**< Count of enqueued elements */
+	uint32_t tail;   /**< Count of reclaimed elements */
+	uint8_t *elems;  /**< Array of 'lcore_size' elements */
+} __rte_cache_aligned;
+
 /* Defer queue structure.
  * This structure holds the defer queue. The defer queue is used to
  * hold the deleted entries from the data structure that are not
@@ -44,6 +59,10 @@ struct rte_rcu_qsbr_dq {                           //延迟队列
 	 *   pointer to the data structure to which the resource to free
 	 *   belongs.
 	 */
+	uint32_t lcore_size;
+	/**< Number of elements in each per lcore defer queue */
+	struct __rte_rcu_qsbr_dq_lcore *lcore;
+	/**< Per lcore defer queues, NULL if not used */
 };
 
 /* Internal structure to represent the element on the defer queue.
@@ -55,4 +74,9 @@ typedef struct {
 	uint8_t elem[0]; /**< Pointer to user element */
 } __attribute__((__may_alias__)) __rte_rcu_qsbr_dq_elem_t;
 
+/* Element of index i, in enqueue order, of a per lcore defer queue */
+#define __RTE_RCU_QSBR_DQ_LCORE_ELEM(dq, lq, i) \
+	((__rte_rcu_qsbr_dq_elem_t *)((lq)->elems + \
+	(size_t)((i) & ((dq)->lcore_size - 1)) * (dq)->esize))
+
 #endif /* _RTE_RCU_QSBR_PVT_H_ */
@@ -10,6 +10,7 @@
 #include <errno.h>
 
 #include <rte_common.h>
+#include <rte_lcore.h>
 #include <rte_log.h>
 #include <rte_memory.h>
 #include <rte_malloc.h>
@@ -42,6 +43,9 @@ rte_rcu_qsbr_get_memsize(uint32_t max_threads) //计算qsbr占用内存
 	/* Add the size of the registered thread ID bitmap array */
 	sz += __RTE_QSBR_THRID_ARRAY_SIZE(max_threads); //线程ID位图数组
 
+	/* Add the size of the thread group acknowledged token array */
+	sz += __RTE_QSBR_THRID_ARRAY_SIZE(max_threads);
+
 	return sz;
 }
 
@@ -281,7 +285,9 @@ rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 	if (params == NULL || params->free_fn == NULL ||
 		params->v == NULL || params->name == NULL ||
 		params->size == 0 || params->esize == 0 ||
-		(params->esize % 4 != 0)) {
+		(params->esize % 4 != 0) ||
+		((params->flags & RTE_RCU_QSBR_DQ_PER_LCORE) &&
+		 (params->flags & RTE_RCU_QSBR_DQ_MT_UNSAFE))) {
 		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
 			"%s(): Invalid input parameter\n", __func__);
 		rte_errno = EINVAL;
@@ -334,6 +340,21 @@ rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 		return NULL;
 	}
 
+	/* The per lcore queues are allocated on first use */
+	if (params->flags & RTE_RCU_QSBR_DQ_PER_LCORE) {
+		dq->lcore = rte_zmalloc(NULL,
+				sizeof(struct __rte_rcu_qsbr_dq_lcore) *
+				RTE_MAX_LCORE, RTE_CACHE_LINE_SIZE);
+		if (dq->lcore == NULL) {
+			rte_ring_free(dq->r);
+			rte_free(dq);
+			rte_errno = ENOMEM;
+			return NULL;
+		}
+		dq->lcore_size = rte_align32pow2(RTE_MIN(params->size,
+					__RTE_RCU_QSBR_DQ_LCORE_SIZE_MAX));
+	}
+
 	dq->v = params->v;
 	dq->size = params->size;
 	dq->esize = __RTE_QSBR_TOKEN_SIZE + params->esize;
@@ -345,6 +366,98 @@ rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 	return dq;
 }
 
+/* Reclaim at most n resources from a per lcore defer queue. */
+static unsigned int
+rcu_qsbr_dq_lcore_reclaim(struct rte_rcu_qsbr_dq *dq,
+			  struct __rte_rcu_qsbr_dq_lcore *lq, unsigned int n)
+{
+	__rte_rcu_qsbr_dq_elem_t *dq_elem;
+	unsigned int cnt, i;
+
+	n = RTE_MIN(n, lq->head - lq->tail);
+	if (n == 0)
+		return 0;
+
+	/* The tokens being in order, the whole batch can be reclaimed
+	 * if its last token is acknowledged.
+	 */
+	dq_elem = __RTE_RCU_QSBR_DQ_LCORE_ELEM(dq, lq, lq->tail + n - 1);
+	if (rte_rcu_qsbr_check(dq->v, dq_elem->token, false) == 1) {
+		for (i = 0; i < n; i++) {
+			dq_elem = __RTE_RCU_QSBR_DQ_LCORE_ELEM(dq, lq,
+							       lq->tail + i);
+			dq->free_fn(dq->p, dq_elem->elem, 1);
+		}
+		lq->tail += n;
+
+		return n;
+	}
+
+	/* The check above updated the least acknowledged token, the
+	 * following checks do not have to go through the threads again
+	 * until a token not yet acknowledged is found.
+	 */
+	for (cnt = 0; cnt < n - 1; cnt++) {
+		dq_elem = __RTE_RCU_QSBR_DQ_LCORE_ELEM(dq, lq, lq->tail);
+		if (rte_rcu_qsbr_check(dq->v, dq_elem->token, false) != 1)
+			break;
+
+		dq->free_fn(dq->p, dq_elem->elem, 1);
+		lq->tail++;
+	}
+
+	return cnt;
+}
+
+/* Enqueue one resource to the defer queue of the calling lcore. */
+static int
+rcu_qsbr_dq_lcore_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	__rte_rcu_qsbr_dq_elem_t *dq_elem;
+	struct __rte_rcu_qsbr_dq_lcore *lq;
+	uint32_t cur_size;
+
+	/* Non-EAL threads use the shared defer queue */
+	if (lcore_id >= RTE_MAX_LCORE)
+		return 1;
+
+	lq = &dq->lcore[lcore_id];
+	if (unlikely(lq->elems == NULL)) {
+		lq->elems = rte_malloc_socket(NULL,
+				(size_t)dq->lcore_size * dq->esize,
+				RTE_CACHE_LINE_SIZE,
+				rte_lcore_to_socket_id(lcore_id));
+		if (lq->elems == NULL)
+			return 1;
+	}
+
+	/* Reclaim resources if the queue size has hit the reclaim
+	 * limit or the queue is full.
+	 */
+	cur_size = lq->head - lq->tail;
+	if (cur_size > dq->trigger_reclaim_limit ||
+	    cur_size == dq->lcore_size) {
+		rte_log(RTE_LOG_INFO, rte_rcu_log_type,
+			"%s(): Triggering reclamation\n", __func__);
+		rcu_qsbr_dq_lcore_reclaim(dq, lq, dq->max_reclaim_size);
+		if (lq->head - lq->tail == dq->lcore_size)
+			return 1;
+	}
+
+	dq_elem = __RTE_RCU_QSBR_DQ_LCORE_ELEM(dq, lq, lq->head);
+	/* Start the grace period */
+	dq_elem->token = rte_rcu_qsbr_start(dq->v);
+	memcpy(dq_elem->elem, e, dq->esize - __RTE_QSBR_TOKEN_SIZE);
+	lq->head++;
+
+	rte_log(RTE_LOG_INFO, rte_rcu_log_type,
+		"%s(): Enqueued token = %" PRIu64 "\n",
+		__func__, dq_elem->token);
+
+	return 0;
+}
+
 /* Enqueue one resource to the defer queue to free after the grace
  * period is over.
  */
@@ -361,6 +474,12 @@ int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 		return 1;
 	}
 
+	/* Fall back to the shared defer queue when the per lcore one
+	 * can not be used.
+	 */
+	if (dq->lcore != NULL && rcu_qsbr_dq_lcore_enqueue(dq, e) == 0)
+		return 0;
+
 	char data[dq->esize];
 	dq_elem = (__rte_rcu_qsbr_dq_elem_t *)data;
 	/* Start the grace period */
@@ -418,8 +537,10 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 			unsigned int *freed, unsigned int *pending,
 			unsigned int *available)
 {
-	uint32_t cnt;
+	uint32_t cnt, lcore_pending, lcore_free;
 	__rte_rcu_qsbr_dq_elem_t *dq_elem;
+	struct __rte_rcu_qsbr_dq_lcore *lq;
+	unsigned int lcore_id;
 
 	if (dq == NULL || n == 0) {
 		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
@@ -430,12 +551,23 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 	}
 
 	cnt = 0;
+	lcore_pending = 0;
+	lcore_free = 0;
+
+	/* Reclaim from the defer queue of the calling lcore first */
+	lcore_id = rte_lcore_id();
+	if (dq->lcore != NULL && lcore_id < RTE_MAX_LCORE) {
+		lq = &dq->lcore[lcore_id];
+		cnt = rcu_qsbr_dq_lcore_reclaim(dq, lq, n);
+		lcore_pending = lq->head - lq->tail;
+		lcore_free = dq->lcore_size - lcore_pending;
+	}
 
 	char data[dq->esize];
 	/* Check reader threads quiescent state and reclaim resources */
 	while (cnt < n &&
 		rte_ring_dequeue_bulk_elem_start(dq->r, &data,
-					dq->esize, 1, available) != 0) { //PEEK队列数据
+					dq->esize, 1, NULL) != 0) { //PEEK队列数据
 		dq_elem = (__rte_rcu_qsbr_dq_elem_t *)data;
 
 		/* Reclaim the resource */
@@ -460,7 +592,10 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 	if (freed != NULL)
 		*freed = cnt;
 	if (pending != NULL)
-		*pending = rte_ring_count(dq->r);
+		*pending = rte_ring_count(dq->r) + lcore_pending;
+	/* The calling lcore can add resources to both defer queues */
+	if (available != NULL)
+		*available = rte_ring_free_count(dq->r) + lcore_free;
 
 	return 0;
 }
@@ -469,7 +604,9 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 int
 rte_rcu_qsbr_dq_delete(struct rte_rcu_qsbr_dq *dq)
 {
+	struct __rte_rcu_qsbr_dq_lcore *lq;
 	unsigned int pending;
+	unsigned int i;
 
 	if (dq == NULL) {
 		rte_log(RTE_LOG_DEBUG, rte_rcu_log_type,
@@ -479,13 +616,25 @@ rte_rcu_qsbr_dq_delete(struct rte_rcu_qsbr_dq *dq)
 	}
 
 	/* Reclaim all the resources */
-	rte_rcu_qsbr_dq_reclaim(dq, ~0, NULL, &pending, NULL);
+	rte_rcu_qsbr_dq_reclaim(dq, ~0, NULL, NULL, NULL);
+	pending = rte_ring_count(dq->r);
+	if (dq->lcore != NULL)
+		for (i = 0; i < RTE_MAX_LCORE; i++) {
+			lq = &dq->lcore[i];
+			rcu_qsbr_dq_lcore_reclaim(dq, lq, ~0);
+			pending += lq->head - lq->tail;
+		}
 	if (pending != 0) {
 		rte_errno = EAGAIN;
 
 		return 1;
 	}
 
+	if (dq->lcore != NULL) {
+		for (i = 0; i < RTE_MAX_LCORE; i++)
+			rte_free(dq->lcore[i].elems);
+		rte_free(dq->lcore);
+	}
 	rte_ring_free(dq->r);
 	rte_free(dq);
 
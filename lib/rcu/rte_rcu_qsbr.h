@@ -73,6 +73,15 @@ extern int rte_rcu_log_type;
 #define __RTE_QSBR_THRID_MASK 0x3f          //低6bit做偏移
 #define RTE_QSBR_THRID_INVALID 0xffffffff
 
+/* The threads sharing an element of the thread ID array form a group.
+ * The least token acked by the threads of each group in the last call to
+ * rte_rcu_qsbr_check API is stored in an array after the thread ID array,
+ * so that the groups which already acked a token are not checked again.
+ */
+#define __RTE_QSBR_GRP_ACKED_ELM(v, i) ((uint64_t *) \
+	((uint8_t *)__RTE_QSBR_THRID_ARRAY_ELM(v, 0) + \
+	__RTE_QSBR_THRID_ARRAY_SIZE(v->max_threads)) + i)
+
 /* Worker thread counter */
 struct rte_rcu_qsbr_cnt {
 	uint64_t cnt; //静默态计数
@@ -83,6 +92,10 @@ struct rte_rcu_qsbr_cnt {
 	 */
 	uint32_t lock_cnt; //加锁计数，调试使用
 	/**< Lock counter. Used when RTE_LIBRTE_RCU_DEBUG is enabled */
+	uint32_t read_nest;
+	/**< Read-side critical section nesting level, only accessed by
+	 *   the reader thread.
+	 */
 } __rte_cache_aligned;
 
 #define __RTE_QSBR_CNT_THR_OFFLINE 0
@@ -91,10 +104,11 @@ struct rte_rcu_qsbr_cnt {
 #define __RTE_QSBR_TOKEN_SIZE sizeof(uint64_t)
 
 /* RTE Quiescent State variable structure.
- * This structure has two elements that vary in size based on the
+ * This structure has three elements that vary in size based on the
  * 'max_threads' parameter.
  * 1) Quiescent state counter array
  * 2) Register thread ID array
+ * 3) Least acknowledged token array of the thread groups
  */
 struct rte_rcu_qsbr {
 	uint64_t token __rte_cache_aligned;
@@ -117,6 +131,10 @@ struct rte_rcu_qsbr {
 	/**< Registered thread IDs are stored in a bitmap array,
 	 *   after the quiescent state counter array.
 	 */
+
+	/**< Least acknowledged token of each group of 64 threads is
+	 *   stored after the registered thread ID array.
+	 */
 } __rte_cache_aligned;
 
 /**
@@ -145,6 +163,16 @@ typedef void (*rte_rcu_qsbr_free_resource_t)(void *p, void *e, unsigned int n);
  *   Set this flag if multi-thread safety is not required.
  */
 #define RTE_RCU_QSBR_DQ_MT_UNSAFE 1
+/**< Each lcore enqueues to and reclaims from its own defer queue, without
+ *   any atomic operation. The tokens of a per lcore defer queue being in
+ *   order, the resources are reclaimed in batches. The resources which do not
+ *   fit in the per lcore queue, or are enqueued by a non-EAL thread, are
+ *   stored in the shared defer queue.
+ *   The resources on the defer queue of an lcore are only reclaimed by that
+ *   lcore, or when deleting the defer queue.
+ *   This flag can not be combined with RTE_RCU_QSBR_DQ_MT_UNSAFE.
+ */
+#define RTE_RCU_QSBR_DQ_PER_LCORE 2
 
 /**
  * Parameters used when creating the defer queue.
@@ -366,6 +394,83 @@ rte_rcu_qsbr_thread_offline(struct rte_rcu_qsbr *v, unsigned int thread_id)
 		__RTE_QSBR_CNT_THR_OFFLINE, __ATOMIC_RELEASE); //记数置0
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enter a read-side critical section, epoch based.
+ *
+ * Instead of reporting its quiescent state periodically, a registered
+ * reader thread can mark the sections where it accesses the shared data
+ * structure. rte_rcu_qsbr_check API waits only for the reader threads in
+ * a critical section started before the grace period, so that the thread
+ * can block for any time outside of its critical sections without
+ * delaying the reclamation.
+ *
+ * Critical sections can be nested. A reader thread using this API must
+ * not call rte_rcu_qsbr_thread_online, rte_rcu_qsbr_thread_offline or
+ * rte_rcu_qsbr_quiescent APIs.
+ *
+ * @param v
+ *   QS variable
+ * @param thread_id
+ *   Reader thread id, registered on the QS variable
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_rcu_qsbr_read_enter(struct rte_rcu_qsbr *v, unsigned int thread_id)
+{
+	struct rte_rcu_qsbr_cnt *cnt;
+
+	RTE_ASSERT(v != NULL && thread_id < v->max_threads);
+
+	/* Only the outermost section records the epoch, the inner ones
+	 * are covered by it.
+	 */
+	cnt = &v->qsbr_cnt[thread_id];
+	if (cnt->read_nest++ != 0)
+		return;
+
+	/* Same as going online, the subsequent loads of the data structure
+	 * should not move above the store of the current token.
+	 */
+	__atomic_store_n(&cnt->cnt,
+		__atomic_load_n(&v->token, __ATOMIC_RELAXED),
+		__ATOMIC_RELAXED);
+	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Exit a read-side critical section started by rte_rcu_qsbr_read_enter.
+ *
+ * @param v
+ *   QS variable
+ * @param thread_id
+ *   Reader thread id, registered on the QS variable
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_rcu_qsbr_read_exit(struct rte_rcu_qsbr *v, unsigned int thread_id)
+{
+	struct rte_rcu_qsbr_cnt *cnt;
+
+	RTE_ASSERT(v != NULL && thread_id < v->max_threads);
+
+	cnt = &v->qsbr_cnt[thread_id];
+	RTE_ASSERT(cnt->read_nest != 0);
+	if (--cnt->read_nest != 0)
+		return;
+
+	/* The loads of the data structure can not move after the thread
+	 * is seen out of the critical section.
+	 */
+	__atomic_store_n(&cnt->cnt, __RTE_QSBR_CNT_THR_OFFLINE,
+		__ATOMIC_RELEASE);
+}
+
 /**
  * Acquire a lock for accessing a shared data structure.
  *
@@ -519,10 +624,24 @@ __rte_rcu_qsbr_check_selective(struct rte_rcu_qsbr *v, uint64_t t, bool wait)
 	uint64_t c;
 	uint64_t *reg_thread_id;
 	uint64_t acked_token = __RTE_QSBR_CNT_MAX;
+	uint64_t grp_acked_token;
 
 	for (i = 0, reg_thread_id = __RTE_QSBR_THRID_ARRAY_ELM(v, 0);
 		i < v->num_elems;
 		i++, reg_thread_id++) {
+		/* Skip the group if all its threads acknowledged this token
+		 * in a previous check.
+		 */
+		grp_acked_token = __atomic_load_n(
+					__RTE_QSBR_GRP_ACKED_ELM(v, i),
+					__ATOMIC_ACQUIRE);
+		if (grp_acked_token >= t) {
+			if (acked_token > grp_acked_token)
+				acked_token = grp_acked_token;
+			continue;
+		}
+		grp_acked_token = __RTE_QSBR_CNT_MAX;
+
 		/* Load the current registered thread bit map before
 		 * loading the reader thread quiescent state counters.
 		 */
@@ -564,11 +683,20 @@ __rte_rcu_qsbr_check_selective(struct rte_rcu_qsbr *v, uint64_t t, bool wait)
 			 * to find the least acknowledged token among all the
 			 * readers.
 			 */
-			if (c != __RTE_QSBR_CNT_THR_OFFLINE && acked_token > c)
-				acked_token = c;
+			if (c != __RTE_QSBR_CNT_THR_OFFLINE &&
+			    grp_acked_token > c)
+				grp_acked_token = c;
 
 			bmap &= ~(1UL << j);
 		}
+
+		/* All the threads of the group acknowledged this token */
+		if (grp_acked_token == __RTE_QSBR_CNT_MAX)
+			grp_acked_token = t;
+		__atomic_store_n(__RTE_QSBR_GRP_ACKED_ELM(v, i),
+			grp_acked_token, __ATOMIC_RELEASE);
+		if (acked_token > grp_acked_token)
+			acked_token = grp_acked_token;
 	}
 
 	/* All readers are checked, update least acknowledged token.
@@ -588,39 +716,69 @@ __rte_rcu_qsbr_check_selective(struct rte_rcu_qsbr *v, uint64_t t, bool wait)
 static __rte_always_inline int
 __rte_rcu_qsbr_check_all(struct rte_rcu_qsbr *v, uint64_t t, bool wait)
 {
-	uint32_t i;
+	uint32_t i, j, n;
 	struct rte_rcu_qsbr_cnt *cnt;
 	uint64_t c;
 	uint64_t acked_token = __RTE_QSBR_CNT_MAX;
+	uint64_t grp_acked_token;
 
-	for (i = 0, cnt = v->qsbr_cnt; i < v->max_threads; i++, cnt++) { //遍历所有线程
-		__RTE_RCU_DP_LOG(DEBUG,
-			"%s: check: token = %" PRIu64 ", wait = %d, Thread ID = %d",
-			__func__, t, wait, i);
-		while (1) {
-			c = __atomic_load_n(&cnt->cnt, __ATOMIC_ACQUIRE); //读取计数
+	for (i = 0; i < v->num_elems; i++) {
+		/* Skip the group if all its threads acknowledged this token
+		 * in a previous check.
+		 */
+		grp_acked_token = __atomic_load_n(
+					__RTE_QSBR_GRP_ACKED_ELM(v, i),
+					__ATOMIC_ACQUIRE);
+		if (grp_acked_token >= t) {
+			if (acked_token > grp_acked_token)
+				acked_token = grp_acked_token;
+			continue;
+		}
+		grp_acked_token = __RTE_QSBR_CNT_MAX;
+
+		j = i << __RTE_QSBR_THRID_INDEX_SHIFT;
+		n = RTE_MIN(j + __RTE_QSBR_THRID_ARRAY_ELM_SIZE,
+			    v->max_threads);
+		for (cnt = &v->qsbr_cnt[j]; j < n; j++, cnt++) { //遍历组内线程
 			__RTE_RCU_DP_LOG(DEBUG,
-				"%s: status: token = %" PRIu64 ", wait = %d, Thread QS cnt = %" PRIu64 ", Thread ID = %d",
-				__func__, t, wait, c, i);
+				"%s: check: token = %" PRIu64 ", wait = %d, Thread ID = %d",
+				__func__, t, wait, j);
+			while (1) {
+				c = __atomic_load_n(&cnt->cnt, __ATOMIC_ACQUIRE); //读取计数
+				__RTE_RCU_DP_LOG(DEBUG,
+					"%s: status: token = %" PRIu64 ", wait = %d, Thread QS cnt = %" PRIu64 ", Thread ID = %d",
+					__func__, t, wait, c, j);
+
+				/* Counter is not checked for wrap-around
+				 * condition as it is a 64b counter.
+				 */
+				if (likely(c == __RTE_QSBR_CNT_THR_OFFLINE ||
+					   c >= t))
+					break;
 
-			/* Counter is not checked for wrap-around condition
-			 * as it is a 64b counter.
-			 */
-			if (likely(c == __RTE_QSBR_CNT_THR_OFFLINE || c >= t))
-				break;
+				/* This thread is not in quiescent state */
+				if (!wait) //不等待直接返回
+					return 0;
 
-			/* This thread is not in quiescent state */
-			if (!wait) //不等待直接返回
-				return 0;
+				rte_pause();
+			}
 
-			rte_pause();
+			/* This thread is in quiescent state. Use the counter
+			 * to find the least acknowledged token among all the
+			 * readers of the group.
+			 */
+			if (likely(c != __RTE_QSBR_CNT_THR_OFFLINE &&
+				   grp_acked_token > c))
+				grp_acked_token = c;
 		}
 
-		/* This thread is in quiescent state. Use the counter to find
-		 * the least acknowledged token among all the readers.
-		 */
-		if (likely(c != __RTE_QSBR_CNT_THR_OFFLINE && acked_token > c))
-			acked_token = c;
+		/* All the threads of the group acknowledged this token */
+		if (grp_acked_token == __RTE_QSBR_CNT_MAX)
+			grp_acked_token = t;
+		__atomic_store_n(__RTE_QSBR_GRP_ACKED_ELM(v, i),
+			grp_acked_token, __ATOMIC_RELEASE);
+		if (acked_token > grp_acked_token)
+			acked_token = grp_acked_token;
 	}
 
 	/* All readers are checked, update least acknowledged token.
@@ -788,6 +946,9 @@ rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e);
  * Free resources from the defer queue.
  *
  * This API is multi-thread safe.
+ * When the defer queue is configured with RTE_RCU_QSBR_DQ_PER_LCORE, the
+ * resources of the per lcore defer queue of the calling lcore are freed
+ * first, then the resources of the shared defer queue.
  *
  * @param dq
  *   Defer queue to free an entry from.
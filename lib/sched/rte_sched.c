@@ -33,6 +33,7 @@
 #define RTE_SCHED_GRINDER_PCACHE_SIZE         (64 / RTE_SCHED_QUEUES_PER_PIPE)
 #define RTE_SCHED_PIPE_INVALID                UINT32_MAX
 #define RTE_SCHED_BMP_POS_INVALID             UINT32_MAX
+#define RTE_SCHED_ENQUEUE_RINGS_BURST         64u
 
 /* Scaling for cycles_per_byte calculation
  * Chosen so that minimum rate is 480 bit/sec
@@ -74,6 +75,15 @@ struct rte_sched_pipe {
 	uint8_t tc_ov_period_id;
 } __rte_cache_aligned;
 
+struct rte_sched_pipe_group {
+	/* Token bucket (TB) */
+	uint64_t tb_time; /* time of last update */
+	uint64_t tb_credits;
+	uint64_t tb_period;
+	uint64_t tb_credits_per_period;
+	uint64_t tb_size;
+} __rte_cache_aligned;
+
 struct rte_sched_queue {
 	uint16_t qw;
 	uint16_t qr;
@@ -120,6 +130,7 @@ struct rte_sched_grinder {
 	struct rte_sched_subport_profile *subport_params;
 	struct rte_sched_pipe *pipe;
 	struct rte_sched_pipe_profile *pipe_params;
+	struct rte_sched_pipe_group *group;
 
 	/* TC cache */
 	uint8_t tccache_qmask[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
@@ -205,6 +216,11 @@ struct rte_sched_subport {
 	/* TC oversubscription activation */
 	int tc_ov_enabled;
 
+	/* Pipe groups, NULL when the pipe group level is not enabled */
+	struct rte_sched_pipe_group *pipe_group;
+	uint32_t n_pipe_groups;
+	uint32_t n_pipes_per_group_log2;
+
 	struct rte_sched_pipe *pipe;
 	struct rte_sched_queue *queue;
 	struct rte_sched_queue_extra *queue_extra;
@@ -214,6 +230,18 @@ struct rte_sched_subport {
 	uint8_t memory[0] __rte_cache_aligned;
 } __rte_cache_aligned;
 
+struct rte_sched_port_share {
+	/* Written by all the attached ports */
+	uint64_t time_cpu_cycles;     /* Time of the last budget update */
+	uint64_t credits;             /* Credits available to the ports */
+
+	/* Read-only */
+	uint64_t tb_size;
+	uint64_t n_credits_per_grant;
+	struct rte_reciprocal inv_cycles_per_byte; /* CPU cycles per byte */
+	uint64_t cycles_per_byte;
+} __rte_cache_aligned;
+
 struct rte_sched_port {
 	/* User parameters */
 	uint32_t n_subports_per_port;
@@ -236,6 +264,10 @@ struct rte_sched_port {
 	struct rte_reciprocal inv_cycles_per_byte; /* CPU cycles per byte */
 	uint64_t cycles_per_byte;
 
+	/* Shared rate budget */
+	struct rte_sched_port_share *share;
+	int64_t credits;              /* Credits left from the shared budget */
+
 	/* Grinders */
 	struct rte_mbuf **pkts_out;
 	uint32_t n_pkts_out;
@@ -1002,6 +1034,8 @@ rte_sched_port_config(struct rte_sched_port_params *params)
 	port->time_cpu_cycles = rte_get_tsc_cycles();
 	port->time_cpu_bytes = 0;
 	port->time = 0;
+	port->share = NULL;
+	port->credits = INT64_MAX;
 
 	/* Subport profile table */
 	rte_sched_port_config_subport_profile_table(port, params, port->rate);
@@ -1046,6 +1080,7 @@ rte_sched_subport_free(struct rte_sched_port *port,
 		}
 	}
 
+	rte_free(subport->pipe_group);
 	rte_free(subport);
 }
 
@@ -1187,6 +1222,209 @@ rte_sched_subport_tc_ov_config(struct rte_sched_port *port,
 	return 0;
 }
 
+int
+rte_sched_subport_pipe_group_config(struct rte_sched_port *port,
+	uint32_t subport_id,
+	uint32_t n_pipes_per_group)
+{
+	struct rte_sched_subport *s;
+	uint32_t n_pipe_groups, i;
+
+	if (port == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter port\n", __func__);
+		return -EINVAL;
+	}
+
+	if (subport_id >= port->n_subports_per_port ||
+	    port->subports[subport_id] == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter subport id\n", __func__);
+		return -EINVAL;
+	}
+
+	s = port->subports[subport_id];
+
+	if (n_pipes_per_group == 0 || !rte_is_power_of_2(n_pipes_per_group) ||
+	    n_pipes_per_group > s->n_pipes_per_subport_enabled) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter n_pipes_per_group\n", __func__);
+		return -EINVAL;
+	}
+
+	if (s->pipe_group != NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Pipe groups already configured for subport\n", __func__);
+		return -EBUSY;
+	}
+
+	n_pipe_groups = (s->n_pipes_per_subport_enabled + n_pipes_per_group - 1) /
+		n_pipes_per_group;
+
+	s->pipe_group = rte_zmalloc_socket("subport_pipe_group",
+		n_pipe_groups * sizeof(struct rte_sched_pipe_group),
+		RTE_CACHE_LINE_SIZE, port->socket);
+	if (s->pipe_group == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Memory allocation fails\n", __func__);
+		return -ENOMEM;
+	}
+
+	/* Pipe groups are not rate limited until configured */
+	for (i = 0; i < n_pipe_groups; i++) {
+		struct rte_sched_pipe_group *g = s->pipe_group + i;
+
+		g->tb_time = port->time;
+		g->tb_period = 1;
+		g->tb_credits_per_period = 1;
+		g->tb_size = UINT32_MAX;
+		g->tb_credits = g->tb_size;
+	}
+
+	s->n_pipe_groups = n_pipe_groups;
+	s->n_pipes_per_group_log2 = __builtin_ctz(n_pipes_per_group);
+
+	return 0;
+}
+
+int
+rte_sched_pipe_group_config(struct rte_sched_port *port,
+	uint32_t subport_id,
+	uint32_t group_id,
+	struct rte_sched_pipe_group_params *params)
+{
+	struct rte_sched_subport *s;
+	struct rte_sched_pipe_group *g;
+
+	if (port == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter port\n", __func__);
+		return -EINVAL;
+	}
+
+	if (subport_id >= port->n_subports_per_port ||
+	    port->subports[subport_id] == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter subport id\n", __func__);
+		return -EINVAL;
+	}
+
+	s = port->subports[subport_id];
+	if (s->pipe_group == NULL || group_id >= s->n_pipe_groups) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter group id\n", __func__);
+		return -EINVAL;
+	}
+
+	if (params == NULL || params->tb_rate == 0 ||
+	    params->tb_rate > port->rate || params->tb_size == 0) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter params\n", __func__);
+		return -EINVAL;
+	}
+
+	g = s->pipe_group + group_id;
+
+	/* Token Bucket */
+	if (params->tb_rate == port->rate) {
+		g->tb_credits_per_period = 1;
+		g->tb_period = 1;
+	} else {
+		double tb_rate = (double)params->tb_rate / (double)port->rate;
+		double d = RTE_SCHED_TB_RATE_CONFIG_ERR;
+
+		rte_approx_64(tb_rate, d, &g->tb_credits_per_period,
+			&g->tb_period);
+	}
+
+	g->tb_size = params->tb_size;
+	g->tb_time = port->time;
+	g->tb_credits = g->tb_size / 2;
+
+	return 0;
+}
+
+struct rte_sched_port_share *
+rte_sched_port_share_create(struct rte_sched_port_share_params *params)
+{
+	struct rte_sched_port_share *share;
+	uint64_t cycles_per_byte;
+
+	if (params == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter params\n", __func__);
+		return NULL;
+	}
+
+	if (params->rate == 0 || params->tb_size == 0 ||
+	    params->n_credits_per_grant == 0 ||
+	    params->n_credits_per_grant > params->tb_size) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for rate, tb_size or n_credits_per_grant\n",
+			__func__);
+		return NULL;
+	}
+
+	if (params->socket < 0) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for socket id\n", __func__);
+		return NULL;
+	}
+
+	share = rte_zmalloc_socket("sched_port_share", sizeof(*share),
+		RTE_CACHE_LINE_SIZE, params->socket);
+	if (share == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Memory allocation fails\n", __func__);
+		return NULL;
+	}
+
+	cycles_per_byte = (rte_get_tsc_hz() << RTE_SCHED_TIME_SHIFT)
+		/ params->rate;
+	share->inv_cycles_per_byte = rte_reciprocal_value(cycles_per_byte);
+	share->cycles_per_byte = cycles_per_byte;
+	share->tb_size = params->tb_size;
+	share->n_credits_per_grant = params->n_credits_per_grant;
+	share->credits = params->tb_size;
+	share->time_cpu_cycles = rte_get_tsc_cycles();
+
+	return share;
+}
+
+void
+rte_sched_port_share_free(struct rte_sched_port_share *share)
+{
+	rte_free(share);
+}
+
+int
+rte_sched_port_share_attach(struct rte_sched_port *port,
+	struct rte_sched_port_share *share)
+{
+	if (port == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter port\n", __func__);
+		return -EINVAL;
+	}
+
+	if (share == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter share\n", __func__);
+		return -EINVAL;
+	}
+
+	if (port->share != NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Port already attached to a shared budget\n", __func__);
+		return -EBUSY;
+	}
+
+	port->share = share;
+	port->credits = 0;
+
+	return 0;
+}
+
 int
 rte_sched_subport_config(struct rte_sched_port *port,
 	uint32_t subport_id,
@@ -2242,6 +2480,30 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts,
 	return result;
 }
 
+int
+rte_sched_port_enqueue_rings(struct rte_sched_port *port,
+	struct rte_ring **rings,
+	uint32_t n_rings,
+	uint32_t n_pkts)
+{
+	struct rte_mbuf *pkts[RTE_SCHED_ENQUEUE_RINGS_BURST];
+	uint32_t i, n, n_left;
+	int count = 0;
+
+	for (i = 0; i < n_rings; i++)
+		for (n_left = n_pkts; n_left > 0; n_left -= n) {
+			n = rte_ring_sc_dequeue_burst(rings[i], (void **)pkts,
+				RTE_MIN(n_left, RTE_SCHED_ENQUEUE_RINGS_BURST),
+				NULL);
+			if (n == 0)
+				break;
+
+			count += rte_sched_port_enqueue(port, pkts, n);
+		}
+
+	return count;
+}
+
 static inline uint64_t
 grinder_tc_ov_credits_update(struct rte_sched_port *port,
 	struct rte_sched_subport *subport, uint32_t pos)
@@ -2286,6 +2548,18 @@ grinder_tc_ov_credits_update(struct rte_sched_port *port,
 	return tc_ov_wm;
 }
 
+static inline void
+grinder_group_credits_update(struct rte_sched_port *port,
+	struct rte_sched_pipe_group *group)
+{
+	uint64_t n_periods;
+
+	n_periods = (port->time - group->tb_time) / group->tb_period;
+	group->tb_credits += n_periods * group->tb_credits_per_period;
+	group->tb_credits = RTE_MIN(group->tb_credits, group->tb_size);
+	group->tb_time += n_periods * group->tb_period;
+}
+
 static inline void
 grinder_credits_update(struct rte_sched_port *port,
 	struct rte_sched_subport *subport, uint32_t pos)
@@ -2309,6 +2583,10 @@ grinder_credits_update(struct rte_sched_port *port,
 	pipe->tb_credits = RTE_MIN(pipe->tb_credits, params->tb_size);
 	pipe->tb_time += n_periods * params->tb_period;
 
+	/* Pipe group TB */
+	if (grinder->group)
+		grinder_group_credits_update(port, grinder->group);
+
 	/* Subport TCs */
 	if (unlikely(port->time >= subport->tc_time)) {
 		for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
@@ -2348,6 +2626,10 @@ grinder_credits_update_with_tc_ov(struct rte_sched_port *port,
 	pipe->tb_credits = RTE_MIN(pipe->tb_credits, params->tb_size);
 	pipe->tb_time += n_periods * params->tb_period;
 
+	/* Pipe group TB */
+	if (grinder->group)
+		grinder_group_credits_update(port, grinder->group);
+
 	/* Subport TCs */
 	if (unlikely(port->time >= subport->tc_time)) {
 		subport->tc_ov_wm =
@@ -2388,22 +2670,27 @@ grinder_credits_check(struct rte_sched_port *port,
 	uint64_t subport_tc_credits = subport->tc_credits[tc_index];
 	uint64_t pipe_tb_credits = pipe->tb_credits;
 	uint64_t pipe_tc_credits = pipe->tc_credits[tc_index];
+	uint64_t group_tb_credits = grinder->group ?
+		grinder->group->tb_credits : UINT64_MAX;
 	int enough_credits;
 
-	/* Check pipe and subport credits */
+	/* Check pipe, pipe group and subport credits */
 	enough_credits = (pkt_len <= subport_tb_credits) &&
 		(pkt_len <= subport_tc_credits) &&
 		(pkt_len <= pipe_tb_credits) &&
-		(pkt_len <= pipe_tc_credits);
+		(pkt_len <= pipe_tc_credits) &&
+		(pkt_len <= group_tb_credits);
 
 	if (!enough_credits)
 		return 0;
 
-	/* Update pipe and subport credits */
+	/* Update pipe, pipe group and subport credits */
 	subport->tb_credits -= pkt_len;
 	subport->tc_credits[tc_index] -= pkt_len;
 	pipe->tb_credits -= pkt_len;
 	pipe->tc_credits[tc_index] -= pkt_len;
+	if (grinder->group)
+		grinder->group->tb_credits -= pkt_len;
 
 	return 1;
 }
@@ -2421,6 +2708,8 @@ grinder_credits_check_with_tc_ov(struct rte_sched_port *port,
 	uint64_t subport_tc_credits = subport->tc_credits[tc_index];
 	uint64_t pipe_tb_credits = pipe->tb_credits;
 	uint64_t pipe_tc_credits = pipe->tc_credits[tc_index];
+	uint64_t group_tb_credits = grinder->group ?
+		grinder->group->tb_credits : UINT64_MAX;
 	uint64_t pipe_tc_ov_mask1[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 	uint64_t pipe_tc_ov_mask2[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE] = {0};
 	uint64_t pipe_tc_ov_credits;
@@ -2434,21 +2723,24 @@ grinder_credits_check_with_tc_ov(struct rte_sched_port *port,
 	pipe_tc_ov_mask2[RTE_SCHED_TRAFFIC_CLASS_BE] = ~0LLU;
 	pipe_tc_ov_credits = pipe_tc_ov_mask1[tc_index];
 
-	/* Check pipe and subport credits */
+	/* Check pipe, pipe group and subport credits */
 	enough_credits = (pkt_len <= subport_tb_credits) &&
 		(pkt_len <= subport_tc_credits) &&
 		(pkt_len <= pipe_tb_credits) &&
 		(pkt_len <= pipe_tc_credits) &&
+		(pkt_len <= group_tb_credits) &&
 		(pkt_len <= pipe_tc_ov_credits);
 
 	if (!enough_credits)
 		return 0;
 
-	/* Update pipe and subport credits */
+	/* Update pipe, pipe group and subport credits */
 	subport->tb_credits -= pkt_len;
 	subport->tc_credits[tc_index] -= pkt_len;
 	pipe->tb_credits -= pkt_len;
 	pipe->tc_credits[tc_index] -= pkt_len;
+	if (grinder->group)
+		grinder->group->tb_credits -= pkt_len;
 	pipe->tc_ov_credits -= pipe_tc_ov_mask2[tc_index] & pkt_len;
 
 	return 1;
@@ -2476,6 +2768,7 @@ grinder_schedule(struct rte_sched_port *port,
 
 	/* Advance port time */
 	port->time += pkt_len;
+	port->credits -= pkt_len;
 
 	/* Send packet */
 	port->pkts_out[port->n_pkts_out++] = pkt;
@@ -2664,6 +2957,8 @@ grinder_next_pipe(struct rte_sched_port *port,
 	grinder->subport = subport;
 	grinder->pipe = subport->pipe + grinder->pindex;
 	grinder->pipe_params = NULL; /* to be set after the pipe structure is prefetched */
+	grinder->group = subport->pipe_group ? subport->pipe_group +
+		(grinder->pindex >> subport->n_pipes_per_group_log2) : NULL;
 	grinder->productive = 0;
 
 	grinder_tccache_populate(subport, pos, pipe_qindex, pipe_qmask);
@@ -2757,6 +3052,8 @@ grinder_prefetch_pipe(struct rte_sched_subport *subport, uint32_t pos)
 
 	rte_prefetch0(grinder->pipe);
 	rte_prefetch0(grinder->queue[0]);
+	if (grinder->group)
+		rte_prefetch0(grinder->group);
 }
 
 static inline void
@@ -2940,6 +3237,80 @@ rte_sched_port_time_resync(struct rte_sched_port *port)
 		port->subports[i]->pipe_loop = RTE_SCHED_PIPE_INVALID;
 }
 
+/*
+ * Add the credits accumulated since the last update to the shared budget. The
+ * update is done by whichever attached port wins the race on the update time,
+ * so the elapsed time is converted into credits exactly once.
+ */
+static inline void
+rte_sched_port_share_update(struct rte_sched_port_share *share)
+{
+	uint64_t cycles = rte_get_tsc_cycles();
+	uint64_t time_cpu_cycles, cycles_diff, bytes_diff, credits, n;
+
+	time_cpu_cycles = __atomic_load_n(&share->time_cpu_cycles,
+		__ATOMIC_RELAXED);
+	if (cycles <= time_cpu_cycles)
+		return;
+
+	cycles_diff = cycles - time_cpu_cycles;
+	bytes_diff = rte_reciprocal_divide(cycles_diff << RTE_SCHED_TIME_SHIFT,
+					   share->inv_cycles_per_byte);
+	if (bytes_diff == 0)
+		return;
+
+	if (!__atomic_compare_exchange_n(&share->time_cpu_cycles,
+			&time_cpu_cycles, time_cpu_cycles +
+			((bytes_diff * share->cycles_per_byte) >> RTE_SCHED_TIME_SHIFT),
+			0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		return;
+
+	credits = __atomic_load_n(&share->credits, __ATOMIC_RELAXED);
+	do {
+		n = RTE_MIN(credits + bytes_diff, share->tb_size);
+	} while (!__atomic_compare_exchange_n(&share->credits, &credits, n,
+			0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/* Take up to one grant of credits from the shared budget */
+static inline uint64_t
+rte_sched_port_share_grant(struct rte_sched_port_share *share)
+{
+	uint64_t credits, n;
+
+	credits = __atomic_load_n(&share->credits, __ATOMIC_RELAXED);
+	do {
+		n = RTE_MIN(credits, share->n_credits_per_grant);
+		if (n == 0)
+			return 0;
+	} while (!__atomic_compare_exchange_n(&share->credits, &credits,
+			credits - n, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	return n;
+}
+
+/*
+ * Refill the port credits from the shared budget, if any. A port not attached
+ * to a shared budget is only limited by its own hierarchy.
+ */
+static inline int
+rte_sched_port_credits_refill(struct rte_sched_port *port)
+{
+	struct rte_sched_port_share *share = port->share;
+
+	if (likely(share == NULL)) {
+		port->credits = INT64_MAX;
+		return 1;
+	}
+
+	if (port->credits < (int64_t)port->mtu) {
+		rte_sched_port_share_update(share);
+		port->credits += rte_sched_port_share_grant(share);
+	}
+
+	return port->credits > 0;
+}
+
 static inline int
 rte_sched_port_exceptions(struct rte_sched_subport *subport, int second_pass)
 {
@@ -2967,6 +3338,10 @@ rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
 
 	rte_sched_port_time_resync(port);
 
+	/* Nothing can be sent until credits are granted by the shared budget */
+	if (!rte_sched_port_credits_refill(port))
+		return 0;
+
 	/* Take each queue in the grinder one step further */
 	for (i = 0, count = 0; ; i++)  {
 		subport = port->subports[subport_id];
@@ -2974,7 +3349,7 @@ rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
 		count += grinder_handle(port, subport,
 				i & (RTE_SCHED_PORT_N_GRINDERS - 1));
 
-		if (count == n_pkts) {
+		if (count == n_pkts || port->credits <= 0) {
 			subport_id++;
 
 			if (subport_id == port->n_subports_per_port)
@@ -38,6 +38,8 @@ extern "C" {
  *             impact to low demand pipes;
  *     3. Pipe:
  *           - Typical usage: individual user/subscriber;
+ *           - Optionally grouped with consecutive pipes of the same
+ *	    subport into a pipe group shaped by its own token bucket;
  *           - Traffic shaping using the token bucket algorithm
  *	    (one bucket per pipe);
  *     4. Traffic class:
@@ -58,6 +60,7 @@ extern "C" {
 #include <rte_compat.h>
 #include <rte_mbuf.h>
 #include <rte_meter.h>
+#include <rte_ring.h>
 
 /** Congestion Management */
 #include "rte_red.h"
@@ -230,6 +233,40 @@ struct rte_sched_subport_profile_params {
 	uint64_t tc_period;
 };
 
+/**
+ * Pipe group configuration parameters. A pipe group is an optional level of
+ * the hierarchy between the subport and its pipes, made of consecutive pipes
+ * of the same subport, with its own token bucket. Typical usage is to shape a
+ * household on top of the pipes shaping its individual services.
+ */
+struct rte_sched_pipe_group_params {
+	/** Token bucket rate (measured in bytes per second) */
+	uint64_t tb_rate;
+
+	/** Token bucket size (measured in credits) */
+	uint64_t tb_size;
+};
+
+/**
+ * Shared port rate budget parameters. A shared rate budget lets several port
+ * scheduler instances, each running on its own core and owning a subset of
+ * the subports of the same output port, collectively stay within the output
+ * port rate.
+ */
+struct rte_sched_port_share_params {
+	/** Aggregate rate of all the attached ports (measured in bytes per second) */
+	uint64_t rate;
+
+	/** Maximum number of unused credits accumulated by the budget */
+	uint64_t tb_size;
+
+	/** Number of credits an attached port takes from the budget at once */
+	uint32_t n_credits_per_grant;
+
+	/** NUMA socket to allocate the budget on */
+	int socket;
+};
+
 /** Subport statistics */
 struct rte_sched_subport_stats {
 	/** Number of packets successfully written */
@@ -596,6 +633,138 @@ __rte_experimental
 int
 rte_sched_subport_tc_ov_config(struct rte_sched_port *port, uint32_t subport_id, bool tc_ov_enable);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler subport pipe group level enable.
+ * The subport pipes are split into groups of *n_pipes_per_group* consecutive
+ * pipes, with pipe group *i* made of pipes *i * n_pipes_per_group* to
+ * *(i + 1) * n_pipes_per_group - 1*. The pipe groups are not rate limited
+ * until configured with rte_sched_pipe_group_config().
+ * This function should be called once, after the subport configuration.
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param subport_id
+ *   Subport ID
+ * @param n_pipes_per_group
+ *   Number of pipes per group, needs to be a power of 2
+ * @return
+ *   0 upon success, error code otherwise
+ */
+__rte_experimental
+int
+rte_sched_subport_pipe_group_config(struct rte_sched_port *port,
+	uint32_t subport_id,
+	uint32_t n_pipes_per_group);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler pipe group configuration
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param subport_id
+ *   Subport ID
+ * @param group_id
+ *   Pipe group ID within the subport
+ * @param params
+ *   Pipe group configuration parameters
+ * @return
+ *   0 upon success, error code otherwise
+ */
+__rte_experimental
+int
+rte_sched_pipe_group_config(struct rte_sched_port *port,
+	uint32_t subport_id,
+	uint32_t group_id,
+	struct rte_sched_pipe_group_params *params);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler shared port rate budget create
+ *
+ * @param params
+ *   Shared rate budget parameters
+ * @return
+ *   Handle to the shared rate budget upon success, NULL otherwise
+ */
+__rte_experimental
+struct rte_sched_port_share *
+rte_sched_port_share_create(struct rte_sched_port_share_params *params);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler shared port rate budget free. The ports attached to
+ * it need to be freed first.
+ *
+ * @param share
+ *   Handle to the shared rate budget
+ */
+__rte_experimental
+void
+rte_sched_port_share_free(struct rte_sched_port_share *share);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler port attach to a shared rate budget. Once attached,
+ * the port only sends as many bytes as it was granted from the shared budget,
+ * so the ports sharing the budget can be dequeued from different cores
+ * without exceeding the output port rate. Each port keeps its own subports,
+ * hence the subports of the output port are partitioned among the attached
+ * ports by the application.
+ * This function should be called before the first dequeue from the port.
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param share
+ *   Handle to the shared rate budget
+ * @return
+ *   0 upon success, error code otherwise
+ */
+__rte_experimental
+int
+rte_sched_port_share_attach(struct rte_sched_port *port,
+	struct rte_sched_port_share *share);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler port enqueue from a set of rings. Each ring is meant
+ * to be written by a single producer core, e.g. an RX core, using the single
+ * producer ring API, so several cores can feed the same port without locking
+ * while the port itself is only accessed by the core calling this function.
+ * The packets that do not fit the hierarchy queues are dropped, as with
+ * rte_sched_port_enqueue().
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param rings
+ *   Array of rings to read the packets from
+ * @param n_rings
+ *   Number of rings
+ * @param n_pkts
+ *   Maximum number of packets read from each ring
+ * @return
+ *   Number of packets successfully enqueued
+ */
+__rte_experimental
+int
+rte_sched_port_enqueue_rings(struct rte_sched_port *port,
+	struct rte_ring **rings,
+	uint32_t n_rings,
+	uint32_t n_pkts);
+
 #ifdef __cplusplus
 }
 #endif
@@ -47,6 +47,36 @@ struct rte_stack_lf_list {
 	uint64_t len;
 };
 
+/** Number of slots in the elimination array of a lock-free stack. */
+#define RTE_STACK_LF_ELIM_SLOTS 8
+/** Maximum number of objects of a push going through the elimination array. */
+#define RTE_STACK_LF_ELIM_MAX_OBJS 32
+
+/* Elimination slot through which a push hands its objects over to a
+ * concurrent pop of the same size, without going through the list head.
+ */
+struct rte_stack_lf_elim_slot {
+	/** Offer sequence number (upper bits) and slot state (lower bits) */
+	uint64_t state;
+	/** Number of objects offered */
+	unsigned int n;
+	/** Objects offered by the push, copied so that it does not wait for
+	 * the pop to read them
+	 */
+	void *objs[RTE_STACK_LF_ELIM_MAX_OBJS];
+} __rte_cache_aligned;
+
+/* Elimination array, used when the stack is created with RTE_STACK_F_LF_ELIM.
+ */
+struct rte_stack_lf_elim {
+	/** Bitmap of the slots currently holding an offer */
+	uint64_t offers __rte_cache_aligned;
+	/** Per lcore flag, set when its last push contended on the head */
+	uint8_t contended[RTE_MAX_LCORE] __rte_cache_aligned;
+	/** Elimination slots */
+	struct rte_stack_lf_elim_slot slots[RTE_STACK_LF_ELIM_SLOTS];
+};
+
 /* Structure containing two lock-free LIFO lists: the stack itself and a list
  * of free linked-list elements.
  */
@@ -55,6 +85,8 @@ struct rte_stack_lf {
 	struct rte_stack_lf_list used __rte_cache_aligned;
 	/** LIFO list of free elements */
 	struct rte_stack_lf_list free __rte_cache_aligned;
+	/** Elimination array, NULL if not enabled */
+	struct rte_stack_lf_elim *elim;
 	/** LIFO elements */
 	struct rte_stack_lf_elem elems[] __rte_cache_aligned;
 };
@@ -91,6 +123,15 @@ struct rte_stack {
  */
 #define RTE_STACK_F_LF 0x0001
 
+/**
+ * The lock-free stack pairs concurrent push and pop operations of the same
+ * size through an elimination array, instead of having both contend on the
+ * list head. Pushes only use the array after contending on the head, and for
+ * up to RTE_STACK_LF_ELIM_MAX_OBJS objects, so an uncontended stack behaves as
+ * with RTE_STACK_F_LF alone. Requires RTE_STACK_F_LF.
+ */
+#define RTE_STACK_F_LF_ELIM 0x0002
+
 #include "rte_stack_std.h"
 #include "rte_stack_lf.h"
 
@@ -196,6 +237,9 @@ rte_stack_free_count(struct rte_stack *s)
  *    - RTE_STACK_F_LF: If this flag is set, the stack uses lock-free
  *      variants of the push and pop functions. Otherwise, it achieves
  *      thread-safety using a lock.
+ *    - RTE_STACK_F_LF_ELIM: If this flag is set along with RTE_STACK_F_LF,
+ *      push and pop operations contending on the lock-free stack are paired
+ *      through an elimination array.
  * @return
  *   On success, the pointer to the new allocated stack. NULL on error with
  *    rte_errno set appropriately. Possible errno values include:
@@ -203,6 +247,7 @@ rte_stack_free_count(struct rte_stack *s)
  *    - EEXIST - a stack with the same name already exists
  *    - ENOMEM - insufficient memory to create the stack
  *    - ENAMETOOLONG - name size exceeds RTE_STACK_NAMESIZE
+ *    - EINVAL - RTE_STACK_F_LF_ELIM is set without RTE_STACK_F_LF
  *    - ENOTSUP - platform does not support given flags combination.
  */
 struct rte_stack *
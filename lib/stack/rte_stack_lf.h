@@ -5,6 +5,9 @@
 #ifndef _RTE_STACK_LF_H_
 #define _RTE_STACK_LF_H_
 
+#include <rte_lcore.h>
+#include <rte_pause.h>
+
 #if !(defined(RTE_ARCH_X86_64) || defined(RTE_ARCH_ARM64))
 #include "rte_stack_lf_stubs.h"
 #else
@@ -20,6 +23,167 @@
 #define RTE_STACK_LF_SUPPORTED
 #endif
 
+/* Elimination slot states, stored in the low bits of the slot state word.
+ * The upper bits hold a sequence number incremented on every offer, so a
+ * pop never takes an offer other than the one it has validated.
+ */
+#define __RTE_STACK_LF_ELIM_EMPTY 0 /* Free for a new offer */
+#define __RTE_STACK_LF_ELIM_OFFER 1 /* Offer published by a push */
+#define __RTE_STACK_LF_ELIM_TAKEN 2 /* Offer being copied out by a pop */
+#define __RTE_STACK_LF_ELIM_BUSY 3 /* Offer being copied in by a push */
+#define __RTE_STACK_LF_ELIM_MASK 3
+#define __RTE_STACK_LF_ELIM_SEQ_INC 4
+
+/* Number of pause iterations a push waits for a pop to take its offer */
+#define __RTE_STACK_LF_ELIM_SPINS 64
+
+/**
+ * @internal Offer objects to a concurrent pop through the elimination array.
+ *
+ * The objects are copied to the slot, so the push is done as soon as a pop
+ * takes the offer, without waiting for the pop to read them.
+ *
+ * @param elim
+ *   A pointer to the elimination array.
+ * @param lcore_id
+ *   The calling lcore.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to offer.
+ * @return
+ *   1 if a pop took the objects, 0 if they still have to be pushed.
+ */
+static __rte_always_inline int
+__rte_stack_lf_elim_push(struct rte_stack_lf_elim *elim,
+			 unsigned int lcore_id,
+			 void * const *obj_table,
+			 unsigned int n)
+{
+	unsigned int idx = lcore_id % RTE_STACK_LF_ELIM_SLOTS;
+	struct rte_stack_lf_elim_slot *slot = &elim->slots[idx];
+	uint64_t state, offer;
+	unsigned int i;
+
+	if (n > RTE_STACK_LF_ELIM_MAX_OBJS)
+		return 0;
+
+	state = __atomic_load_n(&slot->state, __ATOMIC_RELAXED);
+	if ((state & __RTE_STACK_LF_ELIM_MASK) != __RTE_STACK_LF_ELIM_EMPTY)
+		return 0;
+
+	/* Claim the slot, then publish the offer with release semantics so
+	 * that a pop taking it observes the objects.
+	 */
+	if (!__atomic_compare_exchange_n(&slot->state, &state,
+			state | __RTE_STACK_LF_ELIM_BUSY, 0,
+			__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		return 0;
+
+	for (i = 0; i < n; i++)
+		slot->objs[i] = obj_table[i];
+	__atomic_store_n(&slot->n, n, __ATOMIC_RELAXED);
+	offer = (state + __RTE_STACK_LF_ELIM_SEQ_INC) |
+		__RTE_STACK_LF_ELIM_OFFER;
+	__atomic_store_n(&slot->state, offer, __ATOMIC_RELEASE);
+	__atomic_fetch_or(&elim->offers, 1ULL << idx, __ATOMIC_RELEASE);
+
+	for (i = 0; i < __RTE_STACK_LF_ELIM_SPINS; i++) {
+		if (__atomic_load_n(&slot->state, __ATOMIC_RELAXED) != offer)
+			break;
+		rte_pause();
+	}
+
+	if (i == __RTE_STACK_LF_ELIM_SPINS) {
+		/* Withdraw the offer, unless a pop takes it meanwhile */
+		__atomic_fetch_and(&elim->offers, ~(1ULL << idx),
+				   __ATOMIC_RELAXED);
+		state = offer;
+		if (__atomic_compare_exchange_n(&slot->state, &state,
+				offer & ~(uint64_t)__RTE_STACK_LF_ELIM_MASK, 0,
+				__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			return 0;
+	}
+
+	/* The objects were taken, the pop releases the slot once it copied
+	 * them out.
+	 */
+	return 1;
+}
+
+/**
+ * @internal Take objects offered by a concurrent push through the
+ * elimination array.
+ *
+ * @param elim
+ *   A pointer to the elimination array.
+ * @param lcore_id
+ *   The calling lcore, used to spread the slots scan.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to pull.
+ * @return
+ *   1 if an offer of n objects was taken, 0 otherwise.
+ */
+static __rte_always_inline int
+__rte_stack_lf_elim_pop(struct rte_stack_lf_elim *elim,
+			unsigned int lcore_id,
+			void **obj_table,
+			unsigned int n)
+{
+	uint64_t offers = __atomic_load_n(&elim->offers, __ATOMIC_RELAXED);
+	unsigned int i, j, idx;
+
+	if (likely(offers == 0))
+		return 0;
+
+	for (i = 0; i < RTE_STACK_LF_ELIM_SLOTS; i++) {
+		struct rte_stack_lf_elim_slot *slot;
+		uint64_t state;
+
+		idx = (lcore_id + i) % RTE_STACK_LF_ELIM_SLOTS;
+		if (!(offers & (1ULL << idx)))
+			continue;
+
+		slot = &elim->slots[idx];
+		state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+		if ((state & __RTE_STACK_LF_ELIM_MASK) !=
+				__RTE_STACK_LF_ELIM_OFFER)
+			continue;
+
+		/* Only sizes matching exactly are paired. The fields are
+		 * validated by the sequence number in the CAS below.
+		 */
+		if (__atomic_load_n(&slot->n, __ATOMIC_RELAXED) != n)
+			continue;
+
+		if (!__atomic_compare_exchange_n(&slot->state, &state,
+				state ^ (__RTE_STACK_LF_ELIM_OFFER |
+					 __RTE_STACK_LF_ELIM_TAKEN), 0,
+				__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			continue;
+
+		__atomic_fetch_and(&elim->offers, ~(1ULL << idx),
+				   __ATOMIC_RELAXED);
+
+		/* Return the objects in the order a push then a pop of the
+		 * list would have.
+		 */
+		for (j = 0; j < n; j++)
+			obj_table[j] = slot->objs[n - j - 1];
+
+		/* Release the slot for the next offer */
+		__atomic_store_n(&slot->state,
+				 state & ~(uint64_t)__RTE_STACK_LF_ELIM_MASK,
+				 __ATOMIC_RELEASE);
+
+		return 1;
+	}
+
+	return 0;
+}
+
 /**
  * @internal Push several objects on the lock-free stack (MT-safe).
  *
@@ -38,11 +202,21 @@ __rte_stack_lf_push(struct rte_stack *s,
 		    unsigned int n)
 {
 	struct rte_stack_lf_elem *tmp, *first, *last = NULL;
-	unsigned int i;
+	struct rte_stack_lf_elim *elim;
+	unsigned int i, lcore_id;
+	uint8_t contended;
 
 	if (unlikely(n == 0))
 		return 0;
 
+	/* Pair with a concurrent pop if the head was contended last time */
+	elim = s->stack_lf.elim;
+	lcore_id = rte_lcore_id();
+	if (elim != NULL && lcore_id < RTE_MAX_LCORE &&
+			elim->contended[lcore_id] &&
+			__rte_stack_lf_elim_push(elim, lcore_id, obj_table, n))
+		return n;
+
 	/* Pop n free elements */
 	first = __rte_stack_lf_pop_elems(&s->stack_lf.free, n, NULL, &last);
 	if (unlikely(first == NULL))
@@ -53,7 +227,13 @@ __rte_stack_lf_push(struct rte_stack *s,
 		tmp->data = obj_table[n - i - 1];
 
 	/* Push them to the used list */
-	__rte_stack_lf_push_elems(&s->stack_lf.used, first, last, n);
+	contended = __rte_stack_lf_push_elems(&s->stack_lf.used,
+					      first, last, n) != 0;
+
+	/* Only write the hint when it changes, to keep its line shared */
+	if (elim != NULL && lcore_id < RTE_MAX_LCORE &&
+			elim->contended[lcore_id] != contended)
+		elim->contended[lcore_id] = contended;
 
 	return n;
 }
@@ -74,10 +254,16 @@ static __rte_always_inline unsigned int
 __rte_stack_lf_pop(struct rte_stack *s, void **obj_table, unsigned int n)
 {
 	struct rte_stack_lf_elem *first, *last = NULL;
+	struct rte_stack_lf_elim *elim = s->stack_lf.elim;
 
 	if (unlikely(n == 0))
 		return 0;
 
+	/* Take the objects from a push waiting in the elimination array */
+	if (elim != NULL &&
+			__rte_stack_lf_elim_pop(elim, rte_lcore_id(), obj_table, n))
+		return n;
+
 	/* Pop n used elements */
 	first = __rte_stack_lf_pop_elems(&s->stack_lf.used,
 					 n, obj_table, &last);
@@ -97,19 +283,23 @@ __rte_stack_lf_pop(struct rte_stack *s, void **obj_table, unsigned int n)
  *   A pointer to the stack structure.
  * @param count
  *   The size of the stack.
+ * @param flags
+ *   The flags supplied at creation.
  */
 void
-rte_stack_lf_init(struct rte_stack *s, unsigned int count);
+rte_stack_lf_init(struct rte_stack *s, unsigned int count, uint32_t flags);
 
 /**
  * @internal Return the memory required for a lock-free stack.
  *
  * @param count
  *   The size of the stack.
+ * @param flags
+ *   The flags supplied at creation.
  * @return
  *   The bytes to allocate for a lock-free stack.
  */
 ssize_t
-rte_stack_lf_get_memsize(unsigned int count);
+rte_stack_lf_get_memsize(unsigned int count, uint32_t flags);
 
 #endif /* _RTE_STACK_LF_H_ */
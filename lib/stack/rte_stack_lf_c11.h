@@ -30,13 +30,14 @@ __rte_stack_lf_count(struct rte_stack *s)
 					     __ATOMIC_RELAXED);
 }
 
-static __rte_always_inline void
+static __rte_always_inline unsigned int
 __rte_stack_lf_push_elems(struct rte_stack_lf_list *list,
 			  struct rte_stack_lf_elem *first,
 			  struct rte_stack_lf_elem *last,
 			  unsigned int num)
 {
 	struct rte_stack_lf_head old_head;
+	unsigned int retries = 0;
 	int success;
 
 	old_head = list->head;
@@ -61,12 +62,15 @@ __rte_stack_lf_push_elems(struct rte_stack_lf_list *list,
 				(rte_int128_t *)&new_head,
 				1, __ATOMIC_RELEASE,
 				__ATOMIC_RELAXED);
+		retries += !success;
 	} while (success == 0);
 
 	/* Ensure the stack modifications are not reordered with respect
 	 * to the LIFO len update.
 	 */
 	__atomic_fetch_add(&list->len, num, __ATOMIC_RELEASE);
+
+	return retries;
 }
 
 static __rte_always_inline struct rte_stack_lf_elem *
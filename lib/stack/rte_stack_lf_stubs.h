@@ -15,7 +15,7 @@ __rte_stack_lf_count(struct rte_stack *s)
 	return 0;
 }
 
-static __rte_always_inline void
+static __rte_always_inline unsigned int
 __rte_stack_lf_push_elems(struct rte_stack_lf_list *list,
 			  struct rte_stack_lf_elem *first,
 			  struct rte_stack_lf_elem *last,
@@ -25,6 +25,8 @@ __rte_stack_lf_push_elems(struct rte_stack_lf_list *list,
 	RTE_SET_USED(last);
 	RTE_SET_USED(list);
 	RTE_SET_USED(num);
+
+	return 0;
 }
 
 static __rte_always_inline struct rte_stack_lf_elem *
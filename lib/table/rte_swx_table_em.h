@@ -22,6 +22,20 @@ extern struct rte_swx_table_ops rte_swx_table_exact_match_unoptimized_ops;
 /** Exact match table operations. */
 extern struct rte_swx_table_ops rte_swx_table_exact_match_ops;
 
+/** Exact match table operations for large tables - unoptimized. */
+extern struct rte_swx_table_ops rte_swx_table_exact_match_large_unoptimized_ops;
+
+/**
+ * Exact match table operations for large tables.
+ *
+ * Each bucket fits in one cache line and holds the 16-bit signatures of up to
+ * 8 keys, which are compared with a single vector instruction when available.
+ * The keys and their action data are allocated in segments as the table grows,
+ * so the memory in use follows the current number of keys rather than the
+ * maximum, which is up to hundreds of millions of keys.
+ */
+extern struct rte_swx_table_ops rte_swx_table_exact_match_large_ops;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,748 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_prefetch.h>
+#include <rte_vect.h>
+#include <rte_hash_crc.h>
+#include <rte_jhash.h>
+
+#include "rte_swx_keycmp.h"
+#include "rte_swx_table_em.h"
+
+#define CHECK(condition, err_code)                                             \
+do {                                                                           \
+	if (!(condition))                                                      \
+		return -(err_code);                                            \
+} while (0)
+
+#ifndef RTE_SWX_TABLE_EM_USE_HUGE_PAGES
+#define RTE_SWX_TABLE_EM_USE_HUGE_PAGES 1
+#endif
+
+#if RTE_SWX_TABLE_EM_USE_HUGE_PAGES
+
+#include <rte_malloc.h>
+
+static void *
+env_malloc(size_t size, size_t alignment, int numa_node)
+{
+	return rte_zmalloc_socket(NULL, size, alignment, numa_node);
+}
+
+static void
+env_free(void *start, size_t size __rte_unused)
+{
+	rte_free(start);
+}
+
+#else
+
+#include <numa.h>
+
+static void *
+env_malloc(size_t size, size_t alignment __rte_unused, int numa_node)
+{
+	void *start;
+
+	start = numa_alloc_onnode(size, numa_node);
+	if (!start)
+		return NULL;
+
+	memset(start, 0, size);
+	return start;
+}
+
+static void
+env_free(void *start, size_t size)
+{
+	numa_free(start, size);
+}
+
+#endif
+
+/*
+ * The bucket is exactly one cache line: the signatures of all its keys are
+ * compared in a single vector operation, so that only the candidate keys with
+ * matching signature have to be read.
+ */
+#define KEYS_PER_BUCKET 8
+
+/* Number of buckets up to which the signature is the upper half of the hash. */
+#define SIG_HASH_N_BUCKETS (1U << 16)
+
+struct bucket {
+	uint16_t sig[KEYS_PER_BUCKET];
+	uint32_t key_id[KEYS_PER_BUCKET];
+	struct bucket *next;
+} __rte_cache_aligned;
+
+/*
+ * The key records (action data followed by the key) and the bucket extensions
+ * are allocated in segments, when the table grows beyond the segments already
+ * allocated, so the memory footprint tracks the number of keys currently in the
+ * table instead of its maximum size.
+ */
+#define KEY_SEGMENT_SIZE_LOG2 16
+#define KEY_SEGMENT_SIZE (1U << KEY_SEGMENT_SIZE_LOG2)
+#define KEY_SEGMENT_MASK (KEY_SEGMENT_SIZE - 1)
+
+#define BKT_EXT_SEGMENT_SIZE_LOG2 12
+#define BKT_EXT_SEGMENT_SIZE (1U << BKT_EXT_SEGMENT_SIZE_LOG2)
+#define BKT_EXT_SEGMENT_MASK (BKT_EXT_SEGMENT_SIZE - 1)
+
+#define KEY_ID_INVALID UINT32_MAX
+
+struct table {
+	/* Input parameters */
+	struct rte_swx_table_params params;
+
+	/* Internal. */
+	uint32_t data_size;
+	uint32_t record_size_shl;
+	uint32_t n_buckets;
+	uint32_t n_buckets_ext;
+	uint32_t n_key_segments;
+	uint32_t n_bkt_ext_segments;
+	uint32_t n_keys_hwm;
+	uint32_t n_buckets_ext_hwm;
+	uint32_t key_free;
+	int numa_node;
+	uint64_t total_size;
+	rte_swx_keycmp_func_t keycmp_func;
+	struct bucket *bkt_ext_free;
+
+	/* Memory arrays. */
+	struct bucket *buckets;
+	uint8_t **key_segments;
+	struct bucket **bkt_ext_segments;
+};
+
+static inline uint8_t *
+table_record(struct table *t, uint32_t key_id)
+{
+	return &t->key_segments[key_id >> KEY_SEGMENT_SIZE_LOG2]
+		[(size_t)(key_id & KEY_SEGMENT_MASK) << t->record_size_shl];
+}
+
+static inline uint64_t *
+table_key_data(struct table *t, uint32_t key_id)
+{
+	return (uint64_t *)table_record(t, key_id);
+}
+
+static inline uint8_t *
+table_key(struct table *t, uint32_t key_id)
+{
+	return table_record(t, key_id) + t->data_size;
+}
+
+static inline void
+table_record_prefetch(struct table *t, uint32_t key_id)
+{
+	uint8_t *record = table_record(t, key_id);
+
+	rte_prefetch0(record);
+	if ((1U << t->record_size_shl) > RTE_CACHE_LINE_SIZE)
+		rte_prefetch0(record + RTE_CACHE_LINE_SIZE);
+}
+
+/* Return the bitmask of the bucket positions with the given signature. */
+static inline uint32_t
+bkt_sig_match(struct bucket *bkt, uint32_t sig)
+{
+#if defined(__SSE2__)
+	__m128i cmp = _mm_cmpeq_epi16(_mm_load_si128((__m128i const *)bkt->sig),
+				      _mm_set1_epi16((int16_t)sig));
+
+	return (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(cmp,
+							   _mm_setzero_si128()));
+#elif defined(RTE_ARCH_ARM64)
+	const int16x8_t shift = {-15, -14, -13, -12, -11, -10, -9, -8};
+	uint16x8_t cmp;
+
+	cmp = vceqq_u16(vld1q_u16(bkt->sig), vdupq_n_u16((uint16_t)sig));
+	return vaddvq_u16(vshlq_u16(vandq_u16(cmp, vdupq_n_u16(0x8000)),
+				    shift));
+#else
+	uint32_t mask = 0, i;
+
+	for (i = 0; i < KEYS_PER_BUCKET; i++)
+		mask |= (bkt->sig[i] == (uint16_t)sig) << i;
+
+	return mask;
+#endif
+}
+
+static inline uint32_t
+bkt_key_find(struct table *t,
+	     struct bucket *bkt,
+	     uint8_t *input_key,
+	     uint32_t input_sig,
+	     uint32_t *bkt_pos)
+{
+	uint32_t mask;
+
+	for (mask = bkt_sig_match(bkt, input_sig); mask; mask &= mask - 1) {
+		uint32_t pos = __builtin_ctz(mask);
+
+		if (t->keycmp_func(table_key(t, bkt->key_id[pos]),
+				   input_key,
+				   t->params.key_size)) {
+			*bkt_pos = pos;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static inline uint32_t
+table_hash(struct table *t, uint8_t *input_key, uint32_t *input_sig)
+{
+	uint32_t hash, sig;
+
+	hash = t->params.hash_func(input_key, t->params.key_size, 0);
+
+	/* The signature must not repeat the bucket index bits. Beyond
+	 * SIG_HASH_N_BUCKETS buckets, the index reaches into the upper half of
+	 * the hash, so the signature comes from another hash function: hashing
+	 * the key again with the CRC, even with another seed, would give the
+	 * same bits XORed with a constant.
+	 */
+	if (t->n_buckets > SIG_HASH_N_BUCKETS)
+		sig = rte_jhash(input_key, t->params.key_size, 0);
+	else
+		sig = hash >> 16;
+
+	*input_sig = (uint16_t)sig | 1;
+	return hash & (t->n_buckets - 1);
+}
+
+static int
+key_id_alloc(struct table *t, uint32_t *key_id)
+{
+	uint32_t id = t->key_free;
+
+	/* Reuse a previously deleted key. */
+	if (id != KEY_ID_INVALID) {
+		t->key_free = (uint32_t)table_key_data(t, id)[0];
+		*key_id = id;
+		return 0;
+	}
+
+	CHECK(t->n_keys_hwm < t->params.n_keys_max, ENOSPC);
+
+	/* Grow the table by one key segment. */
+	id = t->n_keys_hwm;
+	if (!t->key_segments[id >> KEY_SEGMENT_SIZE_LOG2]) {
+		uint8_t *segment;
+
+		segment = env_malloc((size_t)KEY_SEGMENT_SIZE << t->record_size_shl,
+				     RTE_CACHE_LINE_SIZE,
+				     t->numa_node);
+		CHECK(segment, ENOMEM);
+
+		t->key_segments[id >> KEY_SEGMENT_SIZE_LOG2] = segment;
+	}
+
+	t->n_keys_hwm++;
+	*key_id = id;
+	return 0;
+}
+
+static void
+key_id_free(struct table *t, uint32_t key_id)
+{
+	table_key_data(t, key_id)[0] = t->key_free;
+	t->key_free = key_id;
+}
+
+static struct bucket *
+bkt_ext_alloc(struct table *t)
+{
+	struct bucket *bkt = t->bkt_ext_free;
+	uint32_t id;
+
+	if (bkt) {
+		t->bkt_ext_free = bkt->next;
+		memset(bkt, 0, sizeof(*bkt));
+		return bkt;
+	}
+
+	if (t->n_buckets_ext_hwm == t->n_buckets_ext)
+		return NULL;
+
+	/* Grow the table by one bucket extension segment. */
+	id = t->n_buckets_ext_hwm;
+	if (!t->bkt_ext_segments[id >> BKT_EXT_SEGMENT_SIZE_LOG2]) {
+		struct bucket *segment;
+
+		segment = env_malloc(BKT_EXT_SEGMENT_SIZE * sizeof(struct bucket),
+				     RTE_CACHE_LINE_SIZE,
+				     t->numa_node);
+		if (!segment)
+			return NULL;
+
+		t->bkt_ext_segments[id >> BKT_EXT_SEGMENT_SIZE_LOG2] = segment;
+	}
+
+	t->n_buckets_ext_hwm++;
+	return &t->bkt_ext_segments[id >> BKT_EXT_SEGMENT_SIZE_LOG2]
+		[id & BKT_EXT_SEGMENT_MASK];
+}
+
+static void
+bkt_ext_free(struct table *t, struct bucket *bkt)
+{
+	bkt->next = t->bkt_ext_free;
+	t->bkt_ext_free = bkt;
+}
+
+static inline void
+bkt_key_data_update(struct table *t,
+		    uint32_t bkt_key_id,
+		    struct rte_swx_table_entry *input)
+{
+	uint64_t *bkt_data = table_key_data(t, bkt_key_id);
+
+	bkt_data[0] = input->action_id;
+	if (t->params.action_data_size && input->action_data)
+		memcpy(&bkt_data[1], input->action_data, t->params.action_data_size);
+}
+
+static inline void
+bkt_key_install(struct table *t,
+		struct bucket *bkt,
+		struct rte_swx_table_entry *input,
+		uint32_t bkt_pos,
+		uint32_t bkt_key_id,
+		uint32_t input_sig)
+{
+	/* Key and key data are written before the signature makes them visible. */
+	memcpy(table_key(t, bkt_key_id), input->key, t->params.key_size);
+	bkt_key_data_update(t, bkt_key_id, input);
+
+	bkt->key_id[bkt_pos] = bkt_key_id;
+	bkt->sig[bkt_pos] = (uint16_t)input_sig;
+}
+
+#define CL RTE_CACHE_LINE_ROUNDUP
+
+static int
+__table_create(struct table **table,
+	       uint64_t *memory_footprint,
+	       struct rte_swx_table_params *params,
+	       const char *args __rte_unused,
+	       int numa_node)
+{
+	struct table *t;
+	uint8_t *memory;
+	size_t table_meta_sz, bucket_sz, key_seg_sz, bkt_ext_seg_sz, total_size;
+	size_t bucket_offset, key_seg_offset, bkt_ext_seg_offset;
+	uint32_t key_size, data_size, record_size, n_buckets, n_buckets_ext,
+		n_key_segments, n_bkt_ext_segments, i;
+
+	/* Check input arguments. */
+	CHECK(params, EINVAL);
+	CHECK(params->match_type == RTE_SWX_TABLE_MATCH_EXACT, EINVAL);
+	CHECK(params->key_size, EINVAL);
+
+	if (params->key_mask0) {
+		for (i = 0; i < params->key_size; i++)
+			if (params->key_mask0[i] != 0xFF)
+				break;
+
+		CHECK(i == params->key_size, EINVAL);
+	}
+
+	CHECK(params->n_keys_max, EINVAL);
+	CHECK(params->n_keys_max < KEY_ID_INVALID, EINVAL);
+
+	/* Memory allocation. */
+	key_size = RTE_ALIGN_CEIL(params->key_size, sizeof(uint64_t));
+	data_size = rte_align32pow2(params->action_data_size + 8);
+	record_size = rte_align32pow2(data_size + key_size);
+	n_buckets = rte_align32pow2((params->n_keys_max + KEYS_PER_BUCKET - 1) /
+				    KEYS_PER_BUCKET);
+	n_buckets_ext = n_buckets;
+	n_key_segments = (params->n_keys_max + KEY_SEGMENT_SIZE - 1) >>
+			 KEY_SEGMENT_SIZE_LOG2;
+	n_bkt_ext_segments = (n_buckets_ext + BKT_EXT_SEGMENT_SIZE - 1) >>
+			     BKT_EXT_SEGMENT_SIZE_LOG2;
+
+	table_meta_sz = CL(sizeof(struct table));
+	bucket_sz = CL((size_t)n_buckets * sizeof(struct bucket));
+	key_seg_sz = CL(n_key_segments * sizeof(uint8_t *));
+	bkt_ext_seg_sz = CL(n_bkt_ext_segments * sizeof(struct bucket *));
+	total_size = table_meta_sz + bucket_sz + key_seg_sz + bkt_ext_seg_sz;
+
+	bucket_offset = table_meta_sz;
+	key_seg_offset = bucket_offset + bucket_sz;
+	bkt_ext_seg_offset = key_seg_offset + key_seg_sz;
+
+	/* The footprint accounts for the table at its maximum size. */
+	if (!table) {
+		if (memory_footprint)
+			*memory_footprint = total_size +
+				(uint64_t)n_key_segments * KEY_SEGMENT_SIZE * record_size +
+				(uint64_t)n_bkt_ext_segments * BKT_EXT_SEGMENT_SIZE *
+				sizeof(struct bucket);
+		return 0;
+	}
+
+	memory = env_malloc(total_size, RTE_CACHE_LINE_SIZE, numa_node);
+	CHECK(memory, ENOMEM);
+
+	/* Initialization. */
+	t = (struct table *)memory;
+	memcpy(&t->params, params, sizeof(*params));
+	t->params.key_mask0 = NULL;
+	if (!params->hash_func)
+		t->params.hash_func = rte_hash_crc;
+
+	t->data_size = data_size;
+	t->record_size_shl = __builtin_ctz(record_size);
+	t->n_buckets = n_buckets;
+	t->n_buckets_ext = n_buckets_ext;
+	t->n_key_segments = n_key_segments;
+	t->n_bkt_ext_segments = n_bkt_ext_segments;
+	t->key_free = KEY_ID_INVALID;
+	t->numa_node = numa_node;
+	t->total_size = total_size;
+	t->keycmp_func = rte_swx_keycmp_func_get(params->key_size);
+
+	t->buckets = (struct bucket *)&memory[bucket_offset];
+	t->key_segments = (uint8_t **)&memory[key_seg_offset];
+	t->bkt_ext_segments = (struct bucket **)&memory[bkt_ext_seg_offset];
+
+	*table = t;
+	return 0;
+}
+
+static void
+table_free(void *table)
+{
+	struct table *t = table;
+	uint32_t i;
+
+	if (!t)
+		return;
+
+	for (i = 0; i < t->n_key_segments; i++)
+		if (t->key_segments[i])
+			env_free(t->key_segments[i],
+				 (size_t)KEY_SEGMENT_SIZE << t->record_size_shl);
+
+	for (i = 0; i < t->n_bkt_ext_segments; i++)
+		if (t->bkt_ext_segments[i])
+			env_free(t->bkt_ext_segments[i],
+				 BKT_EXT_SEGMENT_SIZE * sizeof(struct bucket));
+
+	env_free(t, t->total_size);
+}
+
+static int
+table_add(void *table, struct rte_swx_table_entry *entry)
+{
+	struct table *t = table;
+	struct bucket *bkt0, *bkt, *bkt_prev, *new_bkt;
+	uint32_t input_sig, bkt_id, bkt_pos, new_bkt_key_id, mask;
+	int status;
+
+	CHECK(t, EINVAL);
+	CHECK(entry, EINVAL);
+	CHECK(entry->key, EINVAL);
+
+	bkt_id = table_hash(t, entry->key, &input_sig);
+	bkt0 = &t->buckets[bkt_id];
+
+	/* Key is present in the bucket. */
+	for (bkt = bkt0; bkt; bkt = bkt->next)
+		if (bkt_key_find(t, bkt, entry->key, input_sig, &bkt_pos)) {
+			bkt_key_data_update(t, bkt->key_id[bkt_pos], entry);
+			return 0;
+		}
+
+	/* Key is not present in the bucket. Bucket not full. */
+	for (bkt = bkt0, bkt_prev = NULL; bkt; bkt_prev = bkt, bkt = bkt->next) {
+		mask = bkt_sig_match(bkt, 0);
+		if (mask) {
+			status = key_id_alloc(t, &new_bkt_key_id);
+			if (status)
+				return status;
+
+			bkt_key_install(t, bkt, entry, __builtin_ctz(mask),
+					new_bkt_key_id, input_sig);
+			return 0;
+		}
+	}
+
+	/* Bucket full: extend bucket. */
+	new_bkt = bkt_ext_alloc(t);
+	CHECK(new_bkt, ENOSPC);
+
+	status = key_id_alloc(t, &new_bkt_key_id);
+	if (status) {
+		bkt_ext_free(t, new_bkt);
+		return status;
+	}
+
+	bkt_key_install(t, new_bkt, entry, 0, new_bkt_key_id, input_sig);
+	bkt_prev->next = new_bkt;
+	return 0;
+}
+
+static int
+table_del(void *table, struct rte_swx_table_entry *entry)
+{
+	struct table *t = table;
+	struct bucket *bkt0, *bkt, *bkt_prev;
+	uint32_t input_sig, bkt_id, bkt_pos;
+
+	CHECK(t, EINVAL);
+	CHECK(entry, EINVAL);
+	CHECK(entry->key, EINVAL);
+
+	bkt_id = table_hash(t, entry->key, &input_sig);
+	bkt0 = &t->buckets[bkt_id];
+
+	/* Key is present in the bucket. */
+	for (bkt = bkt0, bkt_prev = NULL; bkt; bkt_prev = bkt, bkt = bkt->next)
+		if (bkt_key_find(t, bkt, entry->key, input_sig, &bkt_pos)) {
+			/* Key free. */
+			bkt->sig[bkt_pos] = 0;
+			key_id_free(t, bkt->key_id[bkt_pos]);
+
+			/* Bucket extension free if empty and not the 1st in bucket. */
+			if (bkt_prev &&
+			    bkt_sig_match(bkt, 0) == RTE_LEN2MASK(KEYS_PER_BUCKET, uint32_t)) {
+				bkt_prev->next = bkt->next;
+				bkt_ext_free(t, bkt);
+			}
+
+			return 0;
+		}
+
+	return 0;
+}
+
+static uint64_t
+table_mailbox_size_get_unoptimized(void)
+{
+	return 0;
+}
+
+static int
+table_lookup_unoptimized(void *table,
+			 void *mailbox __rte_unused,
+			 uint8_t **key,
+			 uint64_t *action_id,
+			 uint8_t **action_data,
+			 size_t *entry_id,
+			 int *hit)
+{
+	struct table *t = table;
+	struct bucket *bkt;
+	uint8_t *input_key;
+	uint32_t input_sig, bkt_id, bkt_pos;
+
+	input_key = &(*key)[t->params.key_offset];
+
+	bkt_id = table_hash(t, input_key, &input_sig);
+
+	/* Key is present in the bucket. */
+	for (bkt = &t->buckets[bkt_id]; bkt; bkt = bkt->next)
+		if (bkt_key_find(t, bkt, input_key, input_sig, &bkt_pos)) {
+			uint32_t bkt_key_id = bkt->key_id[bkt_pos];
+			uint64_t *bkt_data = table_key_data(t, bkt_key_id);
+
+			*action_id = bkt_data[0];
+			*action_data = (uint8_t *)&bkt_data[1];
+			*entry_id = bkt_key_id;
+			*hit = 1;
+			return 1;
+		}
+
+	*hit = 0;
+	return 1;
+}
+
+struct mailbox {
+	struct bucket *bkt;
+	uint32_t input_sig;
+	uint32_t sig_match;
+	int state;
+};
+
+static uint64_t
+table_mailbox_size_get(void)
+{
+	return sizeof(struct mailbox);
+}
+
+static int
+table_lookup(void *table,
+	     void *mailbox,
+	     uint8_t **key,
+	     uint64_t *action_id,
+	     uint8_t **action_data,
+	     size_t *entry_id,
+	     int *hit)
+{
+	struct table *t = table;
+	struct mailbox *m = mailbox;
+
+	switch (m->state) {
+	case 0: {
+		uint8_t *input_key = &(*key)[t->params.key_offset];
+		struct bucket *bkt;
+		uint32_t input_sig, bkt_id;
+
+		bkt_id = table_hash(t, input_key, &input_sig);
+		bkt = &t->buckets[bkt_id];
+		rte_prefetch0(bkt);
+
+		m->bkt = bkt;
+		m->input_sig = input_sig;
+		m->state++;
+		return 0;
+	}
+
+	case 1: {
+		struct bucket *bkt = m->bkt;
+		uint32_t sig_match;
+
+		sig_match = bkt_sig_match(bkt, m->input_sig);
+
+		/* No signature match in a single bucket: lookup miss. */
+		if (!sig_match) {
+			m->state = 0;
+			if (bkt->next)
+				return table_lookup_unoptimized(t,
+								m,
+								key,
+								action_id,
+								action_data,
+								entry_id,
+								hit);
+
+			*hit = 0;
+			return 1;
+		}
+
+		table_record_prefetch(t, bkt->key_id[__builtin_ctz(sig_match)]);
+
+		m->sig_match = sig_match;
+		m->state++;
+		return 0;
+	}
+
+	case 2: {
+		uint8_t *input_key = &(*key)[t->params.key_offset];
+		struct bucket *bkt = m->bkt;
+		uint32_t sig_match = m->sig_match;
+		uint32_t bkt_key_id = bkt->key_id[__builtin_ctz(sig_match)];
+		uint64_t *bkt_data = table_key_data(t, bkt_key_id);
+		uint32_t lkp_hit;
+
+		lkp_hit = t->keycmp_func(table_key(t, bkt_key_id),
+					 input_key,
+					 t->params.key_size);
+		*action_id = bkt_data[0];
+		*action_data = (uint8_t *)&bkt_data[1];
+		*entry_id = bkt_key_id;
+		*hit = lkp_hit;
+
+		m->state = 0;
+
+		/* Signature collision: check the other candidates. */
+		if (!lkp_hit && ((sig_match & (sig_match - 1)) || bkt->next))
+			return table_lookup_unoptimized(t,
+							m,
+							key,
+							action_id,
+							action_data,
+							entry_id,
+							hit);
+
+		return 1;
+	}
+
+	default:
+		return 0;
+	}
+}
+
+static void *
+table_create(struct rte_swx_table_params *params,
+	     struct rte_swx_table_entry_list *entries,
+	     const char *args,
+	     int numa_node)
+{
+	struct table *t;
+	struct rte_swx_table_entry *entry;
+	int status;
+
+	RTE_BUILD_BUG_ON(sizeof(struct bucket) > RTE_CACHE_LINE_SIZE);
+
+	/* Table create. */
+	status = __table_create(&t, NULL, params, args, numa_node);
+	if (status)
+		return NULL;
+
+	/* Table add entries. */
+	if (!entries)
+		return t;
+
+	TAILQ_FOREACH(entry, entries, node) {
+		int status;
+
+		status = table_add(t, entry);
+		if (status) {
+			table_free(t);
+			return NULL;
+		}
+	}
+
+	return t;
+}
+
+static uint64_t
+table_footprint(struct rte_swx_table_params *params,
+		struct rte_swx_table_entry_list *entries __rte_unused,
+		const char *args)
+{
+	uint64_t memory_footprint;
+	int status;
+
+	status = __table_create(NULL, &memory_footprint, params, args, 0);
+	if (status)
+		return 0;
+
+	return memory_footprint;
+}
+
+struct rte_swx_table_ops rte_swx_table_exact_match_large_unoptimized_ops = {
+	.footprint_get = table_footprint,
+	.mailbox_size_get = table_mailbox_size_get_unoptimized,
+	.create = table_create,
+	.add = table_add,
+	.del = table_del,
+	.lkp = table_lookup_unoptimized,
+	.free = table_free,
+};
+
+struct rte_swx_table_ops rte_swx_table_exact_match_large_ops = {
+	.footprint_get = table_footprint,
+	.mailbox_size_get = table_mailbox_size_get,
+	.create = table_create,
+	.add = table_add,
+	.del = table_del,
+	.lkp = table_lookup,
+	.free = table_free,
+};
@@ -149,6 +149,12 @@ struct table {
 	/* Table parameters. */
 	struct table_params params;
 
+	/* Table statistics. */
+	struct rte_swx_table_learner_stats stats;
+
+	/* Next bucket to be checked for expired keys by the aging operation. */
+	size_t age_bucket_id;
+
 	/* Table buckets. */
 	uint8_t buckets[];
 } __rte_cache_aligned;
@@ -446,6 +452,35 @@ rte_swx_table_learner_lookup(void *table,
 	}
 }
 
+/* The aging operation may free the position of the key found by the lookup operation before the
+ * key is rearmed, so the position is checked again. A position freed by the aging operation keeps
+ * its key and its (past) time, while the delete operation also clears the time. When the key was
+ * only freed by the aging operation, it is still live and it is restored. When the key was deleted
+ * or a new key reused its position, the rearm is skipped.
+ */
+static inline int
+table_entry_check(struct table *t, struct mailbox *m)
+{
+	struct table_bucket *b = m->bucket;
+	size_t bucket_key_pos = m->bucket_key_pos;
+	uint8_t *key;
+
+	if (b->sig[bucket_key_pos] == m->input_sig)
+		return 1;
+
+	key = table_bucket_key_get(t, b, bucket_key_pos);
+	if (!b->sig[bucket_key_pos] &&
+	    b->time[bucket_key_pos] &&
+	    t->params.keycmp_func(key, m->input_key, t->params.key_size)) {
+		b->sig[bucket_key_pos] = m->input_sig;
+		t->stats.n_keys_expired--;
+		return 1;
+	}
+
+	m->hit = 0;
+	return 0;
+}
+
 void
 rte_swx_table_learner_rearm(void *table,
 			    void *mailbox,
@@ -458,7 +493,7 @@ rte_swx_table_learner_rearm(void *table,
 	uint64_t key_timeout;
 	uint32_t key_timeout_id;
 
-	if (!m->hit)
+	if (!m->hit || !table_entry_check(t, m))
 		return;
 
 	b = m->bucket;
@@ -481,7 +516,7 @@ rte_swx_table_learner_rearm_new(void *table,
 	size_t bucket_key_pos;
 	uint64_t key_timeout;
 
-	if (!m->hit)
+	if (!m->hit || !table_entry_check(t, m))
 		return;
 
 	b = m->bucket;
@@ -546,6 +581,10 @@ rte_swx_table_learner_add(void *table,
 			uint8_t *key = table_bucket_key_get(t, b, i);
 			uint64_t *data = table_bucket_data_get(t, b, i);
 
+			/* Expired key not yet reclaimed by the aging operation. */
+			if (b->sig[i])
+				t->stats.n_keys_expired++;
+
 			/* Install the key and the key timeout. */
 			b->time[i] = (input_time + key_timeout) >> 32;
 			b->sig[i] = m->input_sig;
@@ -561,11 +600,13 @@ rte_swx_table_learner_add(void *table,
 			m->hit = 1;
 			m->bucket_key_pos = i;
 
+			t->stats.n_keys_learned++;
 			return 0;
 		}
 	}
 
 	/* Bucket full. */
+	t->stats.n_keys_rejected++;
 	return 1;
 }
 
@@ -580,8 +621,58 @@ rte_swx_table_learner_delete(void *table __rte_unused,
 
 		/* Expire the key. */
 		b->time[m->bucket_key_pos] = 0;
+		b->sig[m->bucket_key_pos] = 0;
 
 		/* Mailbox. */
 		m->hit = 0;
 	}
 }
+
+uint32_t
+rte_swx_table_learner_age(void *table,
+			  uint64_t input_time,
+			  uint32_t n_buckets)
+{
+	struct table *t = table;
+	size_t bucket_id = t->age_bucket_id;
+	uint32_t n_keys_expired = 0, i, j;
+
+	for (i = 0; i < n_buckets; i++) {
+		struct table_bucket *b = table_bucket_get(t, bucket_id);
+
+		for (j = 0; j < TABLE_KEYS_PER_BUCKET; j++) {
+			uint64_t time = b->time[j];
+
+			time <<= 32;
+
+			/* Free the position of the expired key, so that lookups skip it early and
+			 * the add operation finds it free. The time is kept for the rearm operation.
+			 */
+			if (time < input_time && b->sig[j]) {
+				n_keys_expired++;
+				b->sig[j] = 0;
+			}
+		}
+
+		bucket_id = (bucket_id + 1) & t->params.bucket_mask;
+	}
+
+	t->age_bucket_id = bucket_id;
+	t->stats.n_keys_expired += n_keys_expired;
+
+	return n_keys_expired;
+}
+
+int
+rte_swx_table_learner_stats_read(void *table,
+				 struct rte_swx_table_learner_stats *stats)
+{
+	struct table *t = table;
+
+	if (!t || !stats)
+		return -EINVAL;
+
+	memcpy(stats, &t->stats, sizeof(*stats));
+
+	return 0;
+}
@@ -99,6 +99,20 @@ struct rte_swx_table_learner_params {
 	uint32_t n_key_timeouts;
 };
 
+/** Learner table statistics. */
+struct rte_swx_table_learner_stats {
+	/** Number of keys added to the table. */
+	uint64_t n_keys_learned;
+
+	/** Number of keys removed from the table on timeout, either by the aging operation or when
+	 * their position is reused by the add operation.
+	 */
+	uint64_t n_keys_expired;
+
+	/** Number of keys not added to the table because their bucket is full. */
+	uint64_t n_keys_rejected;
+};
+
 /**
  * Learner table memory footprint get
  *
@@ -306,6 +320,48 @@ void
 rte_swx_table_learner_delete(void *table,
 			     void *mailbox);
 
+/**
+ * Learner table aging
+ *
+ * Expired keys are normally left in place until their position is reused by a new key. This
+ * operation proactively frees the positions of the expired keys, a few buckets at a time, so that
+ * it can be called periodically by the data plane thread with bounded work per call. Each call
+ * resumes the scan from the bucket where the previous call stopped, wrapping around the table.
+ *
+ * This operation must be invoked by the same thread that performs the lookup and add operations
+ * into this table.
+ *
+ * @param[in] table
+ *   Table handle.
+ * @param[in] time
+ *   Current time measured in CPU clock cycles.
+ * @param[in] n_buckets
+ *   Number of table buckets to check.
+ * @return
+ *   Number of expired keys removed from the table.
+ */
+__rte_experimental
+uint32_t
+rte_swx_table_learner_age(void *table,
+			  uint64_t time,
+			  uint32_t n_buckets);
+
+/**
+ * Learner table statistics read
+ *
+ * @param[in] table
+ *   Table handle.
+ * @param[out] stats
+ *   Table statistics.
+ * @return
+ *   0 on success or the following error codes otherwise:
+ *   -EINVAL: Invalid argument(s).
+ */
+__rte_experimental
+int
+rte_swx_table_learner_stats_read(void *table,
+				 struct rte_swx_table_learner_stats *stats);
+
 /**
  * Learner table free
  *
@@ -7,7 +7,9 @@
 #include <stdlib.h>
 #ifndef RTE_EXEC_ENV_WINDOWS
 #include <unistd.h>
+#include <poll.h>
 #include <pthread.h>
+#include <time.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <sys/stat.h>
@@ -24,14 +26,21 @@
 #include "telemetry_json.h"
 #include "telemetry_data.h"
 #include "telemetry_internal.h"
+#include "telemetry_stream.h"
 
 #define MAX_CMD_LEN 56
 #define MAX_OUTPUT_LEN (1024 * 16)
 #define MAX_CONNECTIONS 10
+#define MAX_STREAM_SETS 64
+#define MAX_STREAM_PERIOD_MS 60000
+#define STREAM_NO_SET UINT16_MAX
+#define NS_PER_MS 1000000
 
 #ifndef RTE_EXEC_ENV_WINDOWS
 static void *
 client_handler(void *socket);
+static void *
+stream_client_handler(void *socket);
 #endif /* !RTE_EXEC_ENV_WINDOWS */
 
 struct cmd_callback {
@@ -49,6 +58,8 @@ struct socket {
 };
 static struct socket v2_socket; /* socket for v2 telemetry */
 static struct socket v1_socket; /* socket for v1 telemetry */
+static struct socket stream_socket; /* socket for binary streaming */
+static short v2_suffix; /* instance suffix of the v2 socket path */
 #endif /* !RTE_EXEC_ENV_WINDOWS */
 
 static const char *telemetry_version; /* save rte_version */
@@ -67,6 +78,7 @@ static int num_callbacks; /* How many commands are registered */
 static rte_spinlock_t callback_sl = RTE_SPINLOCK_INITIALIZER;
 #ifndef RTE_EXEC_ENV_WINDOWS
 static uint16_t v2_clients;
+static uint16_t stream_clients;
 #endif /* !RTE_EXEC_ENV_WINDOWS */
 
 int
@@ -369,6 +381,25 @@ unknown_command(const char *cmd __rte_unused, const char *params __rte_unused,
 	return d->type = TEL_NULL;
 }
 
+static telemetry_cb
+find_command(const char *cmd)
+{
+	telemetry_cb fn = NULL;
+	int i;
+
+	if (cmd == NULL || strlen(cmd) >= MAX_CMD_LEN)
+		return NULL;
+
+	rte_spinlock_lock(&callback_sl);
+	for (i = 0; i < num_callbacks; i++)
+		if (strcmp(cmd, callbacks[i].cmd) == 0) {
+			fn = callbacks[i].fn;
+			break;
+		}
+	rte_spinlock_unlock(&callback_sl);
+	return fn;
+}
+
 static void *
 client_handler(void *sock_id)
 {
@@ -389,19 +420,9 @@ client_handler(void *sock_id)
 		buffer[bytes] = 0;
 		const char *cmd = strtok(buffer, ",");
 		const char *param = strtok(NULL, "\0");
-		telemetry_cb fn = unknown_command;
-		int i;
-
-		if (cmd && strlen(cmd) < MAX_CMD_LEN) {
-			rte_spinlock_lock(&callback_sl);
-			for (i = 0; i < num_callbacks; i++)
-				if (strcmp(cmd, callbacks[i].cmd) == 0) {
-					fn = callbacks[i].fn;
-					break;
-				}
-			rte_spinlock_unlock(&callback_sl);
-		}
-		perform_command(fn, cmd, param, s);
+		telemetry_cb fn = find_command(cmd);
+
+		perform_command(fn != NULL ? fn : unknown_command, cmd, param, s);
 
 		bytes = read(s, buffer, sizeof(buffer) - 1);
 	}
@@ -410,6 +431,296 @@ client_handler(void *sock_id)
 	return NULL;
 }
 
+/* A set of counters a stream client subscribed to. */
+struct stream_set {
+	char cmd[MAX_CMD_LEN];
+	char *params;
+	telemetry_cb fn;
+	uint64_t period; /* ns */
+	uint64_t next;   /* time of the next snapshot, ns */
+	uint64_t seq;
+	int schema_sent;
+	struct tel_stream_snapshot cur;
+	struct tel_stream_snapshot prev;
+};
+
+struct stream_client {
+	int s;
+	struct rte_tel_data *data;
+	uint8_t *msg;
+	size_t msg_size;
+	struct stream_set *sets[MAX_STREAM_SETS];
+};
+
+static uint64_t
+stream_time(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 * NS_PER_MS + ts.tv_nsec;
+}
+
+/* make sure the message buffer holds the header and len more bytes */
+static uint8_t *
+stream_msg_get(struct stream_client *c, size_t len)
+{
+	size_t size = sizeof(struct tel_stream_hdr) + len;
+	uint8_t *msg;
+
+	if (size <= c->msg_size)
+		return c->msg;
+	msg = realloc(c->msg, size);
+	if (msg == NULL)
+		return NULL;
+	c->msg = msg;
+	c->msg_size = size;
+	return msg;
+}
+
+static int
+stream_send(struct stream_client *c, uint16_t type, uint16_t set_id,
+		uint32_t count, uint64_t seq, uint64_t timestamp, size_t len)
+{
+	struct tel_stream_hdr *hdr = (struct tel_stream_hdr *)c->msg;
+
+	hdr->type = type;
+	hdr->set_id = set_id;
+	hdr->count = count;
+	hdr->seq = seq;
+	hdr->timestamp = timestamp;
+	if (write(c->s, c->msg, sizeof(*hdr) + len) < 0) {
+		TMTY_LOG(DEBUG, "Error writing to stream socket: %s\n",
+			 strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+static int
+stream_send_error(struct stream_client *c, uint16_t set_id, const char *err)
+{
+	size_t len = strlen(err) + 1;
+	uint8_t *msg = stream_msg_get(c, len);
+
+	if (msg == NULL)
+		return -1;
+	memcpy(msg + sizeof(struct tel_stream_hdr), err, len);
+	return stream_send(c, TEL_STREAM_MSG_ERROR, set_id, 0, 0,
+			stream_time(), len);
+}
+
+static void
+stream_set_free(struct stream_set *set)
+{
+	rte_tel_stream_snapshot_free(&set->cur);
+	rte_tel_stream_snapshot_free(&set->prev);
+	free(set->params);
+	free(set);
+}
+
+/*
+ * Run the command of a set and send its counters, preceded by their names
+ * whenever the list of counters changes, e.g. on the first snapshot.
+ * Counters are encoded as deltas against the previous snapshot, or against
+ * zero right after a schema message.
+ */
+static int
+stream_snapshot(struct stream_client *c, uint16_t set_id, uint64_t now)
+{
+	struct stream_set *set = c->sets[set_id];
+	struct tel_stream_snapshot tmp;
+	const uint64_t *prev = NULL;
+	uint8_t *msg;
+	size_t used;
+	unsigned int i;
+
+	memset(c->data, 0, sizeof(*c->data));
+	if (set->fn(set->cmd, set->params, c->data) < 0)
+		return stream_send_error(c, set_id, "Command failed");
+	if (rte_tel_stream_flatten(&set->cur, c->data) < 0)
+		return stream_send_error(c, set_id, "Out of memory");
+
+	if (!set->schema_sent ||
+			!rte_tel_stream_same_schema(&set->cur, &set->prev)) {
+		msg = stream_msg_get(c, set->cur.names_len);
+		if (msg == NULL)
+			return -1;
+		memcpy(msg + sizeof(struct tel_stream_hdr), set->cur.names,
+			set->cur.names_len);
+		if (stream_send(c, TEL_STREAM_MSG_SCHEMA, set_id,
+				set->cur.n_values, set->seq, now,
+				set->cur.names_len) < 0)
+			return -1;
+		set->schema_sent = 1;
+	} else
+		prev = set->prev.values;
+
+	msg = stream_msg_get(c, set->cur.n_values * TEL_STREAM_VARINT_MAX);
+	if (msg == NULL)
+		return -1;
+	used = sizeof(struct tel_stream_hdr);
+	for (i = 0; i < set->cur.n_values; i++)
+		used += rte_tel_stream_put_delta(msg + used,
+				prev != NULL ? prev[i] : 0, set->cur.values[i]);
+	if (stream_send(c, TEL_STREAM_MSG_DATA, set_id, set->cur.n_values,
+			set->seq++, now, used - sizeof(struct tel_stream_hdr)) < 0)
+		return -1;
+
+	/* current snapshot is the reference of the next one */
+	tmp = set->prev;
+	set->prev = set->cur;
+	set->cur = tmp;
+	return 0;
+}
+
+/*
+ * Handle "subscribe,<period_ms>,<command>[,<params>]" and
+ * "unsubscribe,<set_id>" requests.
+ * A new subscription is answered with its first snapshot, the set id being
+ * the one of the schema message, errors with an error message.
+ */
+static int
+stream_request(struct stream_client *c, char *buffer)
+{
+	const char *req = strtok(buffer, ",");
+	const char *arg = strtok(NULL, ",");
+	const char *cmd, *param;
+	struct stream_set *set;
+	telemetry_cb fn;
+	char *end = NULL;
+	unsigned long val;
+	uint64_t now;
+	uint16_t i;
+
+	if (req == NULL || arg == NULL)
+		return stream_send_error(c, STREAM_NO_SET, "Invalid request");
+	val = strtoul(arg, &end, 0);
+	if (*end != '\0')
+		return stream_send_error(c, STREAM_NO_SET, "Invalid request");
+
+	if (strcmp(req, "unsubscribe") == 0) {
+		if (val >= MAX_STREAM_SETS || c->sets[val] == NULL)
+			return stream_send_error(c, STREAM_NO_SET,
+					"Invalid set id");
+		stream_set_free(c->sets[val]);
+		c->sets[val] = NULL;
+		return 0;
+	}
+
+	if (strcmp(req, "subscribe") != 0)
+		return stream_send_error(c, STREAM_NO_SET, "Unknown request");
+	if (val == 0 || val > MAX_STREAM_PERIOD_MS)
+		return stream_send_error(c, STREAM_NO_SET, "Invalid period");
+
+	for (i = 0; i < MAX_STREAM_SETS && c->sets[i] != NULL; i++)
+		;
+	if (i == MAX_STREAM_SETS)
+		return stream_send_error(c, STREAM_NO_SET,
+				"Too many subscriptions");
+
+	cmd = strtok(NULL, ",");
+	param = strtok(NULL, "\0");
+	fn = find_command(cmd);
+	if (fn == NULL)
+		return stream_send_error(c, STREAM_NO_SET, "Unknown command");
+
+	set = calloc(1, sizeof(*set));
+	if (set == NULL)
+		return stream_send_error(c, STREAM_NO_SET, "Out of memory");
+	if (param != NULL) {
+		set->params = strdup(param);
+		if (set->params == NULL) {
+			free(set);
+			return stream_send_error(c, STREAM_NO_SET,
+					"Out of memory");
+		}
+	}
+	strlcpy(set->cmd, cmd, sizeof(set->cmd));
+	set->fn = fn;
+	set->period = val * NS_PER_MS;
+	c->sets[i] = set;
+
+	now = stream_time();
+	set->next = now + set->period;
+	return stream_snapshot(c, i, now);
+}
+
+/*
+ * Each stream client is served by its own thread, waiting for requests
+ * until the earliest snapshot of its subscriptions is due.
+ * Callbacks fill struct rte_tel_data in binary form, so the counters are
+ * copied from it without any text formatting.
+ */
+static void *
+stream_client_handler(void *sock_id)
+{
+	struct stream_client c = { .s = (int)(uintptr_t)sock_id };
+	struct pollfd pfd = { .fd = c.s, .events = POLLIN };
+	char buffer[1024];
+	uint16_t i;
+
+	c.data = rte_tel_data_alloc();
+	if (c.data == NULL)
+		goto out;
+
+	while (1) {
+		uint64_t now = stream_time();
+		int timeout = -1;
+		int rc;
+
+		for (i = 0; i < MAX_STREAM_SETS; i++) {
+			uint64_t wait;
+			int ms;
+
+			if (c.sets[i] == NULL)
+				continue;
+			wait = c.sets[i]->next > now ? c.sets[i]->next - now : 0;
+			ms = (wait + NS_PER_MS - 1) / NS_PER_MS;
+			if (timeout < 0 || ms < timeout)
+				timeout = ms;
+		}
+
+		rc = poll(&pfd, 1, timeout);
+		if (rc < 0 && errno != EINTR)
+			break;
+		if (rc > 0) {
+			/* receive data is not null terminated */
+			int bytes = read(c.s, buffer, sizeof(buffer) - 1);
+
+			if (bytes <= 0)
+				break;
+			buffer[bytes] = 0;
+			if (stream_request(&c, buffer) < 0)
+				break;
+		}
+
+		now = stream_time();
+		for (i = 0; i < MAX_STREAM_SETS; i++) {
+			struct stream_set *set = c.sets[i];
+
+			if (set == NULL || set->next > now)
+				continue;
+			if (stream_snapshot(&c, i, now) < 0)
+				goto out;
+			/* keep the period, unless we are running late */
+			set->next += set->period;
+			if (set->next <= now)
+				set->next = now + set->period;
+		}
+	}
+
+out:
+	for (i = 0; i < MAX_STREAM_SETS; i++)
+		if (c.sets[i] != NULL)
+			stream_set_free(c.sets[i]);
+	rte_tel_data_free(c.data);
+	free(c.msg);
+	close(c.s);
+	__atomic_fetch_sub(&stream_clients, 1, __ATOMIC_RELAXED);
+	return NULL;
+}
+
 static void *
 socket_listener(void *socket)
 {
@@ -464,6 +775,8 @@ unlink_sockets(void)
 		unlink(v2_socket.path);
 	if (v1_socket.path[0])
 		unlink(v1_socket.path);
+	if (stream_socket.path[0])
+		unlink(stream_socket.path);
 }
 
 static int
@@ -569,6 +882,51 @@ telemetry_legacy_init(void)
 	return 0;
 }
 
+static int
+telemetry_stream_init(void)
+{
+	pthread_t t_stream;
+	int len;
+	int rc;
+
+	stream_socket.num_clients = &stream_clients;
+	stream_socket.fn = stream_client_handler;
+	/* use the same instance suffix as the v2 socket */
+	if (v2_suffix != 0)
+		len = snprintf(stream_socket.path, sizeof(stream_socket.path),
+				"%s/dpdk_telemetry_stream.v%d:%d", socket_dir,
+				TEL_STREAM_VERSION, v2_suffix);
+	else
+		len = snprintf(stream_socket.path, sizeof(stream_socket.path),
+				"%s/dpdk_telemetry_stream.v%d", socket_dir,
+				TEL_STREAM_VERSION);
+	if (len >= (int)sizeof(stream_socket.path)) {
+		TMTY_LOG(ERR, "Error with socket binding, path too long\n");
+		stream_socket.path[0] = '\0';
+		return -1;
+	}
+	stream_socket.sock = create_socket(stream_socket.path);
+	if (stream_socket.sock < 0) {
+		stream_socket.path[0] = '\0';
+		return -1;
+	}
+	rc = pthread_create(&t_stream, NULL, socket_listener, &stream_socket);
+	if (rc != 0) {
+		TMTY_LOG(ERR, "Error with create stream socket thread: %s\n",
+			 strerror(rc));
+		close(stream_socket.sock);
+		stream_socket.sock = -1;
+		unlink(stream_socket.path);
+		stream_socket.path[0] = '\0';
+		return -1;
+	}
+	pthread_setaffinity_np(t_stream, sizeof(*thread_cpuset), thread_cpuset);
+	set_thread_name(t_stream, "telemetry-strm");
+	TMTY_LOG(DEBUG, "Telemetry stream socket initialized ok\n");
+	pthread_detach(t_stream);
+	return 0;
+}
+
 static int
 telemetry_v2_init(void)
 {
@@ -606,6 +964,7 @@ telemetry_v2_init(void)
 		}
 		v2_socket.sock = create_socket(v2_socket.path);
 	}
+	v2_suffix = suffix;
 	rc = pthread_create(&t_new, NULL, socket_listener, &v2_socket);
 	if (rc != 0) {
 		TMTY_LOG(ERR, "Error with create socket thread: %s\n",
@@ -640,6 +999,7 @@ rte_telemetry_init(const char *runtime_dir, const char *rte_version, rte_cpuset_
 	if (telemetry_v2_init() != 0)
 		return -1;
 	TMTY_LOG(DEBUG, "Telemetry initialized ok\n");
+	telemetry_stream_init();
 	telemetry_legacy_init();
 #endif /* RTE_EXEC_ENV_WINDOWS */
 
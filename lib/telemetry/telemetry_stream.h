@@ -0,0 +1,298 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 agent
+ */
+
+#ifndef _RTE_TELEMETRY_STREAM_H_
+#define _RTE_TELEMETRY_STREAM_H_
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rte_common.h>
+#include <rte_telemetry.h>
+
+#include "telemetry_data.h"
+
+/**
+ * @file
+ * Internal Telemetry streaming utility functions
+ *
+ * This file contains small inline functions used to encode the binary
+ * messages of the telemetry stream socket. A subscribed command is run
+ * periodically, the integer values of the returned data are flattened into
+ * a list of named counters, described once by a schema message, and then
+ * sent as a list of zigzag varint encoded deltas against the previous
+ * snapshot. Counters which did not change take a single byte.
+ */
+
+/** Version of the stream protocol, part of the socket name. */
+#define TEL_STREAM_VERSION 1
+
+/** Max number of bytes taken by an encoded delta. */
+#define TEL_STREAM_VARINT_MAX 10
+
+/** Max length of a flattened counter name, including the terminating NUL. */
+#define TEL_STREAM_MAX_NAME_LEN 256
+
+/** Max nesting of containers walked when flattening data. */
+#define TEL_STREAM_MAX_DEPTH 4
+
+/** Types of the messages sent on the stream socket. */
+enum tel_stream_msg_type {
+	TEL_STREAM_MSG_SCHEMA = 1,
+	/**< count NUL terminated counter names follow the header */
+	TEL_STREAM_MSG_DATA = 2,
+	/**< count encoded deltas follow the header */
+	TEL_STREAM_MSG_ERROR = 3,
+	/**< a NUL terminated error string follows the header */
+};
+
+/**
+ * Header of every message sent on the stream socket,
+ * in host byte order as the socket is local.
+ */
+struct tel_stream_hdr {
+	uint16_t type;      /**< one of tel_stream_msg_type */
+	uint16_t set_id;    /**< subscription the message belongs to */
+	uint32_t count;     /**< number of counters */
+	uint64_t seq;       /**< sequence number of the snapshot */
+	uint64_t timestamp; /**< CLOCK_MONOTONIC time of the snapshot, in ns */
+};
+
+/**
+ * Counters of one snapshot, flattened out of a struct rte_tel_data.
+ * Names are stored back to back, each NUL terminated.
+ */
+struct tel_stream_snapshot {
+	uint64_t *values;
+	unsigned int n_values;
+	unsigned int max_values;
+	char *names;
+	size_t names_len;
+	size_t names_size;
+};
+
+/**
+ * @internal
+ * Free the buffers of a snapshot.
+ */
+static inline void
+rte_tel_stream_snapshot_free(struct tel_stream_snapshot *s)
+{
+	free(s->values);
+	free(s->names);
+	memset(s, 0, sizeof(*s));
+}
+
+/**
+ * @internal
+ * Append a counter to a snapshot, growing its buffers as needed.
+ */
+static inline int
+rte_tel_stream_snapshot_add(struct tel_stream_snapshot *s, const char *name,
+		uint64_t val)
+{
+	size_t len = strlen(name) + 1;
+
+	if (s->n_values == s->max_values) {
+		unsigned int n = RTE_MAX(s->max_values * 2, 64U);
+		uint64_t *v = realloc(s->values, n * sizeof(*v));
+
+		if (v == NULL)
+			return -ENOMEM;
+		s->values = v;
+		s->max_values = n;
+	}
+	if (s->names_len + len > s->names_size) {
+		size_t n = RTE_MAX(s->names_size * 2, s->names_len + len);
+		char *p = realloc(s->names, n);
+
+		if (p == NULL)
+			return -ENOMEM;
+		s->names = p;
+		s->names_size = n;
+	}
+
+	memcpy(s->names + s->names_len, name, len);
+	s->names_len += len;
+	s->values[s->n_values++] = val;
+	return 0;
+}
+
+static inline int
+__stream_flatten(struct tel_stream_snapshot *s, const struct rte_tel_data *d,
+		const char *prefix, unsigned int depth);
+
+/**
+ * @internal
+ * Add a container to the snapshot, its counters being named
+ * "<prefix><name>.<counter>", and free it unless it is to be kept.
+ */
+static inline int
+__stream_flatten_container(struct tel_stream_snapshot *s,
+		const struct container *c, const char *prefix, const char *name,
+		unsigned int depth)
+{
+	char path[TEL_STREAM_MAX_NAME_LEN];
+	int ret = 0;
+
+	if (depth < TEL_STREAM_MAX_DEPTH) {
+		snprintf(path, sizeof(path), "%s%s.", prefix, name);
+		ret = __stream_flatten(s, c->data, path, depth + 1);
+	}
+	if (!c->keep)
+		rte_tel_data_free(c->data);
+	return ret;
+}
+
+static inline int
+__stream_flatten(struct tel_stream_snapshot *s, const struct rte_tel_data *d,
+		const char *prefix, unsigned int depth)
+{
+	char name[TEL_STREAM_MAX_NAME_LEN];
+	char idx[16];
+	unsigned int i;
+	int ret = 0;
+
+	switch (d->type) {
+	case TEL_DICT:
+		for (i = 0; i < d->data_len && ret == 0; i++) {
+			const struct tel_dict_entry *e = &d->data.dict[i];
+
+			snprintf(name, sizeof(name), "%s%s", prefix, e->name);
+			switch (e->type) {
+			case RTE_TEL_INT_VAL:
+				ret = rte_tel_stream_snapshot_add(s, name,
+						e->value.ival);
+				break;
+			case RTE_TEL_UINT_VAL:
+				ret = rte_tel_stream_snapshot_add(s, name,
+						e->value.uval);
+				break;
+			case RTE_TEL_CONTAINER:
+				ret = __stream_flatten_container(s,
+						&e->value.container, prefix,
+						e->name, depth);
+				break;
+			default: /* strings are not counters */
+				break;
+			}
+		}
+		break;
+	case TEL_ARRAY_INT:
+	case TEL_ARRAY_UINT:
+		for (i = 0; i < d->data_len && ret == 0; i++) {
+			snprintf(name, sizeof(name), "%s%u", prefix, i);
+			ret = rte_tel_stream_snapshot_add(s, name,
+					d->type == TEL_ARRAY_INT ?
+					(uint64_t)d->data.array[i].ival :
+					d->data.array[i].uval);
+		}
+		break;
+	case TEL_ARRAY_CONTAINER:
+		for (i = 0; i < d->data_len && ret == 0; i++) {
+			snprintf(idx, sizeof(idx), "%u", i);
+			ret = __stream_flatten_container(s,
+					&d->data.array[i].container, prefix,
+					idx, depth);
+		}
+		break;
+	default: /* strings and null carry no counter */
+		break;
+	}
+
+	return ret;
+}
+
+/**
+ * @internal
+ * Flatten the integer values of a telemetry callback result into a snapshot.
+ * Dictionary entries are named after their key, array entries after their
+ * index, and the counters of nested containers get the container name and
+ * a dot as prefix, e.g. "rx_q.3". Non kept containers are freed, as done when
+ * formatting the data in JSON.
+ *
+ * @return
+ *  0 on success, -ENOMEM if the snapshot buffers cannot be grown.
+ */
+static inline int
+rte_tel_stream_flatten(struct tel_stream_snapshot *s,
+		const struct rte_tel_data *d)
+{
+	s->n_values = 0;
+	s->names_len = 0;
+	return __stream_flatten(s, d, "", 0);
+}
+
+/**
+ * @internal
+ * Encode the difference between two counter values, as a zigzag varint.
+ * The delta is computed modulo 2^64, so that both signed values and
+ * wrapping unsigned counters are handled, the buffer must have room for
+ * TEL_STREAM_VARINT_MAX bytes.
+ *
+ * @return
+ *  Number of bytes written.
+ */
+static inline int
+rte_tel_stream_put_delta(uint8_t *buf, uint64_t prev, uint64_t val)
+{
+	int64_t delta = (int64_t)(val - prev);
+	uint64_t zz = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+	int n = 0;
+
+	while (zz >= 0x80) {
+		buf[n++] = (uint8_t)(zz | 0x80);
+		zz >>= 7;
+	}
+	buf[n++] = (uint8_t)zz;
+	return n;
+}
+
+/**
+ * @internal
+ * Decode a delta encoded by rte_tel_stream_put_delta() and apply it
+ * to a counter value.
+ *
+ * @return
+ *  Number of bytes read, or 0 if the encoding is truncated or invalid.
+ */
+static inline int
+rte_tel_stream_get_delta(const uint8_t *buf, size_t len, uint64_t *val)
+{
+	uint64_t zz = 0;
+	unsigned int shift = 0;
+	size_t n = 0;
+
+	while (n < len && n < TEL_STREAM_VARINT_MAX) {
+		uint8_t b = buf[n++];
+
+		zz |= (uint64_t)(b & 0x7f) << shift;
+		if ((b & 0x80) == 0) {
+			*val += (zz >> 1) ^ -(zz & 1);
+			return n;
+		}
+		shift += 7;
+	}
+	return 0;
+}
+
+/**
+ * @internal
+ * Compare the counter names of two snapshots.
+ *
+ * @return
+ *  Non zero if they describe the same counters.
+ */
+static inline int
+rte_tel_stream_same_schema(const struct tel_stream_snapshot *a,
+		const struct tel_stream_snapshot *b)
+{
+	return a->n_values == b->n_values && a->names_len == b->names_len &&
+		(a->names_len == 0 ||
+		memcmp(a->names, b->names, a->names_len) == 0);
+}
+
+#endif /* _RTE_TELEMETRY_STREAM_H_ */
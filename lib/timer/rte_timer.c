@@ -18,6 +18,7 @@
 #include <rte_random.h>
 #include <rte_pause.h>
 #include <rte_memzone.h>
+#include <rte_malloc.h>
 
 #include "rte_timer.h"
 
@@ -40,16 +41,60 @@ struct priv_timer {
 	/** running timer on this lcore now */
 	struct rte_timer *running_tim;
 
+	/** running timers handed to a burst callback on this lcore now */
+	struct rte_timer **running_tims;
+	unsigned int nb_running_tims;
+	/** bitmask of the running_tims updated by the burst callback */
+	uint32_t updated_tims;
+
 #ifdef RTE_LIBRTE_TIMER_DEBUG
 	/** per-lcore statistics */
 	struct rte_timer_debug_stats stats;
 #endif
 } __rte_cache_aligned;
 
+#define TIMER_WHEEL_LEVELS	4
+#define TIMER_WHEEL_SLOTS_LOG2	8
+#define TIMER_WHEEL_SLOTS	(1 << TIMER_WHEEL_SLOTS_LOG2)
+#define TIMER_WHEEL_SLOT_MASK	(TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_RANGE	(1ULL << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS_LOG2))
+
+/* Number of expired timers handed at once to the burst callback */
+#define TIMER_MANAGE_BURST_SIZE	32
+
+/**
+ * Per-lcore hierarchical timing wheel, used instead of the skiplist when
+ * enabled on the timer data instance. Level n slots span 256^n ticks. A
+ * pending timer is linked in its slot using sl_next[0] as next pointer and
+ * sl_next[1] as a pointer to the previous next pointer, so that it can be
+ * removed in constant time, sl_next[1] being NULL once it left the wheel.
+ *
+ * Other lcores do not take the list lock to start a timer on the wheel, they
+ * queue it on the request list under the request lock, linked through
+ * sl_next[2] as next pointer and sl_next[3] as a pointer to the previous next
+ * pointer, NULL once it left the list. The timer is pending as soon as it is
+ * queued, and is moved to the wheel by the lcore managing it. The request lock
+ * is taken after the list lock when both are needed.
+ */
+struct timer_wheel {
+	uint64_t cur_tick;              /**< last tick processed */
+	uint32_t n_pending;             /**< number of timers in the wheel */
+	/** bitmap of the non-empty slots of each level */
+	uint64_t bmp[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS / 64];
+	struct rte_timer *slot[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+	/** lock protecting the request list */
+	rte_spinlock_t requests_lock __rte_cache_aligned;
+	/** timers started by other lcores, to be added to the wheel */
+	struct rte_timer *requests;
+} __rte_cache_aligned;
+
 #define FL_ALLOCATED	(1 << 0)
 struct rte_timer_data {
 	struct priv_timer priv_timer[RTE_MAX_LCORE];
 	uint8_t internal_flags;
+	/** per-lcore timing wheels, NULL when using the skiplists */
+	struct timer_wheel *wheel;
+	uint32_t wheel_tick_shift;
 };
 
 #define RTE_MAX_DATA_ELS 64
@@ -116,6 +161,46 @@ rte_timer_data_dealloc(uint32_t id)
 
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
 
+	rte_free(timer_data->wheel);
+	timer_data->wheel = NULL;
+
+	return 0;
+}
+
+int
+rte_timer_alt_wheel_enable(uint32_t timer_data_id, uint64_t tick_cycles)
+{
+	struct rte_timer_data *timer_data;
+	struct timer_wheel *wheel;
+	uint64_t cur_tick;
+	uint32_t shift;
+	unsigned int lcore_id;
+
+	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
+
+	if (timer_data_id == default_data_id || tick_cycles == 0)
+		return -EINVAL;
+
+	if (timer_data->wheel != NULL)
+		return -EBUSY;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		if (timer_data->priv_timer[lcore_id].pending_head.sl_next[0])
+			return -EBUSY;
+
+	wheel = rte_zmalloc("rte_timer_wheel", RTE_MAX_LCORE * sizeof(*wheel),
+			    RTE_CACHE_LINE_SIZE);
+	if (wheel == NULL)
+		return -ENOMEM;
+
+	shift = 63 - __builtin_clzll(tick_cycles);
+	cur_tick = rte_get_timer_cycles() >> shift;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		wheel[lcore_id].cur_tick = cur_tick;
+
+	timer_data->wheel_tick_shift = shift;
+	timer_data->wheel = wheel;
+
 	return 0;
 }
 
@@ -194,8 +279,13 @@ rte_timer_subsystem_finalize(void)
 		return;
 	}
 
-	if (--(*rte_timer_mz_refcnt) == 0)
+	if (--(*rte_timer_mz_refcnt) == 0) {
+		int i;
+
+		for (i = 0; i < RTE_MAX_DATA_ELS; i++)
+			rte_free(rte_timer_data_arr[i].wheel);
 		rte_memzone_free(rte_timer_data_mz);
+	}
 
 	rte_timer_subsystem_initialized = 0;
 
@@ -213,6 +303,36 @@ rte_timer_init(struct rte_timer *tim)
 	__atomic_store_n(&tim->status.u32, status.u32, __ATOMIC_RELAXED);
 }
 
+/* Check if the timer is run by this lcore, alone or in a burst */
+static inline int
+timer_running_on_lcore(const struct priv_timer *privp,
+		       const struct rte_timer *tim)
+{
+	unsigned int i;
+
+	if (tim == privp->running_tim)
+		return 1;
+
+	for (i = 0; i < privp->nb_running_tims; i++)
+		if (privp->running_tims[i] == tim)
+			return 1;
+
+	return 0;
+}
+
+/* Note that a running timer was stopped or reloaded from its callback */
+static inline void
+timer_set_updated(struct priv_timer *privp, const struct rte_timer *tim)
+{
+	unsigned int i;
+
+	privp->updated = 1;
+
+	for (i = 0; i < privp->nb_running_tims; i++)
+		if (privp->running_tims[i] == tim)
+			privp->updated_tims |= 1U << i;
+}
+
 /*
  * if timer is pending or stopped (or running on the same core than
  * us), mark timer as configuring, and on success return the previous
@@ -239,7 +359,7 @@ timer_set_config_state(struct rte_timer *tim,
 		 */
 		if (prev_status.state == RTE_TIMER_RUNNING &&
 		    (prev_status.owner != (uint16_t)lcore_id ||
-		     tim != priv_timer[lcore_id].running_tim))
+		     !timer_running_on_lcore(&priv_timer[lcore_id], tim)))
 			return -1;
 
 		/* timer is being configured on another core */
@@ -463,6 +583,349 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
 }
 
+/* Tick at which the timer expires, rounded up so it never runs early */
+static inline uint64_t
+timer_wheel_tick(const struct rte_timer *tim,
+		 const struct rte_timer_data *timer_data)
+{
+	uint32_t shift = timer_data->wheel_tick_shift;
+	uint64_t expire = __atomic_load_n(&tim->expire, __ATOMIC_RELAXED);
+
+	return (expire + (1ULL << shift) - 1) >> shift;
+}
+
+/*
+ * Link the timer in the slot of the level matching its distance to the
+ * current tick. The slot of level n > 0 is emptied into the lower levels when
+ * the current tick reaches the start of the slot, which is always before the
+ * timer expiry tick.
+ */
+static void
+timer_wheel_insert(struct timer_wheel *w, struct rte_timer *tim, uint64_t tick)
+{
+	struct rte_timer **head;
+	uint64_t delta;
+	unsigned int lvl, idx;
+
+	if (tick < w->cur_tick)
+		tick = w->cur_tick;
+
+	/* Timers beyond the wheel range are parked in the top level */
+	delta = tick - w->cur_tick;
+	if (delta >= TIMER_WHEEL_RANGE) {
+		delta = TIMER_WHEEL_RANGE - 1;
+		tick = w->cur_tick + delta;
+	}
+
+	for (lvl = 0; lvl < TIMER_WHEEL_LEVELS - 1; lvl++)
+		if (delta < (1ULL << ((lvl + 1) * TIMER_WHEEL_SLOTS_LOG2)))
+			break;
+
+	idx = (tick >> (lvl * TIMER_WHEEL_SLOTS_LOG2)) & TIMER_WHEEL_SLOT_MASK;
+	head = &w->slot[lvl][idx];
+
+	tim->sl_next[0] = *head;
+	if (*head != NULL)
+		(*head)->sl_next[1] = (struct rte_timer *)&tim->sl_next[0];
+	tim->sl_next[1] = (struct rte_timer *)head;
+	*head = tim;
+
+	w->bmp[lvl][idx / 64] |= 1ULL << (idx % 64);
+	w->n_pending++;
+}
+
+/* Unlink the timer from its slot, if it is still in the wheel */
+static void
+timer_wheel_remove(struct timer_wheel *w, struct rte_timer *tim)
+{
+	struct rte_timer **pprev = (struct rte_timer **)tim->sl_next[1];
+	struct rte_timer *next = tim->sl_next[0];
+	uintptr_t slot_first = (uintptr_t)&w->slot[0][0];
+	uintptr_t slot_last = (uintptr_t)&w->slot[TIMER_WHEEL_LEVELS - 1]
+						 [TIMER_WHEEL_SLOTS - 1];
+
+	if (pprev == NULL)
+		return;
+
+	*pprev = next;
+	if (next != NULL)
+		next->sl_next[1] = (struct rte_timer *)pprev;
+	else if ((uintptr_t)pprev >= slot_first &&
+		 (uintptr_t)pprev <= slot_last) {
+		/* the slot is now empty */
+		unsigned int pos = pprev - &w->slot[0][0];
+		unsigned int lvl = pos >> TIMER_WHEEL_SLOTS_LOG2;
+		unsigned int idx = pos & TIMER_WHEEL_SLOT_MASK;
+
+		w->bmp[lvl][idx / 64] &= ~(1ULL << (idx % 64));
+	}
+
+	tim->sl_next[1] = NULL;
+	w->n_pending--;
+}
+
+/* Move the timers of an upper level slot to the lower levels */
+static void
+timer_wheel_cascade(struct timer_wheel *w, unsigned int lvl, unsigned int idx,
+		    const struct rte_timer_data *timer_data)
+{
+	struct rte_timer *tim, *next_tim;
+
+	tim = w->slot[lvl][idx];
+	w->slot[lvl][idx] = NULL;
+	w->bmp[lvl][idx / 64] &= ~(1ULL << (idx % 64));
+
+	for ( ; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[0];
+		w->n_pending--;
+		timer_wheel_insert(w, tim, timer_wheel_tick(tim, timer_data));
+	}
+}
+
+/*
+ * Next tick the wheel has to process, not beyond end_tick: either the next
+ * non-empty level 0 slot, or the next level 0 wrap around where the upper
+ * levels are cascaded.
+ */
+static uint64_t
+timer_wheel_next_tick(const struct timer_wheel *w, uint64_t end_tick)
+{
+	uint64_t tick = w->cur_tick + 1;
+	uint64_t base = tick & ~(uint64_t)TIMER_WHEEL_SLOT_MASK;
+	unsigned int idx = tick & TIMER_WHEEL_SLOT_MASK;
+	unsigned int i;
+
+	if (idx == 0)
+		return tick;
+
+	for (i = idx / 64; i < TIMER_WHEEL_SLOTS / 64; i++) {
+		uint64_t bits = w->bmp[0][i];
+
+		if (i == idx / 64)
+			bits &= ~0ULL << (idx % 64);
+		if (bits) {
+			tick = base + i * 64 + rte_bsf64(bits);
+			return RTE_MIN(tick, end_tick);
+		}
+	}
+
+	return RTE_MIN(base + TIMER_WHEEL_SLOTS, end_tick);
+}
+
+/*
+ * Advance the wheel up to end_tick and return the expired timers marked as
+ * running, linked through sl_next[0] as the skiplist run lists. Must be called
+ * with the list lock held.
+ */
+static struct rte_timer *
+timer_wheel_advance(struct timer_wheel *w, uint64_t end_tick,
+		    const struct rte_timer_data *timer_data)
+{
+	struct rte_timer *run_first_tim = NULL, **pprev = &run_first_tim;
+	struct rte_timer *tim, *next_tim;
+	unsigned int lvl, idx;
+	uint64_t tick;
+
+	while (w->cur_tick < end_tick) {
+		if (w->n_pending == 0) {
+			w->cur_tick = end_tick;
+			break;
+		}
+
+		tick = timer_wheel_next_tick(w, end_tick);
+		w->cur_tick = tick;
+
+		/* on level 0 wrap around, cascade the upper levels top down */
+		if ((tick & TIMER_WHEEL_SLOT_MASK) == 0) {
+			for (lvl = 1; lvl < TIMER_WHEEL_LEVELS - 1; lvl++)
+				if ((tick >> (lvl * TIMER_WHEEL_SLOTS_LOG2)) &
+				    TIMER_WHEEL_SLOT_MASK)
+					break;
+			for ( ; lvl > 0; lvl--)
+				timer_wheel_cascade(w, lvl,
+					(tick >> (lvl * TIMER_WHEEL_SLOTS_LOG2)) &
+					TIMER_WHEEL_SLOT_MASK, timer_data);
+		}
+
+		/* move the whole level 0 slot to the run list */
+		idx = tick & TIMER_WHEEL_SLOT_MASK;
+		tim = w->slot[0][idx];
+		if (tim == NULL)
+			continue;
+
+		w->slot[0][idx] = NULL;
+		w->bmp[0][idx / 64] &= ~(1ULL << (idx % 64));
+		for ( ; tim != NULL; tim = next_tim) {
+			next_tim = tim->sl_next[0];
+			tim->sl_next[1] = NULL;
+			w->n_pending--;
+
+			/* a timer being re-configured by another core is
+			 * left out of the run list
+			 */
+			if (likely(timer_set_running_state(tim) == 0)) {
+				*pprev = tim;
+				pprev = &tim->sl_next[0];
+			}
+		}
+	}
+	*pprev = NULL;
+
+	return run_first_tim;
+}
+
+/* call with lock held as necessary, timer must be in config state */
+static void
+timer_wheel_add(struct rte_timer *tim, unsigned int tim_lcore,
+		struct rte_timer_data *timer_data)
+{
+	struct timer_wheel *w = &timer_data->wheel[tim_lcore];
+	uint64_t tick = timer_wheel_tick(tim, timer_data);
+
+	/* an empty wheel may not have been advanced for a long time */
+	if (w->n_pending == 0)
+		w->cur_tick = RTE_MAX(w->cur_tick, rte_get_timer_cycles() >>
+				      timer_data->wheel_tick_shift);
+
+	/* already expired timers run on the next tick */
+	if (tick <= w->cur_tick)
+		tick = w->cur_tick + 1;
+
+	tim->sl_next[3] = NULL;
+	timer_wheel_insert(w, tim, tick);
+}
+
+/* Unlink the timer from the request list, if it is still queued there */
+static int
+timer_wheel_request_del(struct timer_wheel *w, struct rte_timer *tim)
+{
+	struct rte_timer **pprev;
+	struct rte_timer *next;
+	int queued = 0;
+
+	rte_spinlock_lock(&w->requests_lock);
+
+	pprev = (struct rte_timer **)tim->sl_next[3];
+	if (pprev != NULL) {
+		next = tim->sl_next[2];
+		__atomic_store_n(pprev, next, __ATOMIC_RELAXED);
+		if (next != NULL)
+			next->sl_next[3] = (struct rte_timer *)pprev;
+		tim->sl_next[3] = NULL;
+		queued = 1;
+	}
+
+	rte_spinlock_unlock(&w->requests_lock);
+
+	return queued;
+}
+
+/* same locking as timer_del(), timer must be in config state */
+static void
+timer_wheel_del(struct rte_timer *tim, union rte_timer_status prev_status,
+		int local_is_locked, struct rte_timer_data *timer_data)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	unsigned int prev_owner = prev_status.owner;
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+	struct timer_wheel *w = &timer_data->wheel[prev_owner];
+
+	if (prev_owner != lcore_id || !local_is_locked)
+		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
+
+	if (!timer_wheel_request_del(w, tim))
+		timer_wheel_remove(w, tim);
+
+	if (prev_owner != lcore_id || !local_is_locked)
+		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
+}
+
+/*
+ * Queue a timer in config state for the lcore managing the wheel, and mark it
+ * pending on that lcore.
+ */
+static void
+timer_wheel_request_add(struct rte_timer *tim, unsigned int tim_lcore,
+			struct rte_timer_data *timer_data)
+{
+	struct timer_wheel *w = &timer_data->wheel[tim_lcore];
+	union rte_timer_status status;
+
+	rte_spinlock_lock(&w->requests_lock);
+
+	tim->sl_next[1] = NULL;
+	tim->sl_next[2] = w->requests;
+	if (w->requests != NULL)
+		w->requests->sl_next[3] = (struct rte_timer *)&tim->sl_next[2];
+	tim->sl_next[3] = (struct rte_timer *)&w->requests;
+	__atomic_store_n(&w->requests, tim, __ATOMIC_RELAXED);
+
+	/* update state: as we are in CONFIG state, only us can modify
+	 * the state so we don't need to use cmpset() here. Another lcore
+	 * removing the timer from the list has to take the request lock.
+	 */
+	status.state = RTE_TIMER_PENDING;
+	status.owner = (int16_t)tim_lcore;
+	/* The "RELEASE" ordering guarantees the memory operations above
+	 * the status update are observed before the update by all threads
+	 */
+	__atomic_store_n(&tim->status.u32, status.u32, __ATOMIC_RELEASE);
+
+	rte_spinlock_unlock(&w->requests_lock);
+}
+
+/* Add the timers started by other lcores to the wheel, with list lock held */
+static void
+timer_wheel_requests_drain(struct rte_timer_data *timer_data,
+			   unsigned int tim_lcore)
+{
+	struct timer_wheel *w = &timer_data->wheel[tim_lcore];
+	struct rte_timer *tim, *next_tim;
+
+	if (__atomic_load_n(&w->requests, __ATOMIC_RELAXED) == NULL)
+		return;
+
+	rte_spinlock_lock(&w->requests_lock);
+	tim = w->requests;
+	__atomic_store_n(&w->requests, NULL, __ATOMIC_RELAXED);
+	for (next_tim = tim; next_tim != NULL; next_tim = next_tim->sl_next[2])
+		next_tim->sl_next[3] = NULL;
+	rte_spinlock_unlock(&w->requests_lock);
+
+	/* the timers stay pending, other lcores need the list lock to update
+	 * them now that they left the request list
+	 */
+	for ( ; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[2];
+		timer_wheel_add(tim, tim_lcore, timer_data);
+	}
+}
+
+/* Collect the expired timers of the wheel of poll_lcore */
+static struct rte_timer *
+timer_wheel_run_list_get(struct rte_timer_data *timer_data,
+			 unsigned int poll_lcore)
+{
+	struct priv_timer *privp = &timer_data->priv_timer[poll_lcore];
+	struct timer_wheel *w = &timer_data->wheel[poll_lcore];
+	struct rte_timer *run_first_tim;
+	uint64_t cur_tick;
+
+	/* no lock needed to find out nothing can have expired */
+	cur_tick = rte_get_timer_cycles() >> timer_data->wheel_tick_shift;
+	if (__atomic_load_n(&w->requests, __ATOMIC_RELAXED) == NULL &&
+	    (w->n_pending == 0 || cur_tick <= w->cur_tick))
+		return NULL;
+
+	rte_spinlock_lock(&privp->list_lock);
+
+	timer_wheel_requests_drain(timer_data, poll_lcore);
+	run_first_tim = timer_wheel_advance(w, cur_tick, timer_data);
+	rte_spinlock_unlock(&privp->list_lock);
+
+	return run_first_tim;
+}
+
 /* Reset and start the timer associated with the timer handle (private func) */
 static int
 __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
@@ -499,20 +962,35 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 	__TIMER_STAT_ADD(priv_timer, reset, 1);
 	if (prev_status.state == RTE_TIMER_RUNNING &&
 	    lcore_id < RTE_MAX_LCORE) {
-		priv_timer[lcore_id].updated = 1;
+		timer_set_updated(&priv_timer[lcore_id], tim);
 	}
 
 	/* remove it from list */
 	if (prev_status.state == RTE_TIMER_PENDING) {
-		timer_del(tim, prev_status, local_is_locked, priv_timer);
+		if (timer_data->wheel != NULL)
+			timer_wheel_del(tim, prev_status, local_is_locked,
+					timer_data);
+		else
+			timer_del(tim, prev_status, local_is_locked,
+				  priv_timer);
 		__TIMER_STAT_ADD(priv_timer, pending, -1);
 	}
 
 	tim->period = period;
-	tim->expire = expire;
+	/* the wheel of another lcore may compute the tick of the timer */
+	__atomic_store_n(&tim->expire, expire, __ATOMIC_RELAXED);
 	tim->f = fct;
 	tim->arg = arg;
 
+	/* a timer started on the wheel of another lcore is handed over to
+	 * that lcore through its request list, without its list lock
+	 */
+	if (timer_data->wheel != NULL && tim_lcore != lcore_id) {
+		__TIMER_STAT_ADD(priv_timer, pending, 1);
+		timer_wheel_request_add(tim, tim_lcore, timer_data);
+		return 0;
+	}
+
 	/* if timer needs to be scheduled on another core, we need to
 	 * lock the destination list; if it is on local core, we need to lock if
 	 * we are not called from rte_timer_manage()
@@ -521,7 +999,10 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 		rte_spinlock_lock(&priv_timer[tim_lcore].list_lock);
 
 	__TIMER_STAT_ADD(priv_timer, pending, 1);
-	timer_add(tim, tim_lcore, priv_timer);
+	if (timer_data->wheel != NULL)
+		timer_wheel_add(tim, tim_lcore, timer_data);
+	else
+		timer_add(tim, tim_lcore, priv_timer);
 
 	/* update state: as we are in CONFIG state, only us can modify
 	 * the state so we don't need to use cmpset() here */
@@ -597,12 +1078,15 @@ __rte_timer_stop(struct rte_timer *tim,
 	__TIMER_STAT_ADD(priv_timer, stop, 1);
 	if (prev_status.state == RTE_TIMER_RUNNING &&
 	    lcore_id < RTE_MAX_LCORE) {
-		priv_timer[lcore_id].updated = 1;
+		timer_set_updated(&priv_timer[lcore_id], tim);
 	}
 
 	/* remove it from list */
 	if (prev_status.state == RTE_TIMER_PENDING) {
-		timer_del(tim, prev_status, 0, priv_timer);
+		if (timer_data->wheel != NULL)
+			timer_wheel_del(tim, prev_status, 0, timer_data);
+		else
+			timer_del(tim, prev_status, 0, priv_timer);
 		__TIMER_STAT_ADD(priv_timer, pending, -1);
 	}
 
@@ -789,6 +1273,122 @@ rte_timer_manage(void)
 	return 0;
 }
 
+/* Stop an expired timer, or restart it on this_lcore if it is periodic */
+static void
+timer_expired_complete(struct rte_timer *tim, unsigned int this_lcore,
+		       struct rte_timer_data *data)
+{
+	union rte_timer_status status;
+
+	if (tim->period == 0) {
+		/* remove from done list and mark timer as stopped */
+		status.state = RTE_TIMER_STOP;
+		status.owner = RTE_TIMER_NO_OWNER;
+		/* The "RELEASE" ordering guarantees the memory
+		 * operations above the status update are observed
+		 * before the update by all threads
+		 */
+		__atomic_store_n(&tim->status.u32, status.u32,
+			__ATOMIC_RELEASE);
+	} else {
+		/* keep it in list and mark timer as pending */
+		rte_spinlock_lock(&data->priv_timer[this_lcore].list_lock);
+		status.state = RTE_TIMER_PENDING;
+		__TIMER_STAT_ADD(data->priv_timer, pending, 1);
+		status.owner = (int16_t)this_lcore;
+		/* The "RELEASE" ordering guarantees the memory
+		 * operations above the status update are observed
+		 * before the update by all threads
+		 */
+		__atomic_store_n(&tim->status.u32, status.u32,
+			__ATOMIC_RELEASE);
+		__rte_timer_reset(tim, tim->expire + tim->period,
+			tim->period, this_lcore, tim->f, tim->arg, 1,
+			data);
+		rte_spinlock_unlock(&data->priv_timer[this_lcore].list_lock);
+	}
+}
+
+/* Collect the expired timers of the skiplist of poll_lcore */
+static struct rte_timer *
+timer_skiplist_run_list_get(struct rte_timer_data *data,
+			    unsigned int poll_lcore)
+{
+	struct priv_timer *privp = &data->priv_timer[poll_lcore];
+	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
+	struct rte_timer *tim, *next_tim, **pprev;
+	struct rte_timer *run_first_tim;
+	uint64_t cur_time;
+	int j, ret;
+
+	/* optimize for the case where per-cpu list is empty */
+	if (privp->pending_head.sl_next[0] == NULL)
+		return NULL;
+	cur_time = rte_get_timer_cycles();
+
+#ifdef RTE_ARCH_64
+	/* on 64-bit the value cached in the pending_head.expired will
+	 * be updated atomically, so we can consult that for a quick
+	 * check here outside the lock
+	 */
+	if (likely(privp->pending_head.expire > cur_time))
+		return NULL;
+#endif
+
+	/* browse ordered list, add expired timers in 'expired' list */
+	rte_spinlock_lock(&privp->list_lock);
+
+	/* if nothing to do just unlock and return */
+	if (privp->pending_head.sl_next[0] == NULL ||
+	    privp->pending_head.sl_next[0]->expire > cur_time) {
+		rte_spinlock_unlock(&privp->list_lock);
+		return NULL;
+	}
+
+	/* save start of list of expired timers */
+	tim = privp->pending_head.sl_next[0];
+
+	/* break the existing list at current time point */
+	timer_get_prev_entries(cur_time, poll_lcore, prev,
+			       data->priv_timer);
+	for (j = privp->curr_skiplist_depth - 1; j >= 0; j--) {
+		if (prev[j] == &privp->pending_head)
+			continue;
+		privp->pending_head.sl_next[j] = prev[j]->sl_next[j];
+		if (prev[j]->sl_next[j] == NULL)
+			privp->curr_skiplist_depth--;
+
+		prev[j]->sl_next[j] = NULL;
+	}
+
+	/* transition run-list from PENDING to RUNNING */
+	run_first_tim = tim;
+	pprev = &run_first_tim;
+
+	for ( ; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[0];
+
+		ret = timer_set_running_state(tim);
+		if (likely(ret == 0)) {
+			pprev = &tim->sl_next[0];
+		} else {
+			/* another core is trying to re-config this one,
+			 * remove it from local expired list
+			 */
+			*pprev = next_tim;
+		}
+	}
+
+	/* update the next to expire timer value */
+	privp->pending_head.expire =
+	    (privp->pending_head.sl_next[0] == NULL) ? 0 :
+		privp->pending_head.sl_next[0]->expire;
+
+	rte_spinlock_unlock(&privp->list_lock);
+
+	return run_first_tim;
+}
+
 int
 rte_timer_alt_manage(uint32_t timer_data_id,
 		     unsigned int *poll_lcores,
@@ -796,17 +1396,12 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 		     rte_timer_alt_manage_cb_t f)
 {
 	unsigned int default_poll_lcores[] = {rte_lcore_id()};
-	union rte_timer_status status;
-	struct rte_timer *tim, *next_tim, **pprev;
+	struct rte_timer *tim;
 	struct rte_timer *run_first_tims[RTE_MAX_LCORE];
 	unsigned int this_lcore = rte_lcore_id();
-	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
-	uint64_t cur_time;
-	int i, j, ret;
+	int i;
 	int nb_runlists = 0;
 	struct rte_timer_data *data;
-	struct priv_timer *privp;
-	uint32_t poll_lcore;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, data, -EINVAL);
 
@@ -821,75 +1416,13 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	}
 
 	for (i = 0; i < nb_poll_lcores; i++) {
-		poll_lcore = poll_lcores[i];
-		privp = &data->priv_timer[poll_lcore];
-
-		/* optimize for the case where per-cpu list is empty */
-		if (privp->pending_head.sl_next[0] == NULL)
-			continue;
-		cur_time = rte_get_timer_cycles();
-
-#ifdef RTE_ARCH_64
-		/* on 64-bit the value cached in the pending_head.expired will
-		 * be updated atomically, so we can consult that for a quick
-		 * check here outside the lock
-		 */
-		if (likely(privp->pending_head.expire > cur_time))
-			continue;
-#endif
-
-		/* browse ordered list, add expired timers in 'expired' list */
-		rte_spinlock_lock(&privp->list_lock);
-
-		/* if nothing to do just unlock and return */
-		if (privp->pending_head.sl_next[0] == NULL ||
-		    privp->pending_head.sl_next[0]->expire > cur_time) {
-			rte_spinlock_unlock(&privp->list_lock);
-			continue;
-		}
-
-		/* save start of list of expired timers */
-		tim = privp->pending_head.sl_next[0];
-
-		/* break the existing list at current time point */
-		timer_get_prev_entries(cur_time, poll_lcore, prev,
-				       data->priv_timer);
-		for (j = privp->curr_skiplist_depth - 1; j >= 0; j--) {
-			if (prev[j] == &privp->pending_head)
-				continue;
-			privp->pending_head.sl_next[j] =
-				prev[j]->sl_next[j];
-			if (prev[j]->sl_next[j] == NULL)
-				privp->curr_skiplist_depth--;
-
-			prev[j]->sl_next[j] = NULL;
-		}
-
-		/* transition run-list from PENDING to RUNNING */
-		run_first_tims[nb_runlists] = tim;
-		pprev = &run_first_tims[nb_runlists];
-		nb_runlists++;
-
-		for ( ; tim != NULL; tim = next_tim) {
-			next_tim = tim->sl_next[0];
-
-			ret = timer_set_running_state(tim);
-			if (likely(ret == 0)) {
-				pprev = &tim->sl_next[0];
-			} else {
-				/* another core is trying to re-config this one,
-				 * remove it from local expired list
-				 */
-				*pprev = next_tim;
-			}
-		}
-
-		/* update the next to expire timer value */
-		privp->pending_head.expire =
-		    (privp->pending_head.sl_next[0] == NULL) ? 0 :
-			privp->pending_head.sl_next[0]->expire;
-
-		rte_spinlock_unlock(&privp->list_lock);
+		if (data->wheel != NULL)
+			tim = timer_wheel_run_list_get(data, poll_lcores[i]);
+		else
+			tim = timer_skiplist_run_list_get(data,
+							  poll_lcores[i]);
+		if (tim != NULL)
+			run_first_tims[nb_runlists++] = tim;
 	}
 
 	/* Now process the run lists */
@@ -933,35 +1466,7 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 		if (data->priv_timer[this_lcore].updated == 1)
 			continue;
 
-		if (tim->period == 0) {
-			/* remove from done list and mark timer as stopped */
-			status.state = RTE_TIMER_STOP;
-			status.owner = RTE_TIMER_NO_OWNER;
-			/* The "RELEASE" ordering guarantees the memory
-			 * operations above the status update are observed
-			 * before the update by all threads
-			 */
-			__atomic_store_n(&tim->status.u32, status.u32,
-				__ATOMIC_RELEASE);
-		} else {
-			/* keep it in list and mark timer as pending */
-			rte_spinlock_lock(
-				&data->priv_timer[this_lcore].list_lock);
-			status.state = RTE_TIMER_PENDING;
-			__TIMER_STAT_ADD(data->priv_timer, pending, 1);
-			status.owner = (int16_t)this_lcore;
-			/* The "RELEASE" ordering guarantees the memory
-			 * operations above the status update are observed
-			 * before the update by all threads
-			 */
-			__atomic_store_n(&tim->status.u32, status.u32,
-				__ATOMIC_RELEASE);
-			__rte_timer_reset(tim, tim->expire + tim->period,
-				tim->period, this_lcore, tim->f, tim->arg, 1,
-				data);
-			rte_spinlock_unlock(
-				&data->priv_timer[this_lcore].list_lock);
-		}
+		timer_expired_complete(tim, this_lcore, data);
 
 		data->priv_timer[this_lcore].running_tim = NULL;
 	}
@@ -969,6 +1474,119 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	return 0;
 }
 
+/* Hand running timers to the burst callback, then complete the ones it did not
+ * stop or reload
+ */
+static void
+timer_burst_run(struct rte_timer_data *data, unsigned int this_lcore,
+		rte_timer_alt_manage_burst_cb_t f, struct rte_timer **tims,
+		unsigned int nb_tims)
+{
+	struct priv_timer *privp = &data->priv_timer[this_lcore];
+	unsigned int i;
+
+	privp->running_tims = tims;
+	privp->nb_running_tims = nb_tims;
+	privp->updated_tims = 0;
+
+	/* Call the provided callback function */
+	f(tims, nb_tims);
+
+	for (i = 0; i < nb_tims; i++) {
+		__TIMER_STAT_ADD(data->priv_timer, pending, -1);
+
+		/* the timer was stopped or reloaded by the callback
+		 * function, we have nothing to do here
+		 */
+		if (privp->updated_tims & (1U << i))
+			continue;
+
+		timer_expired_complete(tims[i], this_lcore, data);
+	}
+
+	privp->nb_running_tims = 0;
+}
+
+int
+rte_timer_alt_manage_burst(uint32_t timer_data_id,
+			   unsigned int *poll_lcores,
+			   int nb_poll_lcores,
+			   rte_timer_alt_manage_burst_cb_t f)
+{
+	unsigned int default_poll_lcores[] = {rte_lcore_id()};
+	struct rte_timer *tims[TIMER_MANAGE_BURST_SIZE];
+	struct rte_timer *tim, *next_tim;
+	unsigned int this_lcore = rte_lcore_id();
+	struct rte_timer_data *data;
+	unsigned int nb_tims = 0;
+	int i;
+
+	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, data, -EINVAL);
+
+	/* timer manager only runs on EAL thread with valid lcore_id */
+	assert(this_lcore < RTE_MAX_LCORE);
+
+	__TIMER_STAT_ADD(data->priv_timer, manage, 1);
+
+	if (poll_lcores == NULL) {
+		poll_lcores = default_poll_lcores;
+		nb_poll_lcores = RTE_DIM(default_poll_lcores);
+	}
+
+	for (i = 0; i < nb_poll_lcores; i++) {
+		if (data->wheel != NULL)
+			tim = timer_wheel_run_list_get(data, poll_lcores[i]);
+		else
+			tim = timer_skiplist_run_list_get(data,
+							  poll_lcores[i]);
+
+		/* the run list link is read before the timer is handed to
+		 * the callback, which may restart it
+		 */
+		for ( ; tim != NULL; tim = next_tim) {
+			next_tim = tim->sl_next[0];
+
+			tims[nb_tims++] = tim;
+			if (nb_tims == TIMER_MANAGE_BURST_SIZE) {
+				timer_burst_run(data, this_lcore, f, tims,
+						nb_tims);
+				nb_tims = 0;
+			}
+		}
+	}
+
+	if (nb_tims != 0)
+		timer_burst_run(data, this_lcore, f, tims, nb_tims);
+
+	return 0;
+}
+
+/* Walk the slots of a timing wheel, stopping timers and calling f */
+static void
+timer_wheel_stop_all(struct rte_timer_data *timer_data, unsigned int walk_lcore,
+		     rte_timer_stop_all_cb_t f, void *f_arg)
+{
+	struct timer_wheel *w = &timer_data->wheel[walk_lcore];
+	struct rte_timer *tim, *next_tim;
+	unsigned int lvl, idx;
+
+	rte_spinlock_lock(&timer_data->priv_timer[walk_lcore].list_lock);
+	timer_wheel_requests_drain(timer_data, walk_lcore);
+	rte_spinlock_unlock(&timer_data->priv_timer[walk_lcore].list_lock);
+
+	for (lvl = 0; lvl < TIMER_WHEEL_LEVELS; lvl++)
+		for (idx = 0; idx < TIMER_WHEEL_SLOTS; idx++)
+			for (tim = w->slot[lvl][idx]; tim != NULL;
+			     tim = next_tim) {
+				next_tim = tim->sl_next[0];
+
+				__rte_timer_stop(tim, timer_data);
+
+				if (f)
+					f(tim, f_arg);
+			}
+}
+
 /* Walk pending lists, stopping timers and calling user-specified function */
 int
 rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
@@ -987,6 +1605,11 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 		walk_lcore = walk_lcores[i];
 		priv_timer = &timer_data->priv_timer[walk_lcore];
 
+		if (timer_data->wheel != NULL) {
+			timer_wheel_stop_all(timer_data, walk_lcore, f, f_arg);
+			continue;
+		}
+
 		for (tim = priv_timer->pending_head.sl_next[0];
 		     tim != NULL;
 		     tim = next_tim) {
@@ -157,6 +157,39 @@ int rte_timer_data_alloc(uint32_t *id_ptr);
  */
 int rte_timer_data_dealloc(uint32_t id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Switch a timer data instance from the default skiplist based timer lists
+ * to hierarchical timing wheels, one per lcore. Adding and removing a timer
+ * from a timing wheel is done in constant time whatever the number of pending
+ * timers, at the cost of timers expiring with a granularity of one tick,
+ * never before their expiry time.
+ *
+ * This is to be done after rte_timer_data_alloc() and before any timer is
+ * started on the instance. The timer data instance used by the original
+ * timer APIs can not be switched.
+ *
+ * A timer started by an lcore on the timing wheel of another lcore does not
+ * take the lock of the target timer list: it is queued to that lcore, under a
+ * lock only held to link and unlink queued timers, and is PENDING at once. It
+ * can be stopped or restarted before that lcore moves it to its timing wheel.
+ *
+ * @param timer_data_id
+ *   Identifier of the timer data instance.
+ * @param tick_cycles
+ *   Granularity of the timing wheels (see rte_get_timer_hz()), rounded down
+ *   to a power of two.
+ * @return
+ *   - 0: Success
+ *   - -EINVAL: invalid timer data instance identifier or tick
+ *   - -EBUSY: timing wheels already enabled or timers pending
+ *   - -ENOMEM: not enough memory for the timing wheels
+ */
+__rte_experimental
+int rte_timer_alt_wheel_enable(uint32_t timer_data_id, uint64_t tick_cycles);
+
 /**
  * Initialize the timer library.
  *
@@ -469,6 +502,44 @@ int
 rte_timer_alt_manage(uint32_t timer_data_id, unsigned int *poll_lcores,
 		     int n_poll_lcores, rte_timer_alt_manage_cb_t f);
 
+/**
+ * Callback function type for rte_timer_alt_manage_burst().
+ */
+typedef void (*rte_timer_alt_manage_burst_cb_t)(struct rte_timer **tims,
+						unsigned int nb_tims);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Manage a set of timer lists and execute the specified callback function for
+ * the expired timers, handed over in bursts. This function is similar to
+ * rte_timer_alt_manage(): the timers of a burst are in the RUNNING state while
+ * the callback function is called, which may restart or stop any of them. The
+ * others are stopped, or restarted if periodic, once the callback returns.
+ *
+ * @param timer_data_id
+ *   An identifier indicating which instance of timer data should be used for
+ *   this operation.
+ * @param poll_lcores
+ *   An array of lcore ids identifying the timer lists that should be processed.
+ *   NULL is allowed - if NULL, the timer list corresponding to the lcore
+ *   calling this routine is processed.
+ * @param n_poll_lcores
+ *   The size of the poll_lcores array. If 'poll_lcores' is NULL, this parameter
+ *   is ignored.
+ * @param f
+ *   The callback function which should be called for the expired timers.
+ * @return
+ *   - 0: success
+ *   - -EINVAL: invalid timer_data_id
+ */
+__rte_experimental
+int
+rte_timer_alt_manage_burst(uint32_t timer_data_id, unsigned int *poll_lcores,
+			   int n_poll_lcores,
+			   rte_timer_alt_manage_burst_cb_t f);
+
 /**
  * Callback function type for rte_timer_stop_all().
  */
@@ -0,0 +1,183 @@
+#! /usr/bin/env python3
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright(c) 2023 agent
+
+"""
+Reference client of the DPDK Telemetry stream socket.
+Subscribes to a set of telemetry commands and prints the counters
+which changed in each periodic snapshot, along with their rate.
+"""
+
+import os
+import socket
+import struct
+import sys
+import argparse
+
+# global vars
+STREAM_VERSION = "v1"
+SOCKET_NAME = 'dpdk_telemetry_stream.{}'.format(STREAM_VERSION)
+DEFAULT_PREFIX = 'rte'
+MAX_MSG_LEN = 1 << 22
+
+HDR = struct.Struct('=HHIQQ')
+MSG_SCHEMA = 1
+MSG_DATA = 2
+MSG_ERROR = 3
+NO_SET = 0xffff
+
+
+def get_dpdk_runtime_dir(fp):
+    """ Using the same logic as in DPDK's EAL, get the DPDK runtime directory
+    based on the file-prefix and user """
+    run_dir = os.environ.get('RUNTIME_DIRECTORY')
+    if not run_dir:
+        if (os.getuid() == 0):
+            run_dir = '/var/run'
+        else:
+            run_dir = os.environ.get('XDG_RUNTIME_DIR', '/tmp')
+    return os.path.join(run_dir, 'dpdk', fp)
+
+
+def decode_deltas(buf, count, values):
+    """ Apply the zigzag varint encoded deltas in buf to the values list """
+    pos = 0
+    for i in range(count):
+        zz = 0
+        shift = 0
+        while True:
+            b = buf[pos]
+            pos += 1
+            zz |= (b & 0x7f) << shift
+            if not b & 0x80:
+                break
+            shift += 7
+        delta = (zz >> 1) ^ -(zz & 1)
+        values[i] = (values[i] + delta) & 0xffffffffffffffff
+
+
+def to_signed(val):
+    """ Show unsigned 64-bit values with the top bit set as negative """
+    return val - (1 << 64) if val & (1 << 63) else val
+
+
+class CounterSet:
+    """ Last known state of the counters of one subscription """
+    def __init__(self, cmd):
+        self.cmd = cmd
+        self.names = []
+        self.values = []
+        self.timestamp = None
+
+    def set_schema(self, count, payload):
+        self.names = payload.decode().split('\0')[:count]
+        self.values = [0] * count
+        self.timestamp = None
+
+    def update(self, count, timestamp, payload, show_all):
+        prev = list(self.values)
+        decode_deltas(payload, count, self.values)
+        interval = None
+        if self.timestamp is not None:
+            interval = (timestamp - self.timestamp) / 1e9
+        self.timestamp = timestamp
+        for i, name in enumerate(self.names):
+            delta = to_signed((self.values[i] - prev[i]) & 0xffffffffffffffff)
+            if not show_all and (interval is None or delta == 0):
+                continue
+            rate = '' if not interval else '{:.1f}/s'.format(delta / interval)
+            print('{:.6f} {} {} {} {}'.format(timestamp / 1e9, self.cmd,
+                                              name, to_signed(self.values[i]),
+                                              rate))
+
+
+def subscribe(sock, buf, period, cmd, sets, pending):
+    """ Subscribe to a command and return its set id. Messages of the
+    already subscribed sets received meanwhile are queued in pending """
+    sock.send('subscribe,{},{}'.format(period, cmd).encode())
+    while True:
+        n = sock.recv_into(buf)
+        if n == 0:
+            raise ValueError('{}: connection closed'.format(cmd))
+        msg = bytes(buf[:n])
+        msg_type, set_id, _, _, _ = HDR.unpack_from(msg)
+        if msg_type == MSG_ERROR and set_id == NO_SET:
+            err = msg[HDR.size:].split(b'\0')[0].decode()
+            raise ValueError('{}: {}'.format(cmd, err))
+        pending.append(msg)
+        if msg_type == MSG_SCHEMA and set_id not in sets:
+            return set_id
+
+
+def handle_socket(args, path):
+    """ Subscribe to the requested commands and print the snapshots """
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_SEQPACKET)
+    try:
+        sock.connect(path)
+    except OSError:
+        print("Error connecting to " + path)
+        sock.close()
+        return 1
+
+    buf = bytearray(MAX_MSG_LEN)
+    view = memoryview(buf)
+    sets = {}
+    pending = []
+    try:
+        for cmd in args.commands:
+            set_id = subscribe(sock, buf, args.period, cmd, sets, pending)
+            sets[set_id] = CounterSet(cmd)
+
+        snapshots = 0
+        while args.count == 0 or snapshots < args.count * len(sets):
+            if pending:
+                msg = pending.pop(0)
+                n = len(msg)
+            else:
+                n = sock.recv_into(buf)
+                if n == 0:
+                    break
+                msg = view[:n]
+            msg_type, set_id, count, _, timestamp = HDR.unpack_from(msg)
+            payload = msg[HDR.size:n]
+            if msg_type == MSG_ERROR:
+                err = bytes(payload).split(b'\0')[0].decode()
+                print('Error for set {}: {}'.format(set_id, err),
+                      file=sys.stderr)
+            elif set_id not in sets:
+                continue
+            elif msg_type == MSG_SCHEMA:
+                sets[set_id].set_schema(count, bytes(payload))
+            elif msg_type == MSG_DATA:
+                sets[set_id].update(count, timestamp, payload, args.all)
+                snapshots += 1
+    except ValueError as e:
+        print(e, file=sys.stderr)
+        return 1
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sock.close()
+    return 0
+
+
+parser = argparse.ArgumentParser(
+    description='Stream counters from DPDK Telemetry commands, '
+    'e.g. /ethdev/xstats,0')
+parser.add_argument('-f', '--file-prefix', default=DEFAULT_PREFIX,
+                    help='Provide file-prefix for DPDK runtime directory')
+parser.add_argument('-i', '--instance', default='0', type=int,
+                    help='Provide instance number for DPDK application')
+parser.add_argument('-p', '--period', default=100, type=int,
+                    help='Period of the snapshots in milliseconds')
+parser.add_argument('-c', '--count', default=0, type=int,
+                    help='Number of snapshots to print, 0 to run forever')
+parser.add_argument('-a', '--all', action="store_true", default=False,
+                    help='Print all counters, not only the changed ones')
+parser.add_argument('commands', nargs='+',
+                    help='Telemetry commands to subscribe to')
+args = parser.parse_args()
+sock_path = os.path.join(get_dpdk_runtime_dir(args.file_prefix), SOCKET_NAME)
+if args.instance > 0:
+    sock_path += ":{}".format(args.instance)
+sys.exit(handle_socket(args, sock_path))